@@ -0,0 +1,157 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleBenchmarkRunner.cpp
+    Created: 19 Oct 2026 8:02:41pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "GriddleBenchmarkRunner.h"
+
+//==============================================================================
+constexpr double GriddleBenchmarkRunner::DEFAULT_MIN_SECONDS_PER_BENCHMARK;
+constexpr double GriddleBenchmarkRunner::MIN_SECONDS_PER_BATCH;
+constexpr int GriddleBenchmarkRunner::MIN_NUM_BATCHES;
+
+volatile int64 GriddleBenchmarkRunner::keptValue_ = 0;
+
+//==============================================================================
+GriddleBenchmarkRunner::GriddleBenchmarkRunner(const double minSecondsPerBenchmark)
+    : minSecondsPerBenchmark_(minSecondsPerBenchmark)
+{
+}
+
+GriddleBenchmarkRunner::~GriddleBenchmarkRunner()
+{
+}
+
+//==============================================================================
+double GriddleBenchmarkRunner::run(const String& name, const NamedValueSet& parameters, std::function<void()> benchmark)
+{
+    auto timeBatch = [&benchmark] (const int64 batchSize)
+    {
+        auto startTicks = Time::getHighResolutionTicks();
+
+        for (int64 i = 0; i < batchSize; ++i)
+            benchmark();
+
+        return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+    };
+
+    // Run the benchmark once before timing it so that lazy allocations and cold caches don't count,
+    // then double the batch size until a batch takes long enough to time accurately
+    benchmark();
+
+    int64 batchSize = 1;
+
+    while (timeBatch(batchSize) < MIN_SECONDS_PER_BATCH && batchSize < (int64(1) << 30))
+        batchSize *= 2;
+
+    // Time batches until both the minimum number of batches and the minimum run time are reached
+    Array<double> nanosecondsPerIteration;
+    auto totalSeconds = 0.0;
+
+    while (nanosecondsPerIteration.size() < MIN_NUM_BATCHES || totalSeconds < minSecondsPerBenchmark_)
+    {
+        auto batchSeconds = timeBatch(batchSize);
+
+        nanosecondsPerIteration.add(batchSeconds * 1.0e9 / static_cast<double>(batchSize));
+        totalSeconds += batchSeconds;
+    }
+
+    nanosecondsPerIteration.sort();
+
+    auto numBatches = nanosecondsPerIteration.size();
+    auto sum = 0.0;
+
+    for (auto batchTime : nanosecondsPerIteration)
+        sum += batchTime;
+
+    auto result = createResult(name, parameters);
+    result->setProperty("iterations", batchSize * numBatches);
+    result->setProperty("batches", numBatches);
+    result->setProperty("minNs", nanosecondsPerIteration.getFirst());
+    result->setProperty("medianNs", nanosecondsPerIteration[numBatches / 2]);
+    result->setProperty("meanNs", sum / numBatches);
+    result->setProperty("maxNs", nanosecondsPerIteration.getLast());
+
+    results_.add(var(result.get()));
+
+    return nanosecondsPerIteration[numBatches / 2];
+}
+
+void GriddleBenchmarkRunner::addValue(const String& name, const NamedValueSet& parameters, const double value, const String& units)
+{
+    auto result = createResult(name, parameters);
+    result->setProperty("value", value);
+    result->setProperty("units", units);
+
+    results_.add(var(result.get()));
+}
+
+void GriddleBenchmarkRunner::writeResults(OutputStream& stream) const
+{
+    DynamicObject::Ptr system = new DynamicObject();
+    system->setProperty("os", SystemStats::getOperatingSystemName());
+    system->setProperty("cpuVendor", SystemStats::getCpuVendor());
+    system->setProperty("cpuSpeedMHz", SystemStats::getCpuSpeedInMegahertz());
+    system->setProperty("numCpus", SystemStats::getNumCpus());
+
+    DynamicObject::Ptr root = new DynamicObject();
+    root->setProperty("griddleVersion", ProjectInfo::versionString);
+    root->setProperty("juceVersion", SystemStats::getJUCEVersion());
+   #if JUCE_DEBUG
+    root->setProperty("build", "Debug");
+   #else
+    root->setProperty("build", "Release");
+   #endif
+    root->setProperty("time", Time::getCurrentTime().toISO8601(true));
+    root->setProperty("system", var(system.get()));
+    root->setProperty("results", results_);
+
+    JSON::writeToStream(stream, var(root.get()));
+    stream << newLine;
+}
+
+void GriddleBenchmarkRunner::keepValue(const int64 value)
+{
+    keptValue_ = value;
+}
+
+//==============================================================================
+DynamicObject::Ptr GriddleBenchmarkRunner::createResult(const String& name, const NamedValueSet& parameters)
+{
+    DynamicObject::Ptr parametersObject = new DynamicObject();
+    parametersObject->getProperties() = parameters;
+
+    DynamicObject::Ptr result = new DynamicObject();
+    result->setProperty("name", name);
+    result->setProperty("parameters", var(parametersObject.get()));
+
+    return result;
+}
@@ -0,0 +1,121 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleBenchmarkRunner.h
+    Created: 19 Oct 2026 8:02:41pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+
+//==============================================================================
+/*
+    This class times the Griddle micro-benchmarks and collects their results.
+
+    Each benchmark is a function that is run repeatedly in batches. The batch size is
+    calibrated so a batch takes long enough to time accurately, and batches are run until
+    the minimum run time has passed. The results record the time per iteration of the
+    fastest, median and slowest batches, along with any plain values a benchmark measures
+    (e.g. memory usage), and are written out as JSON for other tools to compare.
+*/
+class GriddleBenchmarkRunner
+{
+public:
+    //==============================================================================
+    explicit GriddleBenchmarkRunner(const double minSecondsPerBenchmark = DEFAULT_MIN_SECONDS_PER_BENCHMARK);
+    ~GriddleBenchmarkRunner();
+
+    //==============================================================================
+    /** Times a benchmark and adds its result
+        @param name          The name of the benchmark (e.g. "compile")
+        @param parameters    The settings the benchmark was run with, which are written out with the result
+        @param benchmark     The function to time, which should do one iteration of the work each call
+        @returns             The median time per iteration in nanoseconds, for comparing benchmarks against each other
+    */
+    double run(const String& name, const NamedValueSet& parameters, std::function<void()> benchmark);
+
+    /** Adds a plain value measured by a benchmark as a result
+        @param name          The name of the benchmark
+        @param parameters    The settings the value was measured with
+        @param value         The measured value
+        @param units         The units of the value (e.g. "bytes")
+    */
+    void addValue(const String& name, const NamedValueSet& parameters, const double value, const String& units);
+
+    /** Writes the results of all of the benchmarks as JSON, along with details of the system they were run on
+        @param stream    The stream to write to
+    */
+    void writeResults(OutputStream& stream) const;
+
+    /** Gets the number of results that have been added
+        @returns    The number of timed benchmarks and plain values
+    */
+    int getNumResults() const;
+
+    /** Stops the compiler from discarding a value that's only computed to be timed
+        @param value    The value a benchmark computed
+    */
+    static void keepValue(const int64 value);
+
+    /** The default minimum time in seconds that each benchmark is run for */
+    static constexpr double DEFAULT_MIN_SECONDS_PER_BENCHMARK = 0.25;
+
+    /** The minimum time in seconds that a batch of iterations is timed for */
+    static constexpr double MIN_SECONDS_PER_BATCH = 0.002;
+
+    /** The minimum number of batches that each benchmark is run for */
+    static constexpr int MIN_NUM_BATCHES = 10;
+
+private:
+    //==============================================================================
+    const double minSecondsPerBenchmark_;
+    Array<var> results_;
+
+    static volatile int64 keptValue_;
+
+    //==============================================================================
+    /** Creates a result object holding a benchmark's name and parameters
+        @param name          The name of the benchmark
+        @param parameters    The settings the benchmark was run with
+        @returns             The new result object
+    */
+    static DynamicObject::Ptr createResult(const String& name, const NamedValueSet& parameters);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleBenchmarkRunner)
+};
+
+//==============================================================================
+// Inline Getter Definitions
+
+inline int GriddleBenchmarkRunner::getNumResults() const
+{
+    return results_.size();
+}
@@ -0,0 +1,954 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleBenchmarks.cpp
+    Created: 19 Oct 2026 8:02:57pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+/*
+    This is the entry point of the GriddleBenchmarks command-line tool, which times the
+    parts of Griddle that run while a sequence is edited and played:
+    - recompiling the source measure after a change (updateSourceMeasure())
+    - the scheduler's dispatch on each tick of the high resolution timer, including polymetric clocked tracks
+      steps with probabilities, ratchets and trig conditions, and chords
+    - reading and writing project files, one at a time and as a large set of fully populated
+      projects, along with the number of allocations each load and save makes and how much faster
+      than a var tree the JSON files are saved
+    - saving the same project file many times in a row
+    - recording undo states
+    - painting the steps and tracks
+
+    Usage: GriddleBenchmarks [--output <file>] [--min-time <seconds>]
+
+    The results are written as JSON to the output file, or to stdout if no file is given. The exit
+    code is 1 if any of the checks made along the way fails (e.g. a save leaving a temporary file behind).
+*/
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+#include "GriddleBenchmarkRunner.h"
+#include "../Source/GriddleMeasureCompiler.h"
+#include "../Source/GriddleOutputEncoder.h"
+#include "../Source/GriddleProjectData.h"
+#include "../Source/GriddleProjectFile.h"
+#include "../Source/GriddleProjectHistory.h"
+#include "../Source/GriddleScheduler.h"
+#include "../Source/GriddleStep.h"
+#include "../Source/GriddleTrack.h"
+#include "../Source/GriddleTrigCondition.h"
+
+//==============================================================================
+// Every allocation made through operator new is counted, so the benchmarks can report how many allocations the work
+// they time makes. JUCE's HeapBlock and MemoryBlock allocate with malloc() directly, so those aren't counted.
+static std::atomic<int64> numAllocations { 0 };
+
+void* operator new(std::size_t size)
+{
+    ++numAllocations;
+
+    if (auto* pointer = std::malloc((size > 0) ? size : 1))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+namespace
+{
+    //==============================================================================
+    /** The sample rate the sequence is compiled at, which matches MainComponent */
+    constexpr double SAMPLE_RATE = 44100.0;
+
+    /** The interval in seconds of the high resolution timer that drives playback in MainComponent */
+    constexpr double TICK_SECONDS = 0.001;
+
+    //==============================================================================
+    /* A GriddleOutputPort that discards every message, so dispatch can be timed without a MIDI device */
+    class NullOutputPort : public GriddleOutputPort
+    {
+    public:
+        void sendMessage(const MidiMessage&, const double) override {}
+    };
+
+    //==============================================================================
+    /** Creates a project with a note on every step of its active tracks
+        Each track plays different notes so that the tracks don't share compiled notes in the cache.
+        @param numActiveTracks    The number of tracks to activate (the rest are inactive)
+        @param numSteps           The number of steps in each track
+        @param burnt              true to burn the tracks, which doubles the number of notes
+        @returns                  The project
+    */
+    GriddleProjectData createProject(const int numActiveTracks, const int numSteps, const bool burnt)
+    {
+        GriddleProjectData projectData;
+
+        for (auto trackIndex = 0; trackIndex < GriddleProjectData::NUM_TRACKS; ++trackIndex)
+        {
+            auto& track = projectData.tracks[trackIndex];
+            track.isActive = (trackIndex < numActiveTracks);
+            track.midiChannel = trackIndex + 1;
+            track.numSteps = numSteps;
+            track.isBurnt = burnt;
+
+            for (auto stepIndex = 0; stepIndex < GriddleTrackData::NUM_STEPS; ++stepIndex)
+            {
+                auto& step = track.steps[stepIndex];
+                step.noteNumber = 36 + (trackIndex * 12) + stepIndex;
+                step.velocity = 64 + (stepIndex * 4);
+                step.gatePercent = 50 + (stepIndex * 3);
+            }
+        }
+
+        return projectData;
+    }
+
+    /** Creates a set of different projects with every setting of every step populated, for timing project files
+        at scale. A project always has NUM_TRACKS tracks of NUM_STEPS steps, so large amounts of step data are
+        made up of many projects.
+        @param numProjects    The number of projects to create
+        @returns              The projects
+    */
+    std::vector<GriddleProjectData> createProjectSet(const int numProjects)
+    {
+        std::vector<GriddleProjectData> projects;
+        projects.reserve(static_cast<size_t>(numProjects));
+
+        for (auto projectIndex = 0; projectIndex < numProjects; ++projectIndex)
+        {
+            auto projectData = createProject(GriddleProjectData::NUM_TRACKS, GriddleTrackData::NUM_STEPS, (projectIndex % 2) != 0);
+            projectData.tempo = 60.0 + (projectIndex % 120);
+            projectData.midiOutput = "Benchmark MIDI Output " + String(projectIndex);
+            projectData.randomSeed = projectIndex;
+
+            for (auto trackIndex = 0; trackIndex < GriddleProjectData::NUM_TRACKS; ++trackIndex)
+            {
+                auto& track = projectData.tracks[trackIndex];
+                track.latencyOffset = (projectIndex % 20) - 10.0;
+                track.swingPercent = GriddleTrackData::MIN_SWING_PERCENT + ((projectIndex + trackIndex) % 20);
+                track.grooveIndex = trackIndex;
+
+                for (auto stepIndex = 0; stepIndex < GriddleTrackData::NUM_STEPS; ++stepIndex)
+                {
+                    auto& step = track.steps[stepIndex];
+                    step.noteNumber = (step.noteNumber + projectIndex) % 116;
+                    step.probability = 100 - ((projectIndex + stepIndex) % 50);
+                    step.ratchets = 1 + (stepIndex % GriddleStepData::MAX_RATCHETS);
+                    step.condition = GriddleTrigCondition::getIterationCondition(1 + (stepIndex % 4), 4);
+                    step.numChordNotes = GriddleStepData::MAX_CHORD_NOTES - 1;
+
+                    for (auto chordNoteI = 0; chordNoteI < step.numChordNotes; ++chordNoteI)
+                        step.chordNotes[static_cast<size_t>(chordNoteI)] = { step.noteNumber + ((chordNoteI + 1) * 4), step.velocity };
+                }
+            }
+
+            auto& tempoAutomation = projectData.tempoAutomation;
+            tempoAutomation.numMeasures = 4;
+            tempoAutomation.numPoints = GriddleTempoAutomationData::MAX_POINTS;
+
+            for (auto pointIndex = 0; pointIndex < tempoAutomation.numPoints; ++pointIndex)
+                tempoAutomation.points[static_cast<size_t>(pointIndex)] = { pointIndex * 2.0, 0.5 + (pointIndex * 0.25), (pointIndex % 2) != 0 };
+
+            for (auto grooveIndex = 0; grooveIndex < GriddleProjectData::NUM_GROOVES; ++grooveIndex)
+            {
+                auto& groove = projectData.grooves[grooveIndex];
+                groove.name = "Groove " + String(grooveIndex + 1);
+
+                for (auto stepIndex = 0; stepIndex < GriddleTrackData::NUM_STEPS; ++stepIndex)
+                {
+                    groove.timingPercents[stepIndex] = ((stepIndex + grooveIndex) % 5) * 5;
+                    groove.velocityOffsets[stepIndex] = ((stepIndex + projectIndex) % 9) - 4;
+                }
+            }
+
+            projects.push_back(projectData);
+        }
+
+        return projects;
+    }
+
+    /** Builds the var tree that projects were saved from with JSON::writeToStream() before the streaming writer,
+        holding the same properties that GriddleProjectFile::writeJson() writes
+        @param projectData    The project data
+        @returns              The project as a var tree
+    */
+    var createProjectVar(const GriddleProjectData& projectData)
+    {
+        auto createIntArray = [] (const int* values, const int numValues)
+        {
+            Array<var> array;
+
+            for (auto valueI = 0; valueI < numValues; ++valueI)
+                array.add(values[valueI]);
+
+            return var(array);
+        };
+
+        // Master settings
+        Array<var> tempoPoints;
+
+        for (auto pointI = 0; pointI < projectData.tempoAutomation.numPoints; ++pointI)
+        {
+            const auto& point = projectData.tempoAutomation.points[static_cast<size_t>(pointI)];
+
+            DynamicObject::Ptr pointObject = new DynamicObject();
+            pointObject->setProperty("beat", point.beat);
+            pointObject->setProperty("tempo_scale", point.tempoScale);
+            pointObject->setProperty("ramp", point.isRamp);
+            tempoPoints.add(var(pointObject.get()));
+        }
+
+        DynamicObject::Ptr tempoAutomation = new DynamicObject();
+        tempoAutomation->setProperty("num_measures", projectData.tempoAutomation.numMeasures);
+        tempoAutomation->setProperty("points", tempoPoints);
+
+        Array<var> grooves;
+
+        for (auto& groove : projectData.grooves)
+        {
+            DynamicObject::Ptr grooveObject = new DynamicObject();
+            grooveObject->setProperty("name", groove.name);
+            grooveObject->setProperty("timing_percents", createIntArray(groove.timingPercents.data(), jlimit(1, GriddleTrackData::NUM_STEPS, groove.length)));
+            grooveObject->setProperty("velocity_offsets", createIntArray(groove.velocityOffsets.data(), jlimit(1, GriddleTrackData::NUM_STEPS, groove.length)));
+            grooves.add(var(grooveObject.get()));
+        }
+
+        DynamicObject::Ptr masterSettings = new DynamicObject();
+        masterSettings->setProperty("tempo", projectData.tempo);
+        masterSettings->setProperty("tempo_automation", var(tempoAutomation.get()));
+        masterSettings->setProperty("grooves", grooves);
+        masterSettings->setProperty("midi_output", projectData.midiOutput);
+        masterSettings->setProperty("midi_wire_rate", projectData.midiWireRate);
+        masterSettings->setProperty("bandwidth_aware_scheduling", projectData.bandwidthAwareScheduling);
+        masterSettings->setProperty("random_seed", projectData.randomSeed);
+
+        // Tracks and steps
+        Array<var> tracks;
+
+        for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+        {
+            const auto& trackData = projectData.tracks[trackI];
+            Array<var> steps;
+
+            for (auto& step : trackData.steps)
+            {
+                Array<var> chordNotes;
+
+                for (auto chordNoteI = 0; chordNoteI < step.numChordNotes; ++chordNoteI)
+                {
+                    DynamicObject::Ptr chordNoteObject = new DynamicObject();
+                    chordNoteObject->setProperty("note_number", step.chordNotes[static_cast<size_t>(chordNoteI)].noteNumber);
+                    chordNoteObject->setProperty("velocity", step.chordNotes[static_cast<size_t>(chordNoteI)].velocity);
+                    chordNotes.add(var(chordNoteObject.get()));
+                }
+
+                DynamicObject::Ptr stepObject = new DynamicObject();
+                stepObject->setProperty("note_number", step.noteNumber);
+                stepObject->setProperty("velocity", step.velocity);
+                stepObject->setProperty("gate_percent", step.gatePercent);
+                stepObject->setProperty("probability", step.probability);
+                stepObject->setProperty("ratchets", step.ratchets);
+                stepObject->setProperty("condition", GriddleTrigCondition::getName(step.condition));
+                stepObject->setProperty("chord_notes", chordNotes);
+                steps.add(var(stepObject.get()));
+            }
+
+            DynamicObject::Ptr trackObject = new DynamicObject();
+            trackObject->setProperty("name", String::charToString(static_cast<juce_wchar>('A' + trackI)));
+            trackObject->setProperty("is_active", trackData.isActive);
+            trackObject->setProperty("midi_ch", trackData.midiChannel);
+            trackObject->setProperty("num_steps", trackData.numSteps);
+            trackObject->setProperty("is_flipped", trackData.isFlipped);
+            trackObject->setProperty("is_chopped", trackData.isChopped);
+            trackObject->setProperty("is_burnt", trackData.isBurnt);
+            trackObject->setProperty("latency_offset", trackData.latencyOffset);
+            trackObject->setProperty("latency_offset_units", trackData.latencyOffsetInSamples ? "samples" : "ms");
+            trackObject->setProperty("swing_percent", trackData.swingPercent);
+            trackObject->setProperty("groove_index", trackData.grooveIndex);
+            trackObject->setProperty("clock_rate", GriddleTimeline::isValidClockRate(trackData.clockRateNumerator, trackData.clockRateDenominator)
+                                                       ? String(trackData.clockRateNumerator) + "/" + String(trackData.clockRateDenominator)
+                                                       : String("fit"));
+            trackObject->setProperty("steps", steps);
+            tracks.add(var(trackObject.get()));
+        }
+
+        DynamicObject::Ptr sequence = new DynamicObject();
+        sequence->setProperty("tracks", tracks);
+
+        DynamicObject::Ptr project = new DynamicObject();
+        project->setProperty("master_settings", var(masterSettings.get()));
+        project->setProperty("sequence", var(sequence.get()));
+
+        return var(project.get());
+    }
+
+    /** Counts the allocations made through operator new by a call of a function
+        @param function    The function to call
+        @returns           The number of allocations the call made
+    */
+    int64 countAllocations(const std::function<void()>& function)
+    {
+        auto numAllocationsBefore = numAllocations.load();
+        function();
+
+        return numAllocations.load() - numAllocationsBefore;
+    }
+
+    //==============================================================================
+    /** Times compiling a project and swapping it into the scheduler, as updateSourceMeasure() does
+        Each case is timed with the tracks' compiled notes in the cache (an edit that leaves them unchanged,
+        e.g. a tempo change) and with every track missing the cache.
+    */
+    void benchmarkSourceBufferUpdate(GriddleBenchmarkRunner& runner)
+    {
+        const int trackCounts[] = { 1, 2, 4 };
+        const int stepCounts[] = { 4, 8, 16 };
+
+        for (auto numActiveTracks : trackCounts)
+        {
+            for (auto numSteps : stepCounts)
+            {
+                for (auto cached : { true, false })
+                {
+                    GriddleOutputEncoder outputEncoder;
+                    GriddleScheduler scheduler(outputEncoder);
+                    GriddleMeasureCompiler measureCompiler;
+                    GriddleCompiledMeasure sourceMeasure;
+                    auto projectData = createProject(numActiveTracks, numSteps, false);
+                    auto iteration = 0;
+
+                    runner.run("updateSourceMeasure", { { "activeTracks", numActiveTracks }, { "numSteps", numSteps }, { "cached", cached } }, [&]
+                    {
+                        // Cycling the first step of each track through more velocities than the cache can hold makes every track miss it
+                        if (! cached)
+                        {
+                            for (auto& track : projectData.tracks)
+                                track.steps[0].velocity = 1 + (iteration % 127);
+
+                            ++iteration;
+                        }
+
+                        measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+                        GriddleBenchmarkRunner::keepValue(scheduler.swapSourceMeasure(sourceMeasure));
+                    });
+                }
+            }
+        }
+    }
+
+    /** Times one tick of the scheduler during playback, on a simulated clock that advances by the timer interval
+        Each case is timed with the playback telemetry on and off, to show what recording it costs, and with
+        a constant tempo and a tempo ramp, to show what integrating the tempo map costs.
+    */
+    void benchmarkTickDispatch(GriddleBenchmarkRunner& runner)
+    {
+        const int trackCounts[] = { 1, 4 };
+
+        // Ramp up to double the tempo over each measure, so every event is timed on a ramp
+        GriddleTempoAutomationData tempoRamp;
+        tempoRamp.numPoints = 2;
+        tempoRamp.points[0] = { 0.0, 1.0, false };
+        tempoRamp.points[1] = { 4.0, 2.0, true };
+
+        for (auto numActiveTracks : trackCounts)
+        {
+            for (auto burnt : { false, true })
+            {
+                for (auto telemetry : { true, false })
+                {
+                    for (auto ramp : { false, true })
+                    {
+                        GriddleOutputEncoder outputEncoder;
+                        outputEncoder.setOutputPort(std::make_unique<NullOutputPort>());
+                        outputEncoder.setWireRate(0.0);
+
+                        GriddleScheduler scheduler(outputEncoder);
+                        GriddleMeasureCompiler measureCompiler;
+                        GriddleCompiledMeasure sourceMeasure;
+                        auto projectData = createProject(numActiveTracks, GriddleTrackData::NUM_STEPS, burnt);
+
+                        if (ramp)
+                            projectData.tempoAutomation = tempoRamp;
+
+                        measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+                        scheduler.swapSourceMeasure(sourceMeasure);
+                        scheduler.setTempoMap(GriddleTempoMap(projectData.tempo, projectData.tempoAutomation));
+                        scheduler.getTelemetry().setEnabled(telemetry);
+
+                        auto clockTime = 1000.0;
+                        scheduler.start(clockTime);
+
+                        runner.run("tickDispatch", { { "activeTracks", numActiveTracks }, { "burnt", burnt }, { "tempo", projectData.tempo },
+                                                     { "tempoRamp", ramp }, { "telemetry", telemetry } }, [&]
+                        {
+                            clockTime += TICK_SECONDS;
+
+                            if (telemetry)
+                                scheduler.getTelemetry().recordTimerCallback(clockTime, TICK_SECONDS);
+
+                            GriddleBenchmarkRunner::keepValue(scheduler.process(clockTime) ? 1 : 0);
+                        });
+
+                        scheduler.stop();
+                    }
+                }
+            }
+        }
+    }
+
+    /** Times one tick of the scheduler during playback with every track clocked at a different rate and length,
+        so the tracks' free-running cycles land differently in every measure and are merged as they're sent
+    */
+    void benchmarkPolymetricDispatch(GriddleBenchmarkRunner& runner)
+    {
+        // 16 steps fitted into the measure, 7 steps of 16th notes, 5 steps of 16th note triplets and 3 steps of 32nd notes
+        const int numSteps[] = { 16, 7, 5, 3 };
+        const GriddleTimeline::ClockRate clockRates[] = { { 0, 1 }, { 1, 1 }, { 3, 2 }, { 2, 1 } };
+
+        for (auto burnt : { false, true })
+        {
+            GriddleOutputEncoder outputEncoder;
+            outputEncoder.setOutputPort(std::make_unique<NullOutputPort>());
+            outputEncoder.setWireRate(0.0);
+
+            GriddleScheduler scheduler(outputEncoder);
+            GriddleMeasureCompiler measureCompiler;
+            GriddleCompiledMeasure sourceMeasure;
+            auto projectData = createProject(GriddleProjectData::NUM_TRACKS, GriddleTrackData::NUM_STEPS, burnt);
+
+            for (auto trackIndex = 0; trackIndex < GriddleProjectData::NUM_TRACKS; ++trackIndex)
+            {
+                projectData.tracks[trackIndex].numSteps = numSteps[trackIndex];
+                projectData.tracks[trackIndex].clockRateNumerator = clockRates[trackIndex].numerator;
+                projectData.tracks[trackIndex].clockRateDenominator = clockRates[trackIndex].denominator;
+            }
+
+            measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+            scheduler.swapSourceMeasure(sourceMeasure);
+            scheduler.setTempoMap(GriddleTempoMap(projectData.tempo, projectData.tempoAutomation));
+            scheduler.getTelemetry().setEnabled(false);
+
+            auto clockTime = 1000.0;
+            scheduler.start(clockTime);
+
+            runner.run("tickDispatchPolymetric", { { "activeTracks", GriddleProjectData::NUM_TRACKS }, { "burnt", burnt }, { "tempo", projectData.tempo } }, [&]
+            {
+                clockTime += TICK_SECONDS;
+                GriddleBenchmarkRunner::keepValue(scheduler.process(clockTime) ? 1 : 0);
+            });
+
+            scheduler.stop();
+        }
+    }
+
+    /** Times one tick of the scheduler during playback with a probability, ratchets or a trig condition on every step,
+        so every measure that's queued decides which of its trigs play
+    */
+    void benchmarkTrigDispatch(GriddleBenchmarkRunner& runner)
+    {
+        for (auto burnt : { false, true })
+        {
+            GriddleOutputEncoder outputEncoder;
+            outputEncoder.setOutputPort(std::make_unique<NullOutputPort>());
+            outputEncoder.setWireRate(0.0);
+
+            GriddleScheduler scheduler(outputEncoder);
+            GriddleMeasureCompiler measureCompiler;
+            GriddleCompiledMeasure sourceMeasure;
+            auto projectData = createProject(GriddleProjectData::NUM_TRACKS, GriddleTrackData::NUM_STEPS, burnt);
+
+            // Cycle each track's steps through a probability, ratchets, an iteration condition and a PREVIOUS condition
+            for (auto& track : projectData.tracks)
+            {
+                for (auto stepIndex = 0; stepIndex < GriddleTrackData::NUM_STEPS; ++stepIndex)
+                {
+                    auto& step = track.steps[stepIndex];
+
+                    if ((stepIndex % 4) == 0)
+                        step.probability = 50;
+                    else if ((stepIndex % 4) == 1)
+                        step.ratchets = 3;
+                    else if ((stepIndex % 4) == 2)
+                        step.condition = GriddleTrigCondition::getIterationCondition(1 + (stepIndex % 3), 3);
+                    else
+                        step.condition = GriddleTrigCondition::PREVIOUS;
+                }
+            }
+
+            measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+            scheduler.swapSourceMeasure(sourceMeasure);
+            scheduler.setTempoMap(GriddleTempoMap(projectData.tempo, projectData.tempoAutomation));
+            scheduler.setRandomSeed(projectData.randomSeed);
+            scheduler.getTelemetry().setEnabled(false);
+
+            auto clockTime = 1000.0;
+            scheduler.start(clockTime);
+
+            runner.run("tickDispatchTrigs", { { "activeTracks", GriddleProjectData::NUM_TRACKS }, { "burnt", burnt }, { "tempo", projectData.tempo } }, [&]
+            {
+                clockTime += TICK_SECONDS;
+                GriddleBenchmarkRunner::keepValue(scheduler.process(clockTime) ? 1 : 0);
+            });
+
+            scheduler.stop();
+        }
+    }
+
+    /** Times one tick of the scheduler during playback with a full chord on every step */
+    void benchmarkChordDispatch(GriddleBenchmarkRunner& runner)
+    {
+        for (auto burnt : { false, true })
+        {
+            GriddleOutputEncoder outputEncoder;
+            outputEncoder.setOutputPort(std::make_unique<NullOutputPort>());
+            outputEncoder.setWireRate(0.0);
+
+            GriddleScheduler scheduler(outputEncoder);
+            GriddleMeasureCompiler measureCompiler;
+            GriddleCompiledMeasure sourceMeasure;
+            auto projectData = createProject(GriddleProjectData::NUM_TRACKS, GriddleTrackData::NUM_STEPS, burnt);
+
+            // Stack thirds on top of each step's note
+            for (auto& track : projectData.tracks)
+            {
+                for (auto& step : track.steps)
+                {
+                    step.numChordNotes = GriddleStepData::MAX_CHORD_NOTES - 1;
+
+                    for (auto chordNoteI = 0; chordNoteI < step.numChordNotes; ++chordNoteI)
+                        step.chordNotes[static_cast<size_t>(chordNoteI)] = { jmin(127, step.noteNumber + ((chordNoteI + 1) * 4)), step.velocity };
+                }
+            }
+
+            measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+            scheduler.swapSourceMeasure(sourceMeasure);
+            scheduler.setTempoMap(GriddleTempoMap(projectData.tempo, projectData.tempoAutomation));
+            scheduler.getTelemetry().setEnabled(false);
+
+            auto clockTime = 1000.0;
+            scheduler.start(clockTime);
+
+            runner.run("tickDispatchChords", { { "activeTracks", GriddleProjectData::NUM_TRACKS }, { "burnt", burnt }, { "tempo", projectData.tempo } }, [&]
+            {
+                clockTime += TICK_SECONDS;
+                GriddleBenchmarkRunner::keepValue(scheduler.process(clockTime) ? 1 : 0);
+            });
+
+            scheduler.stop();
+        }
+    }
+
+    /** Times reading and writing a fully populated project in both file formats
+        The JSON reading is also compared against parsing the same file into a var tree with JSON::parse(),
+        which is how projects were read before the streaming reader.
+    */
+    void benchmarkProjectFiles(GriddleBenchmarkRunner& runner)
+    {
+        auto projectData = createProject(GriddleProjectData::NUM_TRACKS, GriddleTrackData::NUM_STEPS, false);
+        projectData.midiOutput = "Benchmark MIDI Output";
+
+        MemoryOutputStream jsonStream;
+        GriddleProjectFile::writeJson(jsonStream, projectData);
+
+        MemoryOutputStream binaryStream;
+        GriddleProjectFile::writeBinary(binaryStream, projectData);
+
+        NamedValueSet jsonParameters { { "format", "json" }, { "bytes", static_cast<int>(jsonStream.getDataSize()) } };
+        NamedValueSet binaryParameters { { "format", "binary" }, { "bytes", static_cast<int>(binaryStream.getDataSize()) } };
+
+        GriddleProjectData loadedProjectData;
+        String errorString;
+
+        runner.run("projectLoad", jsonParameters, [&]
+        {
+            errorString.clear();
+            auto result = GriddleProjectFile::readJson(jsonStream.getData(), jsonStream.getDataSize(), loadedProjectData, errorString);
+            GriddleBenchmarkRunner::keepValue(result.wasOk() ? 1 : 0);
+        });
+
+        runner.run("projectLoadVarTree", jsonParameters, [&]
+        {
+            auto parsedProject = JSON::parse(String::fromUTF8(static_cast<const char*>(jsonStream.getData()), static_cast<int>(jsonStream.getDataSize())));
+            GriddleBenchmarkRunner::keepValue(parsedProject.isObject() ? 1 : 0);
+        });
+
+        runner.run("projectLoad", binaryParameters, [&]
+        {
+            auto result = GriddleProjectFile::readBinary(binaryStream.getData(), binaryStream.getDataSize(), loadedProjectData);
+            GriddleBenchmarkRunner::keepValue(result.wasOk() ? 1 : 0);
+        });
+
+        MemoryOutputStream saveStream;
+
+        runner.run("projectSave", jsonParameters, [&]
+        {
+            saveStream.reset();
+            GriddleProjectFile::writeJson(saveStream, projectData);
+            GriddleBenchmarkRunner::keepValue(static_cast<int64>(saveStream.getDataSize()));
+        });
+
+        runner.run("projectSave", binaryParameters, [&]
+        {
+            saveStream.reset();
+            GriddleProjectFile::writeBinary(saveStream, projectData);
+            GriddleBenchmarkRunner::keepValue(static_cast<int64>(saveStream.getDataSize()));
+        });
+    }
+
+    /** Times reading and writing a large set of fully populated projects (see createProjectSet()) back to back in both
+        formats, and counts the allocations each load and save makes. The JSON reading is compared against parsing the
+        same files into var trees with JSON::parse(), and the JSON writing against building each project's var tree and
+        writing it with JSON::writeToStream(), which is how projects were saved before the streaming writer.
+    */
+    void benchmarkLargeProjectFiles(GriddleBenchmarkRunner& runner)
+    {
+        // 160 projects of 4 tracks of 16 steps is 10240 steps
+        const auto numProjects = 160;
+        auto projects = createProjectSet(numProjects);
+
+        std::vector<MemoryBlock> jsonFiles;
+        std::vector<MemoryBlock> binaryFiles;
+        size_t numJsonBytes = 0;
+        size_t numBinaryBytes = 0;
+
+        for (auto& projectData : projects)
+        {
+            MemoryOutputStream jsonStream;
+            GriddleProjectFile::writeJson(jsonStream, projectData);
+            jsonFiles.push_back(jsonStream.getMemoryBlock());
+            numJsonBytes += jsonStream.getDataSize();
+
+            MemoryOutputStream binaryStream;
+            GriddleProjectFile::writeBinary(binaryStream, projectData);
+            binaryFiles.push_back(binaryStream.getMemoryBlock());
+            numBinaryBytes += binaryStream.getDataSize();
+        }
+
+        auto numSteps = numProjects * GriddleProjectData::NUM_TRACKS * GriddleTrackData::NUM_STEPS;
+        NamedValueSet jsonParameters { { "format", "json" }, { "projects", numProjects }, { "steps", numSteps }, { "bytes", static_cast<int64>(numJsonBytes) } };
+        NamedValueSet binaryParameters { { "format", "binary" }, { "projects", numProjects }, { "steps", numSteps }, { "bytes", static_cast<int64>(numBinaryBytes) } };
+
+        GriddleProjectData loadedProjectData;
+        String errorString;
+
+        auto loadJson = [&]
+        {
+            for (auto& jsonFile : jsonFiles)
+            {
+                errorString.clear();
+                auto result = GriddleProjectFile::readJson(jsonFile.getData(), jsonFile.getSize(), loadedProjectData, errorString);
+                GriddleBenchmarkRunner::keepValue(result.wasOk() ? 1 : 0);
+            }
+        };
+
+        auto loadVarTree = [&]
+        {
+            for (auto& jsonFile : jsonFiles)
+            {
+                auto parsedProject = JSON::parse(String::fromUTF8(static_cast<const char*>(jsonFile.getData()), static_cast<int>(jsonFile.getSize())));
+                GriddleBenchmarkRunner::keepValue(parsedProject.isObject() ? 1 : 0);
+            }
+        };
+
+        auto loadBinary = [&]
+        {
+            for (auto& binaryFile : binaryFiles)
+            {
+                auto result = GriddleProjectFile::readBinary(binaryFile.getData(), binaryFile.getSize(), loadedProjectData);
+                GriddleBenchmarkRunner::keepValue(result.wasOk() ? 1 : 0);
+            }
+        };
+
+        runner.run("projectLoad", jsonParameters, loadJson);
+        runner.run("projectLoadVarTree", jsonParameters, loadVarTree);
+        runner.run("projectLoad", binaryParameters, loadBinary);
+
+        runner.addValue("projectLoadAllocations", jsonParameters, static_cast<double>(countAllocations(loadJson)) / numProjects, "allocations per load");
+        runner.addValue("projectLoadVarTreeAllocations", jsonParameters, static_cast<double>(countAllocations(loadVarTree)) / numProjects, "allocations per load");
+        runner.addValue("projectLoadAllocations", binaryParameters, static_cast<double>(countAllocations(loadBinary)) / numProjects, "allocations per load");
+
+        // Each save is written into a buffer that's reused, as GriddleProjectFile does
+        MemoryOutputStream saveStream;
+
+        auto saveJson = [&]
+        {
+            for (auto& projectData : projects)
+            {
+                saveStream.reset();
+                GriddleProjectFile::writeJson(saveStream, projectData);
+                GriddleBenchmarkRunner::keepValue(static_cast<int64>(saveStream.getDataSize()));
+            }
+        };
+
+        auto saveVarTree = [&]
+        {
+            for (auto& projectData : projects)
+            {
+                saveStream.reset();
+                JSON::writeToStream(saveStream, createProjectVar(projectData));
+                GriddleBenchmarkRunner::keepValue(static_cast<int64>(saveStream.getDataSize()));
+            }
+        };
+
+        auto saveBinary = [&]
+        {
+            for (auto& projectData : projects)
+            {
+                saveStream.reset();
+                GriddleProjectFile::writeBinary(saveStream, projectData);
+                GriddleBenchmarkRunner::keepValue(static_cast<int64>(saveStream.getDataSize()));
+            }
+        };
+
+        auto saveJsonNs = runner.run("projectSave", jsonParameters, saveJson);
+        auto saveVarTreeNs = runner.run("projectSaveVarTree", jsonParameters, saveVarTree);
+        runner.run("projectSave", binaryParameters, saveBinary);
+
+        runner.addValue("projectSaveSpeedup", jsonParameters, saveVarTreeNs / saveJsonNs, "times faster than projectSaveVarTree");
+
+        runner.addValue("projectSaveAllocations", jsonParameters, static_cast<double>(countAllocations(saveJson)) / numProjects, "allocations per save");
+        runner.addValue("projectSaveVarTreeAllocations", jsonParameters, static_cast<double>(countAllocations(saveVarTree)) / numProjects, "allocations per save");
+        runner.addValue("projectSaveAllocations", binaryParameters, static_cast<double>(countAllocations(saveBinary)) / numProjects, "allocations per save");
+    }
+
+    /** Saves a project to the same file many times in a row in each format, as repeated saves during a session do,
+        timing the saves and checking that every save succeeds, that the file keeps the same size and that no
+        temporary files are left next to it
+        @returns    true if all of the checks passed, otherwise false
+    */
+    bool benchmarkRepeatedSaves(GriddleBenchmarkRunner& runner)
+    {
+        const auto numSaves = 1000;
+
+        auto projectData = createProject(GriddleProjectData::NUM_TRACKS, GriddleTrackData::NUM_STEPS, false);
+        projectData.midiOutput = "Benchmark MIDI Output";
+
+        // Save into a directory of its own, so anything left in it was left by the saves
+        auto directory = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("GriddleBenchmarkSaves", "", false);
+
+        if (directory.createDirectory().failed())
+        {
+            std::cerr << "FAILED - couldn't create " << directory.getFullPathName() << std::endl;
+            return false;
+        }
+
+        auto passed = true;
+
+        for (auto binary : { false, true })
+        {
+            auto projectFile = directory.getChildFile(binary ? "Benchmark.griddlebin" : "Benchmark.griddle");
+            GriddleProjectFile griddleProjectFile;
+            int64 fileSize = -1;
+            auto numFailedSaves = 0;
+            auto numSizeChanges = 0;
+
+            auto startTicks = Time::getHighResolutionTicks();
+
+            for (auto saveIndex = 0; saveIndex < numSaves; ++saveIndex)
+            {
+                auto result = binary ? griddleProjectFile.saveBinary(projectFile, projectData) : griddleProjectFile.save(projectFile, projectData);
+
+                if (result.failed())
+                    ++numFailedSaves;
+
+                if ((fileSize >= 0) && (projectFile.getSize() != fileSize))
+                    ++numSizeChanges;
+
+                fileSize = projectFile.getSize();
+            }
+
+            auto seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+            runner.addValue("projectSaveToFile", { { "format", binary ? "binary" : "json" }, { "saves", numSaves } }, seconds * 1.0e9 / numSaves, "ns per save");
+
+            // Hidden files are included, as the temporary files are hidden
+            auto numLeftoverFiles = directory.findChildFiles(File::findFilesAndDirectories, false).size() - 1;
+
+            if (numFailedSaves > 0)
+                std::cerr << "FAILED - " << numFailedSaves << " of " << numSaves << " saves failed" << std::endl;
+
+            if (numSizeChanges > 0)
+                std::cerr << "FAILED - the project file changed size " << numSizeChanges << " times over " << numSaves << " saves" << std::endl;
+
+            if (numLeftoverFiles > 0)
+                std::cerr << "FAILED - " << numLeftoverFiles << " files were left next to the project file after " << numSaves << " saves" << std::endl;
+
+            passed = (numFailedSaves == 0) && (numSizeChanges == 0) && (numLeftoverFiles == 0) && passed;
+
+            projectFile.deleteFile();
+        }
+
+        directory.deleteRecursively();
+
+        return passed;
+    }
+
+    /** Times recording an undo state for a single step edit, and measures the memory a long edit history uses */
+    void benchmarkProjectHistory(GriddleBenchmarkRunner& runner)
+    {
+        auto editStep = [] (GriddleProjectData& projectData, const int edit)
+        {
+            auto stepIndex = edit % (GriddleProjectData::NUM_TRACKS * GriddleTrackData::NUM_STEPS);
+            auto& step = projectData.tracks[stepIndex / GriddleTrackData::NUM_STEPS].steps[stepIndex % GriddleTrackData::NUM_STEPS];
+            step.noteNumber = (step.noteNumber + 1) % 128;
+        };
+
+        {
+            GriddleProjectHistory projectHistory;
+            auto projectData = createProject(GriddleProjectData::NUM_TRACKS, GriddleTrackData::NUM_STEPS, false);
+            auto edit = 0;
+
+            projectHistory.reset(projectData);
+
+            runner.run("historyRecordState", { { "maxNumStates", GriddleProjectHistory::DEFAULT_MAX_NUM_STATES } }, [&]
+            {
+                editStep(projectData, edit++);
+                GriddleBenchmarkRunner::keepValue(projectHistory.recordState(projectData) ? 1 : 0);
+            });
+        }
+
+        {
+            const auto numEdits = 100000;
+
+            GriddleProjectHistory projectHistory(numEdits + 1);
+            auto projectData = createProject(GriddleProjectData::NUM_TRACKS, GriddleTrackData::NUM_STEPS, false);
+
+            projectHistory.reset(projectData);
+
+            for (auto edit = 0; edit < numEdits; ++edit)
+            {
+                editStep(projectData, edit);
+                projectHistory.recordState(projectData);
+            }
+
+            runner.addValue("historyMemoryUsage", { { "edits", numEdits } }, static_cast<double>(projectHistory.getMemoryUsage()), "bytes");
+        }
+    }
+
+    /** Times painting a step and a whole track into an offscreen image */
+    void benchmarkPainting(GriddleBenchmarkRunner& runner)
+    {
+        for (auto isRest : { false, true })
+        {
+            for (auto drawFlippedAndChopped : { false, true })
+            {
+                GriddleStep step(0, 0);
+                step.setNoteNumber(isRest ? -1 : 60);
+                step.setVelocity(100);
+                step.setGatePercent(75);
+                step.setFlipDrawState(drawFlippedAndChopped);
+                step.setChopDrawState(drawFlippedAndChopped);
+
+                Image image(Image::ARGB, step.getWidth(), step.getHeight(), true);
+                Graphics g(image);
+
+                runner.run("paintStep", { { "rest", isRest }, { "flippedAndChopped", drawFlippedAndChopped } }, [&]
+                {
+                    step.paintEntireComponent(g, true);
+                });
+            }
+        }
+
+        for (auto numSteps : { 1, GriddleTrackData::NUM_STEPS })
+        {
+            GriddleTrack track(0);
+            track.loadTrackData(createProject(1, numSteps, false).tracks[0]);
+
+            Image image(Image::ARGB, track.getWidth(), track.getHeight(), true);
+            Graphics g(image);
+
+            runner.run("paintTrack", { { "numSteps", numSteps } }, [&]
+            {
+                track.paintEntireComponent(g, true);
+            });
+        }
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // Painting needs the GUI side of JUCE (fonts and the default LookAndFeel) to be initialised
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StringArray args(argv + 1, argc - 1);
+    File outputFile;
+    auto minSecondsPerBenchmark = GriddleBenchmarkRunner::DEFAULT_MIN_SECONDS_PER_BENCHMARK;
+
+    for (auto i = 0; i < args.size(); ++i)
+    {
+        if (args[i] == "--output" && i + 1 < args.size())
+        {
+            outputFile = File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        }
+        else if (args[i] == "--min-time" && i + 1 < args.size())
+        {
+            minSecondsPerBenchmark = jmax(0.0, args[++i].getDoubleValue());
+        }
+        else
+        {
+            std::cerr << "Usage: GriddleBenchmarks [--output <file>] [--min-time <seconds>]" << std::endl;
+            return 1;
+        }
+    }
+
+    GriddleBenchmarkRunner runner(minSecondsPerBenchmark);
+
+    benchmarkSourceBufferUpdate(runner);
+    benchmarkTickDispatch(runner);
+    benchmarkPolymetricDispatch(runner);
+    benchmarkTrigDispatch(runner);
+    benchmarkChordDispatch(runner);
+    benchmarkProjectFiles(runner);
+    benchmarkLargeProjectFiles(runner);
+    auto passed = benchmarkRepeatedSaves(runner);
+    benchmarkProjectHistory(runner);
+    benchmarkPainting(runner);
+
+    MemoryOutputStream results;
+    runner.writeResults(results);
+
+    if (outputFile == File())
+    {
+        std::cout << results.toString();
+    }
+    else if (! outputFile.replaceWithData(results.getData(), results.getDataSize()))
+    {
+        std::cerr << "Couldn't write the results to " << outputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleLoopbackPort.cpp
+    Created: 19 Oct 2026 9:14:06pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "GriddleLoopbackPort.h"
+
+//==============================================================================
+GriddleLoopbackPort::GriddleLoopbackPort(const int maxNumEvents)
+    : maxNumEvents_(maxNumEvents)
+    , numDroppedEvents_(0)
+{
+    receivedEvents_.reserve(static_cast<size_t>(maxNumEvents_));
+}
+
+GriddleLoopbackPort::~GriddleLoopbackPort()
+{
+}
+
+//==============================================================================
+void GriddleLoopbackPort::sendMessage(const MidiMessage& message, const double timestamp)
+{
+    // Take the receive time first, so recording the event doesn't count towards its lateness
+    auto receivedTime = Time::getMillisecondCounterHiRes() * 0.001;
+
+    if (static_cast<int>(receivedEvents_.size()) >= maxNumEvents_)
+    {
+        ++numDroppedEvents_;
+        return;
+    }
+
+    receivedEvents_.push_back({ message, timestamp, receivedTime });
+}
+
+void GriddleLoopbackPort::clear()
+{
+    receivedEvents_.clear();
+    numDroppedEvents_ = 0;
+}
@@ -0,0 +1,104 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleLoopbackPort.h
+    Created: 19 Oct 2026 9:14:06pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "../Source/GriddleOutputPort.h"
+
+//==============================================================================
+/*
+    This class is a GriddleOutputPort that loops messages back into memory instead of
+    sending them to a device, recording the time each one was received along with the
+    time it was scheduled for.
+
+    Events are recorded into space reserved up front, so recording never allocates on
+    the playback thread. Once the space is used up, further events are counted but not
+    recorded. The recorded events should only be read once playback has stopped.
+*/
+class GriddleLoopbackPort : public GriddleOutputPort
+{
+public:
+    //==============================================================================
+    explicit GriddleLoopbackPort(const int maxNumEvents);
+    ~GriddleLoopbackPort();
+
+    //==============================================================================
+    /** A message received by the port */
+    struct ReceivedEvent
+    {
+        MidiMessage message;
+        double scheduledTime;
+        double receivedTime;
+    };
+
+    /** Records the message along with the time it was received
+        This is an override of the GriddleOutputPort method.
+    */
+    void sendMessage(const MidiMessage& message, const double timestamp) override;
+
+    /** Clears the recorded events */
+    void clear();
+
+    /** Gets the events recorded so far, in the order they were received
+        @returns    The recorded events
+    */
+    const std::vector<ReceivedEvent>& getReceivedEvents() const;
+
+    /** Gets the number of events that were received after the reserved space was used up
+        @returns    The number of events that weren't recorded
+    */
+    int getNumDroppedEvents() const;
+
+private:
+    //==============================================================================
+    const int maxNumEvents_;
+    std::vector<ReceivedEvent> receivedEvents_;
+    int numDroppedEvents_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleLoopbackPort)
+};
+
+//==============================================================================
+// Inline Getter Definitions
+
+inline const std::vector<GriddleLoopbackPort::ReceivedEvent>& GriddleLoopbackPort::getReceivedEvents() const
+{
+    return receivedEvents_;
+}
+
+inline int GriddleLoopbackPort::getNumDroppedEvents() const
+{
+    return numDroppedEvents_;
+}
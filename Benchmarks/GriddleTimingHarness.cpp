@@ -0,0 +1,1314 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleTimingHarness.cpp
+    Created: 19 Oct 2026 9:15:32pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+/*
+    This is the entry point of the GriddleTimingHarness command-line tool, which plays a
+    sequence through the scheduler and output encoder into a loopback port, then checks
+    what arrived. The mode chooses what is played and checked:
+
+    - timing (the default) plays in real time and measures how accurately the events arrived:
+      - lateness: how long after its scheduled time each event was received (p50, p99 and max)
+      - inter-onset jitter: how far the time between consecutive notes of the first track
+        strayed from the step length (p99 and max)
+      - drift: how far the notes of the first track moved against the tempo grid between
+        the first and last measures of the run
+    - dense-chords plays a chord ratcheted as far as it goes on every step, with bandwidth-aware
+      scheduling over a DIN MIDI wire, on a simulated clock, and checks that no notes are left
+      sounding once the sequence has played out
+    - random-edits plays in real time while the project is edited at random and recompiled
+      every few tens of milliseconds (notes, chords, ratchets, channels, lengths, clock rates,
+      swing and tempo), and checks that no notes are left sounding once the sequence has
+      played out
+    - pattern-switch plays in real time and switches to another pattern at a faster tempo half
+      way through the run, the way selecting a pattern does, then checks that the switch (tempo
+      included) happened at a measure boundary without any event around it being late, dropped
+      or doubled
+    - long-run plays polymetric tracks with swing, a groove template and tempo automation for
+      many measures on a simulated clock, and checks the time of every note against its time
+      worked out from scratch, so any error that builds up from measure to measure fails it
+
+    Usage: GriddleTimingHarness [--mode <timing|dense-chords|random-edits|pattern-switch|long-run>] [--seconds <s>]
+                                [--measures <n>] [--tempo <bpm>] [--tracks <1-4>] [--load-threads <n>] [--seed <n>]
+                                [--max-p99-ms <ms>] [--max-lateness-ms <ms>] [--max-jitter-ms <ms>] [--max-drift-ms <ms>]
+                                [--max-error-ms <ms>] [--output <file>]
+
+    The results are written as JSON to the output file, or to stdout if no file is given. The exit
+    code is 1 if any of the checks fails, so the harness can fail a CI job.
+*/
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "GriddleLoopbackPort.h"
+#include "../Source/GriddleMeasureCompiler.h"
+#include "../Source/GriddleOutputEncoder.h"
+#include "../Source/GriddleGroove.h"
+#include "../Source/GriddleProjectData.h"
+#include "../Source/GriddleScheduler.h"
+#include "../Source/GriddleTempoMap.h"
+#include "../Source/GriddleTimeline.h"
+
+namespace
+{
+    //==============================================================================
+    /** The sample rate the sequence is compiled at, which matches MainComponent */
+    constexpr double SAMPLE_RATE = 44100.0;
+
+    /** The interval in milliseconds of the high resolution timer that drives playback, which matches MainComponent */
+    constexpr int TIMER_INTERVAL_MS = 1;
+
+    /** The wire rate of a DIN MIDI port in bytes per second (31250 baud at 10 bits per byte) */
+    constexpr double DIN_WIRE_RATE = 3125.0;
+
+    /** The shortest time in milliseconds between the edits of a random-edits run, which is up to twice as long */
+    constexpr int EDIT_INTERVAL_MS = 20;
+
+    /** The most ratchets the random edits give a step, which keeps the number of events the run records down */
+    constexpr int MAX_EDITED_RATCHETS = 4;
+
+    /** The range of tempos the random edits set */
+    constexpr int MIN_EDITED_TEMPO = 60;
+    constexpr int MAX_EDITED_TEMPO = 180;
+
+    /** How far the notes of the pattern a pattern-switch run switches to are from those of the first pattern */
+    constexpr int SWITCHED_PATTERN_TRANSPOSE = 24;
+
+    /** How much faster the pattern a pattern-switch run switches to is than the first pattern */
+    constexpr double SWITCHED_PATTERN_TEMPO_SCALE = 1.5;
+
+    /** The tracks of a long run, which all have different lengths or clock rates so they only line up again after
+        many measures, and are moved by different amounts of swing and groove */
+    struct LongRunTrack
+    {
+        int numSteps;
+        GriddleTimeline::ClockRate clockRate;
+        bool isBurnt;
+        int swingPercent;
+        int grooveIndex;
+    };
+
+    constexpr LongRunTrack LONG_RUN_TRACKS[GriddleProjectData::NUM_TRACKS] = { { 16, { 0, 1 }, false, 60, -1 },
+                                                                               { 7, { 0, 1 }, false, 50, 0 },
+                                                                               { 5, { 3, 2 }, false, 58, 0 },
+                                                                               { 13, { 3, 8 }, true, 50, -1 } };
+
+    //==============================================================================
+    /** The settings of a timing run, along with the thresholds that fail it */
+    struct TimingSettings
+    {
+        String mode = "timing";
+        double seconds = 30.0;
+        int numMeasures = 10000;
+        double tempo = 120.0;
+        int numTracks = GriddleProjectData::NUM_TRACKS;
+        int numLoadThreads = 0;
+        int seed = 1;
+
+        double maxP99LatenessMs = 2.0;
+        double maxLatenessMs = 10.0;
+        double maxJitterMs = 5.0;
+        double maxDriftMs = 1.0;
+        double maxErrorMs = 0.001;
+
+        File outputFile;
+    };
+
+    //==============================================================================
+    /* Drives the scheduler from a high resolution timer, the same way MainComponent does during playback */
+    class PlaybackTimer : public HighResolutionTimer
+    {
+    public:
+        explicit PlaybackTimer(GriddleScheduler& scheduler)
+            : scheduler_(scheduler)
+        {
+        }
+
+        void hiResTimerCallback() override
+        {
+            scheduler_.process(Time::getMillisecondCounterHiRes() * 0.001);
+        }
+
+        /** Waits while the timer plays the sequence until a condition is met
+            @param isDone    Returns true once playing can stop
+        */
+        template <typename Condition>
+        void playUntil(Condition isDone)
+        {
+            while (! isDone())
+                Thread::sleep(TIMER_INTERVAL_MS);
+        }
+
+    private:
+        GriddleScheduler& scheduler_;
+    };
+
+    /* Drives the scheduler from a simulated clock that moves on by the timer interval at each call to process(),
+       so a run always plays the same way and takes a fraction of its playing time */
+    class SimulatedClock
+    {
+    public:
+        explicit SimulatedClock(GriddleScheduler& scheduler)
+            : scheduler_(scheduler)
+            , time_(0.0)
+        {
+        }
+
+        /** Starts the scheduler playing from the current time */
+        void start()
+        {
+            time_ = Time::getMillisecondCounterHiRes() * 0.001;
+            scheduler_.start(time_);
+        }
+
+        /** Plays the sequence until a condition is met
+            @param isDone    Returns true once playing can stop
+        */
+        template <typename Condition>
+        void playUntil(Condition isDone)
+        {
+            while (! isDone())
+            {
+                time_ += TIMER_INTERVAL_MS * 0.001;
+                scheduler_.process(time_);
+            }
+        }
+
+        /** Gets the current time of the simulated clock
+            @returns    The time in seconds on the Time::getMillisecondCounterHiRes() clock
+        */
+        double getTime() const
+        {
+            return time_;
+        }
+
+        /** Plays the sequence for a length of time
+            @param seconds    How long to play for
+        */
+        void playFor(const double seconds)
+        {
+            auto endTime = time_ + seconds;
+            playUntil([this, endTime]() { return (time_ >= endTime); });
+        }
+
+    private:
+        GriddleScheduler& scheduler_;
+        double time_;
+    };
+
+    /* A GriddleOutputPort that checks the timestamp of each NOTE ON against the time its note should play, worked out
+       from scratch from the note's position on the timeline: the number of notes the track has played before it,
+       moved by the track's swing and groove, converted to a time with the tempo map from the start of the first measure.
+       Nothing is recorded, so a run can be as long as it likes. Each track must play on its own channel (its index + 1). */
+    class OnsetCheckPort : public GriddleOutputPort
+    {
+    public:
+        explicit OnsetCheckPort(const GriddleProjectData& projectData)
+            : tempoMap_(projectData.tempo, projectData.tempoAutomation)
+            , groove_(projectData)
+            , startTime_(0.0)
+            , maxErrorSeconds_(0.0)
+            , numUnexpectedOnsets_(0)
+        {
+            for (auto trackIndex = 0; trackIndex < GriddleProjectData::NUM_TRACKS; ++trackIndex)
+            {
+                // The notes' indexes count through the track's cycle the same way the measure compiler counts them
+                const auto& track = projectData.tracks[trackIndex];
+                auto noteTicks = GriddleTimeline::getNoteTicks(track);
+                auto patternTicks = noteTicks * track.numSteps;
+                auto cycleTicks = ((GriddleTimeline::TICKS_PER_MEASURE % patternTicks) == 0)
+                                ? GriddleTimeline::TICKS_PER_MEASURE
+                                : patternTicks * (((track.numSteps % 2) == 1) ? 2 : 1);
+
+                noteTicks_[trackIndex] = noteTicks;
+                notesPerCycle_[trackIndex] = cycleTicks / noteTicks;
+            }
+
+            numOnsets_.fill(0);
+        }
+
+        /** Sets the time that the first measure starts at
+            @param startTime    The time in seconds on the Time::getMillisecondCounterHiRes() clock
+        */
+        void setStartTime(const double startTime)
+        {
+            startTime_ = startTime;
+        }
+
+        /** Checks the timestamp of a NOTE ON against the time of the next note of its track
+            This is an override of the GriddleOutputPort method.
+        */
+        void sendMessage(const MidiMessage& message, const double timestamp) override
+        {
+            if (! message.isNoteOn())
+                return;
+
+            auto trackIndex = message.getChannel() - 1;
+
+            if (trackIndex >= GriddleProjectData::NUM_TRACKS)
+            {
+                ++numUnexpectedOnsets_;
+                return;
+            }
+
+            auto noteIndex = numOnsets_[trackIndex]++;
+            auto noteTicks = noteTicks_[trackIndex];
+            auto tick = (noteIndex * noteTicks) + groove_.getNoteShiftTicks(trackIndex, static_cast<int>(noteIndex % notesPerCycle_[trackIndex]), noteTicks);
+
+            auto expectedTime = startTime_ + tempoMap_.getSecondsAtBeat(GriddleTimeline::ticksToBeats(tick));
+            maxErrorSeconds_ = jmax(maxErrorSeconds_, std::abs(timestamp - expectedTime));
+        }
+
+        /** Gets the number of notes a track has played
+            @param trackIndex    The index of the track
+            @returns             The number of NOTE ONs received on the track's channel
+        */
+        int64 getNumOnsets(const int trackIndex) const
+        {
+            return numOnsets_[trackIndex];
+        }
+
+        /** Gets the largest difference between the timestamp of a NOTE ON and the time its note should play
+            @returns    The largest error in seconds
+        */
+        double getMaxErrorSeconds() const
+        {
+            return maxErrorSeconds_;
+        }
+
+        /** Gets the number of NOTE ONs received on channels that no track plays on
+            @returns    The number of unexpected NOTE ONs
+        */
+        int getNumUnexpectedOnsets() const
+        {
+            return numUnexpectedOnsets_;
+        }
+
+    private:
+        const GriddleTempoMap tempoMap_;
+        const GriddleGroove groove_;
+        double startTime_;
+        std::array<int64, GriddleProjectData::NUM_TRACKS> noteTicks_;
+        std::array<int64, GriddleProjectData::NUM_TRACKS> notesPerCycle_;
+        std::array<int64, GriddleProjectData::NUM_TRACKS> numOnsets_;
+        double maxErrorSeconds_;
+        int numUnexpectedOnsets_;
+    };
+
+    /* Keeps a CPU core busy, to measure timing while the system is under load */
+    class LoadThread : public Thread
+    {
+    public:
+        LoadThread()
+            : Thread("Griddle Timing Load")
+            , result_(0.0)
+        {
+        }
+
+        void run() override
+        {
+            auto value = 1.0;
+
+            while (! threadShouldExit())
+            {
+                for (auto i = 0; i < 10000; ++i)
+                    value = std::sqrt(value + i);
+            }
+
+            result_ = value;
+        }
+
+    private:
+        volatile double result_;
+    };
+
+    //==============================================================================
+    /** Gets a percentile of a set of values
+        @param values        The values, which get sorted
+        @param percentile    The percentile to get (0 to 100)
+        @returns             The value at the percentile (nearest rank), or 0 if there are no values
+    */
+    double getPercentile(std::vector<double>& values, const double percentile)
+    {
+        if (values.empty())
+            return 0.0;
+
+        std::sort(values.begin(), values.end());
+
+        auto rank = static_cast<size_t>(std::ceil(percentile * 0.01 * values.size()));
+        return values[jlimit<size_t>(1, values.size(), rank) - 1];
+    }
+
+    /** Creates a project with a note on every step of the first tracks
+        @param settings    The settings of the run
+        @returns           The project
+    */
+    GriddleProjectData createProject(const TimingSettings& settings)
+    {
+        GriddleProjectData projectData;
+        projectData.tempo = settings.tempo;
+
+        for (auto trackIndex = 0; trackIndex < GriddleProjectData::NUM_TRACKS; ++trackIndex)
+        {
+            auto& track = projectData.tracks[trackIndex];
+            track.isActive = (trackIndex < settings.numTracks);
+            track.midiChannel = trackIndex + 1;
+
+            for (auto stepIndex = 0; stepIndex < GriddleTrackData::NUM_STEPS; ++stepIndex)
+            {
+                track.steps[stepIndex].noteNumber = 48 + (trackIndex * 12) + stepIndex;
+                track.steps[stepIndex].gatePercent = 50;
+            }
+        }
+
+        return projectData;
+    }
+
+    /** Makes a random edit to a project, of the kind that can be made from the GUI during playback
+        @param projectData    The project to edit
+        @param random         The random numbers to edit with
+    */
+    void makeRandomEdit(GriddleProjectData& projectData, Random& random)
+    {
+        auto& track = projectData.tracks[random.nextInt(GriddleProjectData::NUM_TRACKS)];
+        auto& step = track.steps[random.nextInt(GriddleTrackData::NUM_STEPS)];
+
+        switch (random.nextInt(10))
+        {
+            case 0:
+                step.noteNumber = random.nextBool() ? -1 : (36 + random.nextInt(48));
+                break;
+
+            case 1:
+                step.numChordNotes = random.nextInt(GriddleStepData::MAX_CHORD_NOTES);
+
+                for (auto chordNoteIndex = 0; chordNoteIndex < step.numChordNotes; ++chordNoteIndex)
+                    step.chordNotes[chordNoteIndex] = { 36 + random.nextInt(48), 1 + random.nextInt(127) };
+                break;
+
+            case 2:
+                step.ratchets = 1 + random.nextInt(MAX_EDITED_RATCHETS);
+                break;
+
+            case 3:
+                step.gatePercent = 1 + random.nextInt(100);
+                break;
+
+            case 4:
+                // Share a few channels between the tracks, so their notes overlap on the same channel
+                track.midiChannel = 1 + random.nextInt(2);
+                break;
+
+            case 5:
+                track.numSteps = 1 + random.nextInt(GriddleTrackData::NUM_STEPS);
+                break;
+
+            case 6:
+                track.isActive = ! track.isActive;
+                break;
+
+            case 7:
+            {
+                // One more than the number of clock rates, for fitting the steps into one measure
+                auto clockRateIndex = random.nextInt(GriddleTimeline::NUM_CLOCK_RATES + 1);
+
+                if (clockRateIndex == GriddleTimeline::NUM_CLOCK_RATES)
+                {
+                    track.clockRateNumerator = 0;
+                    track.clockRateDenominator = 1;
+                }
+                else
+                {
+                    track.clockRateNumerator = GriddleTimeline::getClockRate(clockRateIndex).numerator;
+                    track.clockRateDenominator = GriddleTimeline::getClockRate(clockRateIndex).denominator;
+                }
+                break;
+            }
+
+            case 8:
+                track.swingPercent = GriddleTrackData::MIN_SWING_PERCENT
+                    + random.nextInt(GriddleTrackData::MAX_SWING_PERCENT - GriddleTrackData::MIN_SWING_PERCENT + 1);
+                break;
+
+            default:
+                projectData.tempo = MIN_EDITED_TEMPO + random.nextInt(MAX_EDITED_TEMPO - MIN_EDITED_TEMPO + 1);
+                break;
+        }
+    }
+
+    /** Parses the command line into the settings
+        @param args        The command line arguments (without the program name)
+        @param settings    The settings to fill in
+        @returns           true if the arguments were valid, otherwise false
+    */
+    bool parseArguments(const StringArray& args, TimingSettings& settings)
+    {
+        for (auto i = 0; i < args.size(); ++i)
+        {
+            if (i + 1 >= args.size())
+                return false;
+
+            auto& option = args[i];
+            auto value = args[++i];
+
+            if (option == "--mode")
+                settings.mode = value;
+            else if (option == "--seconds")
+                settings.seconds = value.getDoubleValue();
+            else if (option == "--measures")
+                settings.numMeasures = value.getIntValue();
+            else if (option == "--tempo")
+                settings.tempo = value.getDoubleValue();
+            else if (option == "--tracks")
+                settings.numTracks = value.getIntValue();
+            else if (option == "--load-threads")
+                settings.numLoadThreads = value.getIntValue();
+            else if (option == "--seed")
+                settings.seed = value.getIntValue();
+            else if (option == "--max-p99-ms")
+                settings.maxP99LatenessMs = value.getDoubleValue();
+            else if (option == "--max-lateness-ms")
+                settings.maxLatenessMs = value.getDoubleValue();
+            else if (option == "--max-jitter-ms")
+                settings.maxJitterMs = value.getDoubleValue();
+            else if (option == "--max-drift-ms")
+                settings.maxDriftMs = value.getDoubleValue();
+            else if (option == "--max-error-ms")
+                settings.maxErrorMs = value.getDoubleValue();
+            else if (option == "--output")
+                settings.outputFile = File::getCurrentWorkingDirectory().getChildFile(value);
+            else
+                return false;
+        }
+
+        auto isValidMode = (settings.mode == "timing") || (settings.mode == "dense-chords") || (settings.mode == "random-edits")
+                        || (settings.mode == "pattern-switch") || (settings.mode == "long-run");
+
+        return isValidMode && (settings.seconds > 0.0) && (settings.numMeasures >= 1) && (settings.tempo > 0.0) && (settings.numTracks >= 1)
+            && (settings.numTracks <= GriddleProjectData::NUM_TRACKS) && (settings.numLoadThreads >= 0);
+    }
+
+    /** Checks a measurement against its threshold, adding it to the results
+        @param checks       The object to add the check to
+        @param name         The name of the measurement
+        @param value        The measured value
+        @param threshold    The largest value that passes
+        @returns            true if the value passed, otherwise false
+    */
+    bool checkThreshold(DynamicObject& checks, const String& name, const double value, const double threshold)
+    {
+        auto passed = (value <= threshold);
+
+        DynamicObject::Ptr check = new DynamicObject();
+        check->setProperty("value", value);
+        check->setProperty("threshold", threshold);
+        check->setProperty("passed", passed);
+        checks.setProperty(name, var(check.get()));
+
+        if (! passed)
+            std::cerr << "FAILED - " << name << " " << value << " ms is over the threshold of " << threshold << " ms" << std::endl;
+
+        return passed;
+    }
+
+    /** Checks that a count of problems is zero, adding it to the results
+        @param checks         The object to add the check to
+        @param description    What was counted
+        @param count          The count
+        @returns              true if the count was zero, otherwise false
+    */
+    bool checkNone(DynamicObject& checks, const String& description, const int count)
+    {
+        auto passed = (count == 0);
+
+        DynamicObject::Ptr check = new DynamicObject();
+        check->setProperty("value", count);
+        check->setProperty("threshold", 0);
+        check->setProperty("passed", passed);
+        checks.setProperty(description, var(check.get()));
+
+        if (! passed)
+            std::cerr << "FAILED - " << count << " " << description << std::endl;
+
+        return passed;
+    }
+
+    //==============================================================================
+    /** Counts the notes left sounding at the end of a stream of events, by replaying its NOTE ONs and NOTE OFFs
+        @param events    The events, in the order they were received
+        @returns         The number of notes that were turned on and never turned off
+    */
+    int countSoundingNotes(const std::vector<GriddleLoopbackPort::ReceivedEvent>& events)
+    {
+        std::array<std::array<bool, 128>, 16> isSounding {};
+
+        for (auto& event : events)
+        {
+            // isNoteOff() is also true for the zero-velocity NOTE ONs that the output encoder sends
+            if (event.message.isNoteOn())
+                isSounding[event.message.getChannel() - 1][event.message.getNoteNumber()] = true;
+            else if (event.message.isNoteOff())
+                isSounding[event.message.getChannel() - 1][event.message.getNoteNumber()] = false;
+        }
+
+        auto numSoundingNotes = 0;
+
+        for (auto& channelNotes : isSounding)
+            numSoundingNotes += static_cast<int>(std::count(channelNotes.begin(), channelNotes.end(), true));
+
+        return numSoundingNotes;
+    }
+
+    /** Lets every note that has been sent finish, by swapping in a source measure with no active tracks and
+        playing on until it has played for two measures (longer than any note can last)
+        @param scheduler      The scheduler that is playing
+        @param projectData    The project being played
+        @param wireRate       The wire rate the project was compiled for
+        @param playback       The timer or simulated clock that is playing the sequence
+    */
+    template <typename Playback>
+    void drainNotes(GriddleScheduler& scheduler, const GriddleProjectData& projectData, const double wireRate, Playback& playback)
+    {
+        auto silentProjectData = projectData;
+
+        for (auto& track : silentProjectData.tracks)
+            track.isActive = false;
+
+        GriddleMeasureCompiler measureCompiler;
+        GriddleCompiledMeasure silentMeasure;
+        measureCompiler.compile(silentProjectData, SAMPLE_RATE, wireRate, silentMeasure);
+
+        auto generation = scheduler.swapSourceMeasure(silentMeasure);
+        playback.playUntil([&scheduler, generation]() { return (scheduler.getMeasureSourceGeneration() >= generation); });
+
+        auto lastMeasureIndex = scheduler.getCurrentMeasureIndex() + 2;
+        playback.playUntil([&scheduler, lastMeasureIndex]() { return (scheduler.getCurrentMeasureIndex() >= lastMeasureIndex); });
+    }
+
+    /** Checks that no notes were left sounding once the sequence was drained (see drainNotes()), then stops playback
+        and checks that nothing is sounding after the stop either. Playback must not be running on another thread.
+        @param checks           The object to add the checks to
+        @param scheduler        The scheduler that was playing
+        @param outputEncoder    The output encoder the scheduler sends to
+        @param loopback         The loopback port the output encoder sends to
+        @returns                true if no notes were left sounding, otherwise false
+    */
+    bool checkNoStuckNotes(DynamicObject& checks, GriddleScheduler& scheduler, GriddleOutputEncoder& outputEncoder, GriddleLoopbackPort& loopback)
+    {
+        auto passed = true;
+
+        passed = checkNone(checks, "notes sounding before stopping", outputEncoder.getNumSoundingNotes()) && passed;
+        passed = checkNone(checks, "notes left on at the port before stopping", countSoundingNotes(loopback.getReceivedEvents())) && passed;
+
+        scheduler.stop();
+
+        passed = checkNone(checks, "notes sounding after stopping", outputEncoder.getNumSoundingNotes()) && passed;
+        passed = checkNone(checks, "notes left on at the port after stopping", countSoundingNotes(loopback.getReceivedEvents())) && passed;
+
+        return passed;
+    }
+
+    //==============================================================================
+    /** Plays the sequence in real time and measures the lateness, jitter and drift of the events
+        @param settings    The settings of the run
+        @param results     The object to add the results to
+        @param checks      The object to add the checks to
+        @returns           true if every measurement passed its threshold, otherwise false
+    */
+    bool runTiming(const TimingSettings& settings, DynamicObject& results, DynamicObject& checks)
+    {
+        auto projectData = createProject(settings);
+
+        auto measureSeconds = GriddleTimeline::getMeasureLengthSeconds(settings.tempo);
+        auto stepSeconds = measureSeconds / GriddleTrackData::NUM_STEPS;
+
+        // Reserve room for every NOTE ON and NOTE OFF of the run, with a measure to spare
+        auto eventsPerMeasure = settings.numTracks * GriddleTrackData::NUM_STEPS * 2;
+        auto maxNumEvents = static_cast<int>(std::ceil(settings.seconds / measureSeconds) + 2.0) * eventsPerMeasure;
+
+        auto loopbackPort = std::make_unique<GriddleLoopbackPort>(maxNumEvents);
+        auto& loopback = *loopbackPort;
+
+        GriddleOutputEncoder outputEncoder;
+        outputEncoder.setOutputPort(std::move(loopbackPort));
+        outputEncoder.setWireRate(0.0);
+
+        GriddleScheduler scheduler(outputEncoder);
+        GriddleMeasureCompiler measureCompiler;
+        GriddleCompiledMeasure sourceMeasure;
+
+        measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+        scheduler.swapSourceMeasure(sourceMeasure);
+        scheduler.setTempoMap(GriddleTempoMap(projectData.tempo, projectData.tempoAutomation));
+
+        // Start the background load, then play the sequence for the length of the run
+        OwnedArray<LoadThread> loadThreads;
+
+        for (auto i = 0; i < settings.numLoadThreads; ++i)
+            loadThreads.add(new LoadThread())->startThread();
+
+        PlaybackTimer playbackTimer(scheduler);
+
+        scheduler.start(Time::getMillisecondCounterHiRes() * 0.001);
+        playbackTimer.startTimer(TIMER_INTERVAL_MS);
+
+        Thread::sleep(roundToInt(settings.seconds * 1000.0));
+
+        playbackTimer.stopTimer();
+
+        for (auto* loadThread : loadThreads)
+            loadThread->stopThread(1000);
+
+        // Only the events received during playback are measured, not the NOTE OFFs sent when it stops
+        auto receivedEvents = loopback.getReceivedEvents();
+        auto numDroppedEvents = loopback.getNumDroppedEvents();
+        scheduler.stop();
+
+        // Lateness of every event
+        std::vector<double> latenessMs;
+        latenessMs.reserve(receivedEvents.size());
+
+        for (auto& event : receivedEvents)
+            latenessMs.push_back((event.receivedTime - event.scheduledTime) * 1000.0);
+
+        // Inter-onset intervals of the first track's notes, compared to the step length, and their
+        // offsets from the tempo grid that starts at the first note
+        std::vector<double> onsetTimes;
+
+        for (auto& event : receivedEvents)
+        {
+            if (event.message.isNoteOn() && (event.message.getChannel() == 1))
+                onsetTimes.push_back(event.receivedTime);
+        }
+
+        std::vector<double> jitterMs;
+        std::vector<double> gridOffsetsMs;
+
+        for (size_t i = 0; i < onsetTimes.size(); ++i)
+        {
+            gridOffsetsMs.push_back((onsetTimes[i] - (onsetTimes.front() + (i * stepSeconds))) * 1000.0);
+
+            if (i > 0)
+                jitterMs.push_back(std::abs((onsetTimes[i] - onsetTimes[i - 1]) - stepSeconds) * 1000.0);
+        }
+
+        // Drift is the change in the average grid offset between the first and last measures played
+        auto driftMs = 0.0;
+        auto numMeasureOnsets = static_cast<size_t>(GriddleTrackData::NUM_STEPS);
+
+        if (gridOffsetsMs.size() >= (numMeasureOnsets * 2))
+        {
+            auto firstMeasureOffset = 0.0;
+            auto lastMeasureOffset = 0.0;
+
+            for (size_t i = 0; i < numMeasureOnsets; ++i)
+            {
+                firstMeasureOffset += gridOffsetsMs[i];
+                lastMeasureOffset += gridOffsetsMs[gridOffsetsMs.size() - numMeasureOnsets + i];
+            }
+
+            driftMs = std::abs(lastMeasureOffset - firstMeasureOffset) / numMeasureOnsets;
+        }
+
+        auto maxLatenessMs = latenessMs.empty() ? 0.0 : *std::max_element(latenessMs.begin(), latenessMs.end());
+        auto maxJitterMs = jitterMs.empty() ? 0.0 : *std::max_element(jitterMs.begin(), jitterMs.end());
+
+        // Gather the results and check them against the thresholds
+        DynamicObject::Ptr latenessObject = new DynamicObject();
+        latenessObject->setProperty("p50Ms", getPercentile(latenessMs, 50.0));
+        latenessObject->setProperty("p99Ms", getPercentile(latenessMs, 99.0));
+        latenessObject->setProperty("maxMs", maxLatenessMs);
+
+        DynamicObject::Ptr jitterObject = new DynamicObject();
+        jitterObject->setProperty("p50Ms", getPercentile(jitterMs, 50.0));
+        jitterObject->setProperty("p99Ms", getPercentile(jitterMs, 99.0));
+        jitterObject->setProperty("maxMs", maxJitterMs);
+
+        auto passed = true;
+
+        passed = checkThreshold(checks, "p99 lateness", getPercentile(latenessMs, 99.0), settings.maxP99LatenessMs) && passed;
+        passed = checkThreshold(checks, "max lateness", maxLatenessMs, settings.maxLatenessMs) && passed;
+        passed = checkThreshold(checks, "max inter-onset jitter", maxJitterMs, settings.maxJitterMs) && passed;
+        passed = checkThreshold(checks, "drift", driftMs, settings.maxDriftMs) && passed;
+
+        if (onsetTimes.size() < (numMeasureOnsets * 2))
+        {
+            std::cerr << "FAILED - only " << onsetTimes.size() << " notes of the first track were received" << std::endl;
+            passed = false;
+        }
+
+        if (numDroppedEvents > 0)
+        {
+            std::cerr << "FAILED - " << numDroppedEvents << " events were received past the recording space" << std::endl;
+            passed = false;
+        }
+
+        results.setProperty("events", static_cast<int>(receivedEvents.size()));
+        results.setProperty("onsets", static_cast<int>(onsetTimes.size()));
+        results.setProperty("lateness", var(latenessObject.get()));
+        results.setProperty("interOnsetJitter", var(jitterObject.get()));
+        results.setProperty("driftMs", driftMs);
+
+        return passed;
+    }
+
+    /** Plays a chord ratcheted as far as it goes on every step with the shortest gate, with bandwidth-aware scheduling
+        over a DIN MIDI wire, so each step's burst of events takes longer to send than its notes last. The run is played
+        on a simulated clock, then drained, and fails if any note is left sounding.
+        @param settings    The settings of the run
+        @param results     The object to add the results to
+        @param checks      The object to add the checks to
+        @returns           true if every note that was played was released, otherwise false
+    */
+    bool runDenseChords(const TimingSettings& settings, DynamicObject& results, DynamicObject& checks)
+    {
+        auto projectData = createProject(settings);
+        projectData.midiWireRate = DIN_WIRE_RATE;
+        projectData.bandwidthAwareScheduling = true;
+
+        for (auto& track : projectData.tracks)
+        {
+            for (auto stepIndex = 0; stepIndex < GriddleTrackData::NUM_STEPS; ++stepIndex)
+            {
+                // Keep the chords within each track's octave, so that only the notes of the same track overlap
+                auto& step = track.steps[stepIndex];
+                step.noteNumber = 36 + ((track.midiChannel - 1) * 12) + (stepIndex % 4);
+                step.gatePercent = 1;
+                step.ratchets = GriddleStepData::MAX_RATCHETS;
+                step.numChordNotes = GriddleStepData::MAX_CHORD_NOTES - 1;
+
+                for (auto chordNoteIndex = 0; chordNoteIndex < step.numChordNotes; ++chordNoteIndex)
+                    step.chordNotes[chordNoteIndex] = { step.noteNumber + 3 + (chordNoteIndex * 2), 100 };
+            }
+        }
+
+        // Reserve room for every NOTE ON and NOTE OFF of the run and the drain, with measures to spare
+        auto measureSeconds = GriddleTimeline::getMeasureLengthSeconds(settings.tempo);
+        auto eventsPerMeasure = settings.numTracks * GriddleTrackData::NUM_STEPS * GriddleStepData::MAX_RATCHETS * GriddleStepData::MAX_CHORD_NOTES * 2;
+        auto maxNumEvents = static_cast<int>(std::ceil(settings.seconds / measureSeconds) + 5.0) * eventsPerMeasure;
+
+        auto loopbackPort = std::make_unique<GriddleLoopbackPort>(maxNumEvents);
+        auto& loopback = *loopbackPort;
+
+        GriddleOutputEncoder outputEncoder;
+        outputEncoder.setOutputPort(std::move(loopbackPort));
+        outputEncoder.setWireRate(projectData.midiWireRate);
+
+        GriddleScheduler scheduler(outputEncoder);
+        GriddleMeasureCompiler measureCompiler;
+        GriddleCompiledMeasure sourceMeasure;
+
+        measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+        scheduler.swapSourceMeasure(sourceMeasure);
+        scheduler.setTempoMap(GriddleTempoMap(projectData.tempo, projectData.tempoAutomation));
+        scheduler.setBandwidthAwareScheduling(projectData.bandwidthAwareScheduling);
+
+        SimulatedClock simulatedClock(scheduler);
+        simulatedClock.start();
+        simulatedClock.playFor(settings.seconds);
+
+        drainNotes(scheduler, projectData, outputEncoder.getWireRate(), simulatedClock);
+
+        auto numOnsets = 0;
+
+        for (auto& event : loopback.getReceivedEvents())
+        {
+            if (event.message.isNoteOn())
+                ++numOnsets;
+        }
+
+        auto passed = checkNoStuckNotes(checks, scheduler, outputEncoder, loopback);
+
+        if (loopback.getNumDroppedEvents() > 0)
+        {
+            std::cerr << "FAILED - " << loopback.getNumDroppedEvents() << " events were received past the recording space" << std::endl;
+            passed = false;
+        }
+
+        // How late the events arrived at the end of the wire compared to their nominal times, as the output encoder models it
+        const auto& wireLateness = scheduler.getTelemetry().getWireLateness();
+
+        DynamicObject::Ptr wireLatenessObject = new DynamicObject();
+        wireLatenessObject->setProperty("p50Ms", wireLateness.getPercentileMs(50.0));
+        wireLatenessObject->setProperty("p99Ms", wireLateness.getPercentileMs(99.0));
+        wireLatenessObject->setProperty("maxMs", wireLateness.getMaxMs());
+
+        results.setProperty("events", static_cast<int>(loopback.getReceivedEvents().size()));
+        results.setProperty("onsets", numOnsets);
+        results.setProperty("wireLateness", var(wireLatenessObject.get()));
+
+        return passed;
+    }
+
+    /** Plays the sequence in real time while making random edits to the project from this thread, recompiling it
+        and swapping it in after each edit the way MainComponent does. Once the run is over the sequence is drained,
+        and the run fails if any note is left sounding.
+        @param settings    The settings of the run
+        @param results     The object to add the results to
+        @param checks      The object to add the checks to
+        @returns           true if every note that was played was released, otherwise false
+    */
+    bool runRandomEdits(const TimingSettings& settings, DynamicObject& results, DynamicObject& checks)
+    {
+        auto projectData = createProject(settings);
+        Random random(settings.seed);
+
+        // Reserve room for every NOTE ON and NOTE OFF that the busiest project the edits can make would send during
+        // the run and the drain, at the fastest tempo they can set
+        auto measureSeconds = GriddleTimeline::getMeasureLengthSeconds(jmax(settings.tempo, static_cast<double>(MAX_EDITED_TEMPO)));
+        auto eventsPerMeasure = GriddleProjectData::NUM_TRACKS * GriddleTimeline::MAX_NOTES_PER_MEASURE * MAX_EDITED_RATCHETS
+                              * GriddleStepData::MAX_CHORD_NOTES * 2;
+        auto maxNumEvents = static_cast<int>(std::ceil(settings.seconds / measureSeconds) + 5.0) * eventsPerMeasure;
+
+        auto loopbackPort = std::make_unique<GriddleLoopbackPort>(maxNumEvents);
+        auto& loopback = *loopbackPort;
+
+        GriddleOutputEncoder outputEncoder;
+        outputEncoder.setOutputPort(std::move(loopbackPort));
+        outputEncoder.setWireRate(0.0);
+
+        GriddleScheduler scheduler(outputEncoder);
+        GriddleMeasureCompiler measureCompiler;
+        GriddleCompiledMeasure sourceMeasure;
+
+        measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+        scheduler.swapSourceMeasure(sourceMeasure);
+        scheduler.setTempoMap(GriddleTempoMap(projectData.tempo, projectData.tempoAutomation));
+        scheduler.setGroove(GriddleGroove(projectData));
+
+        OwnedArray<LoadThread> loadThreads;
+
+        for (auto i = 0; i < settings.numLoadThreads; ++i)
+            loadThreads.add(new LoadThread())->startThread();
+
+        PlaybackTimer playbackTimer(scheduler);
+
+        scheduler.start(Time::getMillisecondCounterHiRes() * 0.001);
+        playbackTimer.startTimer(TIMER_INTERVAL_MS);
+
+        auto endTime = Time::getMillisecondCounterHiRes() + (settings.seconds * 1000.0);
+        auto numEdits = 0;
+
+        while (Time::getMillisecondCounterHiRes() < endTime)
+        {
+            Thread::sleep(EDIT_INTERVAL_MS + random.nextInt(EDIT_INTERVAL_MS + 1));
+
+            auto previousTempo = projectData.tempo;
+            makeRandomEdit(projectData, random);
+            ++numEdits;
+
+            measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+            scheduler.swapSourceMeasure(sourceMeasure);
+            scheduler.setGroove(GriddleGroove(projectData));
+
+            if (projectData.tempo != previousTempo)
+                scheduler.setTempoMap(GriddleTempoMap(projectData.tempo, projectData.tempoAutomation));
+        }
+
+        drainNotes(scheduler, projectData, outputEncoder.getWireRate(), playbackTimer);
+
+        playbackTimer.stopTimer();
+
+        for (auto* loadThread : loadThreads)
+            loadThread->stopThread(1000);
+
+        auto numOnsets = 0;
+
+        for (auto& event : loopback.getReceivedEvents())
+        {
+            if (event.message.isNoteOn())
+                ++numOnsets;
+        }
+
+        auto passed = checkNoStuckNotes(checks, scheduler, outputEncoder, loopback);
+
+        if (loopback.getNumDroppedEvents() > 0)
+        {
+            std::cerr << "FAILED - " << loopback.getNumDroppedEvents() << " events were received past the recording space" << std::endl;
+            passed = false;
+        }
+
+        results.setProperty("edits", numEdits);
+        results.setProperty("events", static_cast<int>(loopback.getReceivedEvents().size()));
+        results.setProperty("onsets", numOnsets);
+
+        return passed;
+    }
+
+    /** Plays the sequence in real time and swaps in another pattern half way through the run, from this thread, as
+        MainComponent does when a pattern is selected during playback. The second pattern plays the same steps as
+        the first, transposed, so every note identifies its pattern and step, at a faster tempo that must only take
+        over at the boundary. The run fails if any track doesn't switch at the same measure boundary, in time for
+        the first measure that could be queued after the switch, if any track's notes don't follow its steps in
+        order (a dropped or doubled note), if any event around the boundary is late or the notes there jitter past
+        the thresholds (against the step length of the pattern each note belongs to), or if any note is left sounding.
+        @param settings    The settings of the run
+        @param results     The object to add the results to
+        @param checks      The object to add the checks to
+        @returns           true if all of the checks passed, otherwise false
+    */
+    bool runPatternSwitch(const TimingSettings& settings, DynamicObject& results, DynamicObject& checks)
+    {
+        auto projectData = createProject(settings);
+        auto switchedProjectData = projectData;
+        switchedProjectData.tempo = projectData.tempo * SWITCHED_PATTERN_TEMPO_SCALE;
+
+        for (auto& track : switchedProjectData.tracks)
+        {
+            for (auto& step : track.steps)
+                step.noteNumber += SWITCHED_PATTERN_TRANSPOSE;
+        }
+
+        auto measureSeconds = GriddleTimeline::getMeasureLengthSeconds(settings.tempo);
+        auto stepSeconds = measureSeconds / GriddleTrackData::NUM_STEPS;
+        auto switchedStepSeconds = stepSeconds / SWITCHED_PATTERN_TEMPO_SCALE;
+
+        // Reserve room for every NOTE ON and NOTE OFF of the run and the drain, with measures to spare
+        auto eventsPerMeasure = settings.numTracks * GriddleTrackData::NUM_STEPS * 2;
+        auto maxNumEvents = static_cast<int>(std::ceil(settings.seconds * SWITCHED_PATTERN_TEMPO_SCALE / measureSeconds) + 5.0) * eventsPerMeasure;
+
+        auto loopbackPort = std::make_unique<GriddleLoopbackPort>(maxNumEvents);
+        auto& loopback = *loopbackPort;
+
+        GriddleOutputEncoder outputEncoder;
+        outputEncoder.setOutputPort(std::move(loopbackPort));
+        outputEncoder.setWireRate(0.0);
+
+        GriddleScheduler scheduler(outputEncoder);
+        GriddleMeasureCompiler measureCompiler;
+        GriddleCompiledMeasure sourceMeasure;
+
+        measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+        auto lookAheadSeconds = sourceMeasure.lookAheadSeconds;
+        scheduler.swapSourceMeasure(sourceMeasure);
+        scheduler.setTempoMap(GriddleTempoMap(projectData.tempo, projectData.tempoAutomation));
+
+        OwnedArray<LoadThread> loadThreads;
+
+        for (auto i = 0; i < settings.numLoadThreads; ++i)
+            loadThreads.add(new LoadThread())->startThread();
+
+        PlaybackTimer playbackTimer(scheduler);
+
+        scheduler.start(Time::getMillisecondCounterHiRes() * 0.001);
+        playbackTimer.startTimer(TIMER_INTERVAL_MS);
+
+        Thread::sleep(roundToInt(settings.seconds * 500.0));
+
+        // Compile the pattern before taking the time of the switch, as the pattern library does on its load thread
+        measureCompiler.compile(switchedProjectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+
+        auto switchTime = Time::getMillisecondCounterHiRes() * 0.001;
+        scheduler.swapSourceMeasure(sourceMeasure, GriddleTempoMap(switchedProjectData.tempo, switchedProjectData.tempoAutomation),
+                                    GriddleGroove(switchedProjectData));
+
+        Thread::sleep(roundToInt(settings.seconds * 500.0));
+
+        drainNotes(scheduler, switchedProjectData, outputEncoder.getWireRate(), playbackTimer);
+
+        playbackTimer.stopTimer();
+
+        for (auto* loadThread : loadThreads)
+            loadThread->stopThread(1000);
+
+        // Only the events received during playback are measured, not the NOTE OFFs sent when it stops
+        auto receivedEvents = loopback.getReceivedEvents();
+        auto passed = checkNoStuckNotes(checks, scheduler, outputEncoder, loopback);
+
+        // Find where each track's notes switch to the second pattern, and count the notes that aren't the next step
+        // of the pattern expected at their position
+        auto numStepsOutOfOrder = 0;
+        auto numTracksSwitchedElsewhere = 0;
+        auto switchOnsetIndex = -1;
+        auto boundaryTime = 0.0;
+        std::vector<double> onsetTimes;
+
+        for (auto trackIndex = 0; trackIndex < settings.numTracks; ++trackIndex)
+        {
+            auto& track = projectData.tracks[trackIndex];
+            auto trackSwitchOnsetIndex = -1;
+            auto onsetIndex = 0;
+
+            for (auto& event : receivedEvents)
+            {
+                if ((! event.message.isNoteOn()) || (event.message.getChannel() != track.midiChannel))
+                    continue;
+
+                auto stepIndex = onsetIndex % GriddleTrackData::NUM_STEPS;
+                auto isSwitched = (event.message.getNoteNumber() >= (track.steps[0].noteNumber + SWITCHED_PATTERN_TRANSPOSE));
+
+                if (isSwitched && (trackSwitchOnsetIndex < 0))
+                {
+                    trackSwitchOnsetIndex = onsetIndex;
+
+                    if (trackIndex == 0)
+                        boundaryTime = event.scheduledTime;
+                }
+
+                auto expectedNoteNumber = track.steps[stepIndex].noteNumber + ((trackSwitchOnsetIndex >= 0) ? SWITCHED_PATTERN_TRANSPOSE : 0);
+
+                if (event.message.getNoteNumber() != expectedNoteNumber)
+                    ++numStepsOutOfOrder;
+
+                if (trackIndex == 0)
+                    onsetTimes.push_back(event.receivedTime);
+
+                ++onsetIndex;
+            }
+
+            if (trackIndex == 0)
+                switchOnsetIndex = trackSwitchOnsetIndex;
+            else if (trackSwitchOnsetIndex != switchOnsetIndex)
+                ++numTracksSwitchedElsewhere;
+        }
+
+        passed = checkNone(checks, "notes out of step order (dropped or doubled)", numStepsOutOfOrder) && passed;
+        passed = checkNone(checks, "tracks that switched at a different step from the first track", numTracksSwitchedElsewhere) && passed;
+
+        if ((switchOnsetIndex <= 0) || ((switchOnsetIndex % GriddleTrackData::NUM_STEPS) != 0))
+        {
+            std::cerr << "FAILED - the first track switched patterns at note " << switchOnsetIndex << ", which isn't the start of a measure after the first" << std::endl;
+            passed = false;
+        }
+
+        // The switch must take effect at the first measure that hadn't been queued when it was made, which starts
+        // at most one measure after the look-ahead from the switch
+        auto switchDelayMs = (boundaryTime - switchTime) * 1000.0;
+        auto maxSwitchDelayMs = (lookAheadSeconds + measureSeconds) * 1000.0;
+
+        if (switchOnsetIndex > 0)
+            passed = checkThreshold(checks, "switch delay", switchDelayMs, maxSwitchDelayMs) && passed;
+
+        // Lateness of the events due within a measure either side of the boundary, and the jitter of the first
+        // track's notes there, including across the boundary itself. Each note lasts the step length of its own
+        // pattern, so a tempo change before or after the boundary shows up as jitter.
+        std::vector<double> boundaryLatenessMs;
+
+        for (auto& event : receivedEvents)
+        {
+            if (std::abs(event.scheduledTime - boundaryTime) <= measureSeconds)
+                boundaryLatenessMs.push_back((event.receivedTime - event.scheduledTime) * 1000.0);
+        }
+
+        std::vector<double> boundaryJitterMs;
+
+        for (size_t i = 1; i < onsetTimes.size(); ++i)
+        {
+            auto previousStepSeconds = ((switchOnsetIndex >= 0) && (static_cast<int>(i) > switchOnsetIndex)) ? switchedStepSeconds : stepSeconds;
+
+            if (std::abs(onsetTimes[i] - boundaryTime) <= measureSeconds)
+                boundaryJitterMs.push_back(std::abs((onsetTimes[i] - onsetTimes[i - 1]) - previousStepSeconds) * 1000.0);
+        }
+
+        auto maxBoundaryLatenessMs = boundaryLatenessMs.empty() ? 0.0 : *std::max_element(boundaryLatenessMs.begin(), boundaryLatenessMs.end());
+        auto maxBoundaryJitterMs = boundaryJitterMs.empty() ? 0.0 : *std::max_element(boundaryJitterMs.begin(), boundaryJitterMs.end());
+
+        passed = checkThreshold(checks, "p99 lateness around the switch", getPercentile(boundaryLatenessMs, 99.0), settings.maxP99LatenessMs) && passed;
+        passed = checkThreshold(checks, "max lateness around the switch", maxBoundaryLatenessMs, settings.maxLatenessMs) && passed;
+        passed = checkThreshold(checks, "max inter-onset jitter around the switch", maxBoundaryJitterMs, settings.maxJitterMs) && passed;
+
+        if (loopback.getNumDroppedEvents() > 0)
+        {
+            std::cerr << "FAILED - " << loopback.getNumDroppedEvents() << " events were received past the recording space" << std::endl;
+            passed = false;
+        }
+
+        results.setProperty("events", static_cast<int>(receivedEvents.size()));
+        results.setProperty("onsets", static_cast<int>(onsetTimes.size()));
+        results.setProperty("switchOnset", switchOnsetIndex);
+        results.setProperty("switchDelayMs", switchDelayMs);
+        results.setProperty("boundaryEvents", static_cast<int>(boundaryLatenessMs.size()));
+
+        return passed;
+    }
+
+    /** Plays polymetric tracks with swing, a groove template and ramped tempo automation for many measures on a
+        simulated clock, checking the timestamp of every note as it's sent (see OnsetCheckPort). The run fails if
+        any note is further from its time than the threshold, or if any note of the measures played is missing.
+        @param settings    The settings of the run
+        @param results     The object to add the results to
+        @param checks      The object to add the checks to
+        @returns           true if every note was on time, otherwise false
+    */
+    bool runLongRun(const TimingSettings& settings, DynamicObject& results, DynamicObject& checks)
+    {
+        auto projectData = createProject(settings);
+
+        for (auto trackIndex = 0; trackIndex < GriddleProjectData::NUM_TRACKS; ++trackIndex)
+        {
+            auto& track = projectData.tracks[trackIndex];
+            const auto& longRunTrack = LONG_RUN_TRACKS[trackIndex];
+
+            track.numSteps = longRunTrack.numSteps;
+            track.clockRateNumerator = longRunTrack.clockRate.numerator;
+            track.clockRateDenominator = longRunTrack.clockRate.denominator;
+            track.isBurnt = longRunTrack.isBurnt;
+            track.swingPercent = longRunTrack.swingPercent;
+            track.grooveIndex = longRunTrack.grooveIndex;
+        }
+
+        // A groove template that moves the notes by up to 5% of a note either way, which with the swing never moves
+        // a note past the next one, so each track's notes arrive in order
+        auto& groove = projectData.grooves[0];
+
+        for (auto stepIndex = 0; stepIndex < GriddleTrackData::NUM_STEPS; ++stepIndex)
+            groove.timingPercents[stepIndex] = ((stepIndex % 4) - 1) * 5;
+
+        // Tempo automation over 4 measures that holds, ramps up to one and a half times the tempo, then drops to
+        // three quarters of it
+        auto& tempoAutomation = projectData.tempoAutomation;
+        tempoAutomation.numMeasures = 4;
+        tempoAutomation.numPoints = 3;
+        tempoAutomation.points[0] = { 0.0, 1.0, false };
+        tempoAutomation.points[1] = { 8.0, 1.5, true };
+        tempoAutomation.points[2] = { 12.0, 0.75, false };
+
+        auto onsetCheckPort = std::make_unique<OnsetCheckPort>(projectData);
+        auto& onsetCheck = *onsetCheckPort;
+
+        GriddleOutputEncoder outputEncoder;
+        outputEncoder.setOutputPort(std::move(onsetCheckPort));
+        outputEncoder.setWireRate(0.0);
+
+        GriddleScheduler scheduler(outputEncoder);
+        GriddleMeasureCompiler measureCompiler;
+        GriddleCompiledMeasure sourceMeasure;
+
+        measureCompiler.compile(projectData, SAMPLE_RATE, outputEncoder.getWireRate(), sourceMeasure);
+        auto lookAheadSeconds = sourceMeasure.lookAheadSeconds;
+        scheduler.swapSourceMeasure(sourceMeasure);
+        scheduler.setTempoMap(GriddleTempoMap(projectData.tempo, projectData.tempoAutomation));
+        scheduler.setGroove(GriddleGroove(projectData));
+
+        // The first measure starts the look-ahead after playback starts. Playing on into the measure after the last
+        // one checked makes sure every note of the measures checked has been sent, wherever the groove moved it.
+        SimulatedClock simulatedClock(scheduler);
+        simulatedClock.start();
+        onsetCheck.setStartTime(simulatedClock.getTime() + lookAheadSeconds);
+
+        auto numMeasures = static_cast<int64>(settings.numMeasures);
+        simulatedClock.playUntil([&scheduler, numMeasures]() { return (scheduler.getCurrentMeasureIndex() > numMeasures); });
+
+        scheduler.stop();
+
+        auto numMissingOnsets = 0;
+        DynamicObject::Ptr onsetsObject = new DynamicObject();
+
+        for (auto trackIndex = 0; trackIndex < settings.numTracks; ++trackIndex)
+        {
+            auto expectedNumOnsets = (numMeasures * GriddleTimeline::TICKS_PER_MEASURE) / GriddleTimeline::getNoteTicks(projectData.tracks[trackIndex]);
+            auto numOnsets = onsetCheck.getNumOnsets(trackIndex);
+
+            if (numOnsets < expectedNumOnsets)
+                numMissingOnsets += static_cast<int>(expectedNumOnsets - numOnsets);
+
+            onsetsObject->setProperty(String::charToString(static_cast<juce_wchar>('A' + trackIndex)), numOnsets);
+        }
+
+        auto maxErrorMs = onsetCheck.getMaxErrorSeconds() * 1000.0;
+        auto passed = true;
+
+        passed = checkThreshold(checks, "max onset error", maxErrorMs, settings.maxErrorMs) && passed;
+        passed = checkNone(checks, "notes missing from the measures played", numMissingOnsets) && passed;
+        passed = checkNone(checks, "notes on channels no track plays on", onsetCheck.getNumUnexpectedOnsets()) && passed;
+
+        results.setProperty("measures", settings.numMeasures);
+        results.setProperty("onsets", var(onsetsObject.get()));
+        results.setProperty("maxOnsetErrorMs", maxErrorMs);
+
+        return passed;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    TimingSettings settings;
+
+    if (! parseArguments(StringArray(argv + 1, argc - 1), settings))
+    {
+        std::cerr << "Usage: GriddleTimingHarness [--mode <timing|dense-chords|random-edits|pattern-switch|long-run>] [--seconds <s>]" << std::endl
+                  << "                            [--measures <n>] [--tempo <bpm>] [--tracks <1-4>] [--load-threads <n>] [--seed <n>]" << std::endl
+                  << "                            [--max-p99-ms <ms>] [--max-lateness-ms <ms>] [--max-jitter-ms <ms>] [--max-drift-ms <ms>]" << std::endl
+                  << "                            [--max-error-ms <ms>] [--output <file>]" << std::endl;
+        return 1;
+    }
+
+    DynamicObject::Ptr settingsObject = new DynamicObject();
+    settingsObject->setProperty("mode", settings.mode);
+    settingsObject->setProperty("seconds", settings.seconds);
+    settingsObject->setProperty("measures", settings.numMeasures);
+    settingsObject->setProperty("tempo", settings.tempo);
+    settingsObject->setProperty("tracks", settings.numTracks);
+    settingsObject->setProperty("loadThreads", settings.numLoadThreads);
+    settingsObject->setProperty("seed", settings.seed);
+    settingsObject->setProperty("timerIntervalMs", TIMER_INTERVAL_MS);
+
+    DynamicObject::Ptr root = new DynamicObject();
+    root->setProperty("settings", var(settingsObject.get()));
+
+    DynamicObject::Ptr checks = new DynamicObject();
+    auto passed = false;
+
+    if (settings.mode == "dense-chords")
+        passed = runDenseChords(settings, *root, *checks);
+    else if (settings.mode == "random-edits")
+        passed = runRandomEdits(settings, *root, *checks);
+    else if (settings.mode == "pattern-switch")
+        passed = runPatternSwitch(settings, *root, *checks);
+    else if (settings.mode == "long-run")
+        passed = runLongRun(settings, *root, *checks);
+    else
+        passed = runTiming(settings, *root, *checks);
+
+    root->setProperty("checks", var(checks.get()));
+    root->setProperty("passed", passed);
+
+    MemoryOutputStream results;
+    JSON::writeToStream(results, var(root.get()));
+    results << newLine;
+
+    if (settings.outputFile == File())
+    {
+        std::cout << results.toString();
+    }
+    else if (! settings.outputFile.replaceWithData(results.getData(), results.getDataSize()))
+    {
+        std::cerr << "Couldn't write the results to " << settings.outputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    return passed ? 0 : 1;
+}
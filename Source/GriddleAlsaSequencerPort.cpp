@@ -0,0 +1,134 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleAlsaSequencerPort.cpp
+    Created: 19 Oct 2026 3:10:38pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleAlsaSequencerPort.h"
+
+#if JUCE_LINUX
+
+#include <alsa/asoundlib.h>
+
+constexpr double GriddleAlsaSequencerPort::SCHEDULE_AHEAD_SECONDS;
+
+//==============================================================================
+GriddleAlsaSequencerPort::GriddleAlsaSequencerPort(snd_seq_t* sequencer, const int portId, const int queueId, snd_midi_event_t* eventEncoder)
+    : sequencer_(sequencer)
+    , portId_(portId)
+    , queueId_(queueId)
+    , eventEncoder_(eventEncoder)
+    , queueStartTime_(0.0)
+{
+    // Start the queue's clock running and work out where its 0 is on the application's clock
+    snd_seq_start_queue(sequencer_, queueId_, nullptr);
+    snd_seq_drain_output(sequencer_);
+
+    snd_seq_queue_status_t* queueStatus;
+    snd_seq_queue_status_alloca(&queueStatus);
+
+    auto now = Time::getMillisecondCounterHiRes() * 0.001;
+    queueStartTime_ = now;
+
+    if (snd_seq_get_queue_status(sequencer_, queueId_, queueStatus) >= 0)
+    {
+        auto queueTime = snd_seq_queue_status_get_real_time(queueStatus);
+        queueStartTime_ = now - (queueTime->tv_sec + (queueTime->tv_nsec * 1.0e-9));
+    }
+}
+
+GriddleAlsaSequencerPort::~GriddleAlsaSequencerPort()
+{
+    snd_seq_stop_queue(sequencer_, queueId_, nullptr);
+    snd_seq_drain_output(sequencer_);
+    snd_seq_free_queue(sequencer_, queueId_);
+    snd_midi_event_free(eventEncoder_);
+
+    // Closing the client also removes its port
+    snd_seq_close(sequencer_);
+}
+
+std::unique_ptr<GriddleOutputPort> GriddleAlsaSequencerPort::createVirtualPort(const String& portName)
+{
+    snd_seq_t* sequencer = nullptr;
+
+    if (snd_seq_open(&sequencer, "default", SND_SEQ_OPEN_OUTPUT, 0) < 0)
+        return nullptr;
+
+    snd_seq_set_client_name(sequencer, ProjectInfo::projectName);
+
+    auto portId = snd_seq_create_simple_port(sequencer, portName.toRawUTF8(),
+                                             SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_SUBS_READ,
+                                             SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+    auto queueId = snd_seq_alloc_named_queue(sequencer, ProjectInfo::projectName);
+
+    snd_midi_event_t* eventEncoder = nullptr;
+
+    if ((portId < 0) || (queueId < 0) || (snd_midi_event_new(16, &eventEncoder) < 0))
+    {
+        snd_seq_close(sequencer);
+        return nullptr;
+    }
+
+    return std::unique_ptr<GriddleOutputPort>(new GriddleAlsaSequencerPort(sequencer, portId, queueId, eventEncoder));
+}
+
+void GriddleAlsaSequencerPort::sendMessage(const MidiMessage& message, const double timestamp)
+{
+    snd_seq_event_t event;
+    snd_seq_ev_clear(&event);
+
+    snd_midi_event_reset_encode(eventEncoder_);
+
+    if ((snd_midi_event_encode(eventEncoder_, message.getRawData(), message.getRawDataSize(), &event) <= 0) || (event.type == SND_SEQ_EVENT_NONE))
+        return;
+
+    // Messages are always queued, even ones due now, so they can't overtake messages queued ahead of them
+    auto queueTime = jmax(Time::getMillisecondCounterHiRes() * 0.001, timestamp) - queueStartTime_;
+
+    snd_seq_real_time_t eventTime;
+    eventTime.tv_sec = static_cast<unsigned int>(queueTime);
+    eventTime.tv_nsec = static_cast<unsigned int>((queueTime - eventTime.tv_sec) * 1.0e9);
+
+    snd_seq_ev_set_source(&event, portId_);
+    snd_seq_ev_set_subs(&event);
+    snd_seq_ev_schedule_real(&event, queueId_, 0, &eventTime);
+
+    snd_seq_event_output(sequencer_, &event);
+    snd_seq_drain_output(sequencer_);
+}
+
+double GriddleAlsaSequencerPort::getScheduleAheadSeconds() const
+{
+    return SCHEDULE_AHEAD_SECONDS;
+}
+
+#endif
@@ -0,0 +1,103 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleAlsaSequencerPort.h
+    Created: 19 Oct 2026 3:10:38pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "GriddleOutputPort.h"
+
+#if JUCE_LINUX
+
+// Forward declarations of the ALSA types, so only the .cpp needs the ALSA headers
+typedef struct _snd_seq snd_seq_t;
+typedef struct snd_midi_event snd_midi_event_t;
+
+//==============================================================================
+/*
+    This class is a GriddleOutputPort for a virtual output port that Griddle creates
+    in the ALSA sequencer, which soft-synths and other applications can subscribe to
+    directly (e.g. "aseqdump -p Griddle").
+
+    Messages are handed over ahead of time and queued in the sequencer with real-time
+    timestamps, so the kernel sends them at the right time instead of the 1ms timer.
+*/
+class GriddleAlsaSequencerPort : public GriddleOutputPort
+{
+public:
+    //==============================================================================
+    ~GriddleAlsaSequencerPort();
+    //==============================================================================
+
+    /** How far ahead of their send times messages are queued in the sequencer, in seconds */
+    static constexpr double SCHEDULE_AHEAD_SECONDS = 0.02;
+
+    /** Creates a sequencer client named after the application with a virtual output port
+
+        @param portName    The name of the port, as seen by applications subscribing to it
+        @returns           The created port, or nullptr if the ALSA sequencer couldn't be opened
+    */
+    static std::unique_ptr<GriddleOutputPort> createVirtualPort(const String& portName);
+
+    /** Queues a message in the sequencer to be sent at its timestamp
+
+        This is an override of the GriddleOutputPort method.
+    */
+    void sendMessage(const MidiMessage& message, const double timestamp) override;
+
+    /** Gets how far ahead of their send times messages can be handed to the port
+
+        This is an override of the GriddleOutputPort method.
+    */
+    double getScheduleAheadSeconds() const override;
+
+private:
+    //==============================================================================
+    GriddleAlsaSequencerPort(snd_seq_t* sequencer, const int portId, const int queueId, snd_midi_event_t* eventEncoder);
+    //==============================================================================
+
+    //==============================================================================
+    // Sequencer Variables
+    snd_seq_t* sequencer_;
+    const int portId_;
+    const int queueId_;
+    snd_midi_event_t* eventEncoder_;
+
+    // The time on the Time::getMillisecondCounterHiRes() clock at which the sequencer queue's clock was 0
+    double queueStartTime_;
+    //==============================================================================
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleAlsaSequencerPort)
+};
+
+#endif
@@ -0,0 +1,112 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleGroove.cpp
+    Created: 19 Oct 2026 9:41:07pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleGroove.h"
+#include "GriddleTimeline.h"
+
+constexpr int GriddleTrackData::MIN_SWING_PERCENT;
+constexpr int GriddleTrackData::MAX_SWING_PERCENT;
+constexpr int GriddleGrooveData::MAX_TIMING_PERCENT;
+constexpr int GriddleGrooveData::MAX_VELOCITY_OFFSET;
+
+//==============================================================================
+GriddleGroove::GriddleGroove()
+    : GriddleGroove(GriddleProjectData())
+{
+}
+
+GriddleGroove::GriddleGroove(const GriddleProjectData& projectData)
+    : maxEarlyTicks_(0)
+{
+    for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+    {
+        const auto& trackData = projectData.tracks[trackI];
+        auto& trackGroove = tracks_[trackI];
+
+        trackGroove.swingPercent = jlimit(GriddleTrackData::MIN_SWING_PERCENT, GriddleTrackData::MAX_SWING_PERCENT, trackData.swingPercent);
+        trackGroove.timingPercents.fill(0);
+        trackGroove.velocityOffsets.fill(0);
+        trackGroove.length = 1;
+
+        // A track without a groove template gets one with no offsets
+        if ((trackData.grooveIndex < 0) || (trackData.grooveIndex >= GriddleProjectData::NUM_GROOVES))
+            continue;
+
+        const auto& grooveData = projectData.grooves[trackData.grooveIndex];
+        trackGroove.length = jlimit(1, GriddleTrackData::NUM_STEPS, grooveData.length);
+
+        for (auto stepI = 0; stepI < trackGroove.length; ++stepI)
+        {
+            trackGroove.timingPercents[stepI] = jlimit(-GriddleGrooveData::MAX_TIMING_PERCENT, GriddleGrooveData::MAX_TIMING_PERCENT, grooveData.timingPercents[stepI]);
+            trackGroove.velocityOffsets[stepI] = jlimit(-GriddleGrooveData::MAX_VELOCITY_OFFSET, GriddleGrooveData::MAX_VELOCITY_OFFSET, grooveData.velocityOffsets[stepI]);
+        }
+
+        // Any of a clocked track's notes can land at the start of a measure, so every step position
+        // of the template is checked (swing only ever moves notes later)
+        auto noteTicks = GriddleTimeline::getNoteTicks(trackData);
+
+        for (auto stepI = 0; stepI < trackGroove.length; ++stepI)
+            maxEarlyTicks_ = jmax(maxEarlyTicks_, -(noteTicks * trackGroove.timingPercents[stepI]) / 100);
+    }
+}
+
+GriddleGroove::~GriddleGroove()
+{
+}
+
+int64 GriddleGroove::getNoteShiftTicks(const int trackIndex, const int noteIndex, const int64 noteTicks) const
+{
+    if ((trackIndex < 0) || (trackIndex >= GriddleProjectData::NUM_TRACKS) || (noteIndex < 0) || (noteTicks <= 0))
+        return 0;
+
+    const auto& trackGroove = tracks_[trackIndex];
+
+    // Swing moves the second note of each pair later, by twice the swing beyond 50% of a note
+    auto shiftPercent = trackGroove.timingPercents[noteIndex % trackGroove.length];
+
+    if ((noteIndex % 2) == 1)
+        shiftPercent += (trackGroove.swingPercent - GriddleTrackData::MIN_SWING_PERCENT) * 2;
+
+    return (noteTicks * shiftPercent) / 100;
+}
+
+int GriddleGroove::getVelocityOffset(const int trackIndex, const int noteIndex) const
+{
+    if ((trackIndex < 0) || (trackIndex >= GriddleProjectData::NUM_TRACKS) || (noteIndex < 0))
+        return 0;
+
+    const auto& trackGroove = tracks_[trackIndex];
+
+    return trackGroove.velocityOffsets[noteIndex % trackGroove.length];
+}
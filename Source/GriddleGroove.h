@@ -0,0 +1,124 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleGroove.h
+    Created: 19 Oct 2026 9:41:07pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include "GriddleProjectData.h"
+
+//==============================================================================
+/*
+    This class holds the swing and groove templates of a project's tracks, and works out
+    how they move each note in time and change its velocity.
+
+    Swing delays every second note of a track's grid, so that at a swing of 50% the notes
+    are straight and at 66.7% they're in triplets. A groove template then moves each step
+    position by its timing offset (a percentage of a step) and adds its velocity offset to
+    the notes that start there. Both follow the track's grid of notes, so a burnt or
+    clocked track swings at the rate of its own notes.
+
+    Grooves are applied by the scheduler as it schedules each event rather than compiled
+    into the measure, so they can be changed during playback without a recompile. Like the
+    tempo map, a groove is a fixed-size value with no allocations, so it can be copied onto
+    the playback thread while the sequence is playing.
+*/
+class GriddleGroove
+{
+public:
+    //==============================================================================
+    /** Creates a groove with no swing or groove templates, which leaves every note as it is */
+    GriddleGroove();
+
+    /** Creates a groove from the swing and groove template settings of a project's tracks
+
+        Swing and the templates' offsets are limited to their valid ranges.
+
+        @param projectData    The project to take the tracks' swing and groove templates from
+    */
+    explicit GriddleGroove(const GriddleProjectData& projectData);
+
+    ~GriddleGroove();
+    //==============================================================================
+
+    /** Gets how far a note is moved by its track's swing and groove template
+
+        @param trackIndex    The index of the note's track
+        @param noteIndex     The position of the note in its track's cycle of notes
+        @param noteTicks     The length of the track's notes in ticks
+        @returns             The distance to move the note in ticks (positive values move it later)
+    */
+    int64 getNoteShiftTicks(const int trackIndex, const int noteIndex, const int64 noteTicks) const;
+
+    /** Gets the velocity offset a note gets from its track's groove template
+
+        @param trackIndex    The index of the note's track
+        @param noteIndex     The position of the note in its track's cycle of notes
+        @returns             The amount to add to the note's velocity
+    */
+    int getVelocityOffset(const int trackIndex, const int noteIndex) const;
+
+    /** Gets the furthest a note can be moved earlier than its place on the timeline, which is
+        how far before the start of a measure the measure's first notes can be due
+
+        @returns    The distance in ticks, which is 0 if no note is moved earlier
+    */
+    int64 getMaxEarlyTicks() const;
+
+private:
+    //==============================================================================
+    /** The swing and groove template of one track, with the template's offsets limited to their valid ranges */
+    struct TrackGroove
+    {
+        int swingPercent;
+        int length;
+        std::array<int, GriddleTrackData::NUM_STEPS> timingPercents;
+        std::array<int, GriddleTrackData::NUM_STEPS> velocityOffsets;
+    };
+
+    //==============================================================================
+    // Groove Variables
+    std::array<TrackGroove, GriddleProjectData::NUM_TRACKS> tracks_;
+    int64 maxEarlyTicks_;
+    //==============================================================================
+
+    JUCE_LEAK_DETECTOR(GriddleGroove)
+};
+
+//==============================================================================
+// Inline Getter Definitions
+inline int64 GriddleGroove::getMaxEarlyTicks() const
+{
+    return maxEarlyTicks_;
+}
@@ -0,0 +1,114 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleLatencyCalibrator.cpp
+    Created: 19 Oct 2026 1:26:52pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleLatencyCalibrator.h"
+
+#include <algorithm>
+
+constexpr int GriddleLatencyCalibrator::NUM_PROBES;
+
+//==============================================================================
+GriddleLatencyCalibrator::GriddleLatencyCalibrator(GriddleOutputEncoder& outputEncoder, const String& midiInputIdentifier, const int midiChannel)
+    : ThreadWithProgressWindow("Calibrating latency via MIDI loopback...", true, true)
+    , outputEncoder_(outputEncoder)
+    , midiInputIdentifier_(midiInputIdentifier)
+    , midiChannel_(midiChannel)
+    , probeNoteNumber_(127)
+    , probeReceivedTime_(0.0)
+    , roundTripMs_(0.0)
+{
+}
+
+GriddleLatencyCalibrator::~GriddleLatencyCalibrator()
+{
+}
+
+void GriddleLatencyCalibrator::run()
+{
+    roundTripsMs_.clear();
+    roundTripMs_ = 0.0;
+
+    auto midiInput = MidiInput::openDevice(midiInputIdentifier_, this);
+
+    if (midiInput == nullptr)
+        return;
+
+    midiInput->start();
+
+    for (auto probeI = 0; probeI < NUM_PROBES; ++probeI)
+    {
+        if (threadShouldExit())
+            break;
+
+        setProgress(probeI / static_cast<double>(NUM_PROBES));
+
+        probeReceived_.reset();
+
+        auto sentTime = Time::getMillisecondCounterHiRes();
+        outputEncoder_.sendMessageNow(MidiMessage::noteOn(midiChannel_, probeNoteNumber_, static_cast<uint8>(64)));
+
+        // Probes that don't come back within half a second are counted as lost
+        if (probeReceived_.wait(500))
+            roundTripsMs_.push_back(probeReceivedTime_ - sentTime);
+
+        outputEncoder_.sendMessageNow(MidiMessage::noteOff(midiChannel_, probeNoteNumber_, static_cast<uint8>(0)));
+
+        // Leave a gap so the NOTE OFF coming back can't be mistaken for the next probe
+        wait(50);
+    }
+
+    midiInput->stop();
+
+    if (! roundTripsMs_.empty())
+    {
+        auto median = roundTripsMs_;
+        std::sort(median.begin(), median.end());
+        roundTripMs_ = median[median.size() / 2];
+    }
+}
+
+bool GriddleLatencyCalibrator::hasResult() const
+{
+    return (getNumProbesReceived() >= (NUM_PROBES / 2));
+}
+
+void GriddleLatencyCalibrator::handleIncomingMidiMessage(MidiInput*, const MidiMessage& message)
+{
+    // Zero-velocity NOTE ONs aren't counted as the probe coming back
+    if (message.isNoteOn() && (message.getNoteNumber() == probeNoteNumber_))
+    {
+        probeReceivedTime_ = Time::getMillisecondCounterHiRes();
+        probeReceived_.signal();
+    }
+}
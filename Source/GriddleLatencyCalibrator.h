@@ -0,0 +1,124 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleLatencyCalibrator.h
+    Created: 19 Oct 2026 1:26:52pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <vector>
+#include "GriddleOutputEncoder.h"
+
+//==============================================================================
+/*
+    This class measures the round-trip latency of a MIDI loopback.
+
+    Probe notes are sent through the output encoder to the current MIDI output,
+    and the time until each one comes back on a MIDI input (via a loopback cable,
+    a synth's MIDI THRU or a virtual loopback port) is measured. The median of the
+    round trips is reported so that a few stray slow probes don't skew the result.
+
+    The calibration runs on its own thread behind a modal progress window, and must
+    not be run while the sequence is playing since it sends through the same encoder.
+*/
+class GriddleLatencyCalibrator : public ThreadWithProgressWindow,
+                                 private MidiInputCallback
+{
+public:
+    //==============================================================================
+    GriddleLatencyCalibrator(GriddleOutputEncoder& outputEncoder, const String& midiInputIdentifier, const int midiChannel);
+    ~GriddleLatencyCalibrator();
+    //==============================================================================
+
+    /** Sends the probe notes and collects their round-trip times
+
+        This is an override of the Thread method.
+    */
+    void run() override;
+
+    /** Checks whether enough probes came back to give a reliable round-trip time
+
+        @returns    true if the calibration succeeded, otherwise false
+    */
+    bool hasResult() const;
+
+    /** Gets the median round-trip time of the probes that came back
+
+        @returns    The round-trip latency in milliseconds
+    */
+    double getRoundTripMs() const;
+
+    /** Gets the number of probe notes that came back on the MIDI input
+
+        @returns    The number of probes received
+    */
+    int getNumProbesReceived() const;
+
+    /** The number of probe notes sent during a calibration */
+    static constexpr int NUM_PROBES = 16;
+
+private:
+    //==============================================================================
+    // Loopback Variables
+    GriddleOutputEncoder& outputEncoder_;
+    const String midiInputIdentifier_;
+    const int midiChannel_;
+    const int probeNoteNumber_;
+    WaitableEvent probeReceived_;
+    std::atomic<double> probeReceivedTime_;
+    //==============================================================================
+
+    //==============================================================================
+    // Result Variables
+    std::vector<double> roundTripsMs_;
+    double roundTripMs_;
+    //==============================================================================
+
+    /** Timestamps the probe note when it comes back on the MIDI input
+
+        This is an override of the MidiInputCallback method.
+    */
+    void handleIncomingMidiMessage(MidiInput* source, const MidiMessage& message) override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleLatencyCalibrator)
+};
+
+inline double GriddleLatencyCalibrator::getRoundTripMs() const
+{
+    return roundTripMs_;
+}
+
+inline int GriddleLatencyCalibrator::getNumProbesReceived() const
+{
+    return static_cast<int>(roundTripsMs_.size());
+}
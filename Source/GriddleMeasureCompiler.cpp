@@ -0,0 +1,341 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleMeasureCompiler.cpp
+    Created: 19 Oct 2026 5:41:12pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleMeasureCompiler.h"
+#include "GriddleOutputEncoder.h"
+#include "GriddleProjectFile.h"
+#include "GriddleTimeline.h"
+#include "GriddleTrace.h"
+#include "GriddleTrigCondition.h"
+
+constexpr int GriddleMeasureCompiler::TRACK_CACHE_CAPACITY;
+constexpr int GriddleStepData::MAX_RATCHETS;
+constexpr int GriddleStepData::MAX_CHORD_NOTES;
+
+//==============================================================================
+GriddleMeasureCompiler::GriddleMeasureCompiler()
+    : trackCacheHits_(0)
+    , trackCacheMisses_(0)
+{
+    // Room for a NOTE ON and a NOTE OFF for every note of every track at the fastest clock rate
+    compiledEvents_.reserve(GriddleProjectData::NUM_TRACKS * GriddleTimeline::MAX_NOTES_PER_MEASURE * 2);
+    freeRunningEvents_.reserve(GriddleProjectData::NUM_TRACKS * GriddleTimeline::MAX_NOTES_PER_MEASURE * 2);
+}
+
+GriddleMeasureCompiler::~GriddleMeasureCompiler()
+{
+}
+
+void GriddleMeasureCompiler::compile(const GriddleProjectData& projectData, const double sampleRate, const double wireRate, GriddleCompiledMeasure& measure)
+{
+    GRIDDLE_TRACE_SCOPE("GriddleMeasureCompiler::compile");
+
+    compiledEvents_.clear();
+    freeRunningEvents_.clear();
+
+    // Loop through the tracks and lay out their compiled notes, keeping the tracks with one-measure cycles together
+    for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+    {
+        const auto& track = projectData.tracks[trackI];
+        auto& measureTrack = measure.tracks[trackI];
+
+        measureTrack.events.clear();
+        measureTrack.trigs.clear();
+        measureTrack.cycleTicks = 0;
+        measureTrack.patternTicks = 0;
+
+        // Inactive tracks are not included in the measure
+        if (! track.isActive)
+            continue;
+
+        const auto& compiledTrack = getCompiledTrack(track);
+        measureTrack.cycleTicks = compiledTrack.cycleTicks;
+        measureTrack.patternTicks = compiledTrack.noteTicks * track.numSteps;
+        measureTrack.trigs.assign(compiledTrack.trigs.begin(), compiledTrack.trigs.end());
+
+        if (compiledTrack.cycleTicks == GriddleTimeline::TICKS_PER_MEASURE)
+            addTrackEvents(compiledTrack, track, trackI, projectData.tempo, sampleRate, compiledEvents_);
+        else
+            addTrackEvents(compiledTrack, track, trackI, projectData.tempo, sampleRate, freeRunningEvents_);
+    }
+
+    sortEvents(compiledEvents_);
+    sortEvents(freeRunningEvents_);
+
+    // Each track's latency offset is kept as a time offset on each event, which doesn't change with the tempo. Events
+    // can only be due before the start of their cycle by their offsets and by the scheduler spreading their bursts, so
+    // the most an event moves ahead is how far ahead the scheduler needs to queue a measure.
+    measure.lookAheadSeconds = 0.0;
+
+    if (projectData.bandwidthAwareScheduling && (wireRate > 0.0))
+        measure.lookAheadSeconds = getBurstLookAheadSeconds(sampleRate, wireRate);
+
+    for (const auto* events : { &compiledEvents_, &freeRunningEvents_ })
+    {
+        for (const auto& event : *events)
+        {
+            auto offsetSeconds = (event.samplePosition - event.timelineSamplePosition) / sampleRate;
+
+            measure.tracks[event.trackIndex].events.push_back({ event.tick, event.gateTicks, offsetSeconds, event.message, event.priority,
+                                                                event.trackIndex, event.noteIndex, event.noteTicks, event.trigIndex });
+            measure.lookAheadSeconds = jmax(measure.lookAheadSeconds, -offsetSeconds);
+        }
+    }
+}
+
+void GriddleMeasureCompiler::addTrackEvents(const CompiledTrack& compiledTrack, const GriddleTrackData& track, const int trackIndex,
+                                            const double tempo, const double sampleRate, std::vector<CompiledEvent>& events)
+{
+    // Calculate the smallest possible gate length in samples
+    int minGateLengthInSamples = static_cast<int>(GriddleTimeline::MIN_GATE_SECONDS * sampleRate);
+
+    // Shift the track's events by its latency offset (negative offsets send them early)
+    int latencyOffsetSamples = track.getLatencyOffsetSamples(sampleRate);
+
+    for (const auto& note : compiledTrack.notes)
+    {
+        // The events are laid out at the project tempo to order them and find any bursts on the wire
+        int noteOnPos = GriddleTimeline::ticksToSamples(note.startTick, tempo, sampleRate);
+        int noteOffPos = GriddleTimeline::ticksToSamples(note.startTick + note.gateTicks, tempo, sampleRate);
+
+        // Enforce the calculated minimum gate length to ensure reliable note triggering
+        if (noteOffPos < (noteOnPos + minGateLengthInSamples))
+            noteOffPos = noteOnPos + minGateLengthInSamples;
+
+        // Drums on channel 10 get priority over other NOTE ONs since late drum hits are the most audible
+        events.push_back({ noteOnPos + latencyOffsetSamples, (track.midiChannel == 10) ? 1 : 2,
+            MidiMessage::noteOn(track.midiChannel, note.noteNumber, static_cast<uint8>(note.velocity)),
+            note.startTick, 0, noteOnPos, trackIndex, note.noteIndex, compiledTrack.noteTicks, note.trigIndex });
+
+        // NOTE OFFs get the highest priority to keep them from cutting into the following note
+        events.push_back({ noteOffPos + latencyOffsetSamples, 0,
+            MidiMessage::noteOff(track.midiChannel, note.noteNumber, static_cast<uint8>(0)),
+            note.startTick, note.gateTicks, noteOffPos, trackIndex, note.noteIndex, compiledTrack.noteTicks, note.trigIndex });
+    }
+}
+
+void GriddleMeasureCompiler::sortEvents(std::vector<CompiledEvent>& events)
+{
+    std::stable_sort(events.begin(), events.end(), [](const CompiledEvent& a, const CompiledEvent& b)
+    {
+        return (a.samplePosition < b.samplePosition) || ((a.samplePosition == b.samplePosition) && (a.priority < b.priority));
+    });
+}
+
+const GriddleMeasureCompiler::CompiledTrack& GriddleMeasureCompiler::getCompiledTrack(const GriddleTrackData& track)
+{
+    // Build the key from everything the track's notes depend on (steps beyond the
+    // track's length are left at zero, since they don't affect the compiled notes)
+    TrackCompileKey key;
+    std::memset(&key, 0, sizeof(key));
+
+    key.numSteps = track.numSteps;
+    key.flags = (track.isFlipped ? 1 : 0) | (track.isChopped ? 2 : 0) | (track.isBurnt ? 4 : 0);
+    key.clockRateNumerator = track.clockRateNumerator;
+    key.clockRateDenominator = track.clockRateDenominator;
+
+    for (auto stepI = 0; stepI < jlimit(0, GriddleTrackData::NUM_STEPS, track.numSteps); ++stepI)
+    {
+        const auto& step = track.steps[static_cast<size_t>(stepI)];
+        auto stepValues = key.stepValues.begin() + (stepI * TrackCompileKey::VALUES_PER_STEP);
+
+        stepValues[0] = step.noteNumber;
+        stepValues[1] = step.velocity;
+        stepValues[2] = step.gatePercent;
+        stepValues[3] = step.probability;
+        stepValues[4] = step.ratchets;
+        stepValues[5] = step.condition;
+        stepValues[6] = jlimit(0, GriddleStepData::MAX_CHORD_NOTES - 1, step.numChordNotes);
+
+        for (auto chordNoteI = 0; chordNoteI < stepValues[6]; ++chordNoteI)
+        {
+            stepValues[7 + (chordNoteI * 2)] = step.chordNotes[static_cast<size_t>(chordNoteI)].noteNumber;
+            stepValues[8 + (chordNoteI * 2)] = step.chordNotes[static_cast<size_t>(chordNoteI)].velocity;
+        }
+    }
+
+    auto hash = GriddleProjectFile::hashData(&key, sizeof(key));
+
+    // Look the track up in the cache, moving it to the front as the most recently used
+    for (auto cacheIt = trackCache_.begin(); cacheIt != trackCache_.end(); ++cacheIt)
+    {
+        if ((cacheIt->hash == hash) && (std::memcmp(&cacheIt->key, &key, sizeof(key)) == 0))
+        {
+            trackCache_.splice(trackCache_.begin(), trackCache_, cacheIt);
+            ++trackCacheHits_;
+
+            return trackCache_.front();
+        }
+    }
+
+    // When the cache is full, the least recently used track's storage is reused for the new track
+    if (trackCache_.size() >= static_cast<size_t>(TRACK_CACHE_CAPACITY))
+    {
+        trackCache_.splice(trackCache_.begin(), trackCache_, std::prev(trackCache_.end()));
+    }
+    else
+    {
+        trackCache_.emplace_front();
+        trackCache_.front().notes.reserve(GriddleTimeline::MAX_NOTES_PER_MEASURE);
+        trackCache_.front().trigs.reserve(GriddleTimeline::MAX_NOTES_PER_MEASURE);
+    }
+
+    auto& compiledTrack = trackCache_.front();
+    compiledTrack.hash = hash;
+    std::memcpy(&compiledTrack.key, &key, sizeof(key));
+    compileTrack(track, compiledTrack);
+    ++trackCacheMisses_;
+
+    return compiledTrack;
+}
+
+void GriddleMeasureCompiler::compileTrack(const GriddleTrackData& track, CompiledTrack& compiledTrack)
+{
+    auto& notes = compiledTrack.notes;
+    auto& trigs = compiledTrack.trigs;
+    notes.clear();
+    trigs.clear();
+
+    compiledTrack.noteTicks = GriddleTimeline::getNoteTicks(track);
+    compiledTrack.cycleTicks = 0;
+
+    if (track.numSteps <= 0)
+        return;
+
+    // A pattern that divides the measure is repeated to fill it, so the track stays in step with the measure.
+    // Otherwise the pattern is its own cycle, doubled for an odd number of steps so swing pairs carry on across it.
+    int64 noteTicks = compiledTrack.noteTicks;
+    int64 patternTicks = noteTicks * track.numSteps;
+
+    if ((GriddleTimeline::TICKS_PER_MEASURE % patternTicks) == 0)
+        compiledTrack.cycleTicks = GriddleTimeline::TICKS_PER_MEASURE;
+    else
+        compiledTrack.cycleTicks = patternTicks * (((track.numSteps % 2) == 1) ? 2 : 1);
+
+    // Every note length divides the cycle exactly, so the notes of every track land on whole ticks
+    auto numNotes = static_cast<int>(compiledTrack.cycleTicks / noteTicks);
+
+    // Loop through the steps of the cycle and add their notes
+    for (auto stepI = 0; stepI < numNotes; ++stepI)
+    {
+        // Repeat the step indexes for as many times as the pattern plays in the cycle
+        auto stepIndex = stepI % track.numSteps;
+
+        // Adjust the step index if the track is set to play the steps in reverse
+        if (track.isFlipped)
+            stepIndex = (track.numSteps - stepIndex - 1);
+
+        const auto& step = track.steps[stepIndex];
+
+        // Rests don't have any notes
+        if (step.noteNumber < 0)
+            continue;
+
+        // Calculate the gate length based on the gate percent and chopped state of the track
+        int gatePercent = step.gatePercent;
+        if (track.isChopped)
+            gatePercent = 10;
+
+        // A step with a probability or a trig condition gets a trig, which the scheduler decides whether to play
+        auto trigIndex = -1;
+
+        if ((step.probability < 100) || (step.condition != GriddleTrigCondition::NONE))
+        {
+            trigIndex = static_cast<int>(trigs.size());
+            trigs.push_back({ noteTicks * stepI, jlimit(0, 100, step.probability), step.condition });
+        }
+
+        // A ratcheted step repeats its note evenly through the step (to the nearest tick), with each repeat gated by the
+        // step's gate percent of its own length. The repeats keep the step's note index, so the groove moves them together.
+        auto ratchets = jlimit(1, GriddleStepData::MAX_RATCHETS, step.ratchets);
+        auto numChordNotes = jlimit(0, GriddleStepData::MAX_CHORD_NOTES - 1, step.numChordNotes);
+
+        for (auto ratchetI = 0; ratchetI < ratchets; ++ratchetI)
+        {
+            auto startTick = (noteTicks * stepI) + ((noteTicks * ratchetI) / ratchets);
+            auto gateTicks = (noteTicks * gatePercent) / (100 * ratchets);
+
+            notes.push_back({ stepI, startTick, gateTicks, step.noteNumber, step.velocity, trigIndex });
+
+            // The rest of the step's chord plays with the step's note, sharing its timing and trig
+            for (auto chordNoteI = 0; chordNoteI < numChordNotes; ++chordNoteI)
+            {
+                const auto& chordNote = step.chordNotes[static_cast<size_t>(chordNoteI)];
+
+                if (chordNote.noteNumber >= 0)
+                    notes.push_back({ stepI, startTick, gateTicks, chordNote.noteNumber, chordNote.velocity, trigIndex });
+            }
+        }
+    }
+}
+
+double GriddleMeasureCompiler::getBurstLookAheadSeconds(const double sampleRate, const double wireRate) const
+{
+    const auto& events = compiledEvents_;
+    auto eventI = size_t(0);
+    auto previousBurstEnd = std::numeric_limits<double>::lowest();
+    auto lookAheadSeconds = 0.0;
+
+    while (eventI < events.size())
+    {
+        // Gather a burst: events that would still be queued on the wire when the next event is due
+        auto burstStart = eventI;
+        auto burstNominalStart = static_cast<double>(events[eventI].samplePosition);
+        auto burstWireSamples = 0.0;
+        uint8 runningStatus = 0;
+
+        do
+        {
+            burstWireSamples += GriddleOutputEncoder::getWireTimeSeconds(GriddleOutputEncoder::getWireByteCount(events[eventI].message, runningStatus), wireRate) * sampleRate;
+            runningStatus = GriddleOutputEncoder::getEncodedStatusByte(events[eventI].message);
+            ++eventI;
+        } while ((eventI < events.size()) && (events[eventI].samplePosition < (burstNominalStart + burstWireSamples)));
+
+        // Centre the burst on its nominal start time the way the scheduler does, without overlapping the previous burst,
+        // and see how far ahead of its place on the timeline that sends each event
+        auto sendPos = jmax(previousBurstEnd, burstNominalStart - (burstWireSamples * 0.5));
+        runningStatus = 0;
+
+        for (auto burstI = burstStart; burstI < eventI; ++burstI)
+        {
+            lookAheadSeconds = jmax(lookAheadSeconds, (events[burstI].timelineSamplePosition - sendPos) / sampleRate);
+            sendPos += GriddleOutputEncoder::getWireTimeSeconds(GriddleOutputEncoder::getWireByteCount(events[burstI].message, runningStatus), wireRate) * sampleRate;
+            runningStatus = GriddleOutputEncoder::getEncodedStatusByte(events[burstI].message);
+        }
+
+        previousBurstEnd = sendPos;
+    }
+
+    return lookAheadSeconds;
+}
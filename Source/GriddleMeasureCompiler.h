@@ -0,0 +1,235 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleMeasureCompiler.h
+    Created: 19 Oct 2026 5:41:12pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <list>
+#include <vector>
+#include "GriddleProjectData.h"
+#include "GriddleTimeline.h"
+
+//==============================================================================
+/*
+    This class compiles the steps of a project into the MIDI events of each track,
+    positioned on the tick timeline so the tracks can be played at any tempo.
+
+    It works from plain GriddleProjectData rather than the GUI components, so projects
+    can be compiled without being loaded into the tracks (e.g. patterns in a library).
+    The event list is reused between compilations to avoid allocating on every change.
+
+    Each track's notes are compiled separately onto the tick timeline (see GriddleTimeline)
+    and cached by a hash of the settings they depend on (the steps, number of steps, flip,
+    chop, burn and clock rate). The tempo, sample rate, MIDI channel and latency offset are
+    only applied when the tracks' events are built, so identical tracks on different
+    channels, unchanged tracks, tracks that return to an earlier state (e.g. after an undo)
+    and tempo changes all reuse the compiled notes.
+
+    Each track is compiled into its own cycle of events. A track whose pattern divides the
+    measure (every track fitted into the measure, and most clocked tracks) repeats it to
+    fill a one-measure cycle, and a clocked track whose pattern doesn't divide the measure
+    gets a cycle of its own length that runs freely across the measure boundaries. The
+    scheduler queues each measure's share of every track's cycle and merges the tracks as
+    it sends them.
+
+    Bursts of events on the MIDI wire are spread by the scheduler as it queues each
+    measure, at the tempo and groove the events are actually played at, so tempo changes
+    and tempo automation never require the tracks to be recompiled. The compiler only lays
+    the one-measure cycles out together at the project tempo to estimate how far ahead
+    of their places on the timeline the spreading sends events, for the look-ahead.
+
+    Swing and groove templates aren't compiled into the measure at all. Each event keeps
+    its track and its position in the track's cycle of notes, and the scheduler applies the
+    tracks' grooves as it schedules the events.
+
+    Ratchets are compiled into the notes, but step probabilities and trig conditions aren't:
+    the steps that have them are compiled as trigs along with the notes, and the scheduler
+    decides whether each trig plays as it queues the measure, so the pattern varies from
+    measure to measure without being recompiled.
+*/
+class GriddleMeasureCompiler
+{
+public:
+    //==============================================================================
+    GriddleMeasureCompiler();
+    ~GriddleMeasureCompiler();
+    //==============================================================================
+
+    /** Compiles the tracks of the project onto the tick timeline
+
+        Events moved before the start of their cycle by negative latency offsets or by the spreading of their
+        bursts set the look-ahead, which is how far ahead of each measure's start the scheduler should queue it.
+
+        @param projectData    The project to compile (its tempo is only used to estimate the spreading of bursts of events on the wire)
+        @param sampleRate     The sample rate that latency offsets in samples are converted at
+        @param wireRate       The wire rate of the MIDI output in bytes per second, or 0 for an unthrottled output
+        @param measure        The compiled tracks to fill with the events (any previous contents are cleared)
+    */
+    void compile(const GriddleProjectData& projectData, const double sampleRate, const double wireRate, GriddleCompiledMeasure& measure);
+
+    /** Gets the number of times a track's compiled notes were found in the cache */
+    int64 getTrackCacheHits() const;
+
+    /** Gets the number of times a track had to be compiled because it wasn't in the cache */
+    int64 getTrackCacheMisses() const;
+
+    /** The maximum number of compiled tracks kept in the cache */
+    static constexpr int TRACK_CACHE_CAPACITY = 64;
+
+private:
+    //==============================================================================
+    /** A MIDI event compiled from the sequence, laid out at the project tempo, along with the scheduling
+        priority used when several events compete for the wire at the same time (lower values go first)
+        and its place on the tick timeline */
+    struct CompiledEvent
+    {
+        int samplePosition;
+        int priority;
+        MidiMessage message;
+        int64 tick;
+        int64 gateTicks;
+        int timelineSamplePosition;
+        int trackIndex;
+        int noteIndex;
+        int64 noteTicks;
+        int trigIndex;
+    };
+
+    // The events of the tracks with one-measure cycles, which are laid out together to find bursts on the wire,
+    // and the events of the free-running tracks
+    std::vector<CompiledEvent> compiledEvents_;
+    std::vector<CompiledEvent> freeRunningEvents_;
+    //==============================================================================
+
+    //==============================================================================
+    /** A note of a compiled track, positioned in ticks from the start of the track's cycle */
+    struct TrackNote
+    {
+        int noteIndex;
+        int64 startTick;
+        int64 gateTicks;
+        int noteNumber;
+        int velocity;
+        int trigIndex;
+    };
+
+    /** The settings a track's compiled notes depend on, laid out without padding so it can be hashed and compared as bytes */
+    struct TrackCompileKey
+    {
+        // Each step's note, velocity, gate, probability, ratchets, trig condition and chord
+        static constexpr int VALUES_PER_STEP = 7 + ((GriddleStepData::MAX_CHORD_NOTES - 1) * 2);
+
+        int numSteps;
+        int flags;
+        int clockRateNumerator;
+        int clockRateDenominator;
+        std::array<int, GriddleTrackData::NUM_STEPS * VALUES_PER_STEP> stepValues;
+    };
+
+    /** A track's compiled notes and trigs for one cycle along with the key they were compiled from */
+    struct CompiledTrack
+    {
+        uint64 hash;
+        TrackCompileKey key;
+        int64 cycleTicks;
+        int64 noteTicks;
+        std::vector<TrackNote> notes;
+        std::vector<GriddleCompiledTrig> trigs;
+    };
+
+    // Track Cache Variables (the most recently used track is at the front)
+    std::list<CompiledTrack> trackCache_;
+    int64 trackCacheHits_;
+    int64 trackCacheMisses_;
+    //==============================================================================
+
+    /** Gets a track's compiled notes from the cache, compiling them if they aren't there
+
+        @param track    The track to compile
+        @returns        The cached compiled track, which stays valid until the next call
+    */
+    const CompiledTrack& getCompiledTrack(const GriddleTrackData& track);
+
+    /** Compiles a track's notes and trigs for one cycle onto the tick timeline
+
+        @param track            The track to compile
+        @param compiledTrack    The compiled track to fill with the track's cycle, notes and trigs (any previous ones are cleared)
+    */
+    static void compileTrack(const GriddleTrackData& track, CompiledTrack& compiledTrack);
+
+    /** Adds a track's compiled notes to a list of events, laid out at the project tempo
+
+        @param compiledTrack    The track's compiled notes
+        @param track            The track's settings
+        @param trackIndex       The index of the track in the project
+        @param tempo            The project tempo in BPM
+        @param sampleRate       The sample rate to lay the events out at
+        @param events           The list of events to add the track's events to
+    */
+    static void addTrackEvents(const CompiledTrack& compiledTrack, const GriddleTrackData& track, const int trackIndex,
+                               const double tempo, const double sampleRate, std::vector<CompiledEvent>& events);
+
+    /** Orders a list of events by position, and by priority for events at the same position
+
+        @param events    The list of events to order
+    */
+    static void sortEvents(std::vector<CompiledEvent>& events);
+
+    /**  Estimates how far ahead of their places on the timeline the scheduler sends events to spread their bursts
+
+        Bursts of the one-measure cycles' events that would queue up on the MIDI output's wire are spread the way
+        the scheduler spreads them (see GriddleScheduler): sent back to back in order of position, with the events
+        at the same position in priority order, and centred on their nominal time, which sends the first events of
+        a burst early by up to half of the burst's wire time.
+
+        @param sampleRate    The sample rate of the events' sample positions
+        @param wireRate      The wire rate of the MIDI output in bytes per second
+        @returns             The most any event is sent ahead of its place on the timeline, in seconds
+    */
+    double getBurstLookAheadSeconds(const double sampleRate, const double wireRate) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleMeasureCompiler)
+};
+
+//==============================================================================
+// Inline Getter Definitions
+inline int64 GriddleMeasureCompiler::getTrackCacheHits() const
+{
+    return trackCacheHits_;
+}
+
+inline int64 GriddleMeasureCompiler::getTrackCacheMisses() const
+{
+    return trackCacheMisses_;
+}
@@ -0,0 +1,266 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleOutputEncoder.cpp
+    Created: 19 Oct 2026 9:12:41am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleOutputEncoder.h"
+
+constexpr double GriddleOutputEncoder::DIN_BYTES_PER_SECOND;
+
+//==============================================================================
+GriddleOutputEncoder::GriddleOutputEncoder()
+    : runningStatus_(0)
+    , wireRate_(DIN_BYTES_PER_SECOND)
+    , wireBusyUntil_(0.0)
+    , numSoundingNotes_(0)
+    , measureBytes_(0)
+    , measureMessages_(0)
+    , measureDropped_(0)
+    , measureEventsTimed_(0)
+    , measureMaxLateness_(0.0)
+    , measureTotalLateness_(0.0)
+    , lastEventLateness_(0.0)
+    , lastMeasureBytes_(0)
+    , lastMeasureMessages_(0)
+    , lastMeasureDropped_(0)
+    , lastMeasureEventsTimed_(0)
+    , lastMeasureMaxLateness_(0.0)
+    , lastMeasureTotalLateness_(0.0)
+    , lastMeasureLengthSeconds_(0.0)
+{
+    resetWireState();
+}
+
+GriddleOutputEncoder::~GriddleOutputEncoder()
+{
+}
+
+void GriddleOutputEncoder::setOutputPort(std::unique_ptr<GriddleOutputPort> outputPort)
+{
+    // Don't leave any notes hanging on the port being replaced
+    releaseAllNotes();
+
+    outputPort_ = std::move(outputPort);
+
+    // The new port starts with no status byte on the wire and no sounding notes
+    resetWireState();
+}
+
+bool GriddleOutputEncoder::sendMessageNow(const MidiMessage& message, const double scheduledTime, const double nominalTime)
+{
+    // A message without a nominal time is measured against its scheduled time
+    auto latenessTime = (nominalTime > 0.0) ? nominalTime : scheduledTime;
+
+    if (message.isNoteOn())
+    {
+        auto& activeCount = activeNoteCounts_[message.getChannel() - 1][message.getNoteNumber()];
+
+        if (activeCount == 0)
+            ++numSoundingNotes_;
+
+        if (activeCount < 255)
+            ++activeCount;
+
+        transmit(message, scheduledTime, latenessTime);
+    }
+    else if (message.isNoteOff())
+    {
+        // isNoteOff() is also true for zero-velocity NOTE ONs, so both forms are handled here
+        auto& activeCount = activeNoteCounts_[message.getChannel() - 1][message.getNoteNumber()];
+
+        // A NOTE OFF for a note that isn't sounding has no effect on the synth, and one for a note that
+        // was triggered again since (e.g. two tracks on the same channel playing the same note) would cut
+        // the newer note short, so only the NOTE OFF matching the last sounding NOTE ON is sent
+        if (activeCount == 0)
+        {
+            ++measureDropped_;
+            return false;
+        }
+
+        if (--activeCount > 0)
+        {
+            ++measureDropped_;
+            return false;
+        }
+
+        --numSoundingNotes_;
+
+        // Send the NOTE OFF as a zero-velocity NOTE ON so it can share the NOTE ON running status
+        transmit(MidiMessage::noteOn(message.getChannel(), message.getNoteNumber(), static_cast<uint8>(0)), scheduledTime, latenessTime);
+    }
+    else
+    {
+        transmit(message, scheduledTime, latenessTime);
+    }
+
+    return true;
+}
+
+void GriddleOutputEncoder::releaseAllNotes(const double scheduledTime)
+{
+    for (auto channelIndex = 0; (channelIndex < 16) && (numSoundingNotes_ > 0); ++channelIndex)
+    {
+        for (auto noteNumber = 0; noteNumber < 128; ++noteNumber)
+        {
+            if (activeNoteCounts_[channelIndex][noteNumber] > 0)
+            {
+                activeNoteCounts_[channelIndex][noteNumber] = 0;
+                --numSoundingNotes_;
+
+                transmit(MidiMessage::noteOn(channelIndex + 1, noteNumber, static_cast<uint8>(0)), scheduledTime, scheduledTime);
+            }
+        }
+    }
+}
+
+void GriddleOutputEncoder::startMeasure(const double measureLengthSeconds)
+{
+    // Publish the counts for the finished measure for other threads to read, then start counting again
+    lastMeasureBytes_ = measureBytes_;
+    lastMeasureMessages_ = measureMessages_;
+    lastMeasureDropped_ = measureDropped_;
+    lastMeasureEventsTimed_ = measureEventsTimed_;
+    lastMeasureMaxLateness_ = measureMaxLateness_;
+    lastMeasureTotalLateness_ = measureTotalLateness_;
+    lastMeasureLengthSeconds_ = measureLengthSeconds;
+
+    measureBytes_ = 0;
+    measureMessages_ = 0;
+    measureDropped_ = 0;
+    measureEventsTimed_ = 0;
+    measureMaxLateness_ = 0.0;
+    measureTotalLateness_ = 0.0;
+}
+
+GriddleOutputEncoder::MeasureStats GriddleOutputEncoder::getLastMeasureStats() const
+{
+    MeasureStats stats;
+    stats.bytesSent = lastMeasureBytes_;
+    stats.messagesSent = lastMeasureMessages_;
+    stats.messagesDropped = lastMeasureDropped_;
+
+    double measureLengthSeconds = lastMeasureLengthSeconds_;
+    if (measureLengthSeconds > 0.0)
+        stats.bytesPerSecond = stats.bytesSent / measureLengthSeconds;
+
+    stats.wireTimeMs = getWireTimeSeconds(stats.bytesSent, wireRate_) * 1000.0;
+
+    stats.eventsTimed = lastMeasureEventsTimed_;
+    if (stats.eventsTimed > 0)
+    {
+        stats.maxLatenessMs = lastMeasureMaxLateness_ * 1000.0;
+        stats.meanLatenessMs = (lastMeasureTotalLateness_ / stats.eventsTimed) * 1000.0;
+    }
+
+    return stats;
+}
+
+uint8 GriddleOutputEncoder::getEncodedStatusByte(const MidiMessage& message)
+{
+    auto statusByte = message.getRawData()[0];
+
+    if (message.isNoteOff(false))
+        statusByte = static_cast<uint8>(0x90 | (statusByte & 0x0f));
+
+    return statusByte;
+}
+
+int GriddleOutputEncoder::getWireByteCount(const MidiMessage& message, const uint8 runningStatus)
+{
+    auto numBytes = message.getRawDataSize();
+    auto statusByte = getEncodedStatusByte(message);
+
+    // Channel voice messages with the same status byte as the previous message are sent without it
+    if ((statusByte >= 0x80) && (statusByte < 0xf0) && (statusByte == runningStatus))
+        --numBytes;
+
+    return numBytes;
+}
+
+double GriddleOutputEncoder::getWireTimeSeconds(const int numBytes, const double bytesPerSecond)
+{
+    if (bytesPerSecond <= 0.0)
+        return 0.0;
+
+    return numBytes / bytesPerSecond;
+}
+
+void GriddleOutputEncoder::transmit(const MidiMessage& message, const double scheduledTime, const double nominalTime)
+{
+    if (outputPort_ == nullptr)
+        return;
+
+    outputPort_->sendMessage(message, scheduledTime);
+
+    auto numBytes = getWireByteCount(message, runningStatus_);
+    measureBytes_ += numBytes;
+    ++measureMessages_;
+
+    // Model the port's transmit queue: the message starts going out once it's due (ports that schedule
+    // ahead hold it until then) and everything sent before it has cleared the wire, and it has arrived
+    // once its own bytes are through
+    auto sendTime = jmax(Time::getMillisecondCounterHiRes() * 0.001, scheduledTime);
+    wireBusyUntil_ = jmax(sendTime, wireBusyUntil_) + getWireTimeSeconds(numBytes, wireRate_);
+
+    // Lateness is measured against where the message belongs rather than when it was scheduled to go out, so an
+    // event sent early or late to spread its burst on the wire counts by how far it actually ended up off the timeline
+    if (nominalTime > 0.0)
+    {
+        auto lateness = wireBusyUntil_ - nominalTime;
+        lastEventLateness_ = lateness;
+
+        if ((measureEventsTimed_ == 0) || (lateness > measureMaxLateness_))
+            measureMaxLateness_ = lateness;
+
+        measureTotalLateness_ += lateness;
+        ++measureEventsTimed_;
+    }
+
+    // Channel voice messages set the running status, system common messages cancel it and
+    // system real-time messages (0xf8 and up) can be interleaved without affecting it
+    auto statusByte = message.getRawData()[0];
+    if (statusByte < 0xf0)
+        runningStatus_ = statusByte;
+    else if (statusByte < 0xf8)
+        runningStatus_ = 0;
+}
+
+void GriddleOutputEncoder::resetWireState()
+{
+    runningStatus_ = 0;
+    wireBusyUntil_ = 0.0;
+
+    for (auto& channelNotes : activeNoteCounts_)
+        channelNotes.fill(0);
+
+    numSoundingNotes_ = 0;
+}
@@ -0,0 +1,275 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleOutputEncoder.h
+    Created: 19 Oct 2026 9:12:41am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include "GriddleOutputPort.h"
+
+//==============================================================================
+/*
+    This class is the final stage between the sequencer and the MIDI output port.
+
+    Every outgoing message passes through the encoder, which keeps the byte stream
+    as small as possible for slow serial (DIN) MIDI ports:
+
+    - NOTE OFFs are sent as NOTE ONs with a velocity of 0, so consecutive note
+      messages on a channel share a status byte and the port can use running status
+    - NOTE OFFs for notes that aren't sounding are dropped
+
+    An active-note table counts the NOTE ONs sounding for each channel and note of the
+    output port. Only the NOTE OFF that ends the last of them is sent, so a NOTE OFF
+    arriving late (e.g. from the previous measure or another track on the same channel)
+    can't cut off a note that was triggered again. The table also lets the encoder
+    release exactly the notes that are still sounding when playback stops or the port
+    changes, rather than sending ALL NOTES OFF on every channel.
+
+    The encoder also models the bytes that actually go over the wire (with running
+    status applied) and the queue of bytes waiting on a port with a limited wire rate.
+    It reports the load of each measure in bytes/sec and wire time, along with how
+    late each event arrived at the end of the wire compared to its nominal time (its
+    place on the timeline plus its track's latency offset, before any spreading of its
+    burst), and the lateness of each event can be read back as it's sent.
+*/
+class GriddleOutputEncoder
+{
+public:
+    //==============================================================================
+    GriddleOutputEncoder();
+    ~GriddleOutputEncoder();
+    //==============================================================================
+
+    /** The transmission rate of a standard 31.25 kbaud DIN MIDI port in bytes per second (10 bits per byte) */
+    static constexpr double DIN_BYTES_PER_SECOND = 3125.0;
+
+    /** Wire statistics for one complete measure of playback */
+    struct MeasureStats
+    {
+        int bytesSent = 0;
+        int messagesSent = 0;
+        int messagesDropped = 0;
+        double bytesPerSecond = 0.0;
+        double wireTimeMs = 0.0;
+        int eventsTimed = 0;
+        double maxLatenessMs = 0.0;
+        double meanLatenessMs = 0.0;
+    };
+
+    /** Sets the MIDI output port that encoded messages are sent to
+
+        Any notes still sounding on the previous port are released first.
+
+        @param outputPort    The opened MIDI output port (may be nullptr for no output)
+    */
+    void setOutputPort(std::unique_ptr<GriddleOutputPort> outputPort);
+
+    /** Checks whether there is an output port to send messages to
+
+        @returns    true if an output port is set, otherwise false
+    */
+    bool hasOutputPort() const;
+
+    /** Gets how far ahead of their scheduled times messages can be handed to the output port
+
+        @returns    The schedule-ahead time of the output port in seconds, or 0 if it sends messages immediately
+    */
+    double getScheduleAheadSeconds() const;
+
+    /** Sets the rate at which the output device can put bytes on the wire
+
+        @param bytesPerSecond    The wire rate in bytes per second, or 0 for a port that is effectively
+                                 unthrottled (USB or virtual ports)
+    */
+    void setWireRate(const double bytesPerSecond);
+
+    /** Gets the rate at which the output device can put bytes on the wire
+
+        @returns    The wire rate in bytes per second (0 if the port is unthrottled)
+    */
+    double getWireRate() const;
+
+    /** Encodes a message and hands it to the output port immediately
+
+        NOTE OFFs are converted to zero-velocity NOTE ONs and redundant messages are dropped.
+        Ports that schedule ahead send the message at its scheduled time, others send it straight away.
+
+        @param message          The MIDI message to send
+        @param scheduledTime    The time (in seconds on the Time::getMillisecondCounterHiRes() clock) at which
+                                the message was scheduled to go out. Pass 0 for messages that aren't part of
+                                the sequence timeline (e.g. note previews).
+        @param nominalTime      The time the message belongs at on the timeline, which its lateness is measured
+                                against, or 0 if that's its scheduled time. Spreading a burst of events on the
+                                wire schedules them around their nominal time.
+        @returns                true if the message was sent, or false if it was dropped
+    */
+    bool sendMessageNow(const MidiMessage& message, const double scheduledTime = 0.0, const double nominalTime = 0.0);
+
+    /** Gets how late the last timed message sent arrived at the end of the wire
+
+        @returns    The time in seconds from the message's nominal time to the time its last byte was through
+                    (negative if it arrived early)
+    */
+    double getLastEventLateness() const;
+
+    /** Sends a NOTE OFF for every note in the active-note table, leaving the output port silent
+
+        @param scheduledTime    The time at which the NOTE OFFs should go out (0 for now). Ports that schedule
+                                ahead may have NOTE ONs queued, so this should be after the last of them.
+    */
+    void releaseAllNotes(const double scheduledTime = 0.0);
+
+    /** Gets the number of notes in the active-note table
+
+        @returns    The number of channel and note number pairs that are currently sounding
+    */
+    int getNumSoundingNotes() const;
+
+    /** Closes the wire statistics for the measure that just finished and starts counting the next one
+
+        @param measureLengthSeconds    The length in seconds of the measure that just finished
+    */
+    void startMeasure(const double measureLengthSeconds);
+
+    /** Gets the wire statistics for the last complete measure
+
+        This can be safely called from a different thread than the one sending messages.
+
+        @returns    The statistics of the last complete measure
+    */
+    MeasureStats getLastMeasureStats() const;
+
+    /** Gets the status byte a message is sent with once encoded (NOTE OFFs become zero-velocity NOTE ONs)
+
+        @param message    The MIDI message to be encoded
+        @returns          The status byte of the encoded message
+    */
+    static uint8 getEncodedStatusByte(const MidiMessage& message);
+
+    /** Calculates the number of bytes a message takes on the wire once encoded, given the running status before it
+
+        @param message          The MIDI message to measure
+        @param runningStatus    The status byte currently in effect on the wire (0 for none)
+        @returns                The number of bytes transmitted for the message
+    */
+    static int getWireByteCount(const MidiMessage& message, const uint8 runningStatus);
+
+    /** Calculates the time a number of bytes takes to go over the wire
+
+        @param numBytes          The number of bytes to transmit
+        @param bytesPerSecond    The wire rate in bytes per second (0 for an unthrottled port)
+        @returns                 The wire time in seconds
+    */
+    static double getWireTimeSeconds(const int numBytes, const double bytesPerSecond);
+
+private:
+    //==============================================================================
+    // Output Variables
+    std::unique_ptr<GriddleOutputPort> outputPort_;
+    uint8 runningStatus_;
+    double wireRate_;
+    double wireBusyUntil_;
+    //==============================================================================
+
+    //==============================================================================
+    // Active-Note Table Variables
+    //
+    // activeNoteCounts_ holds the number of NOTE ONs without a matching NOTE OFF for
+    // each note number of each channel, and numSoundingNotes_ the number of non-zero counts
+    std::array<std::array<uint8, 128>, 16> activeNoteCounts_;
+    int numSoundingNotes_;
+    //==============================================================================
+
+    //==============================================================================
+    // Wire Statistics Variables
+    int measureBytes_;
+    int measureMessages_;
+    int measureDropped_;
+    int measureEventsTimed_;
+    double measureMaxLateness_;
+    double measureTotalLateness_;
+    double lastEventLateness_;
+    std::atomic<int> lastMeasureBytes_;
+    std::atomic<int> lastMeasureMessages_;
+    std::atomic<int> lastMeasureDropped_;
+    std::atomic<int> lastMeasureEventsTimed_;
+    std::atomic<double> lastMeasureMaxLateness_;
+    std::atomic<double> lastMeasureTotalLateness_;
+    std::atomic<double> lastMeasureLengthSeconds_;
+    //==============================================================================
+
+    /** Writes a message to the output port and accumulates its wire statistics
+
+        @param message          The MIDI message to write
+        @param scheduledTime    The time the message was scheduled to go out (0 if it isn't timed)
+        @param nominalTime      The time its lateness is measured against (0 if it isn't timed)
+    */
+    void transmit(const MidiMessage& message, const double scheduledTime, const double nominalTime);
+
+    /** Clears the running status and the active-note table */
+    void resetWireState();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleOutputEncoder)
+};
+
+inline bool GriddleOutputEncoder::hasOutputPort() const
+{
+    return (outputPort_ != nullptr);
+}
+
+inline double GriddleOutputEncoder::getLastEventLateness() const
+{
+    return lastEventLateness_;
+}
+
+inline int GriddleOutputEncoder::getNumSoundingNotes() const
+{
+    return numSoundingNotes_;
+}
+
+inline double GriddleOutputEncoder::getScheduleAheadSeconds() const
+{
+    return ((outputPort_ != nullptr) ? outputPort_->getScheduleAheadSeconds() : 0.0);
+}
+
+inline void GriddleOutputEncoder::setWireRate(const double bytesPerSecond)
+{
+    wireRate_ = bytesPerSecond;
+}
+
+inline double GriddleOutputEncoder::getWireRate() const
+{
+    return wireRate_;
+}
@@ -0,0 +1,66 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleOutputPort.cpp
+    Created: 19 Oct 2026 2:48:15pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleOutputPort.h"
+
+//==============================================================================
+double GriddleOutputPort::getScheduleAheadSeconds() const
+{
+    return 0.0;
+}
+
+//==============================================================================
+GriddleMidiOutputPort::GriddleMidiOutputPort(std::unique_ptr<MidiOutput> midiOutput)
+    : midiOutput_(std::move(midiOutput))
+{
+}
+
+GriddleMidiOutputPort::~GriddleMidiOutputPort()
+{
+}
+
+std::unique_ptr<GriddleOutputPort> GriddleMidiOutputPort::openDevice(const String& identifier)
+{
+    auto midiOutput = MidiOutput::openDevice(identifier);
+
+    if (midiOutput == nullptr)
+        return nullptr;
+
+    return std::unique_ptr<GriddleOutputPort>(new GriddleMidiOutputPort(std::move(midiOutput)));
+}
+
+void GriddleMidiOutputPort::sendMessage(const MidiMessage& message, const double)
+{
+    midiOutput_->sendMessageNow(message);
+}
@@ -0,0 +1,99 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleOutputPort.h
+    Created: 19 Oct 2026 2:48:15pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    This is the base class for the ports the output encoder sends MIDI messages to.
+
+    A port either sends each message as soon as it's handed over, or it can accept
+    messages ahead of time along with the time they should go out, in which case
+    the port (or the OS behind it) does the timing.
+*/
+class GriddleOutputPort
+{
+public:
+    //==============================================================================
+    virtual ~GriddleOutputPort() {}
+    //==============================================================================
+
+    /** Sends a message to the port
+
+        @param message      The MIDI message to send
+        @param timestamp    The time (in seconds on the Time::getMillisecondCounterHiRes() clock) at which the
+                            message should go out. Ports that don't schedule ahead send it immediately, as do
+                            scheduling ports when the time is 0 or has already passed.
+    */
+    virtual void sendMessage(const MidiMessage& message, const double timestamp) = 0;
+
+    /** Gets how far ahead of their send times messages can be handed to the port
+
+        @returns    The schedule-ahead time in seconds, or 0 if the port sends messages immediately
+    */
+    virtual double getScheduleAheadSeconds() const;
+};
+
+//==============================================================================
+/*
+    This class is a GriddleOutputPort for a JUCE MidiOutput device, which sends
+    each message immediately.
+*/
+class GriddleMidiOutputPort : public GriddleOutputPort
+{
+public:
+    //==============================================================================
+    GriddleMidiOutputPort(std::unique_ptr<MidiOutput> midiOutput);
+    ~GriddleMidiOutputPort();
+    //==============================================================================
+
+    /** Opens the MIDI output device with the passed-in identifier
+
+        @param identifier    The identifier of the MIDI output device (from MidiOutput::getAvailableDevices())
+        @returns             The opened port, or nullptr if the device couldn't be opened
+    */
+    static std::unique_ptr<GriddleOutputPort> openDevice(const String& identifier);
+
+    /** Sends a message to the MIDI output device immediately
+
+        This is an override of the GriddleOutputPort method.
+    */
+    void sendMessage(const MidiMessage& message, const double timestamp) override;
+
+private:
+    std::unique_ptr<MidiOutput> midiOutput_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleMidiOutputPort)
+};
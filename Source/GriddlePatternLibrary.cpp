@@ -0,0 +1,224 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddlePatternLibrary.cpp
+    Created: 19 Oct 2026 6:07:33pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddlePatternLibrary.h"
+#include "GriddleProjectFile.h"
+
+constexpr int GriddlePatternLibrary::CACHE_CAPACITY;
+const char* const GriddlePatternLibrary::INDEX_FILE_NAME = "library.griddleindex";
+
+//==============================================================================
+GriddlePatternLibrary::GriddlePatternLibrary()
+{
+}
+
+GriddlePatternLibrary::~GriddlePatternLibrary()
+{
+}
+
+Result GriddlePatternLibrary::openDirectory(const File& directory)
+{
+    if (! directory.isDirectory())
+        return Result::fail(directory.getFullPathName() + " is not a directory");
+
+    close();
+    directory_ = directory;
+
+    // Entries from the saved index are reused for files that haven't been modified since they were indexed
+    std::map<String, IndexEntry> savedEntries;
+    readIndexFile(savedEntries);
+
+    auto patternFiles = directory_.findChildFiles(File::findFiles, false, "*.griddlebin");
+    std::sort(patternFiles.begin(), patternFiles.end());
+
+    auto indexChanged = (savedEntries.size() != static_cast<size_t>(patternFiles.size()));
+
+    for (const auto& patternFile : patternFiles)
+    {
+        auto savedEntry = savedEntries.find(patternFile.getFileName());
+
+        if ((savedEntry != savedEntries.end()) && (savedEntry->second.modificationTime == patternFile.getLastModificationTime().toMilliseconds()))
+        {
+            index_.push_back(savedEntry->second);
+            index_.back().file = patternFile;
+            continue;
+        }
+
+        IndexEntry entry;
+        if (indexPatternFile(patternFile, entry))
+            index_.push_back(entry);
+
+        indexChanged = true;
+    }
+
+    if (indexChanged)
+        writeIndexFile();
+
+    return Result::ok();
+}
+
+void GriddlePatternLibrary::close()
+{
+    directory_ = File();
+    index_.clear();
+
+    const ScopedLock lock(cacheLock_);
+    cache_.clear();
+}
+
+bool GriddlePatternLibrary::getCompiledPattern(const IndexEntry& entry, const double sampleRate, const double wireRate, CompiledPattern& pattern)
+{
+    // The pattern is loaded and compiled into a scratch copy, and the cache is only locked to look it up and to
+    // insert it, so fetching a cached pattern is never held up by another pattern being loaded and compiled
+    CompiledPattern compiledPattern;
+    auto isCached = false;
+
+    {
+        const ScopedLock lock(cacheLock_);
+
+        // Look the pattern up in the cache, moving it to the front as the most recently used
+        for (auto cacheIt = cache_.begin(); cacheIt != cache_.end(); ++cacheIt)
+        {
+            if (cacheIt->hash == entry.hash)
+            {
+                cache_.splice(cache_.begin(), cache_, cacheIt);
+
+                // The compiled events depend on the sample rate and wire rate, so recompile if either has changed
+                const auto& cachedPattern = cache_.front();
+                if ((cachedPattern.sampleRate == sampleRate) && (cachedPattern.wireRate == wireRate))
+                {
+                    pattern = cachedPattern;
+                    return true;
+                }
+
+                compiledPattern.projectData = cachedPattern.projectData;
+                isCached = true;
+                break;
+            }
+        }
+    }
+
+    // A failed load leaves the cache as it was
+    if (! isCached && GriddleProjectFile::loadBinary(entry.file, compiledPattern.projectData).failed())
+        return false;
+
+    compiledPattern.hash = entry.hash;
+    compiledPattern.sampleRate = sampleRate;
+    compiledPattern.wireRate = wireRate;
+
+    {
+        const ScopedLock lock(compilerLock_);
+        compiler_.compile(compiledPattern.projectData, sampleRate, wireRate, compiledPattern.measure);
+    }
+
+    const ScopedLock lock(cacheLock_);
+
+    // Another thread may have cached the pattern in the meantime, in which case its entry is replaced. Otherwise, when
+    // the cache is full, the least recently used pattern's storage is reused for the new pattern.
+    auto cacheIt = std::find_if(cache_.begin(), cache_.end(), [&entry](const CompiledPattern& cachedPattern) { return cachedPattern.hash == entry.hash; });
+
+    if (cacheIt != cache_.end())
+        cache_.splice(cache_.begin(), cache_, cacheIt);
+    else if (cache_.size() >= static_cast<size_t>(CACHE_CAPACITY))
+        cache_.splice(cache_.begin(), cache_, std::prev(cache_.end()));
+    else
+        cache_.emplace_front();
+
+    cache_.front() = compiledPattern;
+
+    pattern = compiledPattern;
+    return true;
+}
+
+bool GriddlePatternLibrary::indexPatternFile(const File& patternFile, IndexEntry& entry)
+{
+    MemoryMappedFile mappedFile(patternFile, MemoryMappedFile::readOnly);
+
+    if (mappedFile.getData() == nullptr)
+        return false;
+
+    GriddleProjectData projectData;
+    if (GriddleProjectFile::readBinary(mappedFile.getData(), mappedFile.getSize(), projectData).failed())
+        return false;
+
+    entry.name = patternFile.getFileNameWithoutExtension();
+    entry.file = patternFile;
+    entry.modificationTime = patternFile.getLastModificationTime().toMilliseconds();
+    entry.tempo = projectData.tempo;
+    entry.numTracks = static_cast<int>(std::count_if(projectData.tracks.begin(), projectData.tracks.end(), [](const GriddleTrackData& track) { return track.isActive; }));
+    entry.hash = GriddleProjectFile::hashData(mappedFile.getData(), mappedFile.getSize());
+
+    return true;
+}
+
+void GriddlePatternLibrary::readIndexFile(std::map<String, IndexEntry>& savedEntries) const
+{
+    auto indexData = JSON::parse(directory_.getChildFile(INDEX_FILE_NAME));
+
+    if (! indexData.isArray())
+        return;
+
+    for (const auto& savedEntry : *indexData.getArray())
+    {
+        IndexEntry entry;
+        entry.name = savedEntry.getProperty("name", String()).toString();
+        entry.modificationTime = static_cast<int64>(savedEntry.getProperty("modified", 0));
+        entry.tempo = static_cast<double>(savedEntry.getProperty("tempo", 120.0));
+        entry.numTracks = static_cast<int>(savedEntry.getProperty("tracks", 0));
+        entry.hash = static_cast<uint64>(savedEntry.getProperty("hash", String()).toString().getHexValue64());
+
+        savedEntries[savedEntry.getProperty("file", String()).toString()] = entry;
+    }
+}
+
+void GriddlePatternLibrary::writeIndexFile() const
+{
+    var indexData;
+
+    for (const auto& entry : index_)
+    {
+        DynamicObject::Ptr savedEntry = new DynamicObject();
+        savedEntry->setProperty("file", entry.file.getFileName());
+        savedEntry->setProperty("name", entry.name);
+        savedEntry->setProperty("modified", entry.modificationTime);
+        savedEntry->setProperty("tempo", entry.tempo);
+        savedEntry->setProperty("tracks", entry.numTracks);
+        savedEntry->setProperty("hash", String::toHexString(static_cast<int64>(entry.hash)));
+
+        indexData.append(var(savedEntry.get()));
+    }
+
+    // The index is only a cache of what's in the pattern files, so a failed write just means it's rebuilt next time
+    directory_.getChildFile(INDEX_FILE_NAME).replaceWithText(JSON::toString(indexData));
+}
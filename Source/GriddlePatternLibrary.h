@@ -0,0 +1,179 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddlePatternLibrary.h
+    Created: 19 Oct 2026 6:07:33pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <list>
+#include <vector>
+#include "GriddleProjectData.h"
+#include "GriddleMeasureCompiler.h"
+
+//==============================================================================
+/*
+    This class manages a pattern library: a directory of binary project files (.griddlebin)
+    that can be switched between quickly.
+
+    Opening a library builds an index of its patterns (name, tempo, track count and a hash
+    of the file contents), which is saved in the directory so files that haven't changed
+    since the last time don't need to be read again. Patterns are only loaded and compiled
+    when they're first requested, and the compiled measures of the most recently used
+    patterns are kept in an LRU cache, so switching back to one of them is just a lookup.
+
+    The index is only changed on the message thread, but compiled patterns can be fetched
+    from a background thread, so loading and compiling never hold up the GUI.
+*/
+class GriddlePatternLibrary
+{
+public:
+    //==============================================================================
+    GriddlePatternLibrary();
+    ~GriddlePatternLibrary();
+    //==============================================================================
+
+    /** An entry in the library's index */
+    struct IndexEntry
+    {
+        String name;
+        File file;
+        int64 modificationTime;
+        double tempo;
+        int numTracks;
+        uint64 hash;
+    };
+
+    /** A pattern compiled into the MIDI events for one measure */
+    struct CompiledPattern
+    {
+        uint64 hash;
+        GriddleProjectData projectData;
+        GriddleCompiledMeasure measure;
+        double sampleRate;
+        double wireRate;
+    };
+
+    /** Opens a directory as the pattern library, indexing the binary project files it contains
+
+        Files that aren't valid binary project files are left out of the index.
+
+        @param directory    The directory to open
+        @returns            Result::ok() if the directory was opened, or a failed Result describing the error
+    */
+    Result openDirectory(const File& directory);
+
+    /** Closes the library, clearing the index and the cache */
+    void close();
+
+    /** Gets the compiled measure for a pattern, loading and compiling it if it isn't in the cache
+
+        This is safe to call from any thread. The index entry is passed by value rather than
+        by index, so the library can be re-opened while a pattern is being fetched.
+
+        @param entry         The index entry of the pattern
+        @param sampleRate    The sample rate to compile the pattern at
+        @param wireRate      The wire rate of the MIDI output in bytes per second, or 0 for an unthrottled output
+        @param pattern       Populated with a copy of the compiled pattern
+        @returns             true if the pattern was compiled, or false if the pattern file couldn't be loaded
+    */
+    bool getCompiledPattern(const IndexEntry& entry, const double sampleRate, const double wireRate, CompiledPattern& pattern);
+
+    /** Gets the directory of the open library */
+    const File& getDirectory() const;
+
+    /** Gets the number of patterns in the library */
+    int getNumPatterns() const;
+
+    /** Gets the index entry for a pattern */
+    const IndexEntry& getIndexEntry(const int index) const;
+
+    /** The maximum number of compiled patterns kept in the cache */
+    static constexpr int CACHE_CAPACITY = 16;
+
+    /** The name of the index file saved in the library directory */
+    static const char* const INDEX_FILE_NAME;
+
+private:
+    //==============================================================================
+    // Index Variables
+    File directory_;
+    std::vector<IndexEntry> index_;
+    //==============================================================================
+
+    //==============================================================================
+    // Cache Variables (the most recently used pattern is at the front)
+    //
+    // The cache and compiler are used from the pattern loading thread, so they're protected by locks. The cache lock
+    // is only held to look patterns up and insert them, never while a pattern is being loaded or compiled.
+    CriticalSection cacheLock_;
+    std::list<CompiledPattern> cache_;
+    CriticalSection compilerLock_;
+    GriddleMeasureCompiler compiler_;
+    //==============================================================================
+
+    /** Reads a pattern file to create its index entry
+
+        @param patternFile    The binary project file to index
+        @param entry          The index entry to populate
+        @returns              true if the file is a valid binary project file, otherwise false
+    */
+    static bool indexPatternFile(const File& patternFile, IndexEntry& entry);
+
+    /** Reads the index file saved in the library directory
+
+        @param savedEntries    Populated with the saved index entries, keyed by file name
+    */
+    void readIndexFile(std::map<String, IndexEntry>& savedEntries) const;
+
+    /** Saves the index to the index file in the library directory */
+    void writeIndexFile() const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddlePatternLibrary)
+};
+
+//==============================================================================
+// Inline Getter Definitions
+inline const File& GriddlePatternLibrary::getDirectory() const
+{
+    return directory_;
+}
+
+inline int GriddlePatternLibrary::getNumPatterns() const
+{
+    return static_cast<int>(index_.size());
+}
+
+inline const GriddlePatternLibrary::IndexEntry& GriddlePatternLibrary::getIndexEntry(const int index) const
+{
+    return index_[static_cast<size_t>(index)];
+}
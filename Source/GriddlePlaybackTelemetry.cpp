@@ -0,0 +1,186 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddlePlaybackTelemetry.cpp
+    Created: 19 Oct 2026 9:48:20pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "GriddlePlaybackTelemetry.h"
+
+//==============================================================================
+constexpr int GriddlePlaybackTelemetry::Histogram::NUM_BINS;
+
+//==============================================================================
+GriddlePlaybackTelemetry::Histogram::Histogram(const String& name, const double binWidthMs)
+    : name_(name)
+    , binWidthMs_(binWidthMs)
+{
+    reset();
+}
+
+GriddlePlaybackTelemetry::Histogram::~Histogram()
+{
+}
+
+//==============================================================================
+void GriddlePlaybackTelemetry::Histogram::add(const double timeMs) noexcept
+{
+    auto clampedTimeMs = jmax(0.0, timeMs);
+    auto binIndex = jmin(NUM_BINS - 1, static_cast<int>(clampedTimeMs / binWidthMs_));
+
+    // There's only one writer, so each counter can be updated with a plain load and store rather than
+    // a locked read-modify-write, and readers only ever see whole values
+    auto& binCount = binCounts_[static_cast<size_t>(binIndex)];
+    binCount.store(binCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    totalCount_.store(totalCount_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totalMs_.store(totalMs_.load(std::memory_order_relaxed) + clampedTimeMs, std::memory_order_relaxed);
+
+    if (clampedTimeMs > maxMs_.load(std::memory_order_relaxed))
+        maxMs_.store(clampedTimeMs, std::memory_order_relaxed);
+}
+
+void GriddlePlaybackTelemetry::Histogram::reset() noexcept
+{
+    for (auto& binCount : binCounts_)
+        binCount.store(0, std::memory_order_relaxed);
+
+    totalCount_.store(0, std::memory_order_relaxed);
+    totalMs_.store(0.0, std::memory_order_relaxed);
+    maxMs_.store(0.0, std::memory_order_relaxed);
+}
+
+double GriddlePlaybackTelemetry::Histogram::getMeanMs() const
+{
+    auto totalCount = getTotalCount();
+
+    if (totalCount == 0)
+        return 0.0;
+
+    return totalMs_.load(std::memory_order_relaxed) / totalCount;
+}
+
+double GriddlePlaybackTelemetry::Histogram::getPercentileMs(const double percentile) const
+{
+    // Sum the bins rather than using the total count, since the playback thread may be adding to them
+    uint64 totalCount = 0;
+
+    for (auto binIndex = 0; binIndex < NUM_BINS; ++binIndex)
+        totalCount += getBinCount(binIndex);
+
+    if (totalCount == 0)
+        return 0.0;
+
+    auto rank = jmax(static_cast<uint64>(1), static_cast<uint64>(std::ceil(jlimit(0.0, 100.0, percentile) * 0.01 * totalCount)));
+    uint64 count = 0;
+
+    for (auto binIndex = 0; binIndex < NUM_BINS - 1; ++binIndex)
+    {
+        count += getBinCount(binIndex);
+
+        if (count >= rank)
+            return jmin((binIndex + 1) * binWidthMs_, getMaxMs());
+    }
+
+    return getMaxMs();
+}
+
+//==============================================================================
+GriddlePlaybackTelemetry::GriddlePlaybackTelemetry()
+    : enabled_(true)
+    , nextTimerCallbackTime_(0.0)
+    , eventLateness_("Event Lateness", 0.2)
+    , timerLateness_("Timer Lateness", 0.1)
+    , sendTime_("Send Time", 0.002)
+    , wireLateness_("Wire Lateness", 0.5)
+{
+}
+
+GriddlePlaybackTelemetry::~GriddlePlaybackTelemetry()
+{
+}
+
+//==============================================================================
+void GriddlePlaybackTelemetry::reset()
+{
+    nextTimerCallbackTime_ = 0.0;
+
+    eventLateness_.reset();
+    timerLateness_.reset();
+    sendTime_.reset();
+    wireLateness_.reset();
+}
+
+void GriddlePlaybackTelemetry::setEnabled(const bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void GriddlePlaybackTelemetry::recordTimerCallback(const double clockTime, const double intervalSeconds)
+{
+    if (nextTimerCallbackTime_ > 0.0)
+        timerLateness_.add((clockTime - nextTimerCallbackTime_) * 1000.0);
+
+    // The timer waits for each interval from when the last one was due, unless it has fallen a whole
+    // interval behind, in which case it starts again from now
+    nextTimerCallbackTime_ += intervalSeconds;
+
+    if (nextTimerCallbackTime_ <= clockTime)
+        nextTimerCallbackTime_ = clockTime + intervalSeconds;
+}
+
+void GriddlePlaybackTelemetry::recordEventSent(const double dueTime, const double sendStartTime, const double sendEndTime)
+{
+    eventLateness_.add((sendStartTime - dueTime) * 1000.0);
+    sendTime_.add((sendEndTime - sendStartTime) * 1000.0);
+}
+
+void GriddlePlaybackTelemetry::recordEventArrived(const double latenessSeconds)
+{
+    wireLateness_.add(latenessSeconds * 1000.0);
+}
+
+void GriddlePlaybackTelemetry::writeCsv(OutputStream& stream) const
+{
+    stream << "histogram,bin_start_ms,bin_end_ms,count" << newLine;
+
+    for (auto* histogram : { &eventLateness_, &timerLateness_, &sendTime_, &wireLateness_ })
+    {
+        for (auto binIndex = 0; binIndex < Histogram::NUM_BINS; ++binIndex)
+        {
+            auto binWidthMs = histogram->getBinWidthMs();
+
+            // The last bin has no upper edge, since it also counts every time past the end of the histogram
+            stream << histogram->getName() << ","
+                   << String(binIndex * binWidthMs, 3) << ","
+                   << ((binIndex < Histogram::NUM_BINS - 1) ? String((binIndex + 1) * binWidthMs, 3) : String()) << ","
+                   << String(histogram->getBinCount(binIndex)) << newLine;
+        }
+    }
+}
@@ -0,0 +1,247 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddlePlaybackTelemetry.h
+    Created: 19 Oct 2026 9:48:20pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/*
+    This class records how well the playback engine keeps time, so a sloppy sounding
+    performance can be traced to Griddle or ruled out:
+    - event lateness: how long after it was due each event was handed to the output encoder
+    - timer lateness: how long after it was due each high resolution timer callback ran
+    - send time: how long each call to GriddleOutputEncoder::sendMessageNow() took
+    - wire lateness: how long after its nominal time each event arrived at the end of the
+      MIDI wire, as modelled by the output encoder
+
+    The measurements go into fixed-size histograms of atomic counters. Only the playback
+    thread writes to them, so recording needs no locks and no read-modify-write atomics,
+    and the GUI can read them at any time (e.g. for the telemetry overlay or a CSV export).
+*/
+class GriddlePlaybackTelemetry
+{
+public:
+    //==============================================================================
+    GriddlePlaybackTelemetry();
+    ~GriddlePlaybackTelemetry();
+
+    //==============================================================================
+    /*
+        A histogram of times in milliseconds with equal-width bins, the last of which also
+        counts every time past the end of the histogram.
+    */
+    class Histogram
+    {
+    public:
+        //==============================================================================
+        Histogram(const String& name, const double binWidthMs);
+        ~Histogram();
+
+        //==============================================================================
+        /** Adds a time to the histogram (times below zero are counted as zero)
+            This must only be called from one thread at a time.
+            @param timeMs    The time in milliseconds
+        */
+        void add(const double timeMs) noexcept;
+
+        /** Clears the histogram
+            This must not be called while add() may be running on another thread.
+        */
+        void reset() noexcept;
+
+        /** Gets the name of the histogram */
+        const String& getName() const;
+
+        /** Gets the width of each bin in milliseconds */
+        double getBinWidthMs() const;
+
+        /** Gets the number of times counted in a bin
+            @param binIndex    The index of the bin (0 to NUM_BINS - 1)
+            @returns           The number of times in the bin
+        */
+        uint32 getBinCount(const int binIndex) const;
+
+        /** Gets the number of times added to the histogram */
+        uint32 getTotalCount() const;
+
+        /** Gets the mean of the times added to the histogram, or 0 if there are none */
+        double getMeanMs() const;
+
+        /** Gets the largest time added to the histogram, or 0 if there are none */
+        double getMaxMs() const;
+
+        /** Gets a percentile of the times added to the histogram
+            @param percentile    The percentile to get (0 to 100)
+            @returns             The upper edge of the bin the percentile falls in (the largest time for the
+                                 last bin), or 0 if the histogram is empty
+        */
+        double getPercentileMs(const double percentile) const;
+
+        /** The number of bins in each histogram */
+        static constexpr int NUM_BINS = 50;
+
+    private:
+        //==============================================================================
+        const String name_;
+        const double binWidthMs_;
+
+        std::array<std::atomic<uint32>, NUM_BINS> binCounts_;
+        std::atomic<uint32> totalCount_;
+        std::atomic<double> totalMs_;
+        std::atomic<double> maxMs_;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Histogram)
+    };
+
+    //==============================================================================
+    /** Clears all of the histograms (e.g. when playback starts)
+        This must not be called while the playback thread may be recording.
+    */
+    void reset();
+
+    /** Turns recording on or off
+        @param enabled    Pass true to record the playback timing, or false to skip it
+    */
+    void setEnabled(const bool enabled);
+
+    /** Checks whether the playback timing is being recorded
+        @returns    true if recording is on, otherwise false
+    */
+    bool isEnabled() const;
+
+    /** Records a high resolution timer callback, measuring how late it ran
+        The first callback after reset() only sets the time the next one is due.
+        @param clockTime          The time of the callback in seconds on the Time::getMillisecondCounterHiRes() clock
+        @param intervalSeconds    The interval of the timer in seconds
+    */
+    void recordTimerCallback(const double clockTime, const double intervalSeconds);
+
+    /** Records an event handed to the output encoder
+        @param dueTime          The time the event was due to be handed over (its scheduled time less the
+                                output port's schedule-ahead time)
+        @param sendStartTime    The time the call to sendMessageNow() started
+        @param sendEndTime      The time the call to sendMessageNow() returned
+    */
+    void recordEventSent(const double dueTime, const double sendStartTime, const double sendEndTime);
+
+    /** Records how late an event arrived at the end of the MIDI wire
+        @param latenessSeconds    The time from the event's nominal time to its arrival, as measured by
+                                  GriddleOutputEncoder::getLastEventLateness()
+    */
+    void recordEventArrived(const double latenessSeconds);
+
+    /** Writes every histogram's bins as CSV, with a header row
+        @param stream    The stream to write to
+    */
+    void writeCsv(OutputStream& stream) const;
+
+    /** Gets the histogram of how late events were handed to the output encoder */
+    const Histogram& getEventLateness() const;
+
+    /** Gets the histogram of how late the high resolution timer callbacks ran */
+    const Histogram& getTimerLateness() const;
+
+    /** Gets the histogram of how long the calls to sendMessageNow() took */
+    const Histogram& getSendTime() const;
+
+    /** Gets the histogram of how late events arrived at the end of the MIDI wire */
+    const Histogram& getWireLateness() const;
+
+private:
+    //==============================================================================
+    std::atomic<bool> enabled_;
+    double nextTimerCallbackTime_;
+
+    Histogram eventLateness_;
+    Histogram timerLateness_;
+    Histogram sendTime_;
+    Histogram wireLateness_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddlePlaybackTelemetry)
+};
+
+//==============================================================================
+// Inline Getter Definitions
+
+inline const String& GriddlePlaybackTelemetry::Histogram::getName() const
+{
+    return name_;
+}
+
+inline double GriddlePlaybackTelemetry::Histogram::getBinWidthMs() const
+{
+    return binWidthMs_;
+}
+
+inline uint32 GriddlePlaybackTelemetry::Histogram::getBinCount(const int binIndex) const
+{
+    return binCounts_[static_cast<size_t>(binIndex)].load(std::memory_order_relaxed);
+}
+
+inline uint32 GriddlePlaybackTelemetry::Histogram::getTotalCount() const
+{
+    return totalCount_.load(std::memory_order_relaxed);
+}
+
+inline double GriddlePlaybackTelemetry::Histogram::getMaxMs() const
+{
+    return maxMs_.load(std::memory_order_relaxed);
+}
+
+inline bool GriddlePlaybackTelemetry::isEnabled() const
+{
+    return enabled_.load(std::memory_order_relaxed);
+}
+
+inline const GriddlePlaybackTelemetry::Histogram& GriddlePlaybackTelemetry::getEventLateness() const
+{
+    return eventLateness_;
+}
+
+inline const GriddlePlaybackTelemetry::Histogram& GriddlePlaybackTelemetry::getTimerLateness() const
+{
+    return timerLateness_;
+}
+
+inline const GriddlePlaybackTelemetry::Histogram& GriddlePlaybackTelemetry::getSendTime() const
+{
+    return sendTime_;
+}
+
+inline const GriddlePlaybackTelemetry::Histogram& GriddlePlaybackTelemetry::getWireLateness() const
+{
+    return wireLateness_;
+}
@@ -0,0 +1,259 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleProjectData.h
+    Created: 19 Oct 2026 5:02:44pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <algorithm>
+#include <array>
+
+//==============================================================================
+/*
+    These structures hold the contents of a Griddle project as plain data, separate
+    from the GUI components that display and edit it.
+
+    They are what the binary project format is read into and written from, and the
+    defaults match the settings of a new project.
+*/
+
+/** A note of a step's chord, which plays along with the step's own note */
+struct GriddleChordNoteData
+{
+    bool operator==(const GriddleChordNoteData& other) const
+    {
+        return (noteNumber == other.noteNumber) && (velocity == other.velocity);
+    }
+
+    bool operator!=(const GriddleChordNoteData& other) const
+    {
+        return ! operator==(other);
+    }
+
+    int noteNumber = -1;
+    int velocity = 127;
+};
+
+/** The settings of a single step */
+struct GriddleStepData
+{
+    static constexpr int MAX_RATCHETS = 8;
+
+    /** The most notes a step can play at once, counting its own note */
+    static constexpr int MAX_CHORD_NOTES = 4;
+
+    bool operator==(const GriddleStepData& other) const
+    {
+        return (noteNumber == other.noteNumber) && (velocity == other.velocity) && (gatePercent == other.gatePercent)
+            && (probability == other.probability) && (ratchets == other.ratchets) && (condition == other.condition)
+            && (numChordNotes == other.numChordNotes)
+            && std::equal(chordNotes.begin(), chordNotes.begin() + jlimit(0, MAX_CHORD_NOTES - 1, numChordNotes), other.chordNotes.begin());
+    }
+
+    bool operator!=(const GriddleStepData& other) const
+    {
+        return ! operator==(other);
+    }
+
+    int noteNumber = -1;
+    int velocity = 127;
+    int gatePercent = 100;
+
+    // The step plays with a probability of probability percent each time it comes around, as long as its trig
+    // condition (see GriddleTrigCondition) is met, and repeats its note ratchets times within the step
+    int probability = 100;
+    int ratchets = 1;
+    int condition = 0;
+
+    // The rest of the step's chord, which is held inline so steps never allocate. Only the first numChordNotes
+    // are used, and they only play when the step has a note of its own.
+    int numChordNotes = 0;
+    std::array<GriddleChordNoteData, MAX_CHORD_NOTES - 1> chordNotes;
+};
+
+/** The settings of a single track and its steps */
+struct GriddleTrackData
+{
+    static constexpr int NUM_STEPS = 16;
+    static constexpr double MAX_LATENCY_OFFSET_MS = 100.0;
+    static constexpr int MIN_SWING_PERCENT = 50;
+    static constexpr int MAX_SWING_PERCENT = 75;
+
+    /** Converts a latency offset to samples, limited to MAX_LATENCY_OFFSET_MS either way
+
+        @param offset        The latency offset in milliseconds or samples
+        @param inSamples     true if the offset is in samples, false if it's in milliseconds
+        @param sampleRate    The sample rate to convert at
+        @returns             The latency offset in samples
+    */
+    static int convertLatencyOffsetToSamples(const double offset, const bool inSamples, const double sampleRate)
+    {
+        auto maxOffsetSamples = roundToInt(MAX_LATENCY_OFFSET_MS * 0.001 * sampleRate);
+
+        auto offsetSamples = roundToInt(offset);
+        if (! inSamples)
+            offsetSamples = roundToInt(offset * 0.001 * sampleRate);
+
+        return jlimit(-maxOffsetSamples, maxOffsetSamples, offsetSamples);
+    }
+
+    /** Gets the track's latency offset in samples, limited to MAX_LATENCY_OFFSET_MS either way */
+    int getLatencyOffsetSamples(const double sampleRate) const
+    {
+        return convertLatencyOffsetToSamples(latencyOffset, latencyOffsetInSamples, sampleRate);
+    }
+
+    bool operator==(const GriddleTrackData& other) const
+    {
+        return (isActive == other.isActive) && (midiChannel == other.midiChannel) && (numSteps == other.numSteps)
+            && (isFlipped == other.isFlipped) && (isChopped == other.isChopped) && (isBurnt == other.isBurnt)
+            && (latencyOffset == other.latencyOffset) && (latencyOffsetInSamples == other.latencyOffsetInSamples)
+            && (swingPercent == other.swingPercent) && (grooveIndex == other.grooveIndex)
+            && (clockRateNumerator == other.clockRateNumerator) && (clockRateDenominator == other.clockRateDenominator)
+            && (steps == other.steps);
+    }
+
+    bool operator!=(const GriddleTrackData& other) const
+    {
+        return ! operator==(other);
+    }
+
+    bool isActive = true;
+    int midiChannel = 1;
+    int numSteps = NUM_STEPS;
+    bool isFlipped = false;
+    bool isChopped = false;
+    bool isBurnt = false;
+    double latencyOffset = 0.0;
+    bool latencyOffsetInSamples = false;
+    int swingPercent = MIN_SWING_PERCENT;
+    int grooveIndex = -1;
+
+    // The track's steps are clocked at numerator / denominator steps per 16th note, or fitted into
+    // one measure when the numerator is 0 (see GriddleTimeline::getNoteTicks())
+    int clockRateNumerator = 0;
+    int clockRateDenominator = 1;
+
+    std::array<GriddleStepData, NUM_STEPS> steps;
+};
+
+/** A groove template, which moves the notes at each step position of the tracks that use it in time
+    (by a percentage of a step, later for positive offsets) and adjusts their velocity. The step
+    positions repeat every length steps. */
+struct GriddleGrooveData
+{
+    static constexpr int MAX_TIMING_PERCENT = 50;
+    static constexpr int MAX_VELOCITY_OFFSET = 64;
+
+    bool operator==(const GriddleGrooveData& other) const
+    {
+        return (name == other.name) && (length == other.length) && (timingPercents == other.timingPercents)
+            && (velocityOffsets == other.velocityOffsets);
+    }
+
+    bool operator!=(const GriddleGrooveData& other) const
+    {
+        return ! operator==(other);
+    }
+
+    String name;
+    int length = GriddleTrackData::NUM_STEPS;
+    std::array<int, GriddleTrackData::NUM_STEPS> timingPercents {};
+    std::array<int, GriddleTrackData::NUM_STEPS> velocityOffsets {};
+};
+
+/** A point of a project's tempo automation: its position in beats from the start of the automation, its
+    tempo as a multiple of the project tempo, and whether the tempo ramps to it from the previous point
+    (otherwise the tempo steps at the point) */
+struct GriddleTempoPointData
+{
+    bool operator==(const GriddleTempoPointData& other) const
+    {
+        return (beat == other.beat) && (tempoScale == other.tempoScale) && (isRamp == other.isRamp);
+    }
+
+    bool operator!=(const GriddleTempoPointData& other) const
+    {
+        return ! operator==(other);
+    }
+
+    double beat = 0.0;
+    double tempoScale = 1.0;
+    bool isRamp = false;
+};
+
+/** The tempo automation of a project, which repeats every numMeasures measures of playback */
+struct GriddleTempoAutomationData
+{
+    static constexpr int MAX_POINTS = 8;
+    static constexpr int MAX_MEASURES = 64;
+    static constexpr double MIN_TEMPO_SCALE = 0.25;
+    static constexpr double MAX_TEMPO_SCALE = 4.0;
+
+    bool operator==(const GriddleTempoAutomationData& other) const
+    {
+        return (numMeasures == other.numMeasures) && (numPoints == other.numPoints)
+            && std::equal(points.begin(), points.begin() + jlimit(0, MAX_POINTS, numPoints), other.points.begin());
+    }
+
+    bool operator!=(const GriddleTempoAutomationData& other) const
+    {
+        return ! operator==(other);
+    }
+
+    int numMeasures = 1;
+    int numPoints = 0;
+    std::array<GriddleTempoPointData, MAX_POINTS> points;
+};
+
+/** The master settings and the tracks of a project */
+struct GriddleProjectData
+{
+    static constexpr int NUM_TRACKS = 4;
+    static constexpr int NUM_GROOVES = 4;
+    static constexpr double MIN_TEMPO = 10.0;
+    static constexpr double MAX_TEMPO = 180.0;
+
+    double tempo = 120.0;
+    GriddleTempoAutomationData tempoAutomation;
+    String midiOutput;
+    double midiWireRate = 3125.0;
+    bool bandwidthAwareScheduling = false;
+
+    // The seed of the random numbers that decide whether steps with a probability play, so a project plays
+    // the same way every time playback starts
+    int randomSeed = 0;
+
+    std::array<GriddleTrackData, NUM_TRACKS> tracks;
+    std::array<GriddleGrooveData, NUM_GROOVES> grooves;
+};
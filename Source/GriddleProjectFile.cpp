@@ -0,0 +1,824 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleProjectFile.cpp
+    Created: 19 Oct 2026 4:21:06pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleProjectFile.h"
+#include "GriddleProjectJsonReader.h"
+#include "GriddleTimeline.h"
+#include "GriddleTrace.h"
+#include "GriddleTrigCondition.h"
+
+constexpr int GriddleProjectFile::BINARY_FORMAT_VERSION;
+
+//==============================================================================
+// Binary Format Layout Constants
+static constexpr char binaryMagic[8] = { 'G', 'R', 'I', 'D', 'D', 'L', 'E', 0 };
+static constexpr int binaryHeaderSize = 32;
+static constexpr int binaryMasterRecordSize = 96;
+static constexpr int binaryTrackSettingsSize = 16;
+static constexpr int binaryStepRecordSize = 4;
+static constexpr int binaryTrackGrooveSize = 4;
+static constexpr int binaryStepTrigRecordSize = 4;
+static constexpr int binaryStepChordRecordSize = 2 + ((GriddleStepData::MAX_CHORD_NOTES - 1) * 2);
+static constexpr int binaryTrackRecordSize = binaryTrackSettingsSize + (GriddleTrackData::NUM_STEPS * binaryStepRecordSize) + binaryTrackGrooveSize
+                                             + (GriddleTrackData::NUM_STEPS * binaryStepTrigRecordSize) + (GriddleTrackData::NUM_STEPS * binaryStepChordRecordSize);
+static constexpr int binaryMaxMidiOutputNameBytes = 72;
+static constexpr int binaryTempoAutomationHeaderSize = 8;
+static constexpr int binaryTempoPointRecordSize = 24;
+static constexpr int binaryTempoAutomationRecordSize = binaryTempoAutomationHeaderSize + (GriddleTempoAutomationData::MAX_POINTS * binaryTempoPointRecordSize);
+static constexpr int binaryGroovesHeaderSize = 8;
+static constexpr int binaryMaxGrooveNameBytes = 24;
+static constexpr int binaryGrooveRecordSize = 8 + binaryMaxGrooveNameBytes + (GriddleTrackData::NUM_STEPS * 2);
+static constexpr int binaryGroovesRecordSize = binaryGroovesHeaderSize + (GriddleProjectData::NUM_GROOVES * binaryGrooveRecordSize);
+
+//==============================================================================
+// JSON Writing Helpers
+static void writeJsonIndent(OutputStream& stream, const int indent)
+{
+    stream.writeRepeatedByte(' ', static_cast<size_t>(indent));
+}
+
+static void writeJsonPropertyName(OutputStream& stream, const int indent, const char* propertyName)
+{
+    writeJsonIndent(stream, indent);
+    stream << '"' << propertyName << "\": ";
+}
+
+static void writeJsonDouble(OutputStream& stream, const double value)
+{
+    // Whole numbers keep a decimal point so they read back as doubles, and
+    // JSON has no representation of infinity or NaN, so those are written as null
+    if (! std::isfinite(value))
+        stream << "null";
+    else if ((value == std::floor(value)) && (std::abs(value) < 1.0e15))
+        stream << String(static_cast<int64>(value)) << ".0";
+    else
+        stream << String(value);
+}
+
+static double readLittleEndianDouble(const uint8* data)
+{
+    auto bits = ByteOrder::littleEndianInt64(data);
+
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+static double readLittleEndianDouble(const uint8* data, const double minValue, const double maxValue, const double defaultValue)
+{
+    // A damaged file can hold infinity or NaN, which would poison every time worked out from the value
+    auto value = readLittleEndianDouble(data);
+
+    return std::isfinite(value) ? jlimit(minValue, maxValue, value) : defaultValue;
+}
+
+//==============================================================================
+GriddleProjectFile::GriddleProjectFile()
+    : serialisedProject_(65536)
+{
+}
+
+GriddleProjectFile::~GriddleProjectFile()
+{
+}
+
+Result GriddleProjectFile::save(const File& projectFile, const GriddleProjectData& projectData)
+{
+    GRIDDLE_TRACE_SCOPE("GriddleProjectFile::save");
+
+    // Serialise into the reused buffer (reset() keeps its allocation from the previous save)
+    serialisedProject_.reset();
+    writeJson(serialisedProject_, projectData);
+
+    return writeSerialisedProject(projectFile);
+}
+
+Result GriddleProjectFile::saveBinary(const File& projectFile, const GriddleProjectData& projectData)
+{
+    GRIDDLE_TRACE_SCOPE("GriddleProjectFile::saveBinary");
+
+    serialisedProject_.reset();
+    writeBinary(serialisedProject_, projectData);
+
+    return writeSerialisedProject(projectFile);
+}
+
+Result GriddleProjectFile::load(const File& projectFile, GriddleProjectData& projectData, String& errorString)
+{
+    GRIDDLE_TRACE_SCOPE("GriddleProjectFile::load");
+
+    if (isBinaryProjectFile(projectFile))
+        return loadBinary(projectFile, projectData);
+
+    // An empty file can't be mapped, but it isn't a project either
+    if (projectFile.getSize() == 0)
+        return Result::fail("The file isn't valid JSON");
+
+    MemoryMappedFile mappedFile(projectFile, MemoryMappedFile::readOnly);
+
+    if (mappedFile.getData() == nullptr)
+        return Result::fail("Couldn't open " + projectFile.getFullPathName());
+
+    return readJson(mappedFile.getData(), mappedFile.getSize(), projectData, errorString);
+}
+
+Result GriddleProjectFile::readJson(const void* data, const size_t numBytes, GriddleProjectData& projectData, String& errorString)
+{
+    GriddleProjectJsonReader reader(data, numBytes);
+
+    return reader.read(projectData, errorString);
+}
+
+Result GriddleProjectFile::loadBinary(const File& projectFile, GriddleProjectData& projectData)
+{
+    MemoryMappedFile mappedFile(projectFile, MemoryMappedFile::readOnly);
+
+    if (mappedFile.getData() == nullptr)
+        return Result::fail("Couldn't open " + projectFile.getFullPathName());
+
+    return readBinary(mappedFile.getData(), mappedFile.getSize(), projectData);
+}
+
+Result GriddleProjectFile::readBinary(const void* data, const size_t numBytes, GriddleProjectData& projectData)
+{
+    auto bytes = static_cast<const uint8*>(data);
+
+    // Check the header
+    // ****************
+    if ((numBytes < static_cast<size_t>(binaryHeaderSize)) || (std::memcmp(bytes, binaryMagic, sizeof(binaryMagic)) != 0))
+        return Result::fail("Not a binary Griddle project file");
+
+    auto version = ByteOrder::littleEndianShort(bytes + 8);
+    auto headerSize = ByteOrder::littleEndianShort(bytes + 10);
+    auto numTracks = ByteOrder::littleEndianShort(bytes + 12);
+    auto numSteps = ByteOrder::littleEndianShort(bytes + 14);
+    auto masterRecordSize = ByteOrder::littleEndianShort(bytes + 16);
+    auto trackRecordSize = ByteOrder::littleEndianShort(bytes + 18);
+
+    if (version < 1)
+        return Result::fail("Unsupported binary project format version " + String(version));
+
+    // Later versions may add fields to the end of each record, but never make them smaller
+    if ((headerSize < binaryHeaderSize) || (masterRecordSize < binaryMasterRecordSize)
+        || (trackRecordSize < (binaryTrackSettingsSize + (numSteps * binaryStepRecordSize))))
+        return Result::fail("Invalid record sizes in binary project file");
+
+    // The tempo automation record was added in version 2, and follows the track records
+    auto tempoAutomationRecordSize = (version >= 2) ? ByteOrder::littleEndianShort(bytes + 20) : 0;
+
+    if ((tempoAutomationRecordSize != 0) && (tempoAutomationRecordSize < binaryTempoAutomationHeaderSize))
+        return Result::fail("Invalid record sizes in binary project file");
+
+    // The groove template record was added in version 3, and follows the tempo automation record
+    auto groovesRecordSize = (version >= 3) ? ByteOrder::littleEndianShort(bytes + 22) : 0;
+
+    if ((groovesRecordSize != 0) && (groovesRecordSize < binaryGroovesHeaderSize))
+        return Result::fail("Invalid record sizes in binary project file");
+
+    if (numBytes < (static_cast<size_t>(headerSize) + masterRecordSize + (static_cast<size_t>(numTracks) * trackRecordSize) + tempoAutomationRecordSize + groovesRecordSize))
+        return Result::fail("Binary project file is truncated");
+
+    // Read the master record
+    // **********************
+    auto masterRecord = bytes + headerSize;
+
+    // The doubles are limited to the ranges they can be set to, as nothing else in the file is trusted either
+    projectData.tempo = readLittleEndianDouble(masterRecord, GriddleProjectData::MIN_TEMPO, GriddleProjectData::MAX_TEMPO, GriddleProjectData().tempo);
+    projectData.midiWireRate = readLittleEndianDouble(masterRecord + 8, 0.0, std::numeric_limits<double>::max(), GriddleProjectData().midiWireRate);
+    projectData.bandwidthAwareScheduling = (masterRecord[16] != 0);
+
+    auto midiOutputNameBytes = jmin(static_cast<int>(masterRecord[17]), binaryMaxMidiOutputNameBytes);
+    projectData.midiOutput = String::fromUTF8(reinterpret_cast<const char*>(masterRecord + 24), midiOutputNameBytes);
+
+    // The random seed was padding before version 5, which reads as a seed of 0
+    projectData.randomSeed = static_cast<int>(ByteOrder::littleEndianInt(masterRecord + 20));
+
+    // Read the track records
+    // **********************
+    auto trackRecord = masterRecord + masterRecordSize;
+    auto numTracksToRead = jmin(static_cast<int>(numTracks), GriddleProjectData::NUM_TRACKS);
+    auto numStepsToRead = jmin(static_cast<int>(numSteps), GriddleTrackData::NUM_STEPS);
+
+    for (auto trackI = 0; trackI < numTracksToRead; ++trackI)
+    {
+        auto& track = projectData.tracks[trackI];
+
+        track.isActive = (trackRecord[0] != 0);
+        track.midiChannel = jlimit(1, 16, static_cast<int>(trackRecord[1]));
+        track.numSteps = jlimit(1, GriddleTrackData::NUM_STEPS, static_cast<int>(trackRecord[2]));
+        track.isFlipped = (trackRecord[3] != 0);
+        track.isChopped = (trackRecord[4] != 0);
+        track.isBurnt = (trackRecord[5] != 0);
+        track.latencyOffsetInSamples = (trackRecord[6] != 0);
+
+        // Offsets in samples are only limited once the sample rate is known (see GriddleTrackData::getLatencyOffsetSamples())
+        if (track.latencyOffsetInSamples)
+            track.latencyOffset = readLittleEndianDouble(trackRecord + 8, std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max(), 0.0);
+        else
+            track.latencyOffset = readLittleEndianDouble(trackRecord + 8, -GriddleTrackData::MAX_LATENCY_OFFSET_MS, GriddleTrackData::MAX_LATENCY_OFFSET_MS, 0.0);
+
+        auto stepRecord = trackRecord + binaryTrackSettingsSize;
+
+        for (auto stepI = 0; stepI < numStepsToRead; ++stepI)
+        {
+            track.steps[stepI].noteNumber = jlimit(-1, 127, static_cast<int>(static_cast<int8>(stepRecord[0])));
+            track.steps[stepI].velocity = jlimit(0, 127, static_cast<int>(stepRecord[1]));
+            track.steps[stepI].gatePercent = jlimit(0, 100, static_cast<int>(stepRecord[2]));
+
+            stepRecord += binaryStepRecordSize;
+        }
+
+        // The swing, groove template and clock rate follow the file's steps, in files that have them
+        // (the clock rate bytes were padding before version 4, which reads as fitting the steps into one measure)
+        auto grooveRecord = trackRecord + binaryTrackSettingsSize + (numSteps * binaryStepRecordSize);
+
+        if (trackRecordSize >= (binaryTrackSettingsSize + (numSteps * binaryStepRecordSize) + binaryTrackGrooveSize))
+        {
+            track.swingPercent = jlimit(GriddleTrackData::MIN_SWING_PERCENT, GriddleTrackData::MAX_SWING_PERCENT, static_cast<int>(grooveRecord[0]));
+
+            auto grooveIndex = static_cast<int>(static_cast<int8>(grooveRecord[1]));
+            track.grooveIndex = ((grooveIndex >= 0) && (grooveIndex < GriddleProjectData::NUM_GROOVES)) ? grooveIndex : -1;
+
+            auto clockRateNumerator = static_cast<int>(grooveRecord[2]);
+            auto clockRateDenominator = static_cast<int>(grooveRecord[3]);
+            auto isClocked = GriddleTimeline::isValidClockRate(clockRateNumerator, clockRateDenominator);
+
+            track.clockRateNumerator = isClocked ? clockRateNumerator : 0;
+            track.clockRateDenominator = isClocked ? clockRateDenominator : 1;
+        }
+        else
+        {
+            track.swingPercent = GriddleTrackData::MIN_SWING_PERCENT;
+            track.grooveIndex = -1;
+            track.clockRateNumerator = 0;
+            track.clockRateDenominator = 1;
+        }
+
+        // The steps' probabilities, ratchets and trig conditions follow the groove record, in files that have them
+        auto stepTrigRecord = grooveRecord + binaryTrackGrooveSize;
+        auto hasStepTrigs = (trackRecordSize >= (binaryTrackSettingsSize + (numSteps * binaryStepRecordSize) + binaryTrackGrooveSize
+                                                 + (numSteps * binaryStepTrigRecordSize)));
+
+        for (auto stepI = 0; stepI < numStepsToRead; ++stepI)
+        {
+            auto& step = track.steps[stepI];
+
+            if (hasStepTrigs)
+            {
+                step.probability = jlimit(0, 100, static_cast<int>(stepTrigRecord[0]));
+                step.ratchets = jlimit(1, GriddleStepData::MAX_RATCHETS, static_cast<int>(stepTrigRecord[1]));
+                step.condition = (stepTrigRecord[2] < GriddleTrigCondition::NUM_CONDITIONS) ? static_cast<int>(stepTrigRecord[2]) : GriddleTrigCondition::NONE;
+
+                stepTrigRecord += binaryStepTrigRecordSize;
+            }
+            else
+            {
+                step.probability = 100;
+                step.ratchets = 1;
+                step.condition = GriddleTrigCondition::NONE;
+            }
+        }
+
+        // The steps' chords follow their trigs, in files that have them
+        auto stepChordRecord = grooveRecord + binaryTrackGrooveSize + (numSteps * binaryStepTrigRecordSize);
+        auto hasStepChords = (trackRecordSize >= (binaryTrackSettingsSize + (numSteps * binaryStepRecordSize) + binaryTrackGrooveSize
+                                                  + (numSteps * binaryStepTrigRecordSize) + (numSteps * binaryStepChordRecordSize)));
+
+        for (auto stepI = 0; stepI < numStepsToRead; ++stepI)
+        {
+            auto& step = track.steps[stepI];
+            step.numChordNotes = 0;
+            step.chordNotes.fill(GriddleChordNoteData());
+
+            if (hasStepChords)
+            {
+                step.numChordNotes = jlimit(0, GriddleStepData::MAX_CHORD_NOTES - 1, static_cast<int>(stepChordRecord[0]));
+
+                for (auto chordNoteI = 0; chordNoteI < step.numChordNotes; ++chordNoteI)
+                {
+                    auto& chordNote = step.chordNotes[static_cast<size_t>(chordNoteI)];
+                    chordNote.noteNumber = jlimit(0, 127, static_cast<int>(stepChordRecord[2 + (chordNoteI * 2)]));
+                    chordNote.velocity = jlimit(0, 127, static_cast<int>(stepChordRecord[3 + (chordNoteI * 2)]));
+                }
+
+                stepChordRecord += binaryStepChordRecordSize;
+            }
+        }
+
+        trackRecord += trackRecordSize;
+    }
+
+    // Read the tempo automation record
+    // ********************************
+    projectData.tempoAutomation = GriddleTempoAutomationData();
+
+    if (tempoAutomationRecordSize > 0)
+    {
+        auto tempoAutomationRecord = masterRecord + masterRecordSize + (static_cast<size_t>(numTracks) * trackRecordSize);
+        auto maxPointsInRecord = (tempoAutomationRecordSize - binaryTempoAutomationHeaderSize) / binaryTempoPointRecordSize;
+
+        auto& tempoAutomation = projectData.tempoAutomation;
+        tempoAutomation.numMeasures = jlimit(1, GriddleTempoAutomationData::MAX_MEASURES, static_cast<int>(ByteOrder::littleEndianShort(tempoAutomationRecord)));
+        tempoAutomation.numPoints = jlimit(0, jmin(GriddleTempoAutomationData::MAX_POINTS, maxPointsInRecord), static_cast<int>(ByteOrder::littleEndianShort(tempoAutomationRecord + 2)));
+
+        auto pointRecord = tempoAutomationRecord + binaryTempoAutomationHeaderSize;
+
+        for (auto pointI = 0; pointI < tempoAutomation.numPoints; ++pointI)
+        {
+            tempoAutomation.points[pointI].beat = readLittleEndianDouble(pointRecord, 0.0, std::numeric_limits<double>::max(), 0.0);
+            tempoAutomation.points[pointI].tempoScale = readLittleEndianDouble(pointRecord + 8, GriddleTempoAutomationData::MIN_TEMPO_SCALE,
+                                                                               GriddleTempoAutomationData::MAX_TEMPO_SCALE, 1.0);
+            tempoAutomation.points[pointI].isRamp = (pointRecord[16] != 0);
+
+            pointRecord += binaryTempoPointRecordSize;
+        }
+    }
+
+    // Read the groove template record
+    // *******************************
+    projectData.grooves.fill(GriddleGrooveData());
+
+    if (groovesRecordSize > 0)
+    {
+        auto groovesRecord = masterRecord + masterRecordSize + (static_cast<size_t>(numTracks) * trackRecordSize) + tempoAutomationRecordSize;
+        auto maxGroovesInRecord = (groovesRecordSize - binaryGroovesHeaderSize) / binaryGrooveRecordSize;
+        auto numGrooves = jmin(static_cast<int>(ByteOrder::littleEndianShort(groovesRecord)), GriddleProjectData::NUM_GROOVES, maxGroovesInRecord);
+
+        auto grooveRecord = groovesRecord + binaryGroovesHeaderSize;
+
+        for (auto grooveI = 0; grooveI < numGrooves; ++grooveI)
+        {
+            auto& groove = projectData.grooves[grooveI];
+            groove.length = jlimit(1, GriddleTrackData::NUM_STEPS, static_cast<int>(grooveRecord[0]));
+
+            auto nameBytes = jmin(static_cast<int>(grooveRecord[1]), binaryMaxGrooveNameBytes);
+            groove.name = String::fromUTF8(reinterpret_cast<const char*>(grooveRecord + 8), nameBytes);
+
+            auto offsetsRecord = grooveRecord + 8 + binaryMaxGrooveNameBytes;
+
+            for (auto stepI = 0; stepI < groove.length; ++stepI)
+            {
+                groove.timingPercents[stepI] = jlimit(-GriddleGrooveData::MAX_TIMING_PERCENT, GriddleGrooveData::MAX_TIMING_PERCENT, static_cast<int>(static_cast<int8>(offsetsRecord[stepI])));
+                groove.velocityOffsets[stepI] = jlimit(-GriddleGrooveData::MAX_VELOCITY_OFFSET, GriddleGrooveData::MAX_VELOCITY_OFFSET,
+                                                       static_cast<int>(static_cast<int8>(offsetsRecord[GriddleTrackData::NUM_STEPS + stepI])));
+            }
+
+            grooveRecord += binaryGrooveRecordSize;
+        }
+    }
+
+    return Result::ok();
+}
+
+void GriddleProjectFile::writeJson(OutputStream& stream, const GriddleProjectData& projectData)
+{
+    // The properties and layout are the same as JSON::writeToStream() produced for
+    // the equivalent var tree, with two spaces of indentation per level
+    stream << '{' << newLine;
+
+    // Write the master settings
+    // *************************
+    writeJsonPropertyName(stream, 2, "master_settings");
+    stream << '{' << newLine;
+
+    writeJsonPropertyName(stream, 4, "tempo");
+    writeJsonDouble(stream, projectData.tempo);
+    stream << ',' << newLine;
+
+    const auto& tempoAutomation = projectData.tempoAutomation;
+    auto numTempoPoints = jlimit(0, GriddleTempoAutomationData::MAX_POINTS, tempoAutomation.numPoints);
+
+    writeJsonPropertyName(stream, 4, "tempo_automation");
+    stream << '{' << newLine;
+
+    writeJsonPropertyName(stream, 6, "num_measures");
+    stream << tempoAutomation.numMeasures << ',' << newLine;
+
+    writeJsonPropertyName(stream, 6, "points");
+
+    if (numTempoPoints == 0)
+        stream << "[]" << newLine;
+    else
+        stream << '[' << newLine;
+
+    for (auto pointI = 0; pointI < numTempoPoints; ++pointI)
+    {
+        const auto& point = tempoAutomation.points[pointI];
+
+        writeJsonIndent(stream, 8);
+        stream << '{' << newLine;
+
+        writeJsonPropertyName(stream, 10, "beat");
+        writeJsonDouble(stream, point.beat);
+        stream << ',' << newLine;
+
+        writeJsonPropertyName(stream, 10, "tempo_scale");
+        writeJsonDouble(stream, point.tempoScale);
+        stream << ',' << newLine;
+
+        writeJsonPropertyName(stream, 10, "ramp");
+        stream << (point.isRamp ? "true" : "false") << newLine;
+
+        writeJsonIndent(stream, 8);
+        stream << ((pointI < (numTempoPoints - 1)) ? "}," : "}") << newLine;
+    }
+
+    if (numTempoPoints > 0)
+    {
+        writeJsonIndent(stream, 6);
+        stream << ']' << newLine;
+    }
+
+    writeJsonIndent(stream, 4);
+    stream << '}' << ',' << newLine;
+
+    // Each groove template's offsets are written on one line, one value per step position
+    writeJsonPropertyName(stream, 4, "grooves");
+    stream << '[' << newLine;
+
+    for (auto grooveI = 0; grooveI < GriddleProjectData::NUM_GROOVES; ++grooveI)
+    {
+        const auto& groove = projectData.grooves[grooveI];
+        auto grooveLength = jlimit(1, GriddleTrackData::NUM_STEPS, groove.length);
+
+        writeJsonIndent(stream, 6);
+        stream << '{' << newLine;
+
+        writeJsonPropertyName(stream, 8, "name");
+        stream << '"' << JSON::escapeString(groove.name) << '"' << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "timing_percents");
+        stream << '[';
+
+        for (auto stepI = 0; stepI < grooveLength; ++stepI)
+            stream << ((stepI > 0) ? ", " : "") << groove.timingPercents[stepI];
+
+        stream << ']' << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "velocity_offsets");
+        stream << '[';
+
+        for (auto stepI = 0; stepI < grooveLength; ++stepI)
+            stream << ((stepI > 0) ? ", " : "") << groove.velocityOffsets[stepI];
+
+        stream << ']' << newLine;
+
+        writeJsonIndent(stream, 6);
+        stream << ((grooveI < (GriddleProjectData::NUM_GROOVES - 1)) ? "}," : "}") << newLine;
+    }
+
+    writeJsonIndent(stream, 4);
+    stream << ']' << ',' << newLine;
+
+    writeJsonPropertyName(stream, 4, "midi_output");
+    stream << '"' << JSON::escapeString(projectData.midiOutput) << '"' << ',' << newLine;
+
+    writeJsonPropertyName(stream, 4, "midi_wire_rate");
+    writeJsonDouble(stream, projectData.midiWireRate);
+    stream << ',' << newLine;
+
+    writeJsonPropertyName(stream, 4, "bandwidth_aware_scheduling");
+    stream << (projectData.bandwidthAwareScheduling ? "true" : "false") << ',' << newLine;
+
+    writeJsonPropertyName(stream, 4, "random_seed");
+    stream << projectData.randomSeed << newLine;
+
+    writeJsonIndent(stream, 2);
+    stream << '}' << ',' << newLine;
+
+    // Write the sequence
+    // ******************
+    writeJsonPropertyName(stream, 2, "sequence");
+    stream << '{' << newLine;
+
+    writeJsonPropertyName(stream, 4, "tracks");
+    stream << '[' << newLine;
+
+    for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+    {
+        const auto& trackData = projectData.tracks[trackI];
+
+        writeJsonIndent(stream, 6);
+        stream << '{' << newLine;
+
+        writeJsonPropertyName(stream, 8, "name");
+        stream << '"' << static_cast<char>('A' + trackI) << '"' << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "is_active");
+        stream << (trackData.isActive ? "true" : "false") << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "midi_ch");
+        stream << trackData.midiChannel << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "num_steps");
+        stream << trackData.numSteps << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "is_flipped");
+        stream << (trackData.isFlipped ? "true" : "false") << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "is_chopped");
+        stream << (trackData.isChopped ? "true" : "false") << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "is_burnt");
+        stream << (trackData.isBurnt ? "true" : "false") << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "latency_offset");
+        writeJsonDouble(stream, trackData.latencyOffset);
+        stream << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "latency_offset_units");
+        stream << (trackData.latencyOffsetInSamples ? "\"samples\"" : "\"ms\"") << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "swing_percent");
+        stream << trackData.swingPercent << ',' << newLine;
+
+        writeJsonPropertyName(stream, 8, "groove_index");
+        stream << trackData.grooveIndex << ',' << newLine;
+
+        // The clock rate is written as a fraction of 16th notes (e.g. "3/2"), or "fit" to fit the steps into one measure
+        writeJsonPropertyName(stream, 8, "clock_rate");
+
+        if (GriddleTimeline::isValidClockRate(trackData.clockRateNumerator, trackData.clockRateDenominator))
+            stream << '"' << trackData.clockRateNumerator << '/' << trackData.clockRateDenominator << '"' << ',' << newLine;
+        else
+            stream << "\"fit\"," << newLine;
+
+        writeJsonPropertyName(stream, 8, "steps");
+        stream << '[' << newLine;
+
+        for (auto stepI = 0; stepI < GriddleTrackData::NUM_STEPS; ++stepI)
+        {
+            const auto& step = trackData.steps[stepI];
+
+            writeJsonIndent(stream, 10);
+            stream << '{' << newLine;
+
+            writeJsonPropertyName(stream, 12, "note_number");
+            stream << step.noteNumber << ',' << newLine;
+
+            writeJsonPropertyName(stream, 12, "velocity");
+            stream << step.velocity << ',' << newLine;
+
+            writeJsonPropertyName(stream, 12, "gate_percent");
+            stream << step.gatePercent << ',' << newLine;
+
+            writeJsonPropertyName(stream, 12, "probability");
+            stream << step.probability << ',' << newLine;
+
+            writeJsonPropertyName(stream, 12, "ratchets");
+            stream << step.ratchets << ',' << newLine;
+
+            // The trig condition is written by name (e.g. "1:4" or "FILL")
+            writeJsonPropertyName(stream, 12, "condition");
+            stream << '"' << GriddleTrigCondition::getName(step.condition) << '"' << ',' << newLine;
+
+            // The rest of the step's chord, one note per line
+            auto numChordNotes = jlimit(0, GriddleStepData::MAX_CHORD_NOTES - 1, step.numChordNotes);
+            writeJsonPropertyName(stream, 12, "chord_notes");
+
+            if (numChordNotes == 0)
+                stream << "[]" << newLine;
+            else
+                stream << '[' << newLine;
+
+            for (auto chordNoteI = 0; chordNoteI < numChordNotes; ++chordNoteI)
+            {
+                const auto& chordNote = step.chordNotes[static_cast<size_t>(chordNoteI)];
+
+                writeJsonIndent(stream, 14);
+                stream << "{ \"note_number\": " << chordNote.noteNumber << ", \"velocity\": " << chordNote.velocity
+                       << ((chordNoteI < (numChordNotes - 1)) ? " }," : " }") << newLine;
+            }
+
+            if (numChordNotes > 0)
+            {
+                writeJsonIndent(stream, 12);
+                stream << ']' << newLine;
+            }
+
+            writeJsonIndent(stream, 10);
+            stream << ((stepI < (GriddleTrackData::NUM_STEPS - 1)) ? "}," : "}") << newLine;
+        }
+
+        writeJsonIndent(stream, 8);
+        stream << ']' << newLine;
+
+        writeJsonIndent(stream, 6);
+        stream << ((trackI < (GriddleProjectData::NUM_TRACKS - 1)) ? "}," : "}") << newLine;
+    }
+
+    writeJsonIndent(stream, 4);
+    stream << ']' << newLine;
+
+    writeJsonIndent(stream, 2);
+    stream << '}' << newLine;
+
+    stream << '}';
+}
+
+void GriddleProjectFile::writeBinary(OutputStream& stream, const GriddleProjectData& projectData)
+{
+    // Header
+    // ******
+    stream.write(binaryMagic, sizeof(binaryMagic));
+    stream.writeShort(static_cast<short>(BINARY_FORMAT_VERSION));
+    stream.writeShort(static_cast<short>(binaryHeaderSize));
+    stream.writeShort(static_cast<short>(GriddleProjectData::NUM_TRACKS));
+    stream.writeShort(static_cast<short>(GriddleTrackData::NUM_STEPS));
+    stream.writeShort(static_cast<short>(binaryMasterRecordSize));
+    stream.writeShort(static_cast<short>(binaryTrackRecordSize));
+    stream.writeShort(static_cast<short>(binaryTempoAutomationRecordSize));
+    stream.writeShort(static_cast<short>(binaryGroovesRecordSize));
+    stream.writeRepeatedByte(0, binaryHeaderSize - 24);
+
+    // Master record
+    // *************
+    auto midiOutputName = projectData.midiOutput;
+
+    while (static_cast<int>(midiOutputName.getNumBytesAsUTF8()) > binaryMaxMidiOutputNameBytes)
+        midiOutputName = midiOutputName.dropLastCharacters(1);
+
+    auto midiOutputNameBytes = static_cast<int>(midiOutputName.getNumBytesAsUTF8());
+
+    stream.writeDouble(projectData.tempo);
+    stream.writeDouble(projectData.midiWireRate);
+    stream.writeByte(projectData.bandwidthAwareScheduling ? 1 : 0);
+    stream.writeByte(static_cast<char>(midiOutputNameBytes));
+    stream.writeRepeatedByte(0, 2);
+    stream.writeInt(projectData.randomSeed);
+    stream.write(midiOutputName.toRawUTF8(), static_cast<size_t>(midiOutputNameBytes));
+    stream.writeRepeatedByte(0, static_cast<size_t>(binaryMaxMidiOutputNameBytes - midiOutputNameBytes));
+
+    // Track records
+    // *************
+    for (const auto& track : projectData.tracks)
+    {
+        stream.writeByte(track.isActive ? 1 : 0);
+        stream.writeByte(static_cast<char>(track.midiChannel));
+        stream.writeByte(static_cast<char>(track.numSteps));
+        stream.writeByte(track.isFlipped ? 1 : 0);
+        stream.writeByte(track.isChopped ? 1 : 0);
+        stream.writeByte(track.isBurnt ? 1 : 0);
+        stream.writeByte(track.latencyOffsetInSamples ? 1 : 0);
+        stream.writeByte(0);
+        stream.writeDouble(track.latencyOffset);
+
+        for (const auto& step : track.steps)
+        {
+            stream.writeByte(static_cast<char>(step.noteNumber));
+            stream.writeByte(static_cast<char>(step.velocity));
+            stream.writeByte(static_cast<char>(step.gatePercent));
+            stream.writeByte(0);
+        }
+
+        stream.writeByte(static_cast<char>(track.swingPercent));
+        stream.writeByte(static_cast<char>(track.grooveIndex));
+        stream.writeByte(static_cast<char>(track.clockRateNumerator));
+        stream.writeByte(static_cast<char>(track.clockRateDenominator));
+
+        for (const auto& step : track.steps)
+        {
+            stream.writeByte(static_cast<char>(step.probability));
+            stream.writeByte(static_cast<char>(step.ratchets));
+            stream.writeByte(static_cast<char>(step.condition));
+            stream.writeByte(0);
+        }
+
+        for (const auto& step : track.steps)
+        {
+            stream.writeByte(static_cast<char>(step.numChordNotes));
+            stream.writeByte(0);
+
+            for (auto chordNoteI = 0; chordNoteI < (GriddleStepData::MAX_CHORD_NOTES - 1); ++chordNoteI)
+            {
+                const auto& chordNote = step.chordNotes[static_cast<size_t>(chordNoteI)];
+                auto isUsed = (chordNoteI < step.numChordNotes);
+
+                stream.writeByte(isUsed ? static_cast<char>(chordNote.noteNumber) : 0);
+                stream.writeByte(isUsed ? static_cast<char>(chordNote.velocity) : 0);
+            }
+        }
+    }
+
+    // Tempo automation record
+    // ***********************
+    const auto& tempoAutomation = projectData.tempoAutomation;
+
+    stream.writeShort(static_cast<short>(tempoAutomation.numMeasures));
+    stream.writeShort(static_cast<short>(jlimit(0, GriddleTempoAutomationData::MAX_POINTS, tempoAutomation.numPoints)));
+    stream.writeRepeatedByte(0, binaryTempoAutomationHeaderSize - 4);
+
+    for (const auto& point : tempoAutomation.points)
+    {
+        stream.writeDouble(point.beat);
+        stream.writeDouble(point.tempoScale);
+        stream.writeByte(point.isRamp ? 1 : 0);
+        stream.writeRepeatedByte(0, binaryTempoPointRecordSize - 17);
+    }
+
+    // Groove template record
+    // **********************
+    stream.writeShort(static_cast<short>(GriddleProjectData::NUM_GROOVES));
+    stream.writeRepeatedByte(0, binaryGroovesHeaderSize - 2);
+
+    for (const auto& groove : projectData.grooves)
+    {
+        auto grooveName = groove.name;
+
+        while (static_cast<int>(grooveName.getNumBytesAsUTF8()) > binaryMaxGrooveNameBytes)
+            grooveName = grooveName.dropLastCharacters(1);
+
+        auto grooveNameBytes = static_cast<int>(grooveName.getNumBytesAsUTF8());
+
+        stream.writeByte(static_cast<char>(jlimit(1, GriddleTrackData::NUM_STEPS, groove.length)));
+        stream.writeByte(static_cast<char>(grooveNameBytes));
+        stream.writeRepeatedByte(0, 6);
+        stream.write(grooveName.toRawUTF8(), static_cast<size_t>(grooveNameBytes));
+        stream.writeRepeatedByte(0, static_cast<size_t>(binaryMaxGrooveNameBytes - grooveNameBytes));
+
+        for (auto timingPercent : groove.timingPercents)
+            stream.writeByte(static_cast<char>(jlimit(-GriddleGrooveData::MAX_TIMING_PERCENT, GriddleGrooveData::MAX_TIMING_PERCENT, timingPercent)));
+
+        for (auto velocityOffset : groove.velocityOffsets)
+            stream.writeByte(static_cast<char>(jlimit(-GriddleGrooveData::MAX_VELOCITY_OFFSET, GriddleGrooveData::MAX_VELOCITY_OFFSET, velocityOffset)));
+    }
+}
+
+bool GriddleProjectFile::isBinaryProjectFile(const File& projectFile)
+{
+    return projectFile.hasFileExtension("griddlebin");
+}
+
+uint64 GriddleProjectFile::hashData(const void* data, const size_t numBytes)
+{
+    auto bytes = static_cast<const uint8*>(data);
+    auto hash = static_cast<uint64>(14695981039346656037ULL);
+
+    for (size_t byteI = 0; byteI < numBytes; ++byteI)
+    {
+        hash ^= bytes[byteI];
+        hash *= static_cast<uint64>(1099511628211ULL);
+    }
+
+    return hash;
+}
+
+Result GriddleProjectFile::writeSerialisedProject(const File& projectFile)
+{
+    // The temporary file is created in the same directory as the project file,
+    // so it can be renamed over the project file rather than copied
+    TemporaryFile tempFile(projectFile, TemporaryFile::useHiddenFile);
+
+    {
+        FileOutputStream tempStream(tempFile.getFile());
+
+        if (tempStream.failedToOpen())
+            return tempStream.getStatus();
+
+        tempStream.write(serialisedProject_.getData(), serialisedProject_.getDataSize());
+
+        // Flushing a FileOutputStream also syncs the file to the disk, so the data is
+        // there before the rename makes it the project file
+        tempStream.flush();
+
+        if (tempStream.getStatus().failed())
+            return tempStream.getStatus();
+    }
+
+    if (! tempFile.overwriteTargetFileWithTemporary())
+        return Result::fail("Couldn't replace " + projectFile.getFullPathName() + " with the saved project");
+
+    return Result::ok();
+}
@@ -0,0 +1,186 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleProjectFile.h
+    Created: 19 Oct 2026 4:21:06pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "GriddleProjectData.h"
+
+//==============================================================================
+/*
+    This class handles reading and writing Griddle project files.
+
+    A project is serialised into a buffer that is allocated once and reused for every
+    save, then written to a temporary file next to the project file, flushed through to
+    the disk and renamed over the project file. The project file is therefore always
+    either the complete old version or the complete new version, even if the application
+    or the machine dies part way through a save.
+
+    Projects can be saved as JSON (.griddle) or in a compact binary format (.griddlebin).
+    Both are written directly from the project data, without any intermediate var tree.
+    The binary format is little-endian with a fixed layout:
+
+    - A 32 byte header: the "GRIDDLE" magic, the format version, the number of tracks
+      and steps per track, and the sizes of the master, track, tempo automation and
+      groove template records
+    - The master record: tempo, wire rate, flags, the random seed (added in version 5)
+      and the MIDI output name
+    - One track record per track: the track settings followed by its step array, then
+      its swing and groove template (added in version 3), its clock rate (added in version 4),
+      the probability, ratchets and trig condition of each step (added in version 5)
+      and the rest of each step's chord (added in version 6)
+    - The tempo automation record (added in version 2): the number of measures and
+      points, followed by a fixed-size array of points
+    - The groove template record (added in version 3): the number of groove templates,
+      followed by each template's length, name and offsets
+
+    Readers use the record sizes in the header to step over any fields added by later
+    versions, so binary files are loaded straight from a memory-mapped file without
+    any per-property lookups or allocations.
+*/
+class GriddleProjectFile
+{
+public:
+    //==============================================================================
+    GriddleProjectFile();
+    ~GriddleProjectFile();
+    //==============================================================================
+
+    /** Saves the project data to the passed-in file in JSON format, replacing any existing contents
+
+        @param projectFile    The file to save the project to
+        @param projectData    The project data to write
+        @returns              Result::ok() if the project was saved, or a failed Result describing the error
+    */
+    Result save(const File& projectFile, const GriddleProjectData& projectData);
+
+    /** Saves the project data to the passed-in file in the binary format, replacing any existing contents
+
+        @param projectFile    The file to save the project to
+        @param projectData    The project data to write
+        @returns              Result::ok() if the project was saved, or a failed Result describing the error
+    */
+    Result saveBinary(const File& projectFile, const GriddleProjectData& projectData);
+
+    /** Loads a project file in either format into project data
+
+        This doesn't touch any GUI components, so it's safe to call from a background thread.
+        Properties that are missing from a JSON project file leave the corresponding project
+        data unchanged, so pass in the current project data to keep those settings.
+
+        @param projectFile    The project file to load (.griddlebin files are read as binary, anything else as JSON)
+        @param projectData    The project data to populate
+        @param errorString    Populated with a description of each property that was missing or invalid
+        @returns              Result::ok() if the project was loaded (possibly with errors), or a failed Result
+                              if the file isn't a Griddle project at all
+    */
+    static Result load(const File& projectFile, GriddleProjectData& projectData, String& errorString);
+
+    /** Reads a JSON project from a block of memory, without building a var tree
+
+        @param data           Pointer to the start of the JSON project text
+        @param numBytes       The size of the JSON project text
+        @param projectData    The project data to populate
+        @param errorString    Populated with a description of each property that was missing or invalid
+        @returns              Result::ok() if the project was read (possibly with errors), or a failed Result
+                              if the text isn't valid JSON
+    */
+    static Result readJson(const void* data, const size_t numBytes, GriddleProjectData& projectData, String& errorString);
+
+    /** Loads a binary project file by memory-mapping it
+
+        @param projectFile    The binary project file to load
+        @param projectData    The project data to populate
+        @returns              Result::ok() if the project was loaded, or a failed Result describing the error
+    */
+    static Result loadBinary(const File& projectFile, GriddleProjectData& projectData);
+
+    /** Reads binary project data from a block of memory
+
+        @param data           Pointer to the start of the binary project data
+        @param numBytes       The size of the binary project data
+        @param projectData    The project data to populate
+        @returns              Result::ok() if the data was valid, or a failed Result describing the error
+    */
+    static Result readBinary(const void* data, const size_t numBytes, GriddleProjectData& projectData);
+
+    /** Writes project data in JSON format to a stream, without building a var tree
+
+        The layout matches what JSON::writeToStream() produced for the same project.
+
+        @param stream         The stream to write to
+        @param projectData    The project data to write
+    */
+    static void writeJson(OutputStream& stream, const GriddleProjectData& projectData);
+
+    /** Writes project data in the binary format to a stream
+
+        @param stream         The stream to write to
+        @param projectData    The project data to write
+    */
+    static void writeBinary(OutputStream& stream, const GriddleProjectData& projectData);
+
+    /** Checks whether a file is a binary project file, based on its extension
+
+        @param projectFile    The file to check
+        @returns              true if the file has the binary project file extension, otherwise false
+    */
+    static bool isBinaryProjectFile(const File& projectFile);
+
+    /** Calculates a hash of serialised project data, for identifying and checking it
+
+        @param data        Pointer to the start of the data
+        @param numBytes    The size of the data
+        @returns           The 64-bit FNV-1a hash of the data
+    */
+    static uint64 hashData(const void* data, const size_t numBytes);
+
+    /** The current version of the binary project format */
+    static constexpr int BINARY_FORMAT_VERSION = 6;
+
+private:
+    //==============================================================================
+    // Serialisation Variables
+    MemoryOutputStream serialisedProject_;
+    //==============================================================================
+
+    /** Writes the serialised project to the passed-in file atomically via a temporary file
+
+        @param projectFile    The file to replace with the serialised project
+        @returns              Result::ok() if the file was replaced, or a failed Result describing the error
+    */
+    Result writeSerialisedProject(const File& projectFile);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleProjectFile)
+};
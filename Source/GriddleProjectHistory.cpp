@@ -0,0 +1,213 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleProjectHistory.cpp
+    Created: 19 Oct 2026 7:35:18pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleProjectHistory.h"
+
+#include <unordered_set>
+
+constexpr int GriddleProjectHistory::DEFAULT_MAX_NUM_STATES;
+
+//==============================================================================
+GriddleProjectHistory::GriddleProjectHistory(const int maxNumStates)
+    : currentStateIndex_(0)
+    , maxNumStates_(jmax(1, maxNumStates))
+    , coalesceSource_(nullptr)
+{
+}
+
+GriddleProjectHistory::~GriddleProjectHistory()
+{
+}
+
+void GriddleProjectHistory::reset(const GriddleProjectData& projectData)
+{
+    states_.clear();
+    states_.emplace_back();
+
+    auto& state = states_.back();
+    state.tempo = projectData.tempo;
+    state.tempoAutomation = std::make_shared<const GriddleTempoAutomationData>(projectData.tempoAutomation);
+    state.grooves = std::make_shared<const GrooveTemplates>(projectData.grooves);
+
+    for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+    {
+        state.tracks[trackI] = std::make_shared<const GriddleTrackData>(projectData.tracks[trackI]);
+    }
+
+    currentStateIndex_ = 0;
+    coalesceSource_ = nullptr;
+}
+
+bool GriddleProjectHistory::recordState(const GriddleProjectData& projectData, const void* coalesceSource)
+{
+    if (states_.empty())
+    {
+        reset(projectData);
+        return true;
+    }
+
+    // Build the new state, sharing every track that hasn't changed with the current state
+    const auto& currentState = states_[currentStateIndex_];
+
+    State newState;
+    newState.tempo = projectData.tempo;
+
+    auto hasChanged = (newState.tempo != currentState.tempo);
+
+    if (*currentState.tempoAutomation == projectData.tempoAutomation)
+    {
+        newState.tempoAutomation = currentState.tempoAutomation;
+    }
+    else
+    {
+        newState.tempoAutomation = std::make_shared<const GriddleTempoAutomationData>(projectData.tempoAutomation);
+        hasChanged = true;
+    }
+
+    if (*currentState.grooves == projectData.grooves)
+    {
+        newState.grooves = currentState.grooves;
+    }
+    else
+    {
+        newState.grooves = std::make_shared<const GrooveTemplates>(projectData.grooves);
+        hasChanged = true;
+    }
+
+    for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+    {
+        if (*currentState.tracks[trackI] == projectData.tracks[trackI])
+        {
+            newState.tracks[trackI] = currentState.tracks[trackI];
+        }
+        else
+        {
+            newState.tracks[trackI] = std::make_shared<const GriddleTrackData>(projectData.tracks[trackI]);
+            hasChanged = true;
+        }
+    }
+
+    if (! hasChanged)
+        return false;
+
+    // Any states that were undone can no longer be redone
+    states_.erase(states_.begin() + static_cast<std::ptrdiff_t>(currentStateIndex_ + 1), states_.end());
+
+    // Consecutive changes from the same source replace the state they started, so a whole slider drag is undone in one go
+    if ((coalesceSource != nullptr) && (coalesceSource == coalesceSource_) && (currentStateIndex_ > 0))
+    {
+        states_.back() = newState;
+        return true;
+    }
+
+    states_.push_back(newState);
+    ++currentStateIndex_;
+    coalesceSource_ = coalesceSource;
+
+    // Forget the oldest state once the history is full
+    if (states_.size() > static_cast<size_t>(maxNumStates_))
+    {
+        states_.pop_front();
+        --currentStateIndex_;
+    }
+
+    return true;
+}
+
+void GriddleProjectHistory::endCoalescing()
+{
+    coalesceSource_ = nullptr;
+}
+
+bool GriddleProjectHistory::undo(GriddleProjectData& projectData)
+{
+    if (! canUndo())
+        return false;
+
+    --currentStateIndex_;
+    coalesceSource_ = nullptr;
+
+    applyState(states_[currentStateIndex_], projectData);
+    return true;
+}
+
+bool GriddleProjectHistory::redo(GriddleProjectData& projectData)
+{
+    if (! canRedo())
+        return false;
+
+    ++currentStateIndex_;
+    coalesceSource_ = nullptr;
+
+    applyState(states_[currentStateIndex_], projectData);
+    return true;
+}
+
+size_t GriddleProjectHistory::getMemoryUsage() const
+{
+    std::unordered_set<const GriddleTrackData*> countedTracks;
+    std::unordered_set<const GriddleTempoAutomationData*> countedTempoAutomations;
+    std::unordered_set<const GrooveTemplates*> countedGrooves;
+    auto numBytes = states_.size() * sizeof(State);
+
+    for (const auto& state : states_)
+    {
+        if (countedTempoAutomations.insert(state.tempoAutomation.get()).second)
+            numBytes += sizeof(GriddleTempoAutomationData);
+
+        if (countedGrooves.insert(state.grooves.get()).second)
+            numBytes += sizeof(GrooveTemplates);
+
+        for (const auto& track : state.tracks)
+        {
+            // Shared tracks are only counted for the first state that holds them
+            if (countedTracks.insert(track.get()).second)
+                numBytes += sizeof(GriddleTrackData);
+        }
+    }
+
+    return numBytes;
+}
+
+void GriddleProjectHistory::applyState(const State& state, GriddleProjectData& projectData)
+{
+    projectData.tempo = state.tempo;
+    projectData.tempoAutomation = *state.tempoAutomation;
+    projectData.grooves = *state.grooves;
+
+    for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+    {
+        projectData.tracks[trackI] = *state.tracks[trackI];
+    }
+}
@@ -0,0 +1,163 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleProjectHistory.h
+    Created: 19 Oct 2026 7:35:18pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <deque>
+#include <memory>
+#include "GriddleProjectData.h"
+
+//==============================================================================
+/*
+    This class keeps the undo/redo history of a project's sequence (the tempo, the tempo
+    automation, the groove templates and the tracks with their steps).
+
+    Each state in the history is immutable and holds its tracks, tempo automation and groove
+    templates by shared pointer, so a new state only copies the parts that changed and shares the rest
+    with the state before it. An edit to one step therefore costs one track's worth of memory, however
+    long the history gets.
+
+    Consecutive changes from the same source (e.g. while a slider is being dragged) are
+    merged into a single state until endCoalescing() is called. Changes that don't affect
+    the sequence, like the MIDI output, aren't recorded at all.
+*/
+class GriddleProjectHistory
+{
+public:
+    //==============================================================================
+    /** Creates an empty history
+
+        @param maxNumStates    The maximum number of states kept, after which the oldest are forgotten
+    */
+    explicit GriddleProjectHistory(const int maxNumStates = DEFAULT_MAX_NUM_STATES);
+    ~GriddleProjectHistory();
+    //==============================================================================
+
+    /** Clears the history, making the passed-in project the only state (e.g. after a project is loaded)
+
+        @param projectData    The current project data
+    */
+    void reset(const GriddleProjectData& projectData);
+
+    /** Records the project as a new state if its sequence differs from the current state
+
+        Any states that had been undone are discarded, since they can no longer be redone.
+
+        @param projectData       The project data after the change
+        @param coalesceSource    Identifies the source of the change (e.g. the slider being dragged) so consecutive
+                                 changes from it are merged into one state, or nullptr to never merge the change
+        @returns                 true if the history changed, false if the sequence was the same as the current state
+    */
+    bool recordState(const GriddleProjectData& projectData, const void* coalesceSource = nullptr);
+
+    /** Ends the current run of merged changes, so the next change starts a new state */
+    void endCoalescing();
+
+    /** Steps back to the previous state
+
+        @param projectData    The project data to update with the previous state's sequence
+        @returns              true if there was a state to go back to, otherwise false
+    */
+    bool undo(GriddleProjectData& projectData);
+
+    /** Steps forward to the state that was last undone
+
+        @param projectData    The project data to update with the next state's sequence
+        @returns              true if there was a state to go forward to, otherwise false
+    */
+    bool redo(GriddleProjectData& projectData);
+
+    /** Checks whether there is a state to undo back to */
+    bool canUndo() const;
+
+    /** Checks whether there is a state to redo */
+    bool canRedo() const;
+
+    /** Gets the number of states in the history, including the current one */
+    int getNumStates() const;
+
+    /** Calculates the memory used by the history's states, counting each shared track once
+
+        @returns    The number of bytes used by the states and the tracks they hold
+    */
+    size_t getMemoryUsage() const;
+
+    /** The maximum number of states kept by default */
+    static constexpr int DEFAULT_MAX_NUM_STATES = 1000;
+
+private:
+    //==============================================================================
+    using GrooveTemplates = std::array<GriddleGrooveData, GriddleProjectData::NUM_GROOVES>;
+
+    /** One immutable state of the sequence, sharing unchanged tracks with the other states */
+    struct State
+    {
+        double tempo;
+        std::shared_ptr<const GriddleTempoAutomationData> tempoAutomation;
+        std::shared_ptr<const GrooveTemplates> grooves;
+        std::array<std::shared_ptr<const GriddleTrackData>, GriddleProjectData::NUM_TRACKS> tracks;
+    };
+
+    //==============================================================================
+    // History Variables
+    std::deque<State> states_;
+    size_t currentStateIndex_;
+    const int maxNumStates_;
+    const void* coalesceSource_;
+    //==============================================================================
+
+    /** Copies a state's tempo, tempo automation, groove templates and tracks into project data, leaving the other settings unchanged */
+    static void applyState(const State& state, GriddleProjectData& projectData);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleProjectHistory)
+};
+
+//==============================================================================
+// Inline Getter Definitions
+inline bool GriddleProjectHistory::canUndo() const
+{
+    return currentStateIndex_ > 0;
+}
+
+inline bool GriddleProjectHistory::canRedo() const
+{
+    return (currentStateIndex_ + 1) < states_.size();
+}
+
+inline int GriddleProjectHistory::getNumStates() const
+{
+    return static_cast<int>(states_.size());
+}
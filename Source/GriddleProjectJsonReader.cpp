@@ -0,0 +1,1043 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleProjectJsonReader.cpp
+    Created: 19 Oct 2026 6:47:12pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "GriddleProjectJsonReader.h"
+#include "GriddleTimeline.h"
+#include "GriddleTrigCondition.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+GriddleProjectJsonReader::GriddleProjectJsonReader(const void* data, const size_t numBytes)
+    : start_(static_cast<const char*>(data))
+    , end_(static_cast<const char*>(data) + numBytes)
+    , position_(static_cast<const char*>(data))
+    , failurePosition_(nullptr)
+{
+    // Property names are all short, so this is enough to avoid any reallocation while reading them
+    textBuffer_.reserve(256);
+}
+
+GriddleProjectJsonReader::~GriddleProjectJsonReader()
+{
+}
+
+Result GriddleProjectJsonReader::read(GriddleProjectData& projectData, String& errorString)
+{
+    position_ = start_;
+    failurePosition_ = nullptr;
+
+    // Skip a UTF-8 byte order mark, if there is one
+    if (((end_ - position_) >= 3) && (static_cast<uint8>(position_[0]) == 0xef) && (static_cast<uint8>(position_[1]) == 0xbb) && (static_cast<uint8>(position_[2]) == 0xbf))
+        position_ += 3;
+
+    skipWhitespace();
+
+    if (position_ >= end_)
+        return Result::fail("The file isn't valid JSON");
+
+    // The errors are only reported if the whole file could be read
+    String projectErrors("");
+    readProject(projectData, projectErrors);
+
+    skipWhitespace();
+
+    if (position_ < end_)
+        fail();
+
+    if (hasFailed())
+    {
+        auto lineNumber = 1 + static_cast<int>(std::count(start_, failurePosition_, '\n'));
+        return Result::fail("The file isn't valid JSON (line " + String(lineNumber) + ")");
+    }
+
+    errorString += projectErrors;
+
+    return Result::ok();
+}
+
+//==============================================================================
+void GriddleProjectJsonReader::readProject(GriddleProjectData& projectData, String& errorString)
+{
+    // The errors are collected per section, so they're reported in the same order whatever order the sections are in
+    String masterSettingsErrors("");
+    String sequenceErrors("");
+
+    auto hasMasterSettings = false;
+    auto hasSequence = false;
+
+    if (beginObject())
+    {
+        for (auto propertyI = 0; nextProperty(propertyI); ++propertyI)
+        {
+            if (isProperty("master_settings"))
+            {
+                hasMasterSettings = true;
+                readMasterSettings(projectData, masterSettingsErrors);
+            }
+            else if (isProperty("sequence"))
+            {
+                hasSequence = true;
+                readSequence(projectData, sequenceErrors);
+            }
+            else
+            {
+                skipValue();
+            }
+        }
+    }
+
+    if (! hasMasterSettings)
+        masterSettingsErrors += ("PROPERTY MISSING - master_settings not found in the project file" + String(NewLine::getDefault()));
+
+    if (! hasSequence)
+        sequenceErrors += ("PROPERTY MISSING - sequence property not found in the project file" + String(NewLine::getDefault()));
+
+    errorString += masterSettingsErrors + sequenceErrors;
+}
+
+void GriddleProjectJsonReader::readMasterSettings(GriddleProjectData& projectData, String& errorString)
+{
+    auto hasTempo = false;
+    auto hasMidiOutput = false;
+
+    // Tempo automation and groove templates were added after the initial release, so a project
+    // without them just has a constant tempo and empty groove templates
+    projectData.tempoAutomation = GriddleTempoAutomationData();
+    projectData.grooves.fill(GriddleGrooveData());
+    projectData.randomSeed = 0;
+
+    if (beginObject())
+    {
+        for (auto propertyI = 0; nextProperty(propertyI); ++propertyI)
+        {
+            if (isProperty("tempo"))
+            {
+                hasTempo = true;
+                projectData.tempo = jlimit(GriddleProjectData::MIN_TEMPO, GriddleProjectData::MAX_TEMPO, readNumber());
+            }
+            else if (isProperty("midi_output"))
+            {
+                hasMidiOutput = true;
+                projectData.midiOutput = readText();
+            }
+            // The MIDI output wire settings were added after the initial release, so they are optional
+            else if (isProperty("midi_wire_rate"))
+            {
+                projectData.midiWireRate = jmax(0.0, readNumber());
+            }
+            else if (isProperty("bandwidth_aware_scheduling"))
+            {
+                projectData.bandwidthAwareScheduling = readBool();
+            }
+            else if (isProperty("random_seed"))
+            {
+                projectData.randomSeed = static_cast<int>(jlimit(static_cast<double>(std::numeric_limits<int>::min()), static_cast<double>(std::numeric_limits<int>::max()), readNumber()));
+            }
+            else if (isProperty("tempo_automation"))
+            {
+                readTempoAutomation(projectData.tempoAutomation);
+            }
+            else if (isProperty("grooves"))
+            {
+                // Any groove templates beyond the number a project has are dropped
+                if (beginArray())
+                {
+                    for (auto grooveI = 0; nextElement(grooveI); ++grooveI)
+                    {
+                        if (grooveI < GriddleProjectData::NUM_GROOVES)
+                            readGroove(projectData.grooves[static_cast<size_t>(grooveI)]);
+                        else
+                            skipValue();
+                    }
+                }
+            }
+            else
+            {
+                skipValue();
+            }
+        }
+    }
+
+    if (! hasTempo)
+        errorString += ("PROPERTY MISSING - tempo property not found in master_settings" + String(NewLine::getDefault()));
+
+    if (! hasMidiOutput)
+        errorString += ("PROPERTY MISSING - midi_output property not found in master_settings" + String(NewLine::getDefault()));
+}
+
+void GriddleProjectJsonReader::readTempoAutomation(GriddleTempoAutomationData& tempoAutomation)
+{
+    if (beginObject())
+    {
+        for (auto propertyI = 0; nextProperty(propertyI); ++propertyI)
+        {
+            if (isProperty("num_measures"))
+            {
+                tempoAutomation.numMeasures = static_cast<int>(jlimit(1.0, static_cast<double>(GriddleTempoAutomationData::MAX_MEASURES), readNumber()));
+            }
+            else if (isProperty("points"))
+            {
+                auto numPoints = 0;
+
+                if (beginArray())
+                {
+                    for (; nextElement(numPoints); ++numPoints)
+                    {
+                        if (numPoints < GriddleTempoAutomationData::MAX_POINTS)
+                            readTempoPoint(tempoAutomation.points[static_cast<size_t>(numPoints)]);
+                        else
+                            skipValue();
+                    }
+                }
+
+                // Any points beyond the maximum are dropped
+                tempoAutomation.numPoints = jmin(numPoints, GriddleTempoAutomationData::MAX_POINTS);
+            }
+            else
+            {
+                skipValue();
+            }
+        }
+    }
+}
+
+void GriddleProjectJsonReader::readTempoPoint(GriddleTempoPointData& pointData)
+{
+    // Missing properties take their defaults, so a point can be written as just its beat and tempo scale
+    pointData = GriddleTempoPointData();
+
+    if (beginObject())
+    {
+        for (auto propertyI = 0; nextProperty(propertyI); ++propertyI)
+        {
+            if (isProperty("beat"))
+            {
+                pointData.beat = jmax(0.0, readNumber());
+            }
+            else if (isProperty("tempo_scale"))
+            {
+                pointData.tempoScale = jlimit(GriddleTempoAutomationData::MIN_TEMPO_SCALE, GriddleTempoAutomationData::MAX_TEMPO_SCALE, readNumber());
+            }
+            else if (isProperty("ramp"))
+            {
+                pointData.isRamp = readBool();
+            }
+            else
+            {
+                skipValue();
+            }
+        }
+    }
+}
+
+void GriddleProjectJsonReader::readGroove(GriddleGrooveData& grooveData)
+{
+    grooveData = GriddleGrooveData();
+
+    if (beginObject())
+    {
+        for (auto propertyI = 0; nextProperty(propertyI); ++propertyI)
+        {
+            if (isProperty("name"))
+            {
+                grooveData.name = readText();
+            }
+            else if (isProperty("timing_percents"))
+            {
+                // The groove repeats after as many step positions as it has timing offsets
+                grooveData.length = jlimit(1, GriddleTrackData::NUM_STEPS, readGrooveOffsets(grooveData.timingPercents, GriddleGrooveData::MAX_TIMING_PERCENT));
+            }
+            else if (isProperty("velocity_offsets"))
+            {
+                readGrooveOffsets(grooveData.velocityOffsets, GriddleGrooveData::MAX_VELOCITY_OFFSET);
+            }
+            else
+            {
+                skipValue();
+            }
+        }
+    }
+}
+
+int GriddleProjectJsonReader::readGrooveOffsets(std::array<int, GriddleTrackData::NUM_STEPS>& offsets, const int maxOffset)
+{
+    offsets.fill(0);
+    auto numOffsets = 0;
+
+    if (beginArray())
+    {
+        for (; nextElement(numOffsets); ++numOffsets)
+        {
+            if (numOffsets < GriddleTrackData::NUM_STEPS)
+                offsets[static_cast<size_t>(numOffsets)] = static_cast<int>(jlimit(static_cast<double>(-maxOffset), static_cast<double>(maxOffset), readNumber()));
+            else
+                skipValue();
+        }
+    }
+
+    return numOffsets;
+}
+
+void GriddleProjectJsonReader::readSequence(GriddleProjectData& projectData, String& errorString)
+{
+    auto hasTracks = false;
+
+    if (beginObject())
+    {
+        for (auto propertyI = 0; nextProperty(propertyI); ++propertyI)
+        {
+            if (! isProperty("tracks"))
+            {
+                skipValue();
+                continue;
+            }
+
+            hasTracks = true;
+
+            // The track errors are reported after any problem with the length of the tracks list
+            String tracksErrors("");
+            auto numTracks = 0;
+
+            if (beginArray())
+            {
+                for (; nextElement(numTracks); ++numTracks)
+                {
+                    if (numTracks < GriddleProjectData::NUM_TRACKS)
+                    {
+                        auto trackName = String::charToString(static_cast<juce_wchar>('A' + numTracks));
+                        readTrack(projectData.tracks[numTracks], trackName, tracksErrors);
+                    }
+                    else
+                    {
+                        skipValue();
+                    }
+                }
+            }
+
+            if (numTracks > GriddleProjectData::NUM_TRACKS)
+                errorString += ("INVALID TRACKS LIST - sequence has more than " + String(GriddleProjectData::NUM_TRACKS) + " track entries" + String(NewLine::getDefault()));
+            else if (numTracks < GriddleProjectData::NUM_TRACKS)
+                errorString += ("INVALID TRACKS LIST - sequence has fewer than " + String(GriddleProjectData::NUM_TRACKS) + " track entries" + String(NewLine::getDefault()));
+
+            errorString += tracksErrors;
+        }
+    }
+
+    if (! hasTracks)
+        errorString += ("PROPERTY MISSING - tracks property not found in sequence" + String(NewLine::getDefault()));
+}
+
+void GriddleProjectJsonReader::readTrack(GriddleTrackData& trackData, const String& trackName, String& errorString)
+{
+    auto hasIsActive = false;
+    auto hasMidiChannel = false;
+    auto hasNumSteps = false;
+    auto hasIsFlipped = false;
+    auto hasIsChopped = false;
+    auto hasIsBurnt = false;
+    auto hasSteps = false;
+
+    // The step errors are reported after the track settings errors and any problem with the length of the steps list
+    String stepsErrors("");
+    auto numSteps = 0;
+
+    // The latency offset properties were added after the original project format,
+    // so a missing offset just leaves the track without one
+    trackData.latencyOffset = 0.0;
+    trackData.latencyOffsetInSamples = false;
+
+    // The same goes for swing and the groove template, which leave the track straight,
+    // and the clock rate, which leaves the track's steps fitted into one measure
+    trackData.swingPercent = GriddleTrackData::MIN_SWING_PERCENT;
+    trackData.grooveIndex = -1;
+    trackData.clockRateNumerator = 0;
+    trackData.clockRateDenominator = 1;
+
+    if (beginObject())
+    {
+        for (auto propertyI = 0; nextProperty(propertyI); ++propertyI)
+        {
+            if (isProperty("is_active"))
+            {
+                hasIsActive = true;
+                trackData.isActive = readBool();
+            }
+            else if (isProperty("midi_ch"))
+            {
+                hasMidiChannel = true;
+                trackData.midiChannel = static_cast<int>(jlimit(1.0, 16.0, readNumber()));
+            }
+            else if (isProperty("num_steps"))
+            {
+                hasNumSteps = true;
+                trackData.numSteps = static_cast<int>(jlimit(1.0, static_cast<double>(GriddleTrackData::NUM_STEPS), readNumber()));
+            }
+            else if (isProperty("is_flipped"))
+            {
+                hasIsFlipped = true;
+                trackData.isFlipped = readBool();
+            }
+            else if (isProperty("is_chopped"))
+            {
+                hasIsChopped = true;
+                trackData.isChopped = readBool();
+            }
+            else if (isProperty("is_burnt"))
+            {
+                hasIsBurnt = true;
+                trackData.isBurnt = readBool();
+            }
+            else if (isProperty("latency_offset_units"))
+            {
+                trackData.latencyOffsetInSamples = (readText() == "samples");
+            }
+            else if (isProperty("latency_offset"))
+            {
+                trackData.latencyOffset = readNumber();
+            }
+            else if (isProperty("swing_percent"))
+            {
+                trackData.swingPercent = static_cast<int>(jlimit(static_cast<double>(GriddleTrackData::MIN_SWING_PERCENT), static_cast<double>(GriddleTrackData::MAX_SWING_PERCENT), readNumber()));
+            }
+            else if (isProperty("groove_index"))
+            {
+                // Anything other than the index of one of the project's groove templates means no groove template
+                auto grooveIndex = static_cast<int>(jlimit(-1.0, static_cast<double>(GriddleProjectData::NUM_GROOVES), readNumber()));
+                trackData.grooveIndex = ((grooveIndex >= 0) && (grooveIndex < GriddleProjectData::NUM_GROOVES)) ? grooveIndex : -1;
+            }
+            else if (isProperty("clock_rate"))
+            {
+                // Anything other than one of the clock rates (e.g. "fit") fits the steps into one measure
+                auto clockRateText = readText();
+                auto clockRateNumerator = clockRateText.upToFirstOccurrenceOf("/", false, false).getIntValue();
+                auto clockRateDenominator = clockRateText.containsChar('/') ? clockRateText.fromFirstOccurrenceOf("/", false, false).getIntValue() : 1;
+                auto isClocked = GriddleTimeline::isValidClockRate(clockRateNumerator, clockRateDenominator);
+
+                trackData.clockRateNumerator = isClocked ? clockRateNumerator : 0;
+                trackData.clockRateDenominator = isClocked ? clockRateDenominator : 1;
+            }
+            else if (isProperty("steps"))
+            {
+                hasSteps = true;
+                stepsErrors.clear();
+                numSteps = 0;
+
+                if (beginArray())
+                {
+                    for (; nextElement(numSteps); ++numSteps)
+                    {
+                        if (numSteps < GriddleTrackData::NUM_STEPS)
+                            readStep(trackData.steps[static_cast<size_t>(numSteps)], numSteps + 1, trackName, stepsErrors);
+                        else
+                            skipValue();
+                    }
+                }
+            }
+            else
+            {
+                skipValue();
+            }
+        }
+    }
+
+    // The units may come after the offset, so the offset is only limited once the whole track has been read
+    if (! trackData.latencyOffsetInSamples)
+        trackData.latencyOffset = jlimit(-GriddleTrackData::MAX_LATENCY_OFFSET_MS, GriddleTrackData::MAX_LATENCY_OFFSET_MS, trackData.latencyOffset);
+
+    auto missingProperty = [&errorString, &trackName](const char* propertyName)
+    {
+        errorString += ("PROPERTY MISSING - " + String(propertyName) + " property not found in track settings for track " + trackName + String(NewLine::getDefault()));
+    };
+
+    if (! hasIsActive)
+        missingProperty("is_active");
+
+    if (! hasMidiChannel)
+        missingProperty("midi_ch");
+
+    if (! hasNumSteps)
+        missingProperty("num_steps");
+
+    if (! hasIsFlipped)
+        missingProperty("is_flipped");
+
+    if (! hasIsChopped)
+        missingProperty("is_chopped");
+
+    if (! hasIsBurnt)
+        missingProperty("is_burnt");
+
+    if (hasSteps)
+    {
+        if (numSteps > GriddleTrackData::NUM_STEPS)
+            errorString += ("INVALID STEPS LIST - track " + trackName + " has more than " + String(GriddleTrackData::NUM_STEPS) + " step entries" + String(NewLine::getDefault()));
+        else if (numSteps < GriddleTrackData::NUM_STEPS)
+            errorString += ("INVALID STEPS LIST - track " + trackName + " has fewer than " + String(GriddleTrackData::NUM_STEPS) + " step entries" + String(NewLine::getDefault()));
+
+        errorString += stepsErrors;
+    }
+    else
+    {
+        missingProperty("steps");
+    }
+}
+
+void GriddleProjectJsonReader::readStep(GriddleStepData& stepData, const int stepNumber, const String& trackName, String& errorString)
+{
+    auto hasNoteNumber = false;
+    auto hasVelocity = false;
+    auto hasGatePercent = false;
+
+    // The probability, ratchets and trig condition were added after the original project format,
+    // so a step without them always plays its note once
+    stepData.probability = 100;
+    stepData.ratchets = 1;
+    stepData.condition = GriddleTrigCondition::NONE;
+
+    // Chords were added later too, so a step without a chord_notes list just plays its own note
+    stepData.numChordNotes = 0;
+    stepData.chordNotes.fill(GriddleChordNoteData());
+
+    if (beginObject())
+    {
+        for (auto propertyI = 0; nextProperty(propertyI); ++propertyI)
+        {
+            if (isProperty("note_number"))
+            {
+                hasNoteNumber = true;
+                stepData.noteNumber = static_cast<int>(jlimit(-1.0, 127.0, readNumber()));
+            }
+            else if (isProperty("velocity"))
+            {
+                hasVelocity = true;
+                stepData.velocity = static_cast<int>(jlimit(0.0, 127.0, readNumber()));
+            }
+            else if (isProperty("gate_percent"))
+            {
+                hasGatePercent = true;
+                stepData.gatePercent = static_cast<int>(jlimit(0.0, 100.0, readNumber()));
+            }
+            else if (isProperty("probability"))
+            {
+                stepData.probability = static_cast<int>(jlimit(0.0, 100.0, readNumber()));
+            }
+            else if (isProperty("ratchets"))
+            {
+                stepData.ratchets = static_cast<int>(jlimit(1.0, static_cast<double>(GriddleStepData::MAX_RATCHETS), readNumber()));
+            }
+            else if (isProperty("condition"))
+            {
+                // Anything other than the name of one of the trig conditions means no condition
+                stepData.condition = GriddleTrigCondition::fromName(readText());
+            }
+            else if (isProperty("chord_notes"))
+            {
+                auto numChordNotes = 0;
+
+                if (beginArray())
+                {
+                    for (; nextElement(numChordNotes); ++numChordNotes)
+                    {
+                        if (numChordNotes < (GriddleStepData::MAX_CHORD_NOTES - 1))
+                            readChordNote(stepData.chordNotes[static_cast<size_t>(numChordNotes)]);
+                        else
+                            skipValue();
+                    }
+                }
+
+                // Any notes beyond the largest chord are dropped
+                stepData.numChordNotes = jmin(numChordNotes, GriddleStepData::MAX_CHORD_NOTES - 1);
+            }
+            else
+            {
+                skipValue();
+            }
+        }
+    }
+
+    auto missingProperty = [&errorString, &trackName, stepNumber](const char* propertyName)
+    {
+        errorString += ("PROPERTY MISSING - " + String(propertyName) + " property not found for step " + String(stepNumber) + " in track settings for track " + trackName + String(NewLine::getDefault()));
+    };
+
+    if (! hasNoteNumber)
+        missingProperty("note_number");
+
+    if (! hasVelocity)
+        missingProperty("velocity");
+
+    if (! hasGatePercent)
+        missingProperty("gate_percent");
+}
+
+void GriddleProjectJsonReader::readChordNote(GriddleChordNoteData& chordNoteData)
+{
+    chordNoteData = GriddleChordNoteData();
+
+    if (beginObject())
+    {
+        for (auto propertyI = 0; nextProperty(propertyI); ++propertyI)
+        {
+            if (isProperty("note_number"))
+            {
+                chordNoteData.noteNumber = static_cast<int>(jlimit(0.0, 127.0, readNumber()));
+            }
+            else if (isProperty("velocity"))
+            {
+                chordNoteData.velocity = static_cast<int>(jlimit(0.0, 127.0, readNumber()));
+            }
+            else
+            {
+                skipValue();
+            }
+        }
+    }
+}
+
+//==============================================================================
+bool GriddleProjectJsonReader::beginObject()
+{
+    skipWhitespace();
+
+    if ((position_ < end_) && (*position_ == '{'))
+    {
+        ++position_;
+        return true;
+    }
+
+    skipValue();
+    return false;
+}
+
+bool GriddleProjectJsonReader::nextProperty(const int propertyIndex)
+{
+    if (hasFailed())
+        return false;
+
+    skipWhitespace();
+
+    if (position_ >= end_)
+    {
+        fail();
+        return false;
+    }
+
+    if (*position_ == '}')
+    {
+        ++position_;
+        return false;
+    }
+
+    // Every property after the first is preceded by a comma
+    if (propertyIndex > 0)
+    {
+        if (*position_ != ',')
+        {
+            fail();
+            return false;
+        }
+
+        ++position_;
+        skipWhitespace();
+    }
+
+    if ((position_ >= end_) || (*position_ != '"') || ! readString())
+    {
+        fail();
+        return false;
+    }
+
+    skipWhitespace();
+
+    if ((position_ >= end_) || (*position_ != ':'))
+    {
+        fail();
+        return false;
+    }
+
+    ++position_;
+    return true;
+}
+
+bool GriddleProjectJsonReader::beginArray()
+{
+    skipWhitespace();
+
+    if ((position_ < end_) && (*position_ == '['))
+    {
+        ++position_;
+        return true;
+    }
+
+    skipValue();
+    return false;
+}
+
+bool GriddleProjectJsonReader::nextElement(const int elementIndex)
+{
+    if (hasFailed())
+        return false;
+
+    skipWhitespace();
+
+    if (position_ >= end_)
+    {
+        fail();
+        return false;
+    }
+
+    if (*position_ == ']')
+    {
+        ++position_;
+        return false;
+    }
+
+    // Every element after the first is preceded by a comma
+    if (elementIndex > 0)
+    {
+        if (*position_ != ',')
+        {
+            fail();
+            return false;
+        }
+
+        ++position_;
+    }
+
+    return true;
+}
+
+double GriddleProjectJsonReader::readNumber()
+{
+    skipWhitespace();
+
+    if (position_ >= end_)
+    {
+        fail();
+        return 0.0;
+    }
+
+    auto firstChar = *position_;
+
+    if ((firstChar == '-') || ((firstChar >= '0') && (firstChar <= '9')))
+    {
+        // Copy the number into a null-terminated buffer, since the text itself may not be null-terminated
+        char numberText[64];
+        size_t numberLength = 0;
+
+        while ((position_ < end_) && (std::strchr("0123456789+-.eE", *position_) != nullptr) && (*position_ != 0))
+        {
+            if (numberLength == (sizeof(numberText) - 1))
+            {
+                fail();
+                return 0.0;
+            }
+
+            numberText[numberLength++] = *position_++;
+        }
+
+        numberText[numberLength] = 0;
+
+        CharPointer_ASCII numberPointer(numberText);
+        return CharacterFunctions::readDoubleValue(numberPointer);
+    }
+
+    if (firstChar == '"')
+    {
+        if (! readString())
+            return 0.0;
+
+        return String::fromUTF8(textBuffer_.data(), static_cast<int>(textBuffer_.size())).getDoubleValue();
+    }
+
+    if (firstChar == 't')
+        return readLiteral("true") ? 1.0 : 0.0;
+
+    // false, null, objects and arrays all convert to 0
+    if ((firstChar == 'f') || (firstChar == 'n') || (firstChar == '{') || (firstChar == '['))
+        skipValue();
+    else
+        fail();
+
+    return 0.0;
+}
+
+bool GriddleProjectJsonReader::readBool()
+{
+    return readNumber() != 0.0;
+}
+
+String GriddleProjectJsonReader::readText()
+{
+    skipWhitespace();
+
+    if ((position_ < end_) && (*position_ == '"') && readString())
+        return String::fromUTF8(textBuffer_.data(), static_cast<int>(textBuffer_.size()));
+
+    skipValue();
+    return String();
+}
+
+bool GriddleProjectJsonReader::readString()
+{
+    textBuffer_.clear();
+
+    // Skip the opening quote
+    ++position_;
+
+    while (position_ < end_)
+    {
+        // Copy runs of plain characters in one go
+        auto runStart = position_;
+
+        while ((position_ < end_) && (*position_ != '"') && (*position_ != '\\'))
+            ++position_;
+
+        textBuffer_.append(runStart, static_cast<size_t>(position_ - runStart));
+
+        if (position_ >= end_)
+            break;
+
+        if (*position_++ == '"')
+            return true;
+
+        // Decode an escape sequence
+        if (position_ >= end_)
+            break;
+
+        auto escapeChar = *position_++;
+
+        switch (escapeChar)
+        {
+            case '"':   textBuffer_ += '"'; break;
+            case '\\':  textBuffer_ += '\\'; break;
+            case '/':   textBuffer_ += '/'; break;
+            case 'b':   textBuffer_ += '\b'; break;
+            case 'f':   textBuffer_ += '\f'; break;
+            case 'n':   textBuffer_ += '\n'; break;
+            case 'r':   textBuffer_ += '\r'; break;
+            case 't':   textBuffer_ += '\t'; break;
+
+            case 'u':
+            {
+                auto readHexCodeUnit = [this](uint32& codeUnit)
+                {
+                    if ((end_ - position_) < 4)
+                        return false;
+
+                    codeUnit = 0;
+
+                    for (auto digitI = 0; digitI < 4; ++digitI)
+                    {
+                        auto digitValue = CharacterFunctions::getHexDigitValue(static_cast<juce_wchar>(*position_++));
+
+                        if (digitValue < 0)
+                            return false;
+
+                        codeUnit = (codeUnit << 4) | static_cast<uint32>(digitValue);
+                    }
+
+                    return true;
+                };
+
+                uint32 codePoint = 0;
+
+                if (! readHexCodeUnit(codePoint))
+                {
+                    fail();
+                    return false;
+                }
+
+                // Combine a UTF-16 surrogate pair into a single code point
+                if ((codePoint >= 0xd800) && (codePoint <= 0xdbff) && ((end_ - position_) >= 6) && (position_[0] == '\\') && (position_[1] == 'u'))
+                {
+                    position_ += 2;
+                    uint32 lowSurrogate = 0;
+
+                    if (! readHexCodeUnit(lowSurrogate) || (lowSurrogate < 0xdc00) || (lowSurrogate > 0xdfff))
+                    {
+                        fail();
+                        return false;
+                    }
+
+                    codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+                }
+
+                // Encode the code point as UTF-8
+                if (codePoint < 0x80)
+                {
+                    textBuffer_ += static_cast<char>(codePoint);
+                }
+                else if (codePoint < 0x800)
+                {
+                    textBuffer_ += static_cast<char>(0xc0 | (codePoint >> 6));
+                    textBuffer_ += static_cast<char>(0x80 | (codePoint & 0x3f));
+                }
+                else if (codePoint < 0x10000)
+                {
+                    textBuffer_ += static_cast<char>(0xe0 | (codePoint >> 12));
+                    textBuffer_ += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+                    textBuffer_ += static_cast<char>(0x80 | (codePoint & 0x3f));
+                }
+                else
+                {
+                    textBuffer_ += static_cast<char>(0xf0 | (codePoint >> 18));
+                    textBuffer_ += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+                    textBuffer_ += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+                    textBuffer_ += static_cast<char>(0x80 | (codePoint & 0x3f));
+                }
+
+                break;
+            }
+
+            default:
+                fail();
+                return false;
+        }
+    }
+
+    // The text ended inside the string
+    fail();
+    return false;
+}
+
+bool GriddleProjectJsonReader::readLiteral(const char* literal)
+{
+    auto literalLength = std::strlen(literal);
+
+    if ((static_cast<size_t>(end_ - position_) < literalLength) || (std::memcmp(position_, literal, literalLength) != 0))
+    {
+        fail();
+        return false;
+    }
+
+    position_ += literalLength;
+    return true;
+}
+
+void GriddleProjectJsonReader::skipValue()
+{
+    skipWhitespace();
+
+    if (position_ >= end_)
+    {
+        fail();
+        return;
+    }
+
+    switch (*position_)
+    {
+        case '"':
+            readString();
+            return;
+
+        case 't':
+            readLiteral("true");
+            return;
+
+        case 'f':
+            readLiteral("false");
+            return;
+
+        case 'n':
+            readLiteral("null");
+            return;
+
+        case '{':
+        case '[':
+            break;
+
+        default:
+            readNumber();
+            return;
+    }
+
+    // Skip a whole object or array by tracking the nesting depth, rather than reading each value
+    auto depth = 0;
+
+    do
+    {
+        skipWhitespace();
+
+        if (position_ >= end_)
+        {
+            fail();
+            return;
+        }
+
+        auto nextChar = *position_;
+
+        if ((nextChar == '{') || (nextChar == '['))
+        {
+            ++depth;
+            ++position_;
+        }
+        else if ((nextChar == '}') || (nextChar == ']'))
+        {
+            --depth;
+            ++position_;
+        }
+        else if (nextChar == '"')
+        {
+            if (! readString())
+                return;
+        }
+        else
+        {
+            ++position_;
+        }
+    }
+    while (depth > 0);
+}
+
+void GriddleProjectJsonReader::skipWhitespace()
+{
+    while ((position_ < end_) && ((*position_ == ' ') || (*position_ == '\n') || (*position_ == '\r') || (*position_ == '\t')))
+        ++position_;
+}
+
+bool GriddleProjectJsonReader::isProperty(const char* propertyName) const
+{
+    return textBuffer_ == propertyName;
+}
+
+void GriddleProjectJsonReader::fail()
+{
+    if (failurePosition_ == nullptr)
+        failurePosition_ = jmin(position_, end_);
+
+    // Moving to the end stops every loop that's reading the text
+    position_ = end_;
+}
@@ -0,0 +1,203 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleProjectJsonReader.h
+    Created: 19 Oct 2026 6:47:12pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "GriddleProjectData.h"
+
+#include <string>
+
+//==============================================================================
+/*
+    This class reads a JSON Griddle project straight into project data.
+
+    Rather than parsing the whole file into a var tree first and then looking up each
+    property by name, the reader walks through the JSON text once and stores each
+    recognised value in the project data as it reaches it. Unrecognised properties and
+    extra track or step entries are skipped over without being parsed into anything.
+
+    The only allocations are the scratch buffer used for property names and the MIDI
+    output name, so the cost of a load no longer grows with an allocation per step.
+
+    Missing or invalid properties are reported in the same way as before, and leave
+    the corresponding project data unchanged (apart from the track latency offset,
+    which defaults to none).
+*/
+class GriddleProjectJsonReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader for a block of JSON text, which must stay valid while the reader is used
+
+        @param data        Pointer to the start of the JSON text (UTF-8, not necessarily null-terminated)
+        @param numBytes    The size of the JSON text
+    */
+    GriddleProjectJsonReader(const void* data, const size_t numBytes);
+    ~GriddleProjectJsonReader();
+    //==============================================================================
+
+    /** Reads the JSON project into project data
+
+        @param projectData    The project data to populate
+        @param errorString    Populated with a description of each property that was missing or invalid
+        @returns              Result::ok() if the project was read (possibly with errors), or a failed Result
+                              if the text isn't valid JSON
+    */
+    Result read(GriddleProjectData& projectData, String& errorString);
+
+private:
+    //==============================================================================
+    // Text Variables
+    const char* const start_;
+    const char* const end_;
+    const char* position_;
+    const char* failurePosition_;
+    std::string textBuffer_;
+    //==============================================================================
+
+    //==============================================================================
+    // Project Structure Methods
+
+    /** Reads the top-level project object */
+    void readProject(GriddleProjectData& projectData, String& errorString);
+
+    /** Reads the master_settings object */
+    void readMasterSettings(GriddleProjectData& projectData, String& errorString);
+
+    /** Reads the tempo_automation object of the master settings */
+    void readTempoAutomation(GriddleTempoAutomationData& tempoAutomation);
+
+    /** Reads one point of the tempo automation's points list */
+    void readTempoPoint(GriddleTempoPointData& pointData);
+
+    /** Reads one groove template of the master settings' grooves list */
+    void readGroove(GriddleGrooveData& grooveData);
+
+    /** Reads a list of a groove template's offsets, one for each step position
+
+        @param offsets        The offsets to populate (positions missing from the list are set to 0)
+        @param maxOffset      The largest offset either way, which the values are limited to
+        @returns              The number of values in the list
+    */
+    int readGrooveOffsets(std::array<int, GriddleTrackData::NUM_STEPS>& offsets, const int maxOffset);
+
+    /** Reads the sequence object, which holds the tracks list */
+    void readSequence(GriddleProjectData& projectData, String& errorString);
+
+    /** Reads the settings of one track, including its steps list */
+    void readTrack(GriddleTrackData& trackData, const String& trackName, String& errorString);
+
+    /** Reads the settings of one step
+
+        @param stepData       The step data to populate
+        @param stepNumber     The 1-based number of the step, for error messages
+        @param trackName      The name of the step's track, for error messages
+        @param errorString    Populated with a description of each property that was missing
+    */
+    void readStep(GriddleStepData& stepData, const int stepNumber, const String& trackName, String& errorString);
+
+    /** Reads one note of a step's chord_notes list */
+    void readChordNote(GriddleChordNoteData& chordNoteData);
+    //==============================================================================
+
+    //==============================================================================
+    // JSON Scanning Methods
+
+    /** Starts reading an object value
+
+        @returns    true if the next value is an object, otherwise false (in which case the value is skipped)
+    */
+    bool beginObject();
+
+    /** Moves on to the next property of the object being read, reading its name into textBuffer_
+
+        @param propertyIndex    The number of properties already read from the object
+        @returns                true if there is another property, or false at the end of the object
+    */
+    bool nextProperty(const int propertyIndex);
+
+    /** Starts reading an array value
+
+        @returns    true if the next value is an array, otherwise false (in which case the value is skipped)
+    */
+    bool beginArray();
+
+    /** Moves on to the next element of the array being read
+
+        @param elementIndex    The number of elements already read from the array
+        @returns               true if there is another element, or false at the end of the array
+    */
+    bool nextElement(const int elementIndex);
+
+    /** Reads the next value as a number, the way a var would convert it (true is 1, false, null and containers are 0) */
+    double readNumber();
+
+    /** Reads the next value as a bool, the way a var would convert it */
+    bool readBool();
+
+    /** Reads the next value as text (values that aren't strings give an empty string) */
+    String readText();
+
+    /** Reads a string value into textBuffer_ as UTF-8, decoding any escape sequences
+
+        @returns    true if a valid string was read, otherwise false
+    */
+    bool readString();
+
+    /** Reads a true, false or null literal
+
+        @param literal    The literal to read
+        @returns          true if the literal was read, otherwise false
+    */
+    bool readLiteral(const char* literal);
+
+    /** Skips over the next value, including any nested objects and arrays */
+    void skipValue();
+
+    /** Skips over any whitespace */
+    void skipWhitespace();
+
+    /** Checks whether the property name in textBuffer_ matches the passed-in name */
+    bool isProperty(const char* propertyName) const;
+
+    /** Stops reading because the text isn't valid JSON, remembering where the problem was */
+    void fail();
+
+    /** Checks whether reading has stopped because of invalid JSON */
+    bool hasFailed() const { return failurePosition_ != nullptr; }
+    //==============================================================================
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleProjectJsonReader)
+};
@@ -0,0 +1,615 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleScheduler.cpp
+    Created: 19 Oct 2026 11:03:27am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleScheduler.h"
+#include "GriddleTrace.h"
+#include "GriddleTrigCondition.h"
+
+//==============================================================================
+GriddleScheduler::GriddleScheduler(GriddleOutputEncoder& outputEncoder)
+    : outputEncoder_(outputEncoder)
+    , sourceGeneration_(0)
+    , sourceTempoMapChanged_(false)
+    , sourceGrooveChanged_(false)
+    , sourceTimingAtMeasure_(false)
+    , sourceRandomSeed_(0)
+    , anchorTime_(0.0)
+    , anchorMapSeconds_(0.0)
+    , nextMeasureIndex_(0)
+    , queuedMeasureIndex_(0)
+    , queuedMeasureGeneration_(0)
+    , measureStartPending_(false)
+    , measureStartTime_(0.0)
+    , currentBPM_(120.0)
+    , measureIndex_(0)
+    , measureGeneration_(0)
+    , dispatchedUntilTime_(0.0)
+    , wireBusyUntilTime_(0.0)
+    , bandwidthAwareScheduling_(false)
+    , fillActive_(false)
+{
+    // Reserve room for a couple of very busy measures of each track (every step ratcheted as far as it goes, or a full
+    // chord on every step ratcheted twice) up front so that queueing doesn't allocate on the playback thread
+    for (auto& trackQueue : trackQueues_)
+        trackQueue.reserve(GriddleTimeline::MAX_NOTES_PER_MEASURE * GriddleStepData::MAX_RATCHETS * 2 * 2);
+
+    previousTrigsPlayed_.fill(false);
+    trigsPlayed_.fill(false);
+}
+
+GriddleScheduler::~GriddleScheduler()
+{
+}
+
+int64 GriddleScheduler::swapSourceMeasure(GriddleCompiledMeasure& sourceMeasure)
+{
+    const SpinLock::ScopedLockType lock(sourceLock_);
+
+    std::swap(sourceMeasure_, sourceMeasure);
+
+    return ++sourceGeneration_;
+}
+
+int64 GriddleScheduler::swapSourceMeasure(GriddleCompiledMeasure& sourceMeasure, const GriddleTempoMap& tempoMap, const GriddleGroove& groove)
+{
+    const SpinLock::ScopedLockType lock(sourceLock_);
+
+    std::swap(sourceMeasure_, sourceMeasure);
+
+    sourceTempoMap_ = tempoMap;
+    sourceTempoMapChanged_ = true;
+    sourceGroove_ = groove;
+    sourceGrooveChanged_ = true;
+    sourceTimingAtMeasure_ = true;
+
+    return ++sourceGeneration_;
+}
+
+void GriddleScheduler::setTempoMap(const GriddleTempoMap& tempoMap)
+{
+    const SpinLock::ScopedLockType lock(sourceLock_);
+
+    sourceTempoMap_ = tempoMap;
+    sourceTempoMapChanged_ = true;
+}
+
+void GriddleScheduler::setGroove(const GriddleGroove& groove)
+{
+    const SpinLock::ScopedLockType lock(sourceLock_);
+
+    sourceGroove_ = groove;
+    sourceGrooveChanged_ = true;
+}
+
+void GriddleScheduler::setRandomSeed(const int randomSeed)
+{
+    const SpinLock::ScopedLockType lock(sourceLock_);
+
+    sourceRandomSeed_ = randomSeed;
+}
+
+void GriddleScheduler::setFillActive(const bool fillActive)
+{
+    fillActive_ = fillActive;
+}
+
+void GriddleScheduler::setBandwidthAwareScheduling(const bool bandwidthAwareScheduling)
+{
+    bandwidthAwareScheduling_ = bandwidthAwareScheduling;
+}
+
+void GriddleScheduler::start(const double clockTime)
+{
+    for (auto& trackQueue : trackQueues_)
+        trackQueue.clear();
+
+    dispatchedUntilTime_ = clockTime;
+    wireBusyUntilTime_ = clockTime;
+    measureStartPending_ = false;
+    nextMeasureIndex_ = 0;
+    measureIndex_ = 0;
+
+    telemetry_.reset();
+
+    double lookAheadSeconds;
+    {
+        const SpinLock::ScopedLockType lock(sourceLock_);
+
+        lookAheadSeconds = sourceMeasure_.lookAheadSeconds;
+        measureGeneration_ = sourceGeneration_;
+        tempoMap_ = sourceTempoMap_;
+        sourceTempoMapChanged_ = false;
+        groove_ = sourceGroove_;
+        sourceGrooveChanged_ = false;
+        sourceTimingAtMeasure_ = false;
+
+        // Each track's random numbers are seeded from the project's seed and the track's index, so playback
+        // always starts the same way for the same seed
+        for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+        {
+            trackRandoms_[trackI].setSeed(sourceRandomSeed_);
+            trackRandoms_[trackI].combineSeed(trackI);
+        }
+    }
+
+    previousTrigsPlayed_.fill(false);
+
+    // Pre-roll by the look-ahead, so the first measure can be queued as early as every other measure
+    anchorTime_ = clockTime + lookAheadSeconds;
+    anchorMapSeconds_ = 0.0;
+    measureStartTime_ = anchorTime_;
+    currentBPM_ = tempoMap_.getTempoAtBeat(0.0);
+}
+
+void GriddleScheduler::stop()
+{
+    // Drop the events that haven't been sent and release exactly the notes the output encoder has
+    // sounding. Ports that schedule ahead may still have NOTE ONs queued up to the dispatch horizon,
+    // so the NOTE OFFs are scheduled after them.
+    for (auto& trackQueue : trackQueues_)
+        trackQueue.clear();
+
+    outputEncoder_.releaseAllNotes(dispatchedUntilTime_);
+    measureStartPending_ = false;
+}
+
+bool GriddleScheduler::process(const double clockTime)
+{
+    // Pick up any tempo or groove change before working out which events are due
+    updateTiming();
+
+    // Send up to the time plus the schedule-ahead time of the output port for ports that do their own timing
+    auto scheduleAheadSeconds = outputEncoder_.getScheduleAheadSeconds();
+    dispatchedUntilTime_ = clockTime + scheduleAheadSeconds;
+
+    dispatchDueEvents(scheduleAheadSeconds);
+
+    queueNextMeasure(dispatchedUntilTime_);
+
+    auto currentBeat = tempoMap_.getBeatAtSeconds(clockTime - anchorTime_ + anchorMapSeconds_);
+    currentBPM_ = tempoMap_.getTempoAtBeat(currentBeat);
+
+    // Report the start of the queued measure once it has been reached
+    if (measureStartPending_)
+    {
+        auto queuedMeasureStartTime = getTimeAtTick(queuedMeasureIndex_ * GriddleTimeline::TICKS_PER_MEASURE);
+
+        if (clockTime >= queuedMeasureStartTime)
+        {
+            // Close the wire statistics for the measure that just finished
+            outputEncoder_.startMeasure(queuedMeasureStartTime - measureStartTime_);
+
+            measureStartTime_ = queuedMeasureStartTime;
+            measureIndex_ = queuedMeasureIndex_;
+            measureGeneration_ = queuedMeasureGeneration_;
+            measureStartPending_ = false;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void GriddleScheduler::updateTiming()
+{
+    // Never wait on the message thread - if it's setting a new tempo map or groove, pick it up next pass. The
+    // tempo map and groove of a pattern switch wait for the measure the switch happens at (see queueNextMeasure()).
+    const SpinLock::ScopedTryLockType lock(sourceLock_);
+
+    if (! lock.isLocked() || sourceTimingAtMeasure_ || ! (sourceTempoMapChanged_ || sourceGrooveChanged_))
+        return;
+
+    if (sourceTempoMapChanged_)
+    {
+        // Anchor the new tempo map at the position reached at the dispatch time, since everything before it has
+        // already been sent, so the timeline carries on from there without a jump
+        auto anchorBeat = tempoMap_.getBeatAtSeconds(dispatchedUntilTime_ - anchorTime_ + anchorMapSeconds_);
+
+        tempoMap_ = sourceTempoMap_;
+        sourceTempoMapChanged_ = false;
+
+        anchorTime_ = dispatchedUntilTime_;
+        anchorMapSeconds_ = tempoMap_.getSecondsAtBeat(anchorBeat);
+    }
+
+    if (sourceGrooveChanged_)
+    {
+        groove_ = sourceGroove_;
+        sourceGrooveChanged_ = false;
+    }
+
+    // Retime the events still waiting, then put each track's queue back in order with an insertion sort, which
+    // doesn't allocate and keeps events that are due together in their compiled order
+    for (auto& trackQueue : trackQueues_)
+    {
+        for (auto& queuedEvent : trackQueue)
+            timeQueuedEvent(queuedEvent);
+
+        for (auto eventI = size_t(1); eventI < trackQueue.size(); ++eventI)
+        {
+            for (auto sortI = eventI; (sortI > 0) && (trackQueue[sortI - 1].nominalTime > trackQueue[sortI].nominalTime); --sortI)
+                std::swap(trackQueue[sortI - 1], trackQueue[sortI]);
+        }
+    }
+
+    // The bursts were spread for the old times, so spread them again
+    spreadEventBursts();
+}
+
+void GriddleScheduler::spreadEventBursts()
+{
+    auto wireRate = outputEncoder_.getWireRate();
+
+    if (! bandwidthAwareScheduling_ || (wireRate <= 0.0))
+    {
+        for (auto& trackQueue : trackQueues_)
+        {
+            for (auto& queuedEvent : trackQueue)
+                queuedEvent.dueTime = queuedEvent.nominalTime;
+        }
+
+        return;
+    }
+
+    // Each track's queue is in nominal order, so the next event to send is the earliest of the tracks' next events
+    std::array<size_t, GriddleProjectData::NUM_TRACKS> nextEvents {};
+
+    auto getNextTrack = [this, &nextEvents]()
+    {
+        auto nextTrackI = -1;
+
+        for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+        {
+            if ((nextEvents[trackI] < trackQueues_[trackI].size())
+                && ((nextTrackI < 0) || isQueuedEventNominallyLater(trackQueues_[nextTrackI][nextEvents[nextTrackI]], trackQueues_[trackI][nextEvents[trackI]])))
+                nextTrackI = trackI;
+        }
+
+        return nextTrackI;
+    };
+
+    // The first burst can't go out until the events already sent have cleared the wire
+    auto previousBurstEnd = wireBusyUntilTime_;
+    auto trackI = getNextTrack();
+
+    while (trackI >= 0)
+    {
+        // Gather a burst: events that would still be queued on the wire when the next event is due
+        auto burstStartEvents = nextEvents;
+        auto burstNominalStart = trackQueues_[trackI][nextEvents[trackI]].nominalTime;
+        auto burstWireSeconds = 0.0;
+        auto numBurstEvents = 0;
+        uint8 runningStatus = 0;
+
+        do
+        {
+            const auto& message = trackQueues_[trackI][nextEvents[trackI]++].event.message;
+            burstWireSeconds += GriddleOutputEncoder::getWireTimeSeconds(GriddleOutputEncoder::getWireByteCount(message, runningStatus), wireRate);
+            runningStatus = GriddleOutputEncoder::getEncodedStatusByte(message);
+            ++numBurstEvents;
+            trackI = getNextTrack();
+        } while ((trackI >= 0) && (trackQueues_[trackI][nextEvents[trackI]].nominalTime < (burstNominalStart + burstWireSeconds)));
+
+        // Centre the burst on its nominal start time so the earliest and latest events are off by the same amount,
+        // without overlapping the previous burst (the look-ahead covers any that move before the start of their
+        // measure). The burst is walked again from its start and sent back to back in the same order, which only
+        // puts the most important events first among events due together, so a NOTE OFF never goes ahead of its NOTE ON.
+        nextEvents = burstStartEvents;
+        auto sendTime = jmax(previousBurstEnd, burstNominalStart - (burstWireSeconds * 0.5));
+        runningStatus = 0;
+
+        for (auto burstI = 0; burstI < numBurstEvents; ++burstI)
+        {
+            auto burstTrackI = getNextTrack();
+            auto& queuedEvent = trackQueues_[burstTrackI][nextEvents[burstTrackI]++];
+
+            queuedEvent.dueTime = sendTime;
+            sendTime += GriddleOutputEncoder::getWireTimeSeconds(GriddleOutputEncoder::getWireByteCount(queuedEvent.event.message, runningStatus), wireRate);
+            runningStatus = GriddleOutputEncoder::getEncodedStatusByte(queuedEvent.event.message);
+        }
+
+        previousBurstEnd = sendTime;
+    }
+}
+
+void GriddleScheduler::queueNextMeasure(const double dispatchTime)
+{
+    // Only one measure is queued ahead at a time
+    if (measureStartPending_)
+        return;
+
+    // Never wait on the message thread - if it's swapping in a new source measure, try again next pass
+    const SpinLock::ScopedTryLockType lock(sourceLock_);
+
+    if (! lock.isLocked())
+        return;
+
+    auto measureStartTick = nextMeasureIndex_ * GriddleTimeline::TICKS_PER_MEASURE;
+    auto measureEndTick = measureStartTick + GriddleTimeline::TICKS_PER_MEASURE;
+
+    // The groove can move the first notes of the measure before its start as well as the look-ahead
+    auto earliestNoteTime = getTimeAtTick(measureStartTick - groove_.getMaxEarlyTicks());
+
+    // After a pattern switch, the measure's notes are played with the new pattern's tempo map and groove from the
+    // time the old tempo map gives the start of the measure
+    if (sourceTimingAtMeasure_)
+    {
+        auto earlySeconds = sourceTempoMap_.getSecondsAtBeat(GriddleTimeline::ticksToBeats(measureStartTick))
+                          - sourceTempoMap_.getSecondsAtBeat(GriddleTimeline::ticksToBeats(measureStartTick - sourceGroove_.getMaxEarlyTicks()));
+        earliestNoteTime = getTimeAtTick(measureStartTick) - earlySeconds;
+    }
+
+    if (dispatchTime + sourceMeasure_.lookAheadSeconds < earliestNoteTime)
+        return;
+
+    GRIDDLE_TRACE_SCOPE("GriddleScheduler::queueNextMeasure");
+
+    if (sourceTimingAtMeasure_)
+        switchTimingAtMeasure(measureStartTick);
+
+    // Each track's cycles repeat from the start of playback, so the cycles overlapping the measure are found from
+    // the measure's position, and the notes that start in the measure are queued at the times the tempo map gives them
+    for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+    {
+        const auto& sourceTrack = sourceMeasure_.tracks[trackI];
+
+        if (sourceTrack.cycleTicks <= 0)
+            continue;
+
+        jassert(sourceTrack.trigs.size() <= trigsPlayed_.size());
+
+        for (auto cycleStartTick = measureStartTick - (measureStartTick % sourceTrack.cycleTicks); cycleStartTick < measureEndTick;
+             cycleStartTick += sourceTrack.cycleTicks)
+        {
+            // Decide which of the trigs that start in the measure play, in order, before their notes are queued
+            for (auto trigI = size_t(0); trigI < sourceTrack.trigs.size(); ++trigI)
+            {
+                const auto& trig = sourceTrack.trigs[trigI];
+                auto trigTick = cycleStartTick + trig.tick;
+
+                if ((trigTick >= measureStartTick) && (trigTick < measureEndTick))
+                    trigsPlayed_[trigI] = isTrigPlayed(trackI, trig, trigTick / sourceTrack.patternTicks);
+            }
+
+            for (const auto& sourceEvent : sourceTrack.events)
+            {
+                auto noteStartTick = cycleStartTick + sourceEvent.tick;
+
+                // A trig's notes (including all of its ratchets) belong to the measure the trig starts in
+                auto sliceTick = noteStartTick;
+
+                if (sourceEvent.trigIndex >= 0)
+                    sliceTick = cycleStartTick + sourceTrack.trigs[static_cast<size_t>(sourceEvent.trigIndex)].tick;
+
+                if ((sliceTick < measureStartTick) || (sliceTick >= measureEndTick))
+                    continue;
+
+                if ((sourceEvent.trigIndex >= 0) && ! trigsPlayed_[static_cast<size_t>(sourceEvent.trigIndex)])
+                    continue;
+
+                QueuedEvent queuedEvent { 0.0, 0.0, 0, sourceEvent };
+                queuedEvent.event.tick = noteStartTick;
+                timeQueuedEvent(queuedEvent);
+
+                addQueuedEvent(queuedEvent);
+            }
+        }
+    }
+
+    // The new events can join bursts with the ones still waiting from the previous measure, so spread them all together
+    spreadEventBursts();
+
+    queuedMeasureIndex_ = nextMeasureIndex_++;
+    queuedMeasureGeneration_ = sourceGeneration_;
+    measureStartPending_ = true;
+}
+
+void GriddleScheduler::switchTimingAtMeasure(const int64 measureStartTick)
+{
+    // Anchor the new tempo map at the start of the measure, at the time the old tempo map gives it, so the old
+    // pattern plays out at its own tempo up to there. The events already queued keep their old times and velocities.
+    anchorTime_ = getTimeAtTick(measureStartTick);
+
+    tempoMap_ = sourceTempoMap_;
+    sourceTempoMapChanged_ = false;
+    anchorMapSeconds_ = tempoMap_.getSecondsAtBeat(GriddleTimeline::ticksToBeats(measureStartTick));
+
+    groove_ = sourceGroove_;
+    sourceGrooveChanged_ = false;
+
+    sourceTimingAtMeasure_ = false;
+}
+
+bool GriddleScheduler::isTrigPlayed(const int trackIndex, const GriddleCompiledTrig& trig, const int64 iteration)
+{
+    auto& previousTrigPlayed = previousTrigsPlayed_[trackIndex];
+    auto isPlayed = GriddleTrigCondition::isMet(trig.condition, iteration, fillActive_, previousTrigPlayed);
+
+    // The probability is drawn whether or not the condition is met, so the random numbers a track draws only
+    // depend on its steps and not on the fill or the other conditions
+    if (trig.probability < 100)
+        isPlayed = (trackRandoms_[trackIndex].nextInt(100) < trig.probability) && isPlayed;
+
+    // The PREVIOUS conditions follow the last trig that wasn't itself a PREVIOUS condition
+    if ((trig.condition != GriddleTrigCondition::PREVIOUS) && (trig.condition != GriddleTrigCondition::NOT_PREVIOUS))
+        previousTrigPlayed = isPlayed;
+
+    return isPlayed;
+}
+
+double GriddleScheduler::getTimeAtTick(const int64 tick) const
+{
+    return anchorTime_ + (tempoMap_.getSecondsAtBeat(GriddleTimeline::ticksToBeats(tick)) - anchorMapSeconds_);
+}
+
+double GriddleScheduler::getEventNominalTime(const GriddleTimelineEvent& event) const
+{
+    // Swing and the groove move the whole note, so a NOTE OFF keeps its gate length
+    auto noteStartTick = event.tick + groove_.getNoteShiftTicks(event.trackIndex, event.noteIndex, event.noteTicks);
+    auto dueTime = getTimeAtTick(noteStartTick + event.gateTicks);
+
+    // Keep NOTE OFFs (but not NOTE ONs with zero velocity) the minimum gate length after their NOTE ONs, however fast the tempo
+    if (event.message.isNoteOff(false))
+        dueTime = jmax(dueTime, getTimeAtTick(noteStartTick) + GriddleTimeline::MIN_GATE_SECONDS);
+
+    return dueTime + event.offsetSeconds;
+}
+
+void GriddleScheduler::timeQueuedEvent(QueuedEvent& queuedEvent) const
+{
+    queuedEvent.nominalTime = getEventNominalTime(queuedEvent.event);
+    queuedEvent.dueTime = queuedEvent.nominalTime;
+    queuedEvent.velocityOffset = groove_.getVelocityOffset(queuedEvent.event.trackIndex, queuedEvent.event.noteIndex);
+}
+
+void GriddleScheduler::dispatchDueEvents(const double scheduleAheadSeconds)
+{
+    // The tracks with events due are kept in a min-heap ordered by their next events, so each event sent
+    // only costs a comparison or two against the other tracks' next events
+    std::array<size_t, GriddleProjectData::NUM_TRACKS> numEventsSent {};
+    std::array<int, GriddleProjectData::NUM_TRACKS> dueTracks;
+    auto numDueTracks = 0;
+
+    auto isTrackLater = [this, &numEventsSent](const int a, const int b)
+    {
+        return isQueuedEventLater(trackQueues_[a][numEventsSent[a]], trackQueues_[b][numEventsSent[b]]);
+    };
+
+    for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+    {
+        if (! trackQueues_[trackI].empty() && (trackQueues_[trackI].front().dueTime < dispatchedUntilTime_))
+            dueTracks[numDueTracks++] = trackI;
+    }
+
+    std::make_heap(dueTracks.begin(), dueTracks.begin() + numDueTracks, isTrackLater);
+
+    auto recordTelemetry = telemetry_.isEnabled();
+
+    while (numDueTracks > 0)
+    {
+        // Take the track with the earliest event off the heap and send its event
+        std::pop_heap(dueTracks.begin(), dueTracks.begin() + numDueTracks, isTrackLater);
+
+        auto trackI = dueTracks[numDueTracks - 1];
+        auto& trackQueue = trackQueues_[trackI];
+        const auto& queuedEvent = trackQueue[numEventsSent[trackI]++];
+
+        if (recordTelemetry)
+        {
+            auto sendStartTime = Time::getMillisecondCounterHiRes() * 0.001;
+            auto isSent = sendQueuedEvent(queuedEvent);
+            telemetry_.recordEventSent(queuedEvent.dueTime - scheduleAheadSeconds, sendStartTime, Time::getMillisecondCounterHiRes() * 0.001);
+
+            if (isSent)
+                telemetry_.recordEventArrived(outputEncoder_.getLastEventLateness());
+        }
+        else
+        {
+            sendQueuedEvent(queuedEvent);
+        }
+
+        // Keep track of when the events sent will have cleared the wire, so bursts spread later don't overlap them
+        // (running status isn't counted, which errs on the side of a clear wire)
+        auto wireRate = outputEncoder_.getWireRate();
+
+        if (wireRate > 0.0)
+            wireBusyUntilTime_ = jmax(wireBusyUntilTime_, queuedEvent.dueTime)
+                               + GriddleOutputEncoder::getWireTimeSeconds(GriddleOutputEncoder::getWireByteCount(queuedEvent.event.message, 0), wireRate);
+
+        // Put the track back on the heap if its next event is also due
+        if ((numEventsSent[trackI] < trackQueue.size()) && (trackQueue[numEventsSent[trackI]].dueTime < dispatchedUntilTime_))
+            std::push_heap(dueTracks.begin(), dueTracks.begin() + numDueTracks, isTrackLater);
+        else
+            --numDueTracks;
+    }
+
+    // Remove the events that were sent from the queues
+    for (auto trackI = 0; trackI < GriddleProjectData::NUM_TRACKS; ++trackI)
+    {
+        if (numEventsSent[trackI] > 0)
+            trackQueues_[trackI].erase(trackQueues_[trackI].begin(), trackQueues_[trackI].begin() + static_cast<std::ptrdiff_t>(numEventsSent[trackI]));
+    }
+}
+
+bool GriddleScheduler::sendQueuedEvent(const QueuedEvent& queuedEvent)
+{
+    const auto& event = queuedEvent.event;
+    auto velocityOffset = queuedEvent.velocityOffset;
+
+    // A grooved NOTE ON is rebuilt with its new velocity, which is never lowered to 0 (a NOTE OFF)
+    if ((velocityOffset != 0) && event.message.isNoteOn())
+    {
+        auto velocity = jlimit(1, 127, static_cast<int>(event.message.getVelocity()) + velocityOffset);
+        return outputEncoder_.sendMessageNow(MidiMessage::noteOn(event.message.getChannel(), event.message.getNoteNumber(), static_cast<uint8>(velocity)),
+                                             queuedEvent.dueTime, queuedEvent.nominalTime);
+    }
+
+    return outputEncoder_.sendMessageNow(event.message, queuedEvent.dueTime, queuedEvent.nominalTime);
+}
+
+void GriddleScheduler::addQueuedEvent(const QueuedEvent& queuedEvent)
+{
+    auto& trackQueue = trackQueues_[queuedEvent.event.trackIndex];
+
+    // New events are almost always due after the ones already queued, so search for their place from the back
+    auto insertPos = trackQueue.end();
+
+    while ((insertPos != trackQueue.begin()) && (std::prev(insertPos)->nominalTime > queuedEvent.nominalTime))
+        --insertPos;
+
+    trackQueue.insert(insertPos, queuedEvent);
+}
+
+bool GriddleScheduler::isQueuedEventLater(const QueuedEvent& a, const QueuedEvent& b)
+{
+    if (a.dueTime != b.dueTime)
+        return a.dueTime > b.dueTime;
+
+    if (a.event.priority != b.event.priority)
+        return a.event.priority > b.event.priority;
+
+    return a.event.trackIndex > b.event.trackIndex;
+}
+
+bool GriddleScheduler::isQueuedEventNominallyLater(const QueuedEvent& a, const QueuedEvent& b)
+{
+    if (a.nominalTime != b.nominalTime)
+        return a.nominalTime > b.nominalTime;
+
+    if (a.event.priority != b.event.priority)
+        return a.event.priority > b.event.priority;
+
+    return a.event.trackIndex > b.event.trackIndex;
+}
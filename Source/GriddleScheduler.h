@@ -0,0 +1,405 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleScheduler.h
+    Created: 19 Oct 2026 11:03:27am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include "GriddleGroove.h"
+#include "GriddleOutputEncoder.h"
+#include "GriddlePlaybackTelemetry.h"
+#include "GriddleTempoMap.h"
+#include "GriddleTimeline.h"
+
+//==============================================================================
+/*
+    This class manages the real-time playback of a compiled Griddle sequence.
+
+    The sequence is compiled into a cycle of events for each track, positioned in ticks
+    (see GriddleTimeline). Each measure is queued a look-ahead ahead of its start: the
+    notes of each track's cycle that start in the measure are placed at the cycle's
+    position on the timeline (so free-running tracks carry on across the measure boundary)
+    and converted to times by integrating the tempo map. Events that spill past the end of
+    their measure simply stay queued until they're due.
+
+    Each track has its own queue, and the queues are merged as the events are dispatched
+    to the output encoder, by a k-way merge over a small heap of the tracks with events due.
+    A measure's events are only ever added to the end of each track's queue, which keeps
+    queueing cheap however busy the other tracks are.
+
+    A new tempo map takes effect straight away: the timeline carries on from the position
+    it had reached with the old map, and the events still queued are retimed, so tempo
+    changes are never held back until the next measure and never need a recompile.
+
+    Swing and groove templates (see GriddleGroove) are applied in the same way: they move
+    each event's position on the timeline as its due time is worked out, and the velocity
+    offset worked out along with it is added to a NOTE ON as it's sent, so a new groove
+    also takes effect straight away, including on the events already queued.
+
+    A pattern switch is the exception: the new pattern's source measure, tempo map and
+    groove are swapped in together and all take over at the start of the first measure
+    queued from it, so the rest of the old pattern plays out at its own tempo and groove.
+
+    Steps with a probability or a trig condition are decided as each measure is queued:
+    the trigs of each track that start in the measure are checked in order, drawing the
+    probabilities from the track's own random number generator, and only the notes of the
+    trigs that play are queued. The generators are seeded from the project's random seed
+    each time playback starts, so the same seed always plays the same way, and one
+    track's steps never change the random numbers drawn for another's.
+
+    With bandwidth-aware scheduling on and a throttled output, bursts of events that would
+    queue up on the MIDI wire are spread as each measure is queued, from the times the
+    tempo map and groove actually give the events, and spread again whenever the queued
+    events are retimed. Each burst is centred on its nominal time without overlapping the
+    events already sent, so tempo changes, tempo automation and grooves never leave a
+    burst spread for the wrong tempo. Every event keeps its nominal time (its place on the
+    timeline plus its track's latency offset) apart from the time it's sent at.
+
+    When the output port schedules ahead (e.g. the ALSA sequencer virtual port), events
+    are dispatched that far ahead of their due times along with their timestamps, and
+    the port does the final timing.
+
+    How late each event is dispatched, how long the output encoder takes to send it and
+    how late it arrives at the end of the wire compared to its nominal time are recorded
+    in the playback telemetry.
+*/
+class GriddleScheduler
+{
+public:
+    //==============================================================================
+    explicit GriddleScheduler(GriddleOutputEncoder& outputEncoder);
+    ~GriddleScheduler();
+    //==============================================================================
+
+    /** Swaps in newly-compiled source tracks for the measures that haven't been queued yet
+
+        This is safe to call from the message thread while the sequence is playing. The
+        passed-in measure receives the previous source measure contents in exchange.
+
+        @param sourceMeasure    The compiled events of each track
+        @returns                The generation number of the new source measure, which
+                                getMeasureSourceGeneration() reaches once a measure queued from it starts
+    */
+    int64 swapSourceMeasure(GriddleCompiledMeasure& sourceMeasure);
+
+    /** Swaps in newly-compiled source tracks along with the tempo map and groove they're played at, for a pattern switch
+
+        This is safe to call from the message thread while the sequence is playing. The tempo map and groove take
+        over at the start of the next measure to be queued, rather than straight away, so they switch at the same
+        measure boundary as the tracks. A tempo map or groove set before then is held back to the boundary as well.
+
+        @param sourceMeasure    The compiled events of each track, which receives the previous source measure contents
+        @param tempoMap         The tempo map to play the timeline at from the next measure
+        @param groove           The swing and groove templates of the tracks from the next measure
+        @returns                The generation number of the new source measure, which
+                                getMeasureSourceGeneration() reaches once a measure queued from it starts
+    */
+    int64 swapSourceMeasure(GriddleCompiledMeasure& sourceMeasure, const GriddleTempoMap& tempoMap, const GriddleGroove& groove);
+
+    /** Sets the tempo map that the timeline is played at
+
+        This is safe to call from the message thread while the sequence is playing, and the
+        new tempo map takes effect from the position the timeline has reached.
+
+        @param tempoMap    The tempo map to play the timeline at
+    */
+    void setTempoMap(const GriddleTempoMap& tempoMap);
+
+    /** Sets the swing and groove templates that the events are played with
+
+        This is safe to call from the message thread while the sequence is playing, and the
+        new groove takes effect on every event that hasn't been sent yet.
+
+        @param groove    The swing and groove templates of the tracks
+    */
+    void setGroove(const GriddleGroove& groove);
+
+    /** Sets the seed of the random numbers that decide whether steps with a probability play
+
+        The seed takes effect the next time playback starts.
+
+        @param randomSeed    The seed
+    */
+    void setRandomSeed(const int randomSeed);
+
+    /** Turns fill on or off for the steps with a fill trig condition
+
+        This is safe to call from any thread, and takes effect from the next measure to be queued.
+
+        @param fillActive    Pass true to turn fill on, or false to turn it off
+    */
+    void setFillActive(const bool fillActive);
+
+    /** Checks whether fill is turned on
+
+        @returns    true if fill is turned on
+    */
+    bool isFillActive() const;
+
+    /** Turns the spreading of bursts of events on the MIDI wire on or off
+
+        This is safe to call from any thread, and takes effect from the next measure to be queued. Bursts are only
+        spread when the output encoder has a wire rate.
+
+        @param bandwidthAwareScheduling    Pass true to spread bursts, or false to send every event at its nominal time
+    */
+    void setBandwidthAwareScheduling(const bool bandwidthAwareScheduling);
+
+    /** Starts playback of the sequence
+
+        The first measure starts after a pre-roll equal to the look-ahead of the source measure,
+        so that events moved ahead of the first measure are still sent on time.
+
+        @param clockTime    The current time in seconds on the Time::getMillisecondCounterHiRes() clock
+    */
+    void start(const double clockTime);
+
+    /** Stops playback of the sequence, sending NOTE OFFs for the notes in the output encoder's active-note table
+
+        This must not be called while process() may be running on another thread.
+    */
+    void stop();
+
+    /** Queues upcoming measures and sends all events that have come due
+
+        @param clockTime    The current time in seconds on the Time::getMillisecondCounterHiRes() clock
+        @returns            true if a new measure started during this call, otherwise false
+    */
+    bool process(const double clockTime);
+
+    /** Gets the tempo the timeline was playing at during the last call to process()
+
+        @returns    The current tempo in BPM
+    */
+    double getCurrentBPM() const;
+
+    /** Gets the index of the measure currently playing, counted from the start of playback
+
+        @returns    The index of the measure, which is 0 until the first measure starts
+    */
+    int64 getCurrentMeasureIndex() const;
+
+    /** Gets the generation number of the source measure the measure currently playing was queued from
+
+        @returns    The generation number returned by swapSourceMeasure() for the current measure's source measure
+    */
+    int64 getMeasureSourceGeneration() const;
+
+    /** Gets the telemetry that records the playback timing, which is cleared each time playback starts
+        @returns    The playback telemetry
+    */
+    GriddlePlaybackTelemetry& getTelemetry();
+
+private:
+    //==============================================================================
+    /** A queued event along with its nominal time, the time it's due after any spreading of its burst on the wire,
+        and its groove velocity offset, which are recalculated whenever the tempo map or groove changes */
+    struct QueuedEvent
+    {
+        double nominalTime;
+        double dueTime;
+        int velocityOffset;
+        GriddleTimelineEvent event;
+    };
+
+    //==============================================================================
+    // Output Variables
+    GriddleOutputEncoder& outputEncoder_;
+    //==============================================================================
+
+    //==============================================================================
+    // Source Variables
+    //
+    // The source measure, tempo map, groove and random seed are set from the message thread, so they are protected
+    // by a SpinLock that the playback thread only ever tries to take, never waits on
+    SpinLock sourceLock_;
+    GriddleCompiledMeasure sourceMeasure_;
+    int64 sourceGeneration_;
+    GriddleTempoMap sourceTempoMap_;
+    bool sourceTempoMapChanged_;
+    GriddleGroove sourceGroove_;
+    bool sourceGrooveChanged_;
+    bool sourceTimingAtMeasure_;
+    int sourceRandomSeed_;
+    //==============================================================================
+
+    //==============================================================================
+    // Playback Variables
+    //
+    // The time of a position on the timeline is anchorTime_ plus the tempo map's time from the
+    // anchor position (anchorMapSeconds_ is the tempo map's time of the anchor position), and the
+    // anchor moves to the position reached whenever a new tempo map takes effect
+    GriddleTempoMap tempoMap_;
+    GriddleGroove groove_;
+    double anchorTime_;
+    double anchorMapSeconds_;
+    std::array<std::vector<QueuedEvent>, GriddleProjectData::NUM_TRACKS> trackQueues_;
+    int64 nextMeasureIndex_;
+    int64 queuedMeasureIndex_;
+    int64 queuedMeasureGeneration_;
+    bool measureStartPending_;
+    double measureStartTime_;
+    std::atomic<double> currentBPM_;
+    std::atomic<int64> measureIndex_;
+    std::atomic<int64> measureGeneration_;
+    double dispatchedUntilTime_;
+    double wireBusyUntilTime_;
+    std::atomic<bool> bandwidthAwareScheduling_;
+
+    GriddlePlaybackTelemetry telemetry_;
+    //==============================================================================
+
+    //==============================================================================
+    // Trig Variables
+    //
+    // Each track draws its step probabilities from its own random number generator, and remembers whether its
+    // last step with a probability or a condition played for the PREVIOUS conditions. Whether each trig of the
+    // cycle being queued plays is kept in trigsPlayed_.
+    std::array<Random, GriddleProjectData::NUM_TRACKS> trackRandoms_;
+    std::array<bool, GriddleProjectData::NUM_TRACKS> previousTrigsPlayed_;
+    std::array<bool, GriddleTimeline::MAX_NOTES_PER_MEASURE> trigsPlayed_;
+    std::atomic<bool> fillActive_;
+    //==============================================================================
+
+    /** Switches to a new tempo map or groove if one has been set, retiming the queued events to match */
+    void updateTiming();
+
+    /** Switches to the source tempo map and groove from the start of a measure, for a pattern switch, leaving the
+        events already queued with the times and velocities of the old ones
+
+        @param measureStartTick    The position of the start of the measure in ticks from the start of playback
+    */
+    void switchTimingAtMeasure(const int64 measureStartTick);
+
+    /** Works out an event's nominal time and groove velocity offset with the current tempo map and groove, leaving
+        it due at its nominal time until the queued events are spread
+
+        @param queuedEvent    The event to time
+    */
+    void timeQueuedEvent(QueuedEvent& queuedEvent) const;
+
+    /** Sets the due time of every queued event, spreading the bursts that would queue up on the MIDI wire
+
+        The tracks' queues are walked together in the order the events are sent in, and each burst is sent back to
+        back from the time that centres it on its nominal start, or from the end of the previous burst if that's
+        later. Spreading keeps the events in order, so each track's queue stays in order of due time.
+    */
+    void spreadEventBursts();
+
+    /** Queues each track's events for the next measure if it's within the look-ahead
+
+        @param dispatchTime    The time in seconds that events have been dispatched up to
+    */
+    void queueNextMeasure(const double dispatchTime);
+
+    /** Decides whether a trig plays the time it's being queued, updating its track's PREVIOUS condition state
+
+        @param trackIndex    The index of the trig's track
+        @param trig          The trig
+        @param iteration     The number of times the track's pattern has played before the trig, from the start of playback
+        @returns             true if the trig's notes should be queued
+    */
+    bool isTrigPlayed(const int trackIndex, const GriddleCompiledTrig& trig, const int64 iteration);
+
+    /** Gets the time of a position on the timeline with the current tempo map
+
+        @param tick    The position in ticks from the start of playback
+        @returns       The time in seconds on the Time::getMillisecondCounterHiRes() clock
+    */
+    double getTimeAtTick(const int64 tick) const;
+
+    /** Gets the nominal time of an event with the current tempo map and groove
+
+        @param event    The event, positioned in ticks from the start of playback
+        @returns        The time in seconds on the Time::getMillisecondCounterHiRes() clock
+    */
+    double getEventNominalTime(const GriddleTimelineEvent& event) const;
+
+    /** Sends all queued events that are due before the dispatch time, merging the tracks' queues in order
+
+        @param scheduleAheadSeconds    How far ahead of their due times the output port takes events
+    */
+    void dispatchDueEvents(const double scheduleAheadSeconds);
+
+    /** Sends a queued event to the output encoder at its due time, adding its groove velocity offset if it's a NOTE ON
+
+        @returns    true if the output encoder sent the event, or false if it dropped it
+    */
+    bool sendQueuedEvent(const QueuedEvent& queuedEvent);
+
+    /** Adds an event to its track's queue, keeping the queue in order of nominal time */
+    void addQueuedEvent(const QueuedEvent& queuedEvent);
+
+    /** Compares queued events from different tracks for the merge, by due time, then priority, then track
+
+        @returns    true if the first event should be sent after the second
+    */
+    static bool isQueuedEventLater(const QueuedEvent& a, const QueuedEvent& b);
+
+    /** Compares queued events from different tracks by nominal time, then priority, then track, which is the order
+        their bursts are spread in
+
+        @returns    true if the first event should be sent after the second
+    */
+    static bool isQueuedEventNominallyLater(const QueuedEvent& a, const QueuedEvent& b);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleScheduler)
+};
+
+inline double GriddleScheduler::getCurrentBPM() const
+{
+    return currentBPM_;
+}
+
+inline bool GriddleScheduler::isFillActive() const
+{
+    return fillActive_;
+}
+
+inline int64 GriddleScheduler::getCurrentMeasureIndex() const
+{
+    return measureIndex_;
+}
+
+inline int64 GriddleScheduler::getMeasureSourceGeneration() const
+{
+    return measureGeneration_;
+}
+
+inline GriddlePlaybackTelemetry& GriddleScheduler::getTelemetry()
+{
+    return telemetry_;
+}
@@ -0,0 +1,398 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleSessionJournal.cpp
+    Created: 19 Oct 2026 7:12:48pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleSessionJournal.h"
+#include "GriddleProjectFile.h"
+
+constexpr int GriddleSessionJournal::BATCH_INTERVAL_MS;
+constexpr int GriddleSessionJournal::SNAPSHOT_INTERVAL_RECORDS;
+constexpr int GriddleSessionJournal::MAX_SESSIONS;
+
+//==============================================================================
+// Record Framing Constants
+static constexpr int recordMagic = 0x4e524a47; // "GJRN"
+static constexpr int recordHeaderSize = 24;
+
+//==============================================================================
+// Session File Names (within each instance's session directory)
+static const char* const journalFileName = "session.journal";
+static const char* const snapshotFileName = "session.snapshot";
+
+//==============================================================================
+GriddleSessionJournal::GriddleSessionJournal(const File& sessionsDirectory)
+    : Thread("Griddle Session Journal")
+    , sessionsDirectory_(sessionsDirectory)
+    , nextSequence_(1)
+    , numRecordsSinceSnapshot_(0)
+    , recordStream_(4096)
+    , recordPending_(false)
+    , cleanShutdown_(false)
+    , recoveredSessionReleased_(false)
+{
+}
+
+GriddleSessionJournal::~GriddleSessionJournal()
+{
+    // If the journal wasn't stopped cleanly, leave the session files for the next start to recover
+    stopThread(5000);
+}
+
+void GriddleSessionJournal::start()
+{
+    startThread(2);
+}
+
+void GriddleSessionJournal::stop()
+{
+    // The journal thread deletes the session files on its way out
+    cleanShutdown_ = true;
+    stopThread(5000);
+}
+
+void GriddleSessionJournal::record(const GriddleProjectData& projectData, const File& projectFile, const bool hasUnsavedChanges)
+{
+    // Payload: unsaved changes flag, project file path and the project in the binary project format
+    auto projectFilePath = projectFile.getFullPathName();
+    auto projectFilePathBytes = static_cast<int>(projectFilePath.getNumBytesAsUTF8());
+
+    recordStream_.reset();
+    recordStream_.writeByte(hasUnsavedChanges ? 1 : 0);
+    recordStream_.writeShort(static_cast<short>(projectFilePathBytes));
+    recordStream_.write(projectFilePath.toRawUTF8(), static_cast<size_t>(projectFilePathBytes));
+    GriddleProjectFile::writeBinary(recordStream_, projectData);
+
+    {
+        const ScopedLock lock(pendingLock_);
+
+        pendingRecordPayload_.replaceWith(recordStream_.getData(), recordStream_.getDataSize());
+        recordPending_ = true;
+    }
+
+    notify();
+}
+
+void GriddleSessionJournal::releaseRecoveredSession()
+{
+    // The journal thread deletes the recovered session after writing any pending record
+    recoveredSessionReleased_ = true;
+    notify();
+}
+
+File GriddleSessionJournal::getDefaultSessionDirectory()
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile(ProjectInfo::projectName).getChildFile("Session");
+}
+
+void GriddleSessionJournal::run()
+{
+    recoverPreviousSession();
+
+    // If every session directory is in use, the session simply isn't journalled
+    if (lockSessionDirectory())
+        startNewJournal();
+
+    while (! threadShouldExit())
+    {
+        // Sleep until there's something to record
+        wait(-1);
+
+        // Let the records from a burst of edits (e.g. dragging a slider) pile up, since only the latest needs writing
+        auto batchEndTime = Time::currentTimeMillis() + BATCH_INTERVAL_MS;
+
+        while (! threadShouldExit())
+        {
+            auto remainingMs = batchEndTime - Time::currentTimeMillis();
+
+            if (remainingMs <= 0)
+                break;
+
+            wait(static_cast<int>(remainingMs));
+        }
+
+        writePendingRecord();
+
+        if (numRecordsSinceSnapshot_ >= SNAPSHOT_INTERVAL_RECORDS)
+            writeSnapshot();
+
+        deleteReleasedSession();
+    }
+
+    if (cleanShutdown_)
+    {
+        journalStream_ = nullptr;
+
+        if (sessionLock_ != nullptr)
+            sessionDirectory_.deleteRecursively();
+    }
+    else
+    {
+        // Make sure the last state is on disk, since the session files are being left for recovery
+        writePendingRecord();
+    }
+
+    deleteReleasedSession();
+}
+
+void GriddleSessionJournal::recoverPreviousSession()
+{
+    MemoryBlock recoveredPayload;
+    Time recoveredTime;
+
+    for (auto sessionNumber = 1; sessionNumber <= MAX_SESSIONS; ++sessionNumber)
+    {
+        auto sessionDirectory = sessionsDirectory_.getChildFile(String(sessionNumber));
+
+        if (! sessionDirectory.isDirectory())
+            continue;
+
+        // A locked session belongs to a running instance
+        auto sessionLock = std::make_unique<InterProcessLock>(getSessionLockName(sessionDirectory));
+
+        if (! sessionLock->enter(0))
+            continue;
+
+        // Only sessions with unsaved changes need restoring
+        MemoryBlock payload;
+
+        if (! readSessionRecord(sessionDirectory, payload) || (static_cast<const uint8*>(payload.getData())[0] == 0))
+        {
+            sessionDirectory.deleteRecursively();
+            continue;
+        }
+
+        // Only the newest session is offered, and any others are left (unlocked) to be offered the next time
+        auto sessionTime = jmax(sessionDirectory.getChildFile(journalFileName).getLastModificationTime(),
+                                sessionDirectory.getChildFile(snapshotFileName).getLastModificationTime());
+
+        if ((recoveredSessionLock_ == nullptr) || (sessionTime > recoveredTime))
+        {
+            recoveredPayload.swapWith(payload);
+            recoveredTime = sessionTime;
+            recoveredSessionDirectory_ = sessionDirectory;
+            recoveredSessionLock_ = std::move(sessionLock);
+        }
+    }
+
+    if (recoveredSessionLock_ == nullptr)
+        return;
+
+    auto bytes = static_cast<const uint8*>(recoveredPayload.getData());
+    auto numBytes = recoveredPayload.getSize();
+    auto projectFilePathBytes = (numBytes >= 3) ? static_cast<size_t>(ByteOrder::littleEndianShort(bytes + 1)) : size_t(0);
+
+    GriddleProjectData projectData;
+
+    if ((numBytes < (3 + projectFilePathBytes))
+        || GriddleProjectFile::readBinary(bytes + 3 + projectFilePathBytes, numBytes - 3 - projectFilePathBytes, projectData).failed())
+    {
+        // A session that can't be read can't be restored either
+        recoveredSessionReleased_ = true;
+        deleteReleasedSession();
+        return;
+    }
+
+    auto projectFilePath = String::fromUTF8(reinterpret_cast<const char*>(bytes + 3), static_cast<int>(projectFilePathBytes));
+
+    // The session's files are kept until the user has decided whether to restore it (see releaseRecoveredSession())
+    if (onSessionRecovered != nullptr)
+        onSessionRecovered(projectData, projectFilePath.isNotEmpty() ? File(projectFilePath) : File());
+}
+
+bool GriddleSessionJournal::lockSessionDirectory()
+{
+    // A directory can be used if no running instance has it locked and it isn't holding a session to recover
+    for (auto sessionNumber = 1; sessionNumber <= MAX_SESSIONS; ++sessionNumber)
+    {
+        auto sessionDirectory = sessionsDirectory_.getChildFile(String(sessionNumber));
+
+        // This process already holds the recovered session's lock, so taking it again would succeed
+        if (sessionDirectory == recoveredSessionDirectory_)
+            continue;
+
+        auto sessionLock = std::make_unique<InterProcessLock>(getSessionLockName(sessionDirectory));
+
+        if (! sessionLock->enter(0))
+            continue;
+
+        if (sessionDirectory.getChildFile(journalFileName).exists() || sessionDirectory.getChildFile(snapshotFileName).exists())
+            continue;
+
+        if (sessionDirectory.createDirectory().failed())
+            return false;
+
+        sessionDirectory_ = sessionDirectory;
+        journalFile_ = sessionDirectory.getChildFile(journalFileName);
+        snapshotFile_ = sessionDirectory.getChildFile(snapshotFileName);
+        sessionLock_ = std::move(sessionLock);
+
+        return true;
+    }
+
+    return false;
+}
+
+void GriddleSessionJournal::deleteReleasedSession()
+{
+    if (! recoveredSessionReleased_ || (recoveredSessionLock_ == nullptr))
+        return;
+
+    recoveredSessionDirectory_.deleteRecursively();
+    recoveredSessionDirectory_ = File();
+    recoveredSessionLock_ = nullptr;
+}
+
+void GriddleSessionJournal::writePendingRecord()
+{
+    {
+        const ScopedLock lock(pendingLock_);
+
+        if (! recordPending_)
+            return;
+
+        lastRecordPayload_.swapWith(pendingRecordPayload_);
+        recordPending_ = false;
+    }
+
+    if (journalStream_ == nullptr)
+        return;
+
+    writeRecord(*journalStream_, lastRecordPayload_, nextSequence_++);
+    journalStream_->flush();
+
+    ++numRecordsSinceSnapshot_;
+}
+
+void GriddleSessionJournal::writeSnapshot()
+{
+    // The snapshot replaces the previous one atomically, so there's always a complete snapshot or none
+    TemporaryFile tempFile(snapshotFile_, TemporaryFile::useHiddenFile);
+
+    {
+        FileOutputStream tempStream(tempFile.getFile());
+
+        if (tempStream.failedToOpen())
+            return;
+
+        writeRecord(tempStream, lastRecordPayload_, nextSequence_++);
+        tempStream.flush();
+
+        if (tempStream.getStatus().failed())
+            return;
+    }
+
+    if (tempFile.overwriteTargetFileWithTemporary())
+        startNewJournal();
+}
+
+void GriddleSessionJournal::startNewJournal()
+{
+    journalStream_ = nullptr;
+    journalFile_.deleteFile();
+
+    journalStream_.reset(new FileOutputStream(journalFile_));
+
+    if (journalStream_->failedToOpen())
+        journalStream_ = nullptr;
+
+    numRecordsSinceSnapshot_ = 0;
+}
+
+void GriddleSessionJournal::writeRecord(OutputStream& stream, const MemoryBlock& payload, const int64 sequence)
+{
+    stream.writeInt(recordMagic);
+    stream.writeInt(static_cast<int>(payload.getSize()));
+    stream.writeInt64(sequence);
+    stream.writeInt64(static_cast<int64>(GriddleProjectFile::hashData(payload.getData(), payload.getSize())));
+    stream.write(payload.getData(), payload.getSize());
+}
+
+bool GriddleSessionJournal::readSessionRecord(const File& sessionDirectory, MemoryBlock& payload)
+{
+    MemoryBlock journalPayload, snapshotPayload;
+    int64 journalSequence = 0, snapshotSequence = 0;
+
+    auto hasJournalRecord = readLatestRecord(sessionDirectory.getChildFile(journalFileName), journalPayload, journalSequence);
+    auto hasSnapshotRecord = readLatestRecord(sessionDirectory.getChildFile(snapshotFileName), snapshotPayload, snapshotSequence);
+
+    if (! hasJournalRecord && ! hasSnapshotRecord)
+        return false;
+
+    // A crash between writing a snapshot and starting the new journal leaves older records in the journal
+    payload = (hasJournalRecord && (journalSequence > snapshotSequence)) ? journalPayload : snapshotPayload;
+
+    return payload.getSize() > 0;
+}
+
+String GriddleSessionJournal::getSessionLockName(const File& sessionDirectory)
+{
+    return String(ProjectInfo::projectName) + "Session" + sessionDirectory.getFileName();
+}
+
+bool GriddleSessionJournal::readLatestRecord(const File& sessionFile, MemoryBlock& payload, int64& sequence)
+{
+    MemoryBlock fileData;
+    if (! sessionFile.loadFileAsData(fileData))
+        return false;
+
+    auto bytes = static_cast<const uint8*>(fileData.getData());
+    auto numBytes = fileData.getSize();
+    auto position = size_t(0);
+    auto foundRecord = false;
+
+    // Read records until the end of the file or the first incomplete or corrupt record
+    while ((position + recordHeaderSize) <= numBytes)
+    {
+        auto record = bytes + position;
+        auto payloadSize = static_cast<size_t>(ByteOrder::littleEndianInt(record + 4));
+
+        if ((static_cast<int>(ByteOrder::littleEndianInt(record)) != recordMagic) || ((position + recordHeaderSize + payloadSize) > numBytes))
+            break;
+
+        auto recordPayload = record + recordHeaderSize;
+        if (GriddleProjectFile::hashData(recordPayload, payloadSize) != ByteOrder::littleEndianInt64(record + 16))
+            break;
+
+        auto recordSequence = static_cast<int64>(ByteOrder::littleEndianInt64(record + 8));
+        if (! foundRecord || (recordSequence > sequence))
+        {
+            payload.replaceWith(recordPayload, payloadSize);
+            sequence = recordSequence;
+            foundRecord = true;
+        }
+
+        position += recordHeaderSize + payloadSize;
+    }
+
+    return foundRecord;
+}
@@ -0,0 +1,213 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleSessionJournal.h
+    Created: 19 Oct 2026 7:12:48pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <functional>
+#include "GriddleProjectData.h"
+
+//==============================================================================
+/*
+    This class keeps an auto-save journal of the session so that unsaved changes can
+    be restored after a crash.
+
+    Every edit records the complete project state, serialised in the binary project
+    format. Recording only copies the serialised state into memory and wakes the journal
+    thread - all of the file I/O happens on that low-priority thread. The thread batches
+    the records that arrive within BATCH_INTERVAL_MS and appends the latest of them to the
+    journal file, and every SNAPSHOT_INTERVAL_RECORDS records it writes a snapshot and
+    starts a new journal, so the journal never grows large.
+
+    Each record carries a sequence number and a hash of its contents, so a record that was
+    only partly written when the application died is ignored, and the newest complete
+    record in either the snapshot or the journal is the one that's restored.
+
+    Each running instance of Griddle journals into its own numbered directory within the
+    sessions directory, and holds an InterProcessLock named after it while it runs (which
+    the OS releases if the instance dies). A clean shutdown deletes the instance's session
+    files. When the journal starts, any directory whose lock can be taken was left by an
+    instance that didn't shut down cleanly: sessions without unsaved changes are deleted,
+    and onSessionRecovered is called with the newest one that had unsaved changes. Its
+    files are kept, and stay locked, until releaseRecoveredSession() is called once the
+    user has decided what to do with it, so a crash before then leaves it recoverable.
+*/
+class GriddleSessionJournal : private Thread
+{
+public:
+    //==============================================================================
+    GriddleSessionJournal(const File& sessionsDirectory);
+    ~GriddleSessionJournal();
+    //==============================================================================
+
+    /** Starts the journal thread, which first checks for a session to recover */
+    void start();
+
+    /** Shuts the journal down cleanly, deleting the session files */
+    void stop();
+
+    /** Records the current state of the project
+
+        This only serialises the state into memory, so it's safe to call on every edit.
+
+        @param projectData          The current project data
+        @param projectFile          The current project file, or File() for a new project
+        @param hasUnsavedChanges    true if the project has unsaved changes
+    */
+    void record(const GriddleProjectData& projectData, const File& projectFile, const bool hasUnsavedChanges);
+
+    /** Lets the journal delete the files of the session passed to onSessionRecovered
+
+        Call this once the user has decided whether to restore the session. If it was restored, record the restored
+        state first: the journal writes it before deleting the recovered session's files.
+    */
+    void releaseRecoveredSession();
+
+    /** Gets the default directory that the instances' session directories are kept in, in the user's application data directory */
+    static File getDefaultSessionDirectory();
+
+    /** Called on the journal thread when a previous session ended with unsaved changes and wasn't shut down cleanly
+
+        The callback receives the recovered project data and project file (File() if the project was new).
+        releaseRecoveredSession() must be called once the session has been dealt with.
+    */
+    std::function<void(const GriddleProjectData&, const File&)> onSessionRecovered;
+
+    /** How long records are batched for before the latest is written to the journal */
+    static constexpr int BATCH_INTERVAL_MS = 1000;
+
+    /** How many records are written to the journal before it's replaced by a snapshot */
+    static constexpr int SNAPSHOT_INTERVAL_RECORDS = 100;
+
+    /** How many session directories there can be, for the running instances and the sessions waiting to be recovered */
+    static constexpr int MAX_SESSIONS = 32;
+
+private:
+    //==============================================================================
+    // Session File Variables (only used on the journal thread)
+    const File sessionsDirectory_;
+    File sessionDirectory_;
+    File journalFile_;
+    File snapshotFile_;
+    std::unique_ptr<InterProcessLock> sessionLock_;
+    std::unique_ptr<FileOutputStream> journalStream_;
+    MemoryBlock lastRecordPayload_;
+    int64 nextSequence_;
+    int numRecordsSinceSnapshot_;
+    //==============================================================================
+
+    //==============================================================================
+    // Pending Record Variables
+    //
+    // The pending record is handed over from the message thread under a lock, and only
+    // the latest one is kept, since each record holds the complete project state
+    MemoryOutputStream recordStream_;
+    CriticalSection pendingLock_;
+    MemoryBlock pendingRecordPayload_;
+    bool recordPending_;
+    std::atomic<bool> cleanShutdown_;
+    //==============================================================================
+
+    //==============================================================================
+    // Recovered Session Variables
+    //
+    // The recovered session's directory stays locked, so no other instance recovers it too, until it's released
+    File recoveredSessionDirectory_;
+    std::unique_ptr<InterProcessLock> recoveredSessionLock_;
+    std::atomic<bool> recoveredSessionReleased_;
+    //==============================================================================
+
+    /** The thread callback, which writes the pending records until the thread is stopped
+
+        This is an override of the Thread method.
+    */
+    void run() override;
+
+    /** Reads the session directories that aren't locked by a running instance, deleting the sessions without unsaved
+        changes and calling onSessionRecovered with the newest one that had them */
+    void recoverPreviousSession();
+
+    /** Locks the first numbered session directory that isn't in use or holding a session to recover, for this instance
+
+        @returns    true if a session directory was locked, otherwise false
+    */
+    bool lockSessionDirectory();
+
+    /** Deletes the recovered session's files, and unlocks its directory, once the session has been released */
+    void deleteReleasedSession();
+
+    /** Finds the newest complete record in a session directory's snapshot and journal
+
+        @param sessionDirectory    The session directory to read
+        @param payload             Set to the payload of the newest complete record
+        @returns                   true if the directory had a complete record, otherwise false
+    */
+    static bool readSessionRecord(const File& sessionDirectory, MemoryBlock& payload);
+
+    /** Gets the name of the InterProcessLock that a running instance holds on its session directory
+
+        @param sessionDirectory    The session directory
+        @returns                   The name of the lock
+    */
+    static String getSessionLockName(const File& sessionDirectory);
+
+    /** Appends the pending record, if there is one, to the journal */
+    void writePendingRecord();
+
+    /** Writes the last record to a new snapshot and starts a new journal */
+    void writeSnapshot();
+
+    /** Deletes any existing journal and opens a new, empty one */
+    void startNewJournal();
+
+    /** Writes a framed record to a stream
+
+        @param stream      The stream to write to
+        @param payload     The serialised project state
+        @param sequence    The sequence number of the record
+    */
+    static void writeRecord(OutputStream& stream, const MemoryBlock& payload, const int64 sequence);
+
+    /** Finds the newest complete record in a session file
+
+        @param sessionFile    The journal or snapshot file to read
+        @param payload        Set to the payload of the newest complete record
+        @param sequence       Set to the sequence number of the newest complete record
+        @returns              true if the file had a complete record, otherwise false
+    */
+    static bool readLatestRecord(const File& sessionFile, MemoryBlock& payload, int64& sequence);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleSessionJournal)
+};
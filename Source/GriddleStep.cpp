@@ -33,6 +33,8 @@ along with Griddle. If not, see < https://www.gnu.org/licenses/>.
 
 #include <JuceHeader.h>
 #include "GriddleStep.h"
+#include "GriddleTrace.h"
+#include "GriddleTrigCondition.h"
 
 //==============================================================================
 GriddleStep::GriddleStep(int stepIndex, int ownerTrackIndex)
@@ -44,7 +46,13 @@ GriddleStep::GriddleStep(int stepIndex, int ownerTrackIndex)
     , midiNoteNumber_(-1)
     , gatePercent_(100)
     , velocity_(127)
+    , probability_(100)
+    , ratchets_(1)
+    , condition_(GriddleTrigCondition::NONE)
+    , numChordNotes_(0)
     , midiNoteString_("")
+    , trigString_("")
+    , chordString_("")
     , drawChopped_(false)
     , drawFlipped_(false)
     , canSelect_(true)
@@ -122,6 +130,97 @@ void GriddleStep::setGatePercent(const int gatePercent)
     gateLinePosX_ = static_cast<float>(((gatePercent_/100.0) * getWidth()));
 }
 
+void GriddleStep::setProbability(const int probability)
+{
+    probability_ = probability;
+    updateTrigString();
+}
+
+void GriddleStep::setRatchets(const int ratchets)
+{
+    ratchets_ = ratchets;
+    updateTrigString();
+}
+
+void GriddleStep::setCondition(const int condition)
+{
+    condition_ = condition;
+    updateTrigString();
+}
+
+void GriddleStep::setChordNotes(const std::array<GriddleChordNoteData, GriddleStepData::MAX_CHORD_NOTES - 1>& chordNotes, const int numChordNotes)
+{
+    chordNotes_ = chordNotes;
+    numChordNotes_ = jlimit(0, GriddleStepData::MAX_CHORD_NOTES - 1, numChordNotes);
+    updateChordString();
+}
+
+bool GriddleStep::addChordNote(const int midiNoteNumber, const int velocity)
+{
+    if ((numChordNotes_ >= (GriddleStepData::MAX_CHORD_NOTES - 1)) || (midiNoteNumber == midiNoteNumber_))
+        return false;
+
+    for (auto chordNoteI = 0; chordNoteI < numChordNotes_; ++chordNoteI)
+    {
+        if (chordNotes_[static_cast<size_t>(chordNoteI)].noteNumber == midiNoteNumber)
+            return false;
+    }
+
+    chordNotes_[static_cast<size_t>(numChordNotes_)] = { midiNoteNumber, velocity };
+    ++numChordNotes_;
+    updateChordString();
+
+    return true;
+}
+
+void GriddleStep::clearChordNotes()
+{
+    numChordNotes_ = 0;
+    chordNotes_.fill(GriddleChordNoteData());
+    updateChordString();
+}
+
+String GriddleStep::getNoteNames() const
+{
+    if (midiNoteNumber_ < 0)
+        return "";
+
+    StringArray noteNames(midiNoteString_);
+
+    for (auto chordNoteI = 0; chordNoteI < numChordNotes_; ++chordNoteI)
+        noteNames.add(MidiMessage::getMidiNoteName(chordNotes_[static_cast<size_t>(chordNoteI)].noteNumber, true, true, 4));
+
+    return noteNames.joinIntoString(" ");
+}
+
+void GriddleStep::updateChordString()
+{
+    // The rest of the chord is stacked above the step's note in the order the notes were added
+    StringArray chordNoteNames;
+
+    for (auto chordNoteI = 0; chordNoteI < numChordNotes_; ++chordNoteI)
+        chordNoteNames.insert(0, MidiMessage::getMidiNoteName(chordNotes_[static_cast<size_t>(chordNoteI)].noteNumber, true, true, 4));
+
+    chordString_ = chordNoteNames.joinIntoString("\n");
+}
+
+void GriddleStep::updateTrigString()
+{
+    // Only the settings that change how the step plays are shown (e.g. "50% x2 1:4")
+    StringArray trigSettings;
+
+    if (probability_ < 100)
+        trigSettings.add(String(probability_) + "%");
+
+    if (ratchets_ > 1)
+        trigSettings.add("x" + String(ratchets_));
+
+    if (condition_ != GriddleTrigCondition::NONE)
+        trigSettings.add(GriddleTrigCondition::getName(condition_));
+
+    trigString_ = trigSettings.joinIntoString(" ");
+}
+
 void GriddleStep::addListener(GriddleStep::Listener* l) 
 {
     listeners.add(l); 
@@ -140,6 +239,8 @@ void GriddleStep::callStepSelectedListeners()
 
 void GriddleStep::paint(Graphics& g)
 {
+    GRIDDLE_TRACE_SCOPE("GriddleStep::paint");
+
     g.fillAll(backgroundColor_);
 
     // Draw the chopped indicator if applicable
@@ -175,6 +276,15 @@ void GriddleStep::paint(Graphics& g)
         Point<float>(gateLineDrawPosX, static_cast<float>(getHeight())));
 
     g.drawLine(gLine, 3.0f);
+
+    // Draw the trig settings along the top of the step, for notes only since rests never play
+    if ((midiNoteNumber_ >= 0) && trigString_.isNotEmpty())
+    {
+        g.setFont(Font(11.0f, Font::bold));
+        g.setColour(Colours::lightgrey);
+        g.setOpacity(0.8f);
+        g.drawFittedText(trigString_, Rectangle<int>(1, 2, getWidth() - 2, 40), Justification::centredTop, 3);
+    }
     
     // Draw the note string
     g.setFont(Font(20.0, Font::bold | Font::italic));
@@ -189,6 +299,13 @@ void GriddleStep::paint(Graphics& g)
         g.addTransform(AffineTransform::verticalFlip(static_cast<float>(getHeight())));
     }
     g.drawFittedText(midiNoteString_, Rectangle<int>(2, 2, getWidth() - 6, getHeight() - 1), textJustify, 1);
+
+    // Draw the rest of the chord above the note string
+    if ((midiNoteNumber_ >= 0) && chordString_.isNotEmpty())
+    {
+        g.setFont(Font(11.0f, Font::bold));
+        g.drawFittedText(chordString_, Rectangle<int>(2, 2, getWidth() - 6, getHeight() - 24), textJustify, GriddleStepData::MAX_CHORD_NOTES - 1);
+    }
 }
 
 void GriddleStep::resized()
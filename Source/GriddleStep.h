@@ -34,14 +34,19 @@ along with Griddle. If not, see < https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <JuceHeader.h>
+#include "GriddleProjectData.h"
 
 //==============================================================================
 /*  
     This component contains all of the attributes and logic for a step in a 
     track of a Griddle sequence.
 
-    A GriddleStep can hold a rest or a monophonic MIDI note with velocity and
-    gate percent, all of which have graphical indicators.
+    A GriddleStep can hold a rest or a MIDI note with velocity and gate percent,
+    all of which have graphical indicators. A note can be the lowest of a small
+    chord, whose other notes each have their own velocity and are shown above it.
+
+    A note can also have a probability, a number of ratchets and a trig condition,
+    which are shown along the top of the step when they're set.
 */
 class GriddleStep : public Component
 {
@@ -75,6 +80,42 @@ public:
     */
     void setGatePercent(const int gatePercent);
 
+    /** Sets the probability of the step playing each time it comes around
+
+        @param probability    The probability as a percentage (100 always plays the step).
+    */
+    void setProbability(const int probability);
+
+    /** Sets the number of times the step's note repeats within the step
+
+        @param ratchets    The number of ratchets, from 1 to GriddleStepData::MAX_RATCHETS.
+    */
+    void setRatchets(const int ratchets);
+
+    /** Sets the trig condition that decides whether the step plays each time it comes around
+
+        @param condition    The trig condition (see GriddleTrigCondition).
+    */
+    void setCondition(const int condition);
+
+    /** Sets the rest of the step's chord, which plays along with the step's note
+
+        @param chordNotes       The chord's notes (only the first numChordNotes are used).
+        @param numChordNotes    The number of notes in the chord besides the step's note.
+    */
+    void setChordNotes(const std::array<GriddleChordNoteData, GriddleStepData::MAX_CHORD_NOTES - 1>& chordNotes, const int numChordNotes);
+
+    /** Adds a note to the step's chord
+
+        @param midiNoteNumber    The MIDI note number to add.
+        @param velocity          The velocity of the added note.
+        @returns                 true if the note was added, or false if the chord is full or already has the note.
+    */
+    bool addChordNote(const int midiNoteNumber, const int velocity);
+
+    /** Removes the rest of the step's chord, leaving just the step's note */
+    void clearChordNotes();
+
     /** Selects or deselects the step for editing
 
         @param selected    Pass true to select the step for editing or pass false to deselect the step.
@@ -105,6 +146,42 @@ public:
     */
     int getGatePercent() const;
 
+    /** Gets the probability of the step playing each time it comes around
+
+        @returns    The probability as a percentage.
+    */
+    int getProbability() const;
+
+    /** Gets the number of times the step's note repeats within the step
+
+        @returns    The number of ratchets.
+    */
+    int getRatchets() const;
+
+    /** Gets the trig condition of the step
+
+        @returns    The trig condition (see GriddleTrigCondition).
+    */
+    int getCondition() const;
+
+    /** Gets the number of notes in the step's chord besides the step's note
+
+        @returns    The number of chord notes.
+    */
+    int getNumChordNotes() const;
+
+    /** Gets the rest of the step's chord
+
+        @returns    The chord's notes (only the first getNumChordNotes() are used).
+    */
+    const std::array<GriddleChordNoteData, GriddleStepData::MAX_CHORD_NOTES - 1>& getChordNotes() const;
+
+    /** Gets the names of the step's note and the rest of its chord, separated by spaces (e.g. "C4 E4 G4")
+
+        @returns    The note names, or an empty string if the step is a rest.
+    */
+    String getNoteNames() const;
+
     /** Gets the index of this step in its owner track's step list
 
         @returns    the index of this step in its owner track's step list
@@ -166,6 +243,11 @@ private:
     int midiNoteNumber_;
     int gatePercent_;
     int velocity_;
+    int probability_;
+    int ratchets_;
+    int condition_;
+    int numChordNotes_;
+    std::array<GriddleChordNoteData, GriddleStepData::MAX_CHORD_NOTES - 1> chordNotes_;
     //==============================================================================
 
     //==============================================================================
@@ -173,6 +255,8 @@ private:
     bool drawChopped_;
     bool drawFlipped_;
     String midiNoteString_;
+    String trigString_;
+    String chordString_;
     float velocityLinePosY_;
     float gateLinePosX_;
     Colour backgroundColor_;
@@ -184,6 +268,12 @@ private:
     /** Calls stepSelecetd method for all registered listeners */
     void callStepSelectedListeners();
 
+    /** Updates the trig display string from the step's probability, ratchets and trig condition */
+    void updateTrigString();
+
+    /** Updates the chord display string from the names of the rest of the step's chord */
+    void updateChordString();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleStep)
 };
 
@@ -202,6 +292,31 @@ inline int GriddleStep::getGatePercent() const
     return gatePercent_;
 }
 
+inline int GriddleStep::getProbability() const
+{
+    return probability_;
+}
+
+inline int GriddleStep::getRatchets() const
+{
+    return ratchets_;
+}
+
+inline int GriddleStep::getCondition() const
+{
+    return condition_;
+}
+
+inline int GriddleStep::getNumChordNotes() const
+{
+    return numChordNotes_;
+}
+
+inline const std::array<GriddleChordNoteData, GriddleStepData::MAX_CHORD_NOTES - 1>& GriddleStep::getChordNotes() const
+{
+    return chordNotes_;
+}
+
 inline int GriddleStep::getStepIndex() const
 {
     return stepIndex_;
@@ -0,0 +1,149 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleTelemetryOverlay.cpp
+    Created: 19 Oct 2026 10:06:51pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "GriddleTelemetryOverlay.h"
+#include "GriddleTrace.h"
+
+//==============================================================================
+constexpr int GriddleTelemetryOverlay::REFRESH_RATE_HZ;
+
+//==============================================================================
+GriddleTelemetryOverlay::GriddleTelemetryOverlay(const GriddlePlaybackTelemetry& telemetry)
+    : telemetry_(telemetry)
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+GriddleTelemetryOverlay::~GriddleTelemetryOverlay()
+{
+    stopTimer();
+}
+
+//==============================================================================
+void GriddleTelemetryOverlay::paint(Graphics& g)
+{
+    GRIDDLE_TRACE_SCOPE("GriddleTelemetryOverlay::paint");
+
+    g.setColour(Colours::black.withAlpha(0.8f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 6.0f);
+
+    auto area = getLocalBounds().reduced(10);
+
+    g.setColour(Colours::white);
+    g.setFont(Font(15.0f, Font::bold));
+    g.drawText("Playback Telemetry", area.removeFromTop(20), Justification::centredLeft);
+
+    // Split the rest of the overlay evenly between the histograms
+    auto histogramHeight = area.getHeight() / 4;
+
+    paintHistogram(g, telemetry_.getEventLateness(), area.removeFromTop(histogramHeight));
+    paintHistogram(g, telemetry_.getTimerLateness(), area.removeFromTop(histogramHeight));
+    paintHistogram(g, telemetry_.getSendTime(), area.removeFromTop(histogramHeight));
+    paintHistogram(g, telemetry_.getWireLateness(), area);
+}
+
+void GriddleTelemetryOverlay::visibilityChanged()
+{
+    if (isVisible())
+        startTimerHz(REFRESH_RATE_HZ);
+    else
+        stopTimer();
+}
+
+//==============================================================================
+void GriddleTelemetryOverlay::timerCallback()
+{
+    repaint();
+}
+
+void GriddleTelemetryOverlay::paintHistogram(Graphics& g, const GriddlePlaybackTelemetry::Histogram& histogram, Rectangle<int> area) const
+{
+    area.removeFromTop(6);
+
+    // Name and summary
+    g.setColour(Colours::white);
+    g.setFont(Font(13.0f, Font::bold));
+    g.drawText(histogram.getName() + "  (" + String(histogram.getTotalCount()) + ")", area.removeFromTop(16), Justification::centredLeft);
+
+    g.setColour(Colours::lightgrey);
+    g.setFont(Font(12.0f));
+    g.drawText("p50 " + formatTime(histogram.getPercentileMs(50.0)) + "   p99 " + formatTime(histogram.getPercentileMs(99.0))
+        + "   max " + formatTime(histogram.getMaxMs()), area.removeFromTop(15), Justification::centredLeft);
+
+    // Axis labels, with the last bin counting everything past the end of the histogram
+    auto labelArea = area.removeFromBottom(13);
+    g.setFont(Font(11.0f));
+    g.drawText("0", labelArea, Justification::centredLeft);
+    g.drawText(formatTime(histogram.getBinWidthMs() * (GriddlePlaybackTelemetry::Histogram::NUM_BINS - 1)) + "+", labelArea, Justification::centredRight);
+
+    // Bars, scaled logarithmically so that the rare slow times in the tail stay visible next to the common fast ones
+    uint32 maxBinCount = 0;
+
+    for (auto binIndex = 0; binIndex < GriddlePlaybackTelemetry::Histogram::NUM_BINS; ++binIndex)
+        maxBinCount = jmax(maxBinCount, histogram.getBinCount(binIndex));
+
+    g.setColour(Colours::white.withAlpha(0.15f));
+    g.fillRect(area);
+
+    if (maxBinCount == 0)
+        return;
+
+    auto barWidth = static_cast<float>(area.getWidth()) / GriddlePlaybackTelemetry::Histogram::NUM_BINS;
+    auto maxLogCount = std::log1p(static_cast<double>(maxBinCount));
+
+    g.setColour(Colours::lightgreen);
+
+    for (auto binIndex = 0; binIndex < GriddlePlaybackTelemetry::Histogram::NUM_BINS; ++binIndex)
+    {
+        auto binCount = histogram.getBinCount(binIndex);
+
+        if (binCount == 0)
+            continue;
+
+        // The last bin is drawn in red, since anything in it is past the end of the histogram
+        if (binIndex == GriddlePlaybackTelemetry::Histogram::NUM_BINS - 1)
+            g.setColour(Colours::red);
+
+        auto barHeight = static_cast<float>(area.getHeight() * (std::log1p(static_cast<double>(binCount)) / maxLogCount));
+
+        g.fillRect(area.getX() + (binIndex * barWidth), area.getBottom() - barHeight, jmax(1.0f, barWidth - 1.0f), barHeight);
+    }
+}
+
+String GriddleTelemetryOverlay::formatTime(const double timeMs)
+{
+    if (timeMs < 1.0)
+        return String(roundToInt(timeMs * 1000.0)) + " us";
+
+    return String(timeMs, 1) + " ms";
+}
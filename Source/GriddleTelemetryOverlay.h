@@ -0,0 +1,90 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleTelemetryOverlay.h
+    Created: 19 Oct 2026 10:06:51pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "GriddlePlaybackTelemetry.h"
+
+//==============================================================================
+/*
+    This component is an overlay that shows the playback telemetry histograms, along
+    with the p50, p99 and largest time of each.
+
+    It repaints itself a few times a second while it's visible and lets mouse clicks
+    through to the components underneath, so the sequence can still be edited.
+*/
+class GriddleTelemetryOverlay : public Component,
+                                private Timer
+{
+public:
+    //==============================================================================
+    explicit GriddleTelemetryOverlay(const GriddlePlaybackTelemetry& telemetry);
+    ~GriddleTelemetryOverlay();
+
+    //==============================================================================
+    void paint(Graphics&) override;
+
+    /** Starts or stops the repaint timer as the overlay is shown or hidden
+        This is an override of the Component method.
+    */
+    void visibilityChanged() override;
+
+    /** The number of times per second the overlay repaints while it's visible */
+    static constexpr int REFRESH_RATE_HZ = 10;
+
+private:
+    //==============================================================================
+    const GriddlePlaybackTelemetry& telemetry_;
+
+    //==============================================================================
+    /** Repaints the overlay with the latest telemetry
+        This is an override of the Timer method.
+    */
+    void timerCallback() override;
+
+    /** Draws one histogram with its name and summary
+        @param g            The graphics context to draw with
+        @param histogram    The histogram to draw
+        @param area         The area to draw it in
+    */
+    void paintHistogram(Graphics& g, const GriddlePlaybackTelemetry::Histogram& histogram, Rectangle<int> area) const;
+
+    /** Formats a time for display, in microseconds if it's under a millisecond
+        @param timeMs    The time in milliseconds
+        @returns         The formatted time (e.g. "0.4 ms" or "35 us")
+    */
+    static String formatTime(const double timeMs);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleTelemetryOverlay)
+};
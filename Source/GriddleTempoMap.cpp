@@ -0,0 +1,210 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleTempoMap.cpp
+    Created: 19 Oct 2026 7:14:52pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GriddleTempoMap.h"
+#include "GriddleTimeline.h"
+
+constexpr int GriddleTempoAutomationData::MAX_POINTS;
+constexpr int GriddleTempoAutomationData::MAX_MEASURES;
+constexpr double GriddleTempoAutomationData::MIN_TEMPO_SCALE;
+constexpr double GriddleTempoAutomationData::MAX_TEMPO_SCALE;
+
+//==============================================================================
+GriddleTempoMap::GriddleTempoMap()
+    : GriddleTempoMap(120.0, GriddleTempoAutomationData())
+{
+}
+
+GriddleTempoMap::GriddleTempoMap(const double tempo, const GriddleTempoAutomationData& automation)
+    : numSegments_(0)
+    , cycleBeats_(GriddleTimeline::QUARTER_NOTES_PER_MEASURE * jlimit(1, GriddleTempoAutomationData::MAX_MEASURES, automation.numMeasures))
+    , cycleSeconds_(0.0)
+{
+    // Sort a copy of the points, keeping them within the cycle (a point at the very end of the
+    // cycle is the target of a ramp, which then steps back to the first point's tempo)
+    auto numPoints = jlimit(0, GriddleTempoAutomationData::MAX_POINTS, automation.numPoints);
+    auto points = automation.points;
+
+    for (auto pointI = 0; pointI < numPoints; ++pointI)
+    {
+        points[pointI].beat = jlimit(0.0, cycleBeats_, points[pointI].beat);
+        points[pointI].tempoScale = jlimit(GriddleTempoAutomationData::MIN_TEMPO_SCALE, GriddleTempoAutomationData::MAX_TEMPO_SCALE, points[pointI].tempoScale);
+    }
+
+    std::stable_sort(points.begin(), points.begin() + numPoints, [](const GriddleTempoPointData& a, const GriddleTempoPointData& b)
+    {
+        return a.beat < b.beat;
+    });
+
+    // Without automation the tempo is constant
+    if (numPoints == 0)
+    {
+        segments_[0] = { 0.0, cycleBeats_, tempo, tempo, 0.0, 0.0 };
+        segments_[0].endSeconds = getSecondsIntoSegment(segments_[0], cycleBeats_);
+        numSegments_ = 1;
+        cycleSeconds_ = segments_[0].endSeconds;
+
+        return;
+    }
+
+    // The automation repeats, so before the first point the tempo follows the last point of the previous cycle
+    // and after the last point it heads for the first point of the next cycle
+    auto getTempoAt = [&points, numPoints, tempo, this](const double beat)
+    {
+        GriddleTempoPointData previous = points[numPoints - 1];
+        previous.beat -= cycleBeats_;
+
+        GriddleTempoPointData next = points[0];
+        next.beat += cycleBeats_;
+
+        for (auto pointI = 0; pointI < numPoints; ++pointI)
+        {
+            if (points[pointI].beat <= beat)
+                previous = points[pointI];
+        }
+
+        for (auto pointI = numPoints - 1; pointI >= 0; --pointI)
+        {
+            if (points[pointI].beat > beat)
+                next = points[pointI];
+        }
+
+        if (! next.isRamp)
+            return tempo * previous.tempoScale;
+
+        auto proportion = (beat - previous.beat) / (next.beat - previous.beat);
+        return tempo * (previous.tempoScale + ((next.tempoScale - previous.tempoScale) * proportion));
+    };
+
+    // Split the cycle into segments at the points, skipping any that would be empty
+    auto segmentStartBeat = 0.0;
+
+    for (auto pointI = 0; pointI <= numPoints; ++pointI)
+    {
+        auto segmentEndBeat = (pointI < numPoints) ? points[pointI].beat : cycleBeats_;
+
+        if (segmentEndBeat <= segmentStartBeat)
+            continue;
+
+        // A step at the end of the segment belongs to the next segment, so the end tempo is taken just before it
+        auto startTempo = getTempoAt(segmentStartBeat);
+        auto endTempo = startTempo;
+
+        if ((pointI < numPoints) ? points[pointI].isRamp : points[0].isRamp)
+            endTempo = tempo * ((pointI < numPoints) ? points[pointI].tempoScale : points[0].tempoScale);
+
+        auto& segment = segments_[numSegments_++];
+        segment = { segmentStartBeat, segmentEndBeat, startTempo, endTempo, cycleSeconds_, 0.0 };
+        segment.endSeconds = cycleSeconds_ + getSecondsIntoSegment(segment, segmentEndBeat);
+        cycleSeconds_ = segment.endSeconds;
+
+        segmentStartBeat = segmentEndBeat;
+    }
+}
+
+GriddleTempoMap::~GriddleTempoMap()
+{
+}
+
+double GriddleTempoMap::getTempoAtBeat(const double beat) const
+{
+    auto beatInCycle = beat - (std::floor(beat / cycleBeats_) * cycleBeats_);
+    const auto& segment = getSegmentAtBeat(beatInCycle);
+
+    auto proportion = (beatInCycle - segment.startBeat) / (segment.endBeat - segment.startBeat);
+    return segment.startTempo + ((segment.endTempo - segment.startTempo) * proportion);
+}
+
+double GriddleTempoMap::getSecondsAtBeat(const double beat) const
+{
+    // Whole cycles are multiplied rather than added up, so the time of any position is found directly
+    auto cycles = std::floor(beat / cycleBeats_);
+    auto beatInCycle = beat - (cycles * cycleBeats_);
+    const auto& segment = getSegmentAtBeat(beatInCycle);
+
+    return (cycles * cycleSeconds_) + segment.startSeconds + getSecondsIntoSegment(segment, beatInCycle);
+}
+
+double GriddleTempoMap::getBeatAtSeconds(const double seconds) const
+{
+    auto cycles = std::floor(seconds / cycleSeconds_);
+    auto secondsInCycle = seconds - (cycles * cycleSeconds_);
+    const auto& segment = getSegmentAtSeconds(secondsInCycle);
+
+    return (cycles * cycleBeats_) + getBeatIntoSegment(segment, secondsInCycle - segment.startSeconds);
+}
+
+//==============================================================================
+const GriddleTempoMap::Segment& GriddleTempoMap::getSegmentAtBeat(const double beatInCycle) const
+{
+    for (auto segmentI = 0; segmentI < (numSegments_ - 1); ++segmentI)
+    {
+        if (beatInCycle < segments_[segmentI].endBeat)
+            return segments_[segmentI];
+    }
+
+    return segments_[numSegments_ - 1];
+}
+
+const GriddleTempoMap::Segment& GriddleTempoMap::getSegmentAtSeconds(const double secondsInCycle) const
+{
+    for (auto segmentI = 0; segmentI < (numSegments_ - 1); ++segmentI)
+    {
+        if (secondsInCycle < segments_[segmentI].endSeconds)
+            return segments_[segmentI];
+    }
+
+    return segments_[numSegments_ - 1];
+}
+
+double GriddleTempoMap::getSecondsIntoSegment(const Segment& segment, const double beat)
+{
+    auto beats = beat - segment.startBeat;
+
+    if (segment.endTempo == segment.startTempo)
+        return beats * 60.0 / segment.startTempo;
+
+    // The tempo ramps linearly in beats, so the time is a logarithm of the tempo reached
+    auto slope = (segment.endTempo - segment.startTempo) / (segment.endBeat - segment.startBeat);
+    return (60.0 / slope) * std::log1p((slope * beats) / segment.startTempo);
+}
+
+double GriddleTempoMap::getBeatIntoSegment(const Segment& segment, const double seconds)
+{
+    if (segment.endTempo == segment.startTempo)
+        return segment.startBeat + (seconds * segment.startTempo / 60.0);
+
+    auto slope = (segment.endTempo - segment.startTempo) / (segment.endBeat - segment.startBeat);
+    return segment.startBeat + (segment.startTempo * std::expm1((slope * seconds) / 60.0) / slope);
+}
@@ -0,0 +1,130 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleTempoMap.h
+    Created: 19 Oct 2026 7:14:52pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include "GriddleProjectData.h"
+
+//==============================================================================
+/*
+    This class maps positions on the sequence timeline in beats to times in seconds,
+    following a project's tempo and tempo automation.
+
+    The automation is made up of segments between its points, each either holding a
+    tempo or ramping linearly (in beats) from one tempo to the next, and it repeats
+    every numMeasures measures. Times are found by integrating the tempo over the
+    segments in closed form, with the time of each automation cycle calculated once,
+    so any position is found directly rather than by adding up earlier measures.
+
+    A tempo map is a fixed-size value with no allocations, so it can be copied onto the
+    playback thread while the sequence is playing.
+*/
+class GriddleTempoMap
+{
+public:
+    //==============================================================================
+    /** Creates a tempo map with a constant tempo of 120 BPM */
+    GriddleTempoMap();
+
+    /** Creates a tempo map from a project tempo and its tempo automation
+
+        Automation points are sorted by position and limited to the automation's length
+        and the valid range of tempo scales.
+
+        @param tempo         The project tempo in BPM, which the automation's tempo scales multiply
+        @param automation    The tempo automation, or automation with no points for a constant tempo
+    */
+    GriddleTempoMap(const double tempo, const GriddleTempoAutomationData& automation);
+
+    ~GriddleTempoMap();
+    //==============================================================================
+
+    /** Gets the tempo at a position on the timeline
+
+        @param beat    The position in beats from the start of playback
+        @returns       The tempo in BPM
+    */
+    double getTempoAtBeat(const double beat) const;
+
+    /** Gets the time of a position on the timeline
+
+        @param beat    The position in beats from the start of playback
+        @returns       The time in seconds from the start of playback
+    */
+    double getSecondsAtBeat(const double beat) const;
+
+    /** Gets the position on the timeline at a time
+
+        @param seconds    The time in seconds from the start of playback
+        @returns          The position in beats from the start of playback
+    */
+    double getBeatAtSeconds(const double seconds) const;
+
+private:
+    //==============================================================================
+    /** A part of one automation cycle where the tempo holds or ramps linearly between two positions */
+    struct Segment
+    {
+        double startBeat;
+        double endBeat;
+        double startTempo;
+        double endTempo;
+        double startSeconds;
+        double endSeconds;
+    };
+
+    //==============================================================================
+    // Tempo Map Variables
+    std::array<Segment, GriddleTempoAutomationData::MAX_POINTS + 1> segments_;
+    int numSegments_;
+    double cycleBeats_;
+    double cycleSeconds_;
+    //==============================================================================
+
+    /** Finds the segment that contains a position in the automation cycle */
+    const Segment& getSegmentAtBeat(const double beatInCycle) const;
+
+    /** Finds the segment that contains a time in the automation cycle */
+    const Segment& getSegmentAtSeconds(const double secondsInCycle) const;
+
+    /** Integrates a segment's tempo to get the time from its start to a position in it */
+    static double getSecondsIntoSegment(const Segment& segment, const double beat);
+
+    /** Inverts getSecondsIntoSegment() to get the position reached a time after a segment's start */
+    static double getBeatIntoSegment(const Segment& segment, const double seconds);
+
+    JUCE_LEAK_DETECTOR(GriddleTempoMap)
+};
@@ -0,0 +1,272 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleTimeline.h
+    Created: 19 Oct 2026 6:02:37pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <vector>
+#include "GriddleProjectData.h"
+
+//==============================================================================
+/*
+    The sequence timeline is counted in ticks rather than samples, so the position of
+    every step is exact whatever the tempo, sample rate or number of steps in a track.
+
+    A measure is 4 beats of 960 PPQN, refined by 3 x 7 x 11 x 13 so that it divides
+    exactly by every number of notes a track can play in a measure (1 to 16 steps, or
+    twice as many notes for a burnt track). Every note starts on a whole tick and tracks of any
+    lengths meet exactly at every measure boundary, so polymetric tracks never drift
+    out of phase however many measures are played.
+
+    A track can instead be clocked at a fixed rate (see getClockRate()), from a step every
+    whole note to a step every 128th note, including triplet rates. Every clock rate is also
+    a whole number of ticks, so a clocked track's pattern runs freely across the measure
+    boundaries for as long as it's played without gaining or losing a tick.
+
+    Compiled measures keep their events in ticks, and the scheduler only converts them
+    to times as they're queued, by integrating the tempo map (see GriddleTempoMap). Each
+    position is converted on its own, so rounding errors are never carried from one step
+    to the next, and tempo changes never require the steps to be recompiled.
+*/
+struct GriddleTimeline
+{
+    static constexpr int64 TICKS_PER_QUARTER_NOTE = int64(960) * 3 * 7 * 11 * 13;
+    static constexpr int QUARTER_NOTES_PER_MEASURE = 4;
+    static constexpr int64 TICKS_PER_MEASURE = TICKS_PER_QUARTER_NOTE * QUARTER_NOTES_PER_MEASURE;
+    static constexpr int64 TICKS_PER_SIXTEENTH_NOTE = TICKS_PER_QUARTER_NOTE / 4;
+
+    /** The most steps a track can play in a measure (a burnt track at the fastest clock rate), each of which
+        can be ratcheted into up to GriddleStepData::MAX_RATCHETS repeats of a chord of up to
+        GriddleStepData::MAX_CHORD_NOTES notes */
+    static constexpr int MAX_NOTES_PER_MEASURE = 256;
+
+    /** The shortest time between a note's NOTE ON and NOTE OFF, which ensures reliable note triggering */
+    static constexpr double MIN_GATE_SECONDS = 0.02;
+
+    /** A rate a track's steps can be clocked at, in steps per 16th note */
+    struct ClockRate
+    {
+        int numerator;
+        int denominator;
+    };
+
+    /** The number of clock rates a track can be set to (see getClockRate()) */
+    static constexpr int NUM_CLOCK_RATES = 11;
+
+    /** Gets one of the clock rates a track can be set to, from slowest to fastest
+
+        The rates run from 1/4x (a step every whole note) to 8x (a step every 128th note), and the
+        rates with a numerator of 3 are the triplet rates in between.
+
+        @param index    The index of the clock rate, from 0 to NUM_CLOCK_RATES - 1
+        @returns        The clock rate
+    */
+    static constexpr ClockRate getClockRate(const int index)
+    {
+        constexpr ClockRate clockRates[NUM_CLOCK_RATES] = { { 1, 4 }, { 3, 8 }, { 1, 2 }, { 3, 4 }, { 1, 1 }, { 3, 2 },
+                                                            { 2, 1 }, { 3, 1 }, { 4, 1 }, { 6, 1 }, { 8, 1 } };
+
+        return clockRates[index];
+    }
+
+    /** Checks whether a clock rate is one a track can be set to
+
+        @param numerator      The clock rate's numerator
+        @param denominator    The clock rate's denominator
+        @returns              true if the clock rate is one of the rates returned by getClockRate()
+    */
+    static constexpr bool isValidClockRate(const int numerator, const int denominator)
+    {
+        for (int rateI = 0; rateI < NUM_CLOCK_RATES; ++rateI)
+        {
+            if ((getClockRate(rateI).numerator == numerator) && (getClockRate(rateI).denominator == denominator))
+                return true;
+        }
+
+        return false;
+    }
+
+    /** Gets the length of each of a track's notes
+
+        A track that isn't clocked at a valid rate fits its steps into one measure, or plays them twice
+        in a measure if it's burnt. A clocked track plays a step at its clock rate, or at twice its clock
+        rate if it's burnt, whatever its number of steps.
+
+        @param numSteps               The number of steps in the track
+        @param isBurnt                true if the track is burnt
+        @param clockRateNumerator     The numerator of the track's clock rate, or 0 to fit the steps into one measure
+        @param clockRateDenominator   The denominator of the track's clock rate
+        @returns                      The length of each note in ticks
+    */
+    static constexpr int64 getNoteTicks(const int numSteps, const bool isBurnt, const int clockRateNumerator, const int clockRateDenominator)
+    {
+        return isValidClockRate(clockRateNumerator, clockRateDenominator)
+            ? (TICKS_PER_SIXTEENTH_NOTE * clockRateDenominator) / (clockRateNumerator * (isBurnt ? 2 : 1))
+            : TICKS_PER_MEASURE / ((numSteps > 1 ? numSteps : 1) * (isBurnt ? 2 : 1));
+    }
+
+    /** Gets the length of each of a track's notes
+
+        @param track    The track
+        @returns        The length of each note in ticks
+    */
+    static int64 getNoteTicks(const GriddleTrackData& track)
+    {
+        return getNoteTicks(track.numSteps, track.isBurnt, track.clockRateNumerator, track.clockRateDenominator);
+    }
+
+    /** Gets the length of a measure in seconds
+        @param tempo    The tempo in BPM
+        @returns        The length of one measure in seconds
+    */
+    static double getMeasureLengthSeconds(const double tempo)
+    {
+        return (60.0 / tempo) * QUARTER_NOTES_PER_MEASURE;
+    }
+
+    /** Converts a tick position to the nearest sample position at a constant tempo
+        @param ticks         The position in ticks from the start of the measure
+        @param tempo         The tempo in BPM
+        @param sampleRate    The sample rate of the sample positions
+        @returns             The position in samples from the start of the measure
+    */
+    static int ticksToSamples(const int64 ticks, const double tempo, const double sampleRate)
+    {
+        return roundToInt((static_cast<double>(ticks) / TICKS_PER_MEASURE) * getMeasureLengthSeconds(tempo) * sampleRate);
+    }
+
+    /** Converts a tick position to a position in beats
+        @param ticks    The position in ticks
+        @returns        The position in beats (quarter notes)
+    */
+    static double ticksToBeats(const int64 ticks)
+    {
+        return static_cast<double>(ticks) / TICKS_PER_QUARTER_NOTE;
+    }
+
+    /** Checks that every number of notes a track can play divides the measure into whole ticks,
+        and that every clock rate, burnt or not, is a whole number of ticks
+        @returns    true if every note of every track starts exactly on a tick
+    */
+    static constexpr bool isEveryNoteExact()
+    {
+        for (int numSteps = 1; numSteps <= GriddleTrackData::NUM_STEPS; ++numSteps)
+        {
+            if (((TICKS_PER_MEASURE % numSteps) != 0) || ((TICKS_PER_MEASURE % (numSteps * 2)) != 0))
+                return false;
+        }
+
+        for (int rateI = 0; rateI < NUM_CLOCK_RATES; ++rateI)
+        {
+            auto clockRate = getClockRate(rateI);
+
+            if (((TICKS_PER_SIXTEENTH_NOTE * clockRate.denominator) % (clockRate.numerator * 2)) != 0)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+static_assert(GriddleTimeline::isEveryNoteExact(), "Every number of notes a track can play must divide the measure into whole ticks");
+static_assert(GriddleTimeline::TICKS_PER_MEASURE / GriddleTimeline::getNoteTicks(1, true, 8, 1) == GriddleTimeline::MAX_NOTES_PER_MEASURE,
+              "MAX_NOTES_PER_MEASURE must be the number of notes of a burnt track at the fastest clock rate");
+
+//==============================================================================
+/** A MIDI event of a compiled measure, positioned on the tick timeline
+
+    The event is due at the time of tick + gateTicks, plus offsetSeconds. For a NOTE OFF, tick is
+    the start of the note and gateTicks its length, so the NOTE OFF can be kept at least
+    MIN_GATE_SECONDS after the NOTE ON whatever the tempo. The offset holds the part of the
+    event's timing that doesn't scale with the tempo (the track's latency offset). Any
+    spreading of a burst of events on the MIDI wire is added by the scheduler as it queues
+    the event, and kept apart from the event's nominal time (see GriddleScheduler).
+
+    The track index, the note's position in its track's cycle and the length of the track's
+    notes are kept so that swing and grooves can be applied as the event is scheduled (see
+    GriddleGroove). The priority orders events from different tracks that are due at the same
+    time (lower values go first).
+
+    An event of a step with a probability or a trig condition has the index of the step's trig
+    in its track (see GriddleCompiledTrig), and is only queued if the trig plays. Events of every
+    other step have a trig index of -1.
+*/
+struct GriddleTimelineEvent
+{
+    int64 tick;
+    int64 gateTicks;
+    double offsetSeconds;
+    MidiMessage message;
+    int priority;
+    int trackIndex;
+    int noteIndex;
+    int64 noteTicks;
+    int trigIndex;
+};
+
+/** A step of a compiled track with a probability or a trig condition, positioned in ticks from the start of the
+    cycle, which the scheduler decides whether to play each time it's queued (see GriddleTrigCondition) */
+struct GriddleCompiledTrig
+{
+    int64 tick;
+    int probability;
+    int condition;
+};
+
+/** The events of one compiled track, which repeat every cycleTicks from the start of playback
+
+    The events are positioned in ticks from the start of the cycle, in the order they should be sent
+    when they're due at the same time. A track that fits into a measure has a cycle of one measure,
+    and a clocked track whose pattern doesn't divide the measure runs freely with a cycle of its own.
+
+    The trigs of the steps with a probability or a trig condition are kept in order of position, along
+    with the length of the track's pattern, which iteration conditions count the plays of.
+*/
+struct GriddleCompiledTrack
+{
+    std::vector<GriddleTimelineEvent> events;
+    std::vector<GriddleCompiledTrig> trigs;
+    int64 cycleTicks = 0;
+    int64 patternTicks = 0;
+};
+
+/** The compiled tracks that each measure's events are queued from */
+struct GriddleCompiledMeasure
+{
+    std::array<GriddleCompiledTrack, GriddleProjectData::NUM_TRACKS> tracks;
+
+    /** How far ahead of the measure start its earliest event can be due, which is how far ahead it needs to be queued */
+    double lookAheadSeconds = 0.0;
+};
@@ -0,0 +1,236 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleTrace.cpp
+    Created: 19 Oct 2026 10:41:09pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "GriddleTrace.h"
+
+#if GRIDDLE_ENABLE_TRACING
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+constexpr int GriddleTrace::EVENTS_PER_THREAD;
+
+//==============================================================================
+void GriddleTrace::record(const char* name, const int64 startTicks, const int64 endTicks) noexcept
+{
+    auto& buffer = getThreadBuffer();
+
+    // Only this thread writes to its buffer, so the slot can be filled in before the write index is
+    // published to a thread that's writing the trace file
+    auto index = buffer.writeIndex.load(std::memory_order_relaxed);
+    buffer.events[index & (EVENTS_PER_THREAD - 1)] = { name, startTicks, endTicks };
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+void GriddleTrace::writeChromeTrace(OutputStream& stream)
+{
+    struct ThreadEvents
+    {
+        int threadIndex;
+        String threadName;
+        std::vector<Event> events;
+    };
+
+    std::vector<ThreadEvents> threadEvents;
+    auto originTicks = std::numeric_limits<int64>::max();
+
+    // Buffers are only ever added to the front of the list and never removed, so the list can be walked
+    // while other threads add their buffers
+    for (auto* buffer = getThreadBuffers().getFirst(); buffer != nullptr; buffer = buffer->next)
+    {
+        auto threadName = buffer->threadName.isNotEmpty() ? buffer->threadName : "Thread " + String(buffer->threadIndex);
+        ThreadEvents copy { buffer->threadIndex, threadName, {} };
+
+        // Copy the events that are in the buffer, oldest first
+        auto endIndex = buffer->writeIndex.load(std::memory_order_acquire);
+        auto startIndex = (endIndex > EVENTS_PER_THREAD) ? (endIndex - EVENTS_PER_THREAD) : 0;
+
+        for (auto index = startIndex; index < endIndex; ++index)
+            copy.events.push_back(buffer->events[index & (EVENTS_PER_THREAD - 1)]);
+
+        // The thread may have kept recording while its events were copied, so drop the ones whose slots it
+        // could have reused (including the slot it may be in the middle of writing)
+        auto latestIndex = buffer->writeIndex.load(std::memory_order_acquire);
+
+        if (latestIndex + 1 > startIndex + EVENTS_PER_THREAD)
+        {
+            auto numOverwritten = static_cast<size_t>(jmin<uint64>(endIndex - startIndex, latestIndex + 1 - startIndex - EVENTS_PER_THREAD));
+            copy.events.erase(copy.events.begin(), copy.events.begin() + static_cast<std::ptrdiff_t>(numOverwritten));
+        }
+
+        for (auto& event : copy.events)
+            originTicks = jmin(originTicks, event.startTicks);
+
+        threadEvents.push_back(std::move(copy));
+    }
+
+    // The list has the most recent threads first, so put the threads back in the order they started recording
+    std::sort(threadEvents.begin(), threadEvents.end(), [](const ThreadEvents& a, const ThreadEvents& b) { return a.threadIndex < b.threadIndex; });
+
+    // Chrome trace timestamps and durations are in microseconds
+    auto ticksToMicroseconds = [originTicks] (const int64 ticks)
+    {
+        return String(Time::highResolutionTicksToSeconds(ticks - originTicks) * 1.0e6, 3);
+    };
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    auto separator = "";
+
+    for (auto& thread : threadEvents)
+    {
+        stream << separator << newLine
+               << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.threadIndex
+               << ",\"args\":{\"name\":\"" << JSON::escapeString(thread.threadName) << "\"}}";
+        separator = ",";
+
+        for (auto& event : thread.events)
+        {
+            stream << "," << newLine
+                   << "{\"name\":\"" << JSON::escapeString(event.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.threadIndex
+                   << ",\"ts\":" << ticksToMicroseconds(event.startTicks)
+                   << ",\"dur\":" << String(Time::highResolutionTicksToSeconds(event.endTicks - event.startTicks) * 1.0e6, 3) << "}";
+        }
+    }
+
+    stream << newLine << "]}" << newLine;
+}
+
+void GriddleTrace::reserveThreadBuffer()
+{
+    // One reserved buffer is enough for the next thread to start
+    if (getReservedThreadBuffers().getFirst() == nullptr)
+        getReservedThreadBuffers().push(createThreadBuffer());
+}
+
+//==============================================================================
+GriddleTrace::ThreadBuffer& GriddleTrace::getThreadBuffer()
+{
+    thread_local ThreadBuffer* threadBuffer = nullptr;
+
+    if (threadBuffer == nullptr)
+    {
+        // This only happens the first time each thread records an event. A reserved buffer is claimed if there
+        // is one, so a thread that had one reserved for it neither allocates nor locks here.
+        auto buffer = getReservedThreadBuffers().pop();
+
+        if (buffer == nullptr)
+            buffer = createThreadBuffer();
+
+        auto* messageManager = MessageManager::getInstanceWithoutCreating();
+
+        if ((messageManager != nullptr) && messageManager->isThisTheMessageThread())
+            buffer->threadName = "Message Thread";
+        else if (auto* thread = Thread::getCurrentThread())
+            buffer->threadName = thread->getThreadName();
+
+        buffer->threadIndex = ++getNumThreads();
+
+        getThreadBuffers().push(buffer);
+        threadBuffer = buffer;
+    }
+
+    return *threadBuffer;
+}
+
+GriddleTrace::ThreadBuffer* GriddleTrace::createThreadBuffer()
+{
+    auto buffer = new ThreadBuffer();
+    buffer->threadIndex = 0;
+    buffer->events.calloc(static_cast<size_t>(EVENTS_PER_THREAD));
+    buffer->writeIndex = 0;
+    buffer->next = nullptr;
+
+    return buffer;
+}
+
+GriddleTrace::ThreadBufferList& GriddleTrace::getThreadBuffers()
+{
+    static ThreadBufferList threadBuffers;
+    return threadBuffers;
+}
+
+GriddleTrace::ThreadBufferList& GriddleTrace::getReservedThreadBuffers()
+{
+    static ThreadBufferList reservedThreadBuffers;
+    return reservedThreadBuffers;
+}
+
+std::atomic<int>& GriddleTrace::getNumThreads()
+{
+    static std::atomic<int> numThreads { 0 };
+    return numThreads;
+}
+
+//==============================================================================
+GriddleTrace::ThreadBufferList::ThreadBufferList() noexcept
+    : first_(nullptr)
+{
+}
+
+GriddleTrace::ThreadBufferList::~ThreadBufferList()
+{
+    for (auto* buffer = first_.load(); buffer != nullptr;)
+        delete std::exchange(buffer, buffer->next);
+}
+
+void GriddleTrace::ThreadBufferList::push(ThreadBuffer* buffer) noexcept
+{
+    // Publish the buffer along with everything written to it so far, so a thread walking the list sees it complete
+    buffer->next = first_.load(std::memory_order_relaxed);
+
+    while (! first_.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+GriddleTrace::ThreadBuffer* GriddleTrace::ThreadBufferList::pop() noexcept
+{
+    auto* buffer = first_.load(std::memory_order_acquire);
+
+    while ((buffer != nullptr) && ! first_.compare_exchange_weak(buffer, buffer->next, std::memory_order_acquire, std::memory_order_acquire))
+    {
+    }
+
+    return buffer;
+}
+
+GriddleTrace::ThreadBuffer* GriddleTrace::ThreadBufferList::getFirst() const noexcept
+{
+    return first_.load(std::memory_order_acquire);
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleTrace.h
+    Created: 19 Oct 2026 10:41:09pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Scoped trace events for the hot paths, which can be written out as a Chrome JSON
+    trace file and opened in chrome://tracing or Perfetto.
+
+    Tracing is compiled in by defining GRIDDLE_ENABLE_TRACING=1 (e.g. by adding it to the
+    preprocessor definitions in Projucer, or with CPPFLAGS=-DGRIDDLE_ENABLE_TRACING=1 for the
+    Linux Makefile). Otherwise GRIDDLE_TRACE_SCOPE() expands to nothing and none of the
+    tracing code is built.
+
+    Each thread records its events into its own ring buffer, so recording never locks or
+    allocates once a thread's buffer exists. When a buffer fills up, the oldest events are
+    overwritten, so a trace file always holds each thread's most recent events.
+
+    The buffers are kept in lock-free lists, so a thread claiming its buffer never waits on
+    another thread or on a trace file being written. A thread that mustn't allocate either
+    (e.g. the playback timer thread) should have a buffer reserved for it before it starts,
+    with GRIDDLE_TRACE_RESERVE_THREAD_BUFFER(), which it then claims on its first event.
+*/
+
+#ifndef GRIDDLE_ENABLE_TRACING
+ #define GRIDDLE_ENABLE_TRACING 0
+#endif
+
+#if GRIDDLE_ENABLE_TRACING
+
+#include <atomic>
+
+//==============================================================================
+class GriddleTrace
+{
+public:
+    //==============================================================================
+    /*
+        Records a trace event covering the lifetime of the object. The name must be a
+        string literal, since only the pointer is kept.
+    */
+    class ScopedEvent
+    {
+    public:
+        explicit ScopedEvent(const char* name) noexcept
+            : name_(name)
+            , startTicks_(Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedEvent() noexcept
+        {
+            GriddleTrace::record(name_, startTicks_, Time::getHighResolutionTicks());
+        }
+
+    private:
+        const char* name_;
+        const int64 startTicks_;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedEvent)
+    };
+
+    //==============================================================================
+    /** Records a completed event into the calling thread's ring buffer
+        @param name          The name of the event (a string literal)
+        @param startTicks    The Time::getHighResolutionTicks() value when the event started
+        @param endTicks      The Time::getHighResolutionTicks() value when the event ended
+    */
+    static void record(const char* name, const int64 startTicks, const int64 endTicks) noexcept;
+
+    /** Writes the events in every thread's ring buffer as a Chrome JSON trace
+        This can be called from any thread while events are being recorded. Events that get
+        overwritten while they're being copied are left out.
+        @param stream    The stream to write to
+    */
+    static void writeChromeTrace(OutputStream& stream);
+
+    /** Allocates a ring buffer for the next thread to record its first event, unless one is already waiting
+        Call this before starting a thread that records events but mustn't allocate (e.g. the playback timer thread).
+    */
+    static void reserveThreadBuffer();
+
+    /** The number of events each thread's ring buffer holds (a power of 2) */
+    static constexpr int EVENTS_PER_THREAD = 1 << 16;
+
+private:
+    //==============================================================================
+    /** A completed trace event */
+    struct Event
+    {
+        const char* name;
+        int64 startTicks;
+        int64 endTicks;
+    };
+
+    /** The ring buffer of one thread's events, which only that thread writes to
+
+        The thread's name is left empty for threads that aren't named, and written as "Thread" and the thread's index.
+    */
+    struct ThreadBuffer
+    {
+        int threadIndex;
+        String threadName;
+        HeapBlock<Event> events;
+        std::atomic<uint64> writeIndex;
+        ThreadBuffer* next;
+    };
+
+    /** A singly-linked list of ring buffers that threads add to and take from without locking, which owns its buffers */
+    class ThreadBufferList
+    {
+    public:
+        ThreadBufferList() noexcept;
+        ~ThreadBufferList();
+
+        /** Adds a buffer to the front of the list */
+        void push(ThreadBuffer* buffer) noexcept;
+
+        /** Takes the buffer at the front of the list, or returns nullptr if the list is empty
+            Buffers that have been taken must never be pushed back, so the list can't be fooled by a buffer
+            reappearing at the front while another thread is taking it.
+        */
+        ThreadBuffer* pop() noexcept;
+
+        /** Gets the buffer at the front of the list, whose next pointers lead to the rest */
+        ThreadBuffer* getFirst() const noexcept;
+
+    private:
+        std::atomic<ThreadBuffer*> first_;
+
+        JUCE_DECLARE_NON_COPYABLE(ThreadBufferList)
+    };
+
+    //==============================================================================
+    /** Gets the calling thread's ring buffer, claiming a reserved buffer or creating one the first time the thread
+        records an event
+        @returns    The calling thread's ring buffer
+    */
+    static ThreadBuffer& getThreadBuffer();
+
+    /** Allocates an empty ring buffer */
+    static ThreadBuffer* createThreadBuffer();
+
+    /** Gets the ring buffers of every thread that has recorded an event */
+    static ThreadBufferList& getThreadBuffers();
+
+    /** Gets the ring buffers reserved for threads that haven't recorded an event yet */
+    static ThreadBufferList& getReservedThreadBuffers();
+
+    /** Gets the counter that numbers the threads in the order they record their first events */
+    static std::atomic<int>& getNumThreads();
+};
+
+#define GRIDDLE_TRACE_SCOPE(name)    const GriddleTrace::ScopedEvent JUCE_JOIN_MACRO(griddleTraceEvent_, __LINE__)(name)
+#define GRIDDLE_TRACE_RESERVE_THREAD_BUFFER()    GriddleTrace::reserveThreadBuffer()
+
+#else
+
+#define GRIDDLE_TRACE_SCOPE(name)
+#define GRIDDLE_TRACE_RESERVE_THREAD_BUFFER()
+
+#endif
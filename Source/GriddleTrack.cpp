@@ -33,6 +33,10 @@ along with Griddle. If not, see < https://www.gnu.org/licenses/>.
 
 #include <JuceHeader.h>
 #include "GriddleTrack.h"
+#include "GriddleTimeline.h"
+#include "GriddleTrace.h"
+
+constexpr double GriddleTrack::MAX_LATENCY_OFFSET_MS;
 
 //==============================================================================
 GriddleTrack::GriddleTrack(int trackIndex)
@@ -60,11 +64,18 @@ GriddleTrack::GriddleTrack(int trackIndex)
     , flippedStateToDraw_(false)
     , choppedStateToDraw_(false)
     , burntStateToDraw_(false)
+    , clockRateNumeratorToDraw_(0)
+    , clockRateDenominatorToDraw_(1)
     , flipToggle_("FLIP")
     , chopToggle_("CHOP")
     , burnToggle_("BURN")
     , activeToggle_("ACTIVE")
-    , projectTrackDataVar_(new DynamicObject())
+    , latencyOffset_(0.0)
+    , latencyOffsetInSamples_(false)
+    , swingPercent_(GriddleTrackData::MIN_SWING_PERCENT)
+    , grooveIndex_(-1)
+    , clockRateNumerator_(0)
+    , clockRateDenominator_(1)
 {
     setSize(1200, 95);
 
@@ -76,6 +87,7 @@ GriddleTrack::GriddleTrack(int trackIndex)
     trackTitleLabel_.setText("A", dontSendNotification);
     trackTitleLabel_.setAlpha(0.5f);
     trackTitleLabel_.setFont(Font(110.0f, Font::italic | Font::bold));
+    trackTitleLabel_.setInterceptsMouseClicks(false, false);
 
     // Track Active Toggle
     addAndMakeVisible(activeToggle_);
@@ -190,247 +202,326 @@ GriddleTrack::~GriddleTrack()
 {
 }
 
-const String GriddleTrack::loadProjectTrackData(const var& projectTrackData)
+void GriddleTrack::loadTrackData(const GriddleTrackData& trackData)
 {
-    // Initialize an error string to populate if any properties are missing or invalid
-    String errorString("");
+    // Notifications aren't sent when the components are set
+    // and any processing needed for the new values is called explicitly
+    activeToggle_.setToggleState(trackData.isActive, dontSendNotification);
+    updateTrackActiveState(false);
 
-    // Creating Identifier objects can be slow, so just initialize one to reuse for each property
-    Identifier propertyId;
+    midiChannelComboBox_.setSelectedId(trackData.midiChannel, dontSendNotification);
 
-    // Initialize a default return var to be reused for each getProperty call
-    var defaultReturn;
-    
-    // ******************************************************************************************
-    // Load each setting from the properties in the file
-    // ******************************************************************************************
-    // NOTE: When the various components are set, the notification setting is always
-    // dontSendNotification, so that the notifier callbacks don't get asynchronously called after 
-    // the processing is over resulting in a the unsaved changes flag incorrectly getting set.
-    // Since notifications aren't sent, any processing that needs to happen when the values are
-    // set is called expliclitly.
-    // *******************************************************************************************
-    
-    propertyId = "is_active";
-    if (projectTrackData.hasProperty(propertyId))
-    {
-        auto isActive = projectTrackData.getProperty(propertyId, defaultReturn);
-        activeToggle_.setToggleState(isActive, dontSendNotification);
-        updateTrackActiveState(false);
-    }
-    else
-    {
-        errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in track settings for track " + trackTitleLabel_.getText() + String(NewLine::getDefault()));
-    }
+    numStepsComboBox_.setSelectedId(trackData.numSteps, dontSendNotification);
+    updateNumSteps(false);
 
-    propertyId = "midi_ch";
-    if (projectTrackData.hasProperty(propertyId))
-    {
-        auto midiChannel = projectTrackData.getProperty(propertyId, defaultReturn);
-        midiChannelComboBox_.setSelectedId(midiChannel, dontSendNotification);
-    }
-    else
-    {
-        errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in track settings for track " + trackTitleLabel_.getText() + String(NewLine::getDefault()));
-    }
+    flipToggle_.setToggleState(trackData.isFlipped, dontSendNotification);
+    updateFlippedState(false);
 
-    propertyId = "num_steps";
-    if (projectTrackData.hasProperty(propertyId))
-    {
-        auto numSteps = projectTrackData.getProperty(propertyId, defaultReturn);
-        numStepsComboBox_.setSelectedId(numSteps, dontSendNotification);
-        updateNumSteps(false);
-    }
-    else
-    {
-        errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in track settings for track " + trackTitleLabel_.getText() + String(NewLine::getDefault()));
-    }
+    chopToggle_.setToggleState(trackData.isChopped, dontSendNotification);
+    updateChoppedState(false);
+
+    burnToggle_.setToggleState(trackData.isBurnt, dontSendNotification);
+    updateBurntState(false);
+
+    setLatencyOffset(trackData.latencyOffset, trackData.latencyOffsetInSamples, false);
+    setSwingPercent(trackData.swingPercent, false);
+    setGrooveIndex(trackData.grooveIndex, false);
+    setClockRate(trackData.clockRateNumerator, trackData.clockRateDenominator, false);
 
-    propertyId = "is_flipped";
-    if (projectTrackData.hasProperty(propertyId))
+    for (auto sI = 0; sI < steps_.size(); ++sI)
     {
-        auto isFlipped = projectTrackData.getProperty(propertyId, defaultReturn);
-        flipToggle_.setToggleState(isFlipped, dontSendNotification);
-        updateFlippedState(false);
+        steps_[sI]->setNoteNumber(trackData.steps[sI].noteNumber);
+        steps_[sI]->setVelocity(trackData.steps[sI].velocity);
+        steps_[sI]->setGatePercent(trackData.steps[sI].gatePercent);
+        steps_[sI]->setProbability(trackData.steps[sI].probability);
+        steps_[sI]->setRatchets(trackData.steps[sI].ratchets);
+        steps_[sI]->setCondition(trackData.steps[sI].condition);
+        steps_[sI]->setChordNotes(trackData.steps[sI].chordNotes, trackData.steps[sI].numChordNotes);
     }
-    else
+}
+
+void GriddleTrack::getTrackData(GriddleTrackData& trackData) const
+{
+    trackData.isActive = activeToggle_.getToggleState();
+    trackData.midiChannel = midiChannelComboBox_.getSelectedId();
+    trackData.numSteps = numStepsComboBox_.getSelectedId();
+    trackData.isFlipped = flipToggle_.getToggleState();
+    trackData.isChopped = chopToggle_.getToggleState();
+    trackData.isBurnt = burnToggle_.getToggleState();
+    trackData.latencyOffset = latencyOffset_;
+    trackData.latencyOffsetInSamples = latencyOffsetInSamples_;
+    trackData.swingPercent = swingPercent_;
+    trackData.grooveIndex = grooveIndex_;
+    trackData.clockRateNumerator = clockRateNumerator_;
+    trackData.clockRateDenominator = clockRateDenominator_;
+
+    for (auto sI = 0; sI < steps_.size(); ++sI)
     {
-        errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in track settings for track " + trackTitleLabel_.getText() + String(NewLine::getDefault()));
+        trackData.steps[sI].noteNumber = steps_[sI]->getNoteNumber();
+        trackData.steps[sI].velocity = steps_[sI]->getVelocity();
+        trackData.steps[sI].gatePercent = steps_[sI]->getGatePercent();
+        trackData.steps[sI].probability = steps_[sI]->getProbability();
+        trackData.steps[sI].ratchets = steps_[sI]->getRatchets();
+        trackData.steps[sI].condition = steps_[sI]->getCondition();
+        trackData.steps[sI].numChordNotes = steps_[sI]->getNumChordNotes();
+        trackData.steps[sI].chordNotes = steps_[sI]->getChordNotes();
     }
+}
+
+bool GriddleTrack::isActive(const bool toDrawValue) const
+{
+    bool active = activeToggle_.getToggleState();
+
+    if (toDrawValue)
+        active = activeStateToDraw_;
+
+    return active;
+}
 
-    propertyId = "is_chopped";
-    if (projectTrackData.hasProperty(propertyId))
+bool GriddleTrack::isFlipped(const bool toDrawValue) const
+{
+    bool flipped = flipToggle_.getToggleState();
+    if (toDrawValue)
+        flipped = flippedStateToDraw_;
+    return flipped;
+}
+
+bool GriddleTrack::isChopped(const bool toDrawValue) const
+{
+    bool chopped = chopToggle_.getToggleState();
+    if (toDrawValue)
+        chopped = choppedStateToDraw_;
+    return chopped;
+}
+
+bool GriddleTrack::isBurnt(const bool toDrawValue) const
+{
+    bool burnt = burnToggle_.getToggleState();
+    if (toDrawValue)
+        burnt = burntStateToDraw_;
+    return burnt;
+}
+
+void GriddleTrack::setClockRate(const int numerator, const int denominator, const bool notifyTrackChanged)
+{
+    // Anything other than one of the clock rates fits the track's steps into one measure
+    if (GriddleTimeline::isValidClockRate(numerator, denominator))
     {
-        auto isChopped = projectTrackData.getProperty(propertyId, defaultReturn);
-        chopToggle_.setToggleState(isChopped, dontSendNotification);
-        updateChoppedState(false);
+        clockRateNumerator_ = numerator;
+        clockRateDenominator_ = denominator;
     }
     else
     {
-        errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in track settings for track " + trackTitleLabel_.getText() + String(NewLine::getDefault()));
+        clockRateNumerator_ = 0;
+        clockRateDenominator_ = 1;
     }
 
-    propertyId = "is_burnt";
-    if (projectTrackData.hasProperty(propertyId))
-    {
-        auto isBurnt = projectTrackData.getProperty(propertyId, defaultReturn);
-        burnToggle_.setToggleState(isBurnt, dontSendNotification);
-        updateBurntState(false);
-    }
-    else
+    // The clock rate to draw should change immediately if the sequence isn't playing,
+    // or if it is, but the active state of the current sequence pass for this track is inactive
+    if (! isPlaying_ || (isActive(true) == false))
     {
-        errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in track settings for track " + trackTitleLabel_.getText() + String(NewLine::getDefault()));
+        clockRateNumeratorToDraw_ = clockRateNumerator_;
+        clockRateDenominatorToDraw_ = clockRateDenominator_;
     }
 
-    propertyId = "steps";
-    if (projectTrackData.hasProperty(propertyId))
-    {
-        auto stepsArray = projectTrackData.getProperty(propertyId, defaultReturn);
+    repaint();
 
-        int numStepsToRead = stepsArray.size();
-        if (numStepsToRead > steps_.size())
-        {
-            numStepsToRead = static_cast<int>(steps_.size());
-            errorString += ("INVALID STEPS LIST - track " + trackTitleLabel_.getText() + " has more than " + String(steps_.size()) + " step entries" + String(NewLine::getDefault()));
-        }
-        else if (numStepsToRead < steps_.size())
-        {
-            errorString += ("INVALID STEPS LIST - track " + trackTitleLabel_.getText() + " has fewer than " + String(steps_.size()) + " step entries" + String(NewLine::getDefault()));
-        }
+    if (notifyTrackChanged)
+        callTrackCharacteristicsChangedCallbacks();
+}
 
-        for (auto sI = 0; sI < numStepsToRead; ++sI)
-        {
-            propertyId = "note_number";
-            if (stepsArray[sI].hasProperty(propertyId))
-            {
-                auto noteNumber = stepsArray[sI].getProperty(propertyId, defaultReturn);
-                steps_[sI]->setNoteNumber(noteNumber);
-            }
-            else
-            {
-                errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found for step " + String(sI + 1) + " in track settings for track " + trackTitleLabel_.getText() + String(NewLine::getDefault()));
-            }
-
-            propertyId = "velocity";
-            if (stepsArray[sI].hasProperty(propertyId))
-            {
-                auto velocity = stepsArray[sI].getProperty(propertyId, defaultReturn);
-                steps_[sI]->setVelocity(velocity);
-            }
-            else
-            {
-                errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found for step " + String(sI + 1) + " in track settings for track " + trackTitleLabel_.getText() + String(NewLine::getDefault()));
-            }
-
-            propertyId = "gate_percent";
-            if (stepsArray[sI].hasProperty(propertyId))
-            {
-                auto gatePercent = stepsArray[sI].getProperty(propertyId, defaultReturn);
-                steps_[sI]->setGatePercent(gatePercent);
-            }
-            else
-            {
-                errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found for step " + String(sI + 1) + " in track settings for track " + trackTitleLabel_.getText() + String(NewLine::getDefault()));
-            }
-        }
-    }
-    else
-    {
-        errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in track settings for track " + trackTitleLabel_.getText() + String(NewLine::getDefault()));
-    }
+int64 GriddleTrack::getPatternTicks(const bool toDrawValue) const
+{
+    if (toDrawValue)
+        return GriddleTimeline::getNoteTicks(numStepsToDraw_, burntStateToDraw_, clockRateNumeratorToDraw_, clockRateDenominatorToDraw_) * numStepsToDraw_;
 
-    return errorString;
+    return GriddleTimeline::getNoteTicks(getNumSteps(), isBurnt(), clockRateNumerator_, clockRateDenominator_) * getNumSteps();
 }
 
-const var& GriddleTrack::getProjectTrackData()
+String GriddleTrack::getClockRateText(const int numerator, const int denominator)
 {
-    // Creating Identifier objects can be slow, so just initialize one to reuse for each property
-    Identifier propertyId;
-
-    // Set the properties to write to the project file as JSON
-    // ********************************************************
-    propertyId = "name";
-    projectTrackDataVar_.getDynamicObject()->setProperty(propertyId, trackTitleLabel_.getText());
+    if (denominator == 1)
+        return String(numerator) + "x";
 
-    propertyId = "is_active";
-    projectTrackDataVar_.getDynamicObject()->setProperty(propertyId, activeToggle_.getToggleState());
+    return String(numerator) + "/" + String(denominator) + "x";
+}
 
-    propertyId = "midi_ch";
-    projectTrackDataVar_.getDynamicObject()->setProperty(propertyId, midiChannelComboBox_.getSelectedId());
+void GriddleTrack::setLatencyOffset(const double offset, const bool inSamples, const bool notifyTrackChanged)
+{
+    latencyOffsetInSamples_ = inSamples;
 
-    propertyId = "num_steps";
-    projectTrackDataVar_.getDynamicObject()->setProperty(propertyId, numStepsComboBox_.getSelectedId());
+    // Sample offsets can only be limited once the sample rate is known, in getLatencyOffsetSamples()
+    if (latencyOffsetInSamples_)
+        latencyOffset_ = std::round(offset);
+    else
+        latencyOffset_ = jlimit(-MAX_LATENCY_OFFSET_MS, MAX_LATENCY_OFFSET_MS, offset);
 
-    propertyId = "is_flipped";
-    projectTrackDataVar_.getDynamicObject()->setProperty(propertyId, flipToggle_.getToggleState());
+    repaint();
 
-    propertyId = "is_chopped";
-    projectTrackDataVar_.getDynamicObject()->setProperty(propertyId, chopToggle_.getToggleState());
+    if (notifyTrackChanged)
+        callTrackCharacteristicsChangedCallbacks();
+}
 
-    propertyId = "is_burnt";
-    projectTrackDataVar_.getDynamicObject()->setProperty(propertyId, burnToggle_.getToggleState());
+int GriddleTrack::getLatencyOffsetSamples(const double sampleRate) const
+{
+    return GriddleTrackData::convertLatencyOffsetToSamples(latencyOffset_, latencyOffsetInSamples_, sampleRate);
+}
 
-    Array<var> stepsArray;
+void GriddleTrack::setSwingPercent(const int swingPercent, const bool notifyTrackChanged)
+{
+    swingPercent_ = jlimit(GriddleTrackData::MIN_SWING_PERCENT, GriddleTrackData::MAX_SWING_PERCENT, swingPercent);
 
-    for (auto stepI = 0; stepI < steps_.size(); ++stepI)
-    {
-        var tempStepVar(new DynamicObject());
+    repaint();
 
-        propertyId = "note_number";
-        tempStepVar.getDynamicObject()->setProperty(propertyId, steps_[stepI]->getNoteNumber());
+    if (notifyTrackChanged)
+        callTrackGrooveChangedCallbacks();
+}
 
-        propertyId = "velocity";
-        tempStepVar.getDynamicObject()->setProperty(propertyId, steps_[stepI]->getVelocity());
+void GriddleTrack::setGrooveIndex(const int grooveIndex, const bool notifyTrackChanged)
+{
+    grooveIndex_ = ((grooveIndex >= 0) && (grooveIndex < GriddleProjectData::NUM_GROOVES)) ? grooveIndex : -1;
 
-        propertyId = "gate_percent";
-        tempStepVar.getDynamicObject()->setProperty(propertyId, steps_[stepI]->getGatePercent());
+    repaint();
 
-        stepsArray.add(tempStepVar);
-    }
+    if (notifyTrackChanged)
+        callTrackGrooveChangedCallbacks();
+}
 
-    propertyId = "steps";
-    projectTrackDataVar_.getDynamicObject()->setProperty(propertyId, stepsArray);
+void GriddleTrack::setGrooveNames(const StringArray& grooveNames)
+{
+    grooveNames_ = grooveNames;
 
-    return projectTrackDataVar_;
+    repaint();
 }
 
-bool GriddleTrack::isActive(const bool toDrawValue) const
+String GriddleTrack::getLatencyOffsetText() const
 {
-    bool active = activeToggle_.getToggleState();
+    String offsetText = (latencyOffset_ > 0.0) ? "+" : "";
 
-    if (toDrawValue)
-        active = activeStateToDraw_;
+    if (latencyOffsetInSamples_)
+        offsetText += String(roundToInt(latencyOffset_)) + " smp";
+    else
+        offsetText += String(latencyOffset_, 1) + " ms";
 
-    return active;
+    return offsetText;
 }
 
-bool GriddleTrack::isFlipped(const bool toDrawValue) const
+void GriddleTrack::mouseDown(const MouseEvent& event)
 {
-    bool flipped = flipToggle_.getToggleState();
-    if (toDrawValue)
-        flipped = flippedStateToDraw_;
-    return flipped;
+    if (event.mods.isPopupMenu())
+        showTrackOptionsMenu();
 }
 
-bool GriddleTrack::isChopped(const bool toDrawValue) const
+void GriddleTrack::showTrackOptionsMenu()
 {
-    bool chopped = chopToggle_.getToggleState();
-    if (toDrawValue)
-        chopped = choppedStateToDraw_;
-    return chopped;
-}
+    PopupMenu menu;
+    menu.addSectionHeader("LATENCY OFFSET: " + getLatencyOffsetText());
+    menu.addItem(1, "Set Latency Offset...");
+    menu.addItem(2, "Reset Latency Offset", (latencyOffset_ != 0.0));
+    menu.addSeparator();
+    menu.addItem(3, "Calibrate Latency via MIDI Loopback...", (onLatencyCalibrationRequested != nullptr));
 
-bool GriddleTrack::isBurnt(const bool toDrawValue) const
-{
-    bool burnt = burnToggle_.getToggleState();
-    if (toDrawValue)
-        burnt = burntStateToDraw_;
-    return burnt;
+    // The swing amounts are offered in even steps from straight to the maximum, with a tick next to the current one
+    PopupMenu swingMenu;
+    const int swingPercents[] = { 50, 54, 58, 62, 67, 71, 75 };
+
+    for (auto swingPercent : swingPercents)
+    {
+        String itemText = String(swingPercent) + "%";
+
+        if (swingPercent == GriddleTrackData::MIN_SWING_PERCENT)
+            itemText << " (Straight)";
+        else if (swingPercent == 67)
+            itemText << " (Triplet)";
+
+        swingMenu.addItem(100 + swingPercent, itemText, true, (swingPercent_ == swingPercent));
+    }
+
+    // The clock rates run from slowest to fastest, with the triplet rates marked
+    PopupMenu clockRateMenu;
+    clockRateMenu.addItem(300, "Fit to Measure", true, (clockRateNumerator_ == 0));
+    clockRateMenu.addSeparator();
+
+    for (auto rateI = 0; rateI < GriddleTimeline::NUM_CLOCK_RATES; ++rateI)
+    {
+        auto clockRate = GriddleTimeline::getClockRate(rateI);
+        String itemText = getClockRateText(clockRate.numerator, clockRate.denominator);
+
+        if (clockRate.numerator == 3)
+            itemText << " (Triplet)";
+
+        clockRateMenu.addItem(301 + rateI, itemText, true,
+                              (clockRateNumerator_ == clockRate.numerator) && (clockRateDenominator_ == clockRate.denominator));
+    }
+
+    PopupMenu grooveMenu;
+    grooveMenu.addItem(200, "None", true, (grooveIndex_ < 0));
+    grooveMenu.addSeparator();
+
+    for (auto grooveI = 0; grooveI < GriddleProjectData::NUM_GROOVES; ++grooveI)
+    {
+        auto grooveName = (grooveI < grooveNames_.size()) ? grooveNames_[grooveI] : "Groove " + String(grooveI + 1);
+        grooveMenu.addItem(201 + grooveI, grooveName, true, (grooveIndex_ == grooveI));
+    }
+
+    menu.addSeparator();
+    menu.addSubMenu("Clock Rate (" + ((clockRateNumerator_ == 0) ? String("Fit") : getClockRateText(clockRateNumerator_, clockRateDenominator_)) + ")", clockRateMenu);
+    menu.addSubMenu("Swing (" + String(swingPercent_) + "%)", swingMenu);
+    menu.addSubMenu("Groove Template", grooveMenu);
+
+    const int menuResult = menu.show();
+
+    if (menuResult == 1)
+    {
+        promptForLatencyOffset();
+    }
+    else if (menuResult == 2)
+    {
+        setLatencyOffset(0.0, latencyOffsetInSamples_);
+    }
+    else if (menuResult == 3)
+    {
+        onLatencyCalibrationRequested();
+    }
+    else if ((menuResult >= 100 + GriddleTrackData::MIN_SWING_PERCENT) && (menuResult <= 100 + GriddleTrackData::MAX_SWING_PERCENT))
+    {
+        setSwingPercent(menuResult - 100);
+    }
+    else if ((menuResult >= 200) && (menuResult <= 200 + GriddleProjectData::NUM_GROOVES))
+    {
+        setGrooveIndex(menuResult - 201);
+    }
+    else if (menuResult == 300)
+    {
+        setClockRate(0, 1);
+    }
+    else if ((menuResult > 300) && (menuResult <= 300 + GriddleTimeline::NUM_CLOCK_RATES))
+    {
+        auto clockRate = GriddleTimeline::getClockRate(menuResult - 301);
+        setClockRate(clockRate.numerator, clockRate.denominator);
+    }
 }
 
-int GriddleTrack::getTempoMultiplier() const
+void GriddleTrack::promptForLatencyOffset()
 {
-    return (isBurnt() ? 2 : 1);
+    AlertWindow offsetWindow("Track " + trackTitleLabel_.getText() + " Latency Offset",
+                             "Enter the offset in milliseconds (e.g. -4.5 ms) or in samples (e.g. -200 smp)." + String(NewLine::getDefault()) + String(NewLine::getDefault()) +
+                             "A negative offset sends the track's notes early to make up for a synth that is slow to respond.",
+                             AlertWindow::NoIcon, this);
+    offsetWindow.addTextEditor("offset", getLatencyOffsetText());
+    offsetWindow.addButton("OK", 1, KeyPress(KeyPress::returnKey));
+    offsetWindow.addButton("Cancel", 0, KeyPress(KeyPress::escapeKey));
+
+    if (offsetWindow.runModalLoop() == 1)
+    {
+        auto offsetText = offsetWindow.getTextEditorContents("offset").trim();
+
+        // Anything other than sample units after the number is taken as milliseconds
+        auto unitsText = offsetText.trimCharactersAtStart("+-0123456789. ");
+        auto inSamples = (unitsText.startsWithIgnoreCase("smp") || unitsText.startsWithIgnoreCase("sample"));
+
+        setLatencyOffset(offsetText.getDoubleValue(), inSamples);
+    }
 }
 
 void GriddleTrack::addStepsListener(GriddleStep::Listener* listener)
@@ -524,6 +615,8 @@ void GriddleTrack::applyPendingChanges(const bool isPlaying)
     flippedStateToDraw_ = flipToggle_.getToggleState();
     choppedStateToDraw_ = chopToggle_.getToggleState();
     burntStateToDraw_ = burnToggle_.getToggleState();
+    clockRateNumeratorToDraw_ = clockRateNumerator_;
+    clockRateDenominatorToDraw_ = clockRateDenominator_;
 
     // Only make this track's steps selectable if the sequence isn't playing
     // or the track isn't currently active
@@ -544,8 +637,21 @@ void GriddleTrack::callTrackCharacteristicsChangedCallbacks()
         onTrackCharacteristicsChanged();
 }
 
+void GriddleTrack::callTrackGrooveChangedCallbacks()
+{
+    Component::BailOutChecker checker(this);
+
+    if (checker.shouldBailOut())
+        return;
+
+    if (onTrackGrooveChanged != nullptr)
+        onTrackGrooveChanged();
+}
+
 void GriddleTrack::paint(Graphics& g)
 {
+    GRIDDLE_TRACE_SCOPE("GriddleTrack::paint");
+
     // Set the background color of the track based on the active state to draw
     auto bgColor = Colour::fromRGB(25, 25, 25);
     if (!activeStateToDraw_)
@@ -567,6 +673,28 @@ void GriddleTrack::paint(Graphics& g)
         g.fillAll(bgColor);
     }
 
+    // Show the latency offset, clock rate, swing and groove template under the track title when the track has them
+    StringArray trackTimingText;
+
+    if (latencyOffset_ != 0.0)
+        trackTimingText.add("OFFSET " + getLatencyOffsetText());
+
+    if (clockRateNumeratorToDraw_ != 0)
+        trackTimingText.add("CLOCK " + getClockRateText(clockRateNumeratorToDraw_, clockRateDenominatorToDraw_));
+
+    if (swingPercent_ != GriddleTrackData::MIN_SWING_PERCENT)
+        trackTimingText.add("SWING " + String(swingPercent_) + "%");
+
+    if (grooveIndex_ >= 0)
+        trackTimingText.add("GROOVE " + String(grooveIndex_ + 1));
+
+    if (! trackTimingText.isEmpty())
+    {
+        g.setColour(Colours::lightslategrey);
+        g.setFont(Font(12.0f, Font::italic));
+        g.drawText(trackTimingText.joinIntoString("  "), 10, 78, 220, 14, Justification::centredLeft);
+    }
+
     // Set the images for the various toggles based on their toggle states
     // *******************************************************************
     if (activeToggle_.getToggleState())
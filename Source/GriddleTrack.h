@@ -37,6 +37,7 @@ along with Griddle. If not, see < https://www.gnu.org/licenses/>.
 
 #include <array>
 #include "GriddleStep.h"
+#include "GriddleProjectData.h"
 
 //==============================================================================
 /*
@@ -55,6 +56,15 @@ public:
     //==============================================================================
     void paint(Graphics&) override;
     void resized() override;
+
+    /** Shows the options menu for the track (latency offset, clock rate, swing and groove template) when it is right-clicked
+
+        This is an override of the Component method.
+    */
+    void mouseDown(const MouseEvent& event) override;
+
+    /** The largest latency offset, positive or negative, that can be applied to a track in milliseconds */
+    static constexpr double MAX_LATENCY_OFFSET_MS = GriddleTrackData::MAX_LATENCY_OFFSET_MS;
     
     /** Passes through registration of a Listener for each of the GriddleSteps in the track
 
@@ -144,12 +154,112 @@ public:
     */
     bool isBurnt(const bool toDrawValue = false) const;
 
-    /** Gets the tempo multiplier for the track (currently based only on the burnt state)
+    /** Sets the clock rate for the track, which plays its steps at a fixed rate instead of fitting them into one measure
+
+        A clocked track's pattern runs freely across measure boundaries when its length doesn't divide the measure.
+        The rate is doubled if the track is burnt.
+
+        @param numerator             The numerator of one of the rates from GriddleTimeline::getClockRate(),
+                                     or 0 to fit the track's steps into one measure
+        @param denominator           The denominator of the clock rate
+        @param notifyTrackChanged    Pass true to have the method notify listeners of
+                                     changes to the track or pass false to prohibit
+                                     notification
+
+    */
+    void setClockRate(const int numerator, const int denominator, const bool notifyTrackChanged = true);
+
+    /** Gets the length of the track's pattern on the timeline, from its number of steps, burnt state and clock rate
+
+        @param toDrawValue    Pass true to get back the length of the pattern being drawn for the track,
+                              or pass false to get back the length of the current absolute pattern
+        @returns              The length of the pattern in ticks (see GriddleTimeline)
+
+    */
+    int64 getPatternTicks(const bool toDrawValue = false) const;
+
+    /** Sets the latency offset for the track, which shifts all of its events in time during playback
+
+        A negative offset sends the track's events early to make up for a synth that is slow to respond.
+        Millisecond offsets are limited to MAX_LATENCY_OFFSET_MS either way, and sample offsets are limited
+        to the equivalent when they're converted by getLatencyOffsetSamples().
+
+        @param offset                The offset in milliseconds or samples
+        @param inSamples             Pass true if the offset is in samples or false if it is in milliseconds
+        @param notifyTrackChanged    Pass true to have the method notify listeners of
+                                     changes to the track or pass false to prohibit
+                                     notification
+
+    */
+    void setLatencyOffset(const double offset, const bool inSamples, const bool notifyTrackChanged = true);
+
+    /** Gets the latency offset for the track in the units it was set in
+
+        @returns    The latency offset in milliseconds, or in samples if isLatencyOffsetInSamples() is true
+
+    */
+    double getLatencyOffset() const;
+
+    /** Gets the boolean indicator for whether the latency offset of the track was set in samples or milliseconds
+
+        @returns    true if the latency offset is in samples, or false if it is in milliseconds
+
+    */
+    bool isLatencyOffsetInSamples() const;
+
+    /** Gets the latency offset for the track in samples at the passed-in sample rate
+
+        @param sampleRate    The sample rate of the buffer the track's events are compiled into
+        @returns             The latency offset in samples, limited to MAX_LATENCY_OFFSET_MS either way
+
+    */
+    int getLatencyOffsetSamples(const double sampleRate) const;
+
+    /** Sets the swing for the track, which delays every second note of the track
+
+        Swing is applied as the notes are scheduled, so it takes effect immediately during playback.
+
+        @param swingPercent          The position of the second note of each pair as a percentage of the pair's length,
+                                     from 50 (straight) to 75, where 67 is close to triplets
+        @param notifyTrackChanged    Pass true to have the method notify listeners of
+                                     changes to the track's groove or pass false to prohibit
+                                     notification
+
+    */
+    void setSwingPercent(const int swingPercent, const bool notifyTrackChanged = true);
+
+    /** Gets the swing for the track
 
-        @returns    2 if the track is currently burnt, otherwise 1
+        @returns    The swing as a percentage, where 50 is straight
 
     */
-    int getTempoMultiplier() const;
+    int getSwingPercent() const;
+
+    /** Sets the groove template the track is played with
+
+        Like swing, the groove template is applied as the notes are scheduled, so it takes effect immediately during playback.
+
+        @param grooveIndex           The index of one of the project's groove templates, or -1 for none
+        @param notifyTrackChanged    Pass true to have the method notify listeners of
+                                     changes to the track's groove or pass false to prohibit
+                                     notification
+
+    */
+    void setGrooveIndex(const int grooveIndex, const bool notifyTrackChanged = true);
+
+    /** Gets the groove template the track is played with
+
+        @returns    The index of one of the project's groove templates, or -1 for none
+
+    */
+    int getGrooveIndex() const;
+
+    /** Sets the names of the project's groove templates, which are shown in the track's options menu
+
+        @param grooveNames    The display name of each groove template
+
+    */
+    void setGrooveNames(const StringArray& grooveNames);
     
     /** Applies any pending track characteristic changes, updating the draw state variables and other elements
 
@@ -158,25 +268,29 @@ public:
     */
     void applyPendingChanges(const bool isPlaying);
 
-    /** Loads all of the track characteristics into the track from JSON data
+    /** Loads all of the track characteristics into the track from plain track data (e.g. from a project file)
 
-        @params projectTrackData    The var containing the JSON track settings from a project file
-
-        @returns                    A string containing any error conditions encountered when unpacking the settings
+        @param trackData    The track settings to load
 
     */
-    const String loadProjectTrackData(const var& projectTrackData);
+    void loadTrackData(const GriddleTrackData& trackData);
 
-    /** Gets the track data in a var that can be written in JSON format to a project file
+    /** Gets the track characteristics as plain track data (e.g. for a project file)
 
-        @returns A var containing the track settings that can be writte in JSON format to a project file
+        @param trackData    The track data to populate with the track settings
 
     */
-    const var& getProjectTrackData();
+    void getTrackData(GriddleTrackData& trackData) const;
 
     /** A lambda can be assigned to this callback object to have it called when the characteristics of the track change */
     std::function<void()> onTrackCharacteristicsChanged;
 
+    /** A lambda can be assigned to this callback object to have it called when the user asks to calibrate the track's latency offset */
+    std::function<void()> onLatencyCalibrationRequested;
+
+    /** A lambda can be assigned to this callback object to have it called when the swing or groove template of the track changes */
+    std::function<void()> onTrackGrooveChanged;
+
 private:
     
     //==============================================================================
@@ -184,7 +298,13 @@ private:
     std::array<std::shared_ptr<GriddleStep>, 16> steps_;
     bool isPlaying_;
     int trackIndex_;
-    var projectTrackDataVar_;
+    double latencyOffset_;
+    bool latencyOffsetInSamples_;
+    int swingPercent_;
+    int grooveIndex_;
+    StringArray grooveNames_;
+    int clockRateNumerator_;
+    int clockRateDenominator_;
     //==============================================================================
 
     //==============================================================================
@@ -199,6 +319,8 @@ private:
     bool flippedStateToDraw_;
     bool choppedStateToDraw_;
     bool burntStateToDraw_;
+    int clockRateNumeratorToDraw_;
+    int clockRateDenominatorToDraw_;
     //==============================================================================
 
     //==============================================================================
@@ -271,6 +393,31 @@ private:
     /** Calls lambda functions registered for onTrackCharacteristicsChanged  */
     void callTrackCharacteristicsChangedCallbacks();
 
+    /** Calls lambda functions registered for onTrackGrooveChanged */
+    void callTrackGrooveChangedCallbacks();
+
+    /** Pops up the options menu for the track (set, reset or calibrate the latency offset, and choose the clock rate, swing and groove template) */
+    void showTrackOptionsMenu();
+
+    /** Brings up an AlertWindow for the user to enter the latency offset in milliseconds or samples */
+    void promptForLatencyOffset();
+
+    /** Gets the latency offset formatted for display, with its sign and units (e.g. "-4.5 ms" or "+200 smp")
+
+        @returns    The formatted latency offset
+
+    */
+    String getLatencyOffsetText() const;
+
+    /** Gets a clock rate formatted for display (e.g. "1/4x" or "3/2x")
+
+        @param numerator      The numerator of the clock rate
+        @param denominator    The denominator of the clock rate
+        @returns              The formatted clock rate
+
+    */
+    static String getClockRateText(const int numerator, const int denominator);
+
     //==============================================================================
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GriddleTrack)
@@ -291,6 +438,26 @@ inline int GriddleTrack::getMidiChannel() const
     return (midiChannelComboBox_.getSelectedItemIndex() + 1);
 }
 
+inline double GriddleTrack::getLatencyOffset() const
+{
+    return latencyOffset_;
+}
+
+inline bool GriddleTrack::isLatencyOffsetInSamples() const
+{
+    return latencyOffsetInSamples_;
+}
+
+inline int GriddleTrack::getSwingPercent() const
+{
+    return swingPercent_;
+}
+
+inline int GriddleTrack::getGrooveIndex() const
+{
+    return grooveIndex_;
+}
+
 inline const GriddleStep& GriddleTrack::getStep(int index) const
 {
     return (*steps_[index]);
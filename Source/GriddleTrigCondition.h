@@ -0,0 +1,194 @@
+/*
+==============================================================================
+
+Copyright 2020 Kevin Frank
+
+This file is part of Griddle.
+
+Griddle is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Griddle is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Griddle. If not, see < https://www.gnu.org/licenses/>.
+
+==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+    GriddleTrigCondition.h
+    Created: 19 Oct 2026 10:12:40am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    A step's trig condition decides whether the step plays each time it comes around,
+    along with its probability (see GriddleStepData).
+
+    Conditions are stored as a single index: NONE, then the fill, previous and first
+    conditions and their inverses, then the iteration conditions A:B (1:2 to 8:8), which
+    play the step on the Ath of every B plays of the track's pattern.
+
+    - FILL plays while fill is turned on, and NOT_FILL while it's off.
+    - PREVIOUS plays if the track's last step with a condition or a probability played,
+      and NOT_PREVIOUS if it didn't (these two don't count as the last step themselves).
+    - FIRST only plays the first time the pattern plays after playback starts, and
+      NOT_FIRST every time after that.
+*/
+struct GriddleTrigCondition
+{
+    static constexpr int NONE = 0;
+    static constexpr int FILL = 1;
+    static constexpr int NOT_FILL = 2;
+    static constexpr int PREVIOUS = 3;
+    static constexpr int NOT_PREVIOUS = 4;
+    static constexpr int FIRST = 5;
+    static constexpr int NOT_FIRST = 6;
+
+    /** The index of the first iteration condition (1:2), which the others follow in order of length */
+    static constexpr int FIRST_ITERATION = 7;
+
+    /** The longest number of plays of the pattern an iteration condition can count */
+    static constexpr int MAX_ITERATION_LENGTH = 8;
+
+    /** The number of trig conditions, including NONE */
+    static constexpr int NUM_CONDITIONS = FIRST_ITERATION + ((MAX_ITERATION_LENGTH * (MAX_ITERATION_LENGTH + 1)) / 2) - 1;
+
+    /** Gets the index of an iteration condition
+
+        @param iteration    The play of the pattern the step plays on (A), from 1 to length
+        @param length       The number of plays of the pattern the condition counts (B), from 2 to MAX_ITERATION_LENGTH
+        @returns            The index of the condition
+    */
+    static constexpr int getIterationCondition(const int iteration, const int length)
+    {
+        return FIRST_ITERATION + (((length - 1) * length) / 2) - 1 + (iteration - 1);
+    }
+
+    /** Checks whether a condition is one of the iteration conditions */
+    static constexpr bool isIterationCondition(const int condition)
+    {
+        return (condition >= FIRST_ITERATION) && (condition < NUM_CONDITIONS);
+    }
+
+    /** Gets the number of plays of the pattern an iteration condition counts (B in A:B), or 0 for any other condition */
+    static constexpr int getIterationLength(const int condition)
+    {
+        if (! isIterationCondition(condition))
+            return 0;
+
+        auto length = 2;
+
+        while (condition >= getIterationCondition(1, length + 1))
+            ++length;
+
+        return length;
+    }
+
+    /** Gets the play of the pattern an iteration condition plays on (A in A:B), or 0 for any other condition */
+    static constexpr int getIteration(const int condition)
+    {
+        return isIterationCondition(condition) ? (condition - getIterationCondition(1, getIterationLength(condition)) + 1) : 0;
+    }
+
+    /** Checks whether a condition lets its step play
+
+        @param condition         The trig condition
+        @param iteration         The number of times the track's pattern has played before, from the start of playback
+        @param isFillActive      true if fill is turned on
+        @param previousPlayed    true if the track's last step with a condition or a probability played
+        @returns                 true if the condition is met
+    */
+    static bool isMet(const int condition, const int64 iteration, const bool isFillActive, const bool previousPlayed)
+    {
+        switch (condition)
+        {
+        case FILL:
+            return isFillActive;
+        case NOT_FILL:
+            return ! isFillActive;
+        case PREVIOUS:
+            return previousPlayed;
+        case NOT_PREVIOUS:
+            return ! previousPlayed;
+        case FIRST:
+            return iteration == 0;
+        case NOT_FIRST:
+            return iteration != 0;
+        default:
+            break;
+        }
+
+        if (isIterationCondition(condition))
+            return (iteration % getIterationLength(condition)) == (getIteration(condition) - 1);
+
+        return true;
+    }
+
+    /** Gets the name of a condition as it's shown on the steps and written to project files (e.g. "FILL" or "1:4")
+
+        @param condition    The trig condition
+        @returns            The name of the condition, or "NONE" for no condition
+    */
+    static String getName(const int condition)
+    {
+        switch (condition)
+        {
+        case FILL:
+            return "FILL";
+        case NOT_FILL:
+            return "!FILL";
+        case PREVIOUS:
+            return "PRE";
+        case NOT_PREVIOUS:
+            return "!PRE";
+        case FIRST:
+            return "1ST";
+        case NOT_FIRST:
+            return "!1ST";
+        default:
+            break;
+        }
+
+        if (isIterationCondition(condition))
+            return String(getIteration(condition)) + ":" + String(getIterationLength(condition));
+
+        return "NONE";
+    }
+
+    /** Gets a condition from its name, ignoring case
+
+        @param name    The name of the condition, as returned by getName()
+        @returns       The trig condition, or NONE if the name isn't one of the conditions
+    */
+    static int fromName(const String& name)
+    {
+        auto trimmedName = name.trim();
+
+        for (auto condition = 0; condition < NUM_CONDITIONS; ++condition)
+        {
+            if (trimmedName.equalsIgnoreCase(getName(condition)))
+                return condition;
+        }
+
+        return NONE;
+    }
+};
+
+static_assert(GriddleTrigCondition::getIterationCondition(GriddleTrigCondition::MAX_ITERATION_LENGTH, GriddleTrigCondition::MAX_ITERATION_LENGTH)
+              == GriddleTrigCondition::NUM_CONDITIONS - 1, "The iteration conditions must fill the condition indexes up to NUM_CONDITIONS");
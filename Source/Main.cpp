@@ -99,10 +99,8 @@ public:
 
         void closeButtonPressed() override
         {
-            if (dynamic_cast<MainComponent*>(getContentComponent())->handleWindowCloseRequest())
-            {
-                JUCEApplication::getInstance()->systemRequestedQuit();
-            }
+            // The MainComponent asks the application to quit once any unsaved changes have been dealt with
+            dynamic_cast<MainComponent*>(getContentComponent())->handleWindowCloseRequest();
         }
 
         /* Note: Be careful if you override any DocumentWindow methods - the base
@@ -23,20 +23,21 @@ along with Griddle. If not, see < https://www.gnu.org/licenses/>.
 
 #include "MainComponent.h"
 
+constexpr int MainComponent::NUM_GROOVE_PRESETS;
+
 //==============================================================================
 MainComponent::MainComponent()
     : tracks_{ {std::shared_ptr<GriddleTrack>(new GriddleTrack(0)), 
                 std::shared_ptr<GriddleTrack>(new GriddleTrack(1)), 
                 std::shared_ptr<GriddleTrack>(new GriddleTrack(2)), 
                 std::shared_ptr<GriddleTrack>(new GriddleTrack(3))} }
-    , previousSampleNumber_(0)
+    , sourceGeneration_(0)
     , bufferSampleRate_(44100.0)
-    , playbackSampleNumber_(0)
-    , seqStartTime_(0.0)
-    , nextStartTime_(0.0)
+    , scheduler_(outputEncoder_)
     , tempoBPM_(120.0)
-    , thisPassBPM_(tempoBPM_)
+    , randomSeed_(0)
     , isPlaying_(false)
+    , bandwidthAwareScheduling_(false)
     , keyboardComponent_(keyboardState_, MidiKeyboardComponent::horizontalKeyboard)
     , restButton_("REST")
     , playButton_("PLAY")
@@ -46,12 +47,22 @@ MainComponent::MainComponent()
     , stepSelectPreviousTrackButton_("PREVIOUS TRACK")
     , stepSelectNextTrackButton_("NEXT TRACK")
     , autoAdvanceSelectionToggle_("AUTO ADVANCE SELECTION")
+    , telemetryOverlay_(scheduler_.getTelemetry())
     , playLineX_Offset_(0.0f)
     , selectedStepPtr_(nullptr)
+    , chordCaptureStepPtr_(nullptr)
+    , chordCaptureVelocity_(1.0f)
     , startOfMeasurePassed_(false)
     , unsavedProjectChanges_(false)
+    , backgroundLoadPool_(1)
+    , loadRequestId_(0)
+    , patternSwitchPending_(false)
+    , patternSwitchGeneration_(0)
+    , sessionJournal_(GriddleSessionJournal::getDefaultSessionDirectory())
+    , draggedSlider_(nullptr)
     , REST_NOTE_VALUE(-1)
     , STEPS_DISPLAY_PIXEL_WIDTH(715)
+    , VIRTUAL_MIDI_OUTPUT_NAME("Griddle (Virtual ALSA Port)")
     , GriddleLightGray(Colour::fromRGB(175, 175, 175))
     , GriddleDarkGray(Colour::fromRGB(50, 50, 50))
     , GriddleSuperDarkGray(Colour::fromRGB(25, 25, 25))
@@ -122,6 +133,8 @@ MainComponent::MainComponent()
     projectMenu_.addSeparator();
     projectMenu_.addItem(3, "Save As");
     projectMenu_.addItem(4, "Save");
+    projectMenu_.addSeparator();
+    projectMenu_.addItem(8, "Open Pattern Library");
 
     // Tempo Slider
     addAndMakeVisible(tempoSlider_);
@@ -129,7 +142,7 @@ MainComponent::MainComponent()
     tempoSlider_.setSize(160, 160);
     tempoSlider_.setSliderStyle(Slider::SliderStyle::Rotary);
     tempoSlider_.setTextBoxStyle(Slider::TextBoxBelow, false, tempoSlider_.getTextBoxWidth(), tempoSlider_.getTextBoxHeight());
-    tempoSlider_.setRange(10.0, 180.0, 0.5);
+    tempoSlider_.setRange(GriddleProjectData::MIN_TEMPO, GriddleProjectData::MAX_TEMPO, 0.5);
     tempoSlider_.setTextValueSuffix(" BPM");
     tempoSlider_.addListener(this);
     tempoSlider_.setValue(tempoBPM_, dontSendNotification);
@@ -160,6 +173,14 @@ MainComponent::MainComponent()
     stopButton_.onClick = [this] { handleStopButtonClick(); };
     stopButton_.setEnabled(false);
 
+    // Fill Button (turns the steps with fill trig conditions on or off from the next measure)
+    addAndMakeVisible(fillButton_);
+    fillButton_.setTopLeftPosition(450, 140);
+    fillButton_.setSize(70, 30);
+    fillButton_.setButtonText("FILL");
+    fillButton_.setClickingTogglesState(true);
+    fillButton_.onClick = [this] { scheduler_.setFillActive(fillButton_.getToggleState()); };
+
     // MIDI Output ComboBox and Label
     addAndMakeVisible(midiOutputList_);
     midiOutputList_.setTopLeftPosition(910, 85);
@@ -171,17 +192,16 @@ MainComponent::MainComponent()
     {
         midiOutIdentifiers.add(midiOutputs[i].name);
     }
+   #if JUCE_LINUX
+    // On Linux, Griddle can also create its own port in the ALSA sequencer for soft-synths to subscribe to
+    midiOutIdentifiers.add(VIRTUAL_MIDI_OUTPUT_NAME);
+   #endif
     midiOutputList_.addItemList(midiOutIdentifiers, 1);
     midiOutputList_.onChange = [this] { setMidiOutput(midiOutputList_.getItemText(midiOutputList_.getSelectedItemIndex())); };
     midiOutputList_.setSelectedId(1, dontSendNotification);
-    midiOutputs = MidiOutput::getAvailableDevices();
-    for (auto i = 0; i < midiOutputs.size(); ++i)
-    {
-        if (midiOutputs[i].name == midiOutputList_.getItemText(midiOutputList_.getSelectedItemIndex()))
-        {
-            midiOutPtr_ = MidiOutput::openDevice(midiOutputs[i].identifier);
-        }
-    }
+    outputEncoder_.setOutputPort(openMidiOutputPort(midiOutputList_.getItemText(midiOutputList_.getSelectedItemIndex())));
+    if (midiOutputList_.getText() == VIRTUAL_MIDI_OUTPUT_NAME)
+        outputEncoder_.setWireRate(0.0);
 
     addAndMakeVisible(midiOutputListLabel_); 
     midiOutputListLabel_.setText("MIDI OUTPUT", dontSendNotification);
@@ -189,6 +209,29 @@ MainComponent::MainComponent()
     midiOutputListLabel_.setFont(Font(16.0f, Font::italic | Font::bold));
     midiOutputListLabel_.attachToComponent(&midiOutputList_, true);
 
+    // MIDI Wire Statistics Label
+    addAndMakeVisible(midiWireStatsLabel_);
+    midiWireStatsLabel_.setTopLeftPosition(910, 114);
+    midiWireStatsLabel_.setSize(250, 15);
+    midiWireStatsLabel_.setJustificationType(Justification::centredRight);
+    midiWireStatsLabel_.setFont(Font(12.0f, Font::italic));
+    midiWireStatsLabel_.setAlpha(0.6f);
+    midiWireStatsLabel_.setText("", dontSendNotification);
+
+    // Pattern ComboBox and Label
+    addAndMakeVisible(patternList_);
+    patternList_.setTopLeftPosition(910, 165);
+    patternList_.setSize(250, 25);
+    patternList_.setTextWhenNoChoicesAvailable("No Pattern Library Open");
+    patternList_.setTextWhenNothingSelected("(select a pattern)");
+    patternList_.onChange = [this] { selectPattern(patternList_.getSelectedItemIndex()); };
+
+    addAndMakeVisible(patternListLabel_);
+    patternListLabel_.setText("PATTERN", dontSendNotification);
+    patternListLabel_.setJustificationType(Justification::centred);
+    patternListLabel_.setFont(Font(16.0f, Font::italic | Font::bold));
+    patternListLabel_.attachToComponent(&patternList_, true);
+
     // GriddleTracks
     for (auto i = 0; i < tracks_.size(); ++i)
     {
@@ -198,6 +241,8 @@ MainComponent::MainComponent()
         tracks_[i]->setTopLeftPosition(0, 200 + (i * tracks_[i]->getHeight()) + (i * bottomMargin));
         tracks_[i]->addStepsListener(this);
         tracks_[i]->onTrackCharacteristicsChanged = [this] { handleTrackCharacteristicsChanged(); };
+        tracks_[i]->onTrackGrooveChanged = [this] { handleTrackGrooveChanged(); };
+        tracks_[i]->onLatencyCalibrationRequested = [this, i] { calibrateTrackLatency(i); };
 
         switch (i)
         {
@@ -349,6 +394,13 @@ MainComponent::MainComponent()
     stepEditNoteTitleLabel_.setFont(Font(16.0f, Font::italic | Font::bold));
     stepEditNoteTitleLabel_.attachToComponent(&stepEditNoteLabel_, true);
 
+    // Step Edit Trig Button
+    addAndMakeVisible(stepEditTrigButton_);
+    stepEditTrigButton_.setTopLeftPosition(10, 745);
+    stepEditTrigButton_.setSize(110, 30);
+    stepEditTrigButton_.onClick = [this] { handleStepEditTrigButtonClick(); };
+    updateStepEditTrigButtonText();
+
     // Set FPS for animating the play lines to 30FPS
     setFramesPerSecond(30);
 
@@ -362,19 +414,41 @@ MainComponent::MainComponent()
         playLines_[plI].setAlwaysOnTop(true);
     }
 
-    // All tacks are populated with default data now, so clone the default track data into a var for
+    // Playback Telemetry Overlay (hidden until it's turned on from the project menu)
+    addChildComponent(telemetryOverlay_);
+    telemetryOverlay_.setBounds(830, 205, 360, 520);
+    telemetryOverlay_.setAlwaysOnTop(true);
+
+    // All tacks are populated with default data now, so keep a copy of the default track data for
     // when the user chooses to initialize a new project from the project menu
-    trackDefaultData_ = tracks_[0]->getProjectTrackData().clone();
+    tracks_[0]->getTrackData(trackDefaultData_);
 
     // Listen for computer keyboard events
     addKeyListener(this);
 
     // Start a new project
     startNewProject();
+
+    // Start journalling the session, offering to restore a previous session first if it crashed with unsaved changes
+    Component::SafePointer<MainComponent> safeThis(this);
+    sessionJournal_.onSessionRecovered = [safeThis](const GriddleProjectData& projectData, const File& projectFile)
+    {
+        MessageManager::callAsync([safeThis, projectData, projectFile]
+        {
+            if (safeThis != nullptr)
+                safeThis->restoreRecoveredSession(projectData, projectFile);
+        });
+    };
+    sessionJournal_.start();
 }
 
 MainComponent::~MainComponent()
 {
+    // Wait for any pattern or project that's still loading, since pattern jobs use the pattern library
+    backgroundLoadPool_.removeAllJobs(true, 5000);
+
+    // This is a clean shutdown, so the session doesn't need recovering
+    sessionJournal_.stop();
 }
 
 void MainComponent::showAboutDialog()
@@ -410,20 +484,35 @@ void MainComponent::startNewProject()
     // Load each track with default track data
     for (auto trackI = 0; trackI < tracks_.size(); ++trackI)
     {
-        auto errors = tracks_[trackI]->loadProjectTrackData(trackDefaultData_);
+        tracks_[trackI]->loadTrackData(trackDefaultData_);
     }
 
+    // New projects have no tempo automation or groove templates
+    tempoAutomation_ = GriddleTempoAutomationData();
+    updateTempoMap();
+
+    grooves_.fill(GriddleGrooveData());
+    updateTrackGrooveNames();
+    updateGroove();
+
+    randomSeed_ = 0;
+    scheduler_.setRandomSeed(randomSeed_);
+
     // Reset the selected step, force-clearing the current step selection
     resetSelectedStep(true);
 
     // Set the project button text to indicate a new/unsaved project
     projectButton_.setButtonText("(new - click here for options)");
 
-    // Clear the current project file
+    // Clear the current project file and the pattern selection
     currentProjectFile_ = File();
+    updatePatternList();
 
     // Reset the source buffer
-    updateSourceMidiBuffer();
+    updateSourceMeasure();
+
+    // Start the undo history again from the new project
+    resetProjectHistory();
 
     // Clear the unsaved changes flag
     setUnsavedChangesFlag(false);
@@ -431,53 +520,18 @@ void MainComponent::startNewProject()
 
 void MainComponent::hiResTimerCallback()
 {
-    // Determine the current sample number in the MidiBuffer from the time
-    auto clockTime = Time::getMillisecondCounterHiRes() * 0.001;
-    auto currentTime = clockTime - seqStartTime_;
-    auto currentSampleNumber = static_cast<int>(currentTime * bufferSampleRate_);
-
-    // Send all MIDI messages that are at or before the current sample number
-    MidiBuffer::Iterator iterator(playbackBuffer_);
-
-    while (iterator.getNextEvent(bufferOutputMessage_, playbackSampleNumber_))
-    {
-        if (playbackSampleNumber_ >= currentSampleNumber)
-            break;
+    GRIDDLE_TRACE_SCOPE("MainComponent::hiResTimerCallback");
 
-        midiOutPtr_->sendMessageNow(bufferOutputMessage_);
-    }
-
-    // Clear MIDI events from the playbackBuffer_ that were sent
-    playbackBuffer_.clear(previousSampleNumber_, currentSampleNumber - previousSampleNumber_);
+    // Send the MIDI events that have come due, queueing up the next measure once it's within the scheduler's look-ahead
+    auto clockTime = Time::getMillisecondCounterHiRes() * 0.001;
 
-    // Store off the sample number for the next pass
-    previousSampleNumber_ = currentSampleNumber;
+    auto& telemetry = scheduler_.getTelemetry();
+    if (telemetry.isEnabled())
+        telemetry.recordTimerCallback(clockTime, HighResolutionTimer::getTimerInterval() * 0.001);
 
-    // Handle the end of the measure when it is reached
-    if (clockTime >= nextStartTime_)
+    // Handle the start of the measure when it is reached
+    if (scheduler_.process(clockTime))
     {
-        // If there are still some messages that didn't get sent for this measure, send them now.
-        // This should just be any NOTE OFFs that didn't get caught because of imprecise timing.
-        if (!playbackBuffer_.isEmpty())
-        {
-            while (iterator.getNextEvent(bufferOutputMessage_, playbackSampleNumber_))
-            {
-                midiOutPtr_->sendMessageNow(bufferOutputMessage_);
-            }
-        }
-
-        // Populate the playbackBuffer_ with the MIDI events from the sourceBuffer_
-        playbackBuffer_.clear();
-        playbackBuffer_ = sourceBuffer_;
-
-        // Update the sample number and time variables
-        previousSampleNumber_ = 0;
-        seqStartTime_ = clockTime;
-        nextStartTime_ = seqStartTime_ + (1 / (tempoBPM_ / 60.0) * 4);  
-
-        // Update the BPM to use for this measure
-        thisPassBPM_ = tempoBPM_;
-
         // Set the startOfMeasurePassed_ flag so that GUI elements can update accordingly in the update method
         startOfMeasurePassed_ = true;
 
@@ -492,23 +546,37 @@ void MainComponent::handleNoteOn(MidiKeyboardState*, int midiChannel, int midiNo
     // Ensure NOTE ON events from the MIDI keyboard are only processed if there is a selected step
     if (selectedStepPtr_ != nullptr)
     {
-        // Update the note number, display of the note for the step, and the source buffer
-        selectedStepPtr_->setNoteNumber(midiNoteNumber);
-        stepEditNoteLabel_.setText(MidiMessage::getMidiNoteName(midiNoteNumber, true, true, 4), dontSendNotification);
-        updateSourceMidiBuffer();
+        auto noteVelocity = static_cast<int>(stepEditVelocitySlider_.getValue());
 
-        // Send a NOTE ON message to preview the note, only if the sequence is not currently being played
-        if (! isPlaying_)
+        if (chordCaptureStepPtr_ != selectedStepPtr_)
         {
-            auto message = MidiMessage::noteOn(tracks_[selectedStepPtr_->getOwnerTrackIndex()]->getMidiChannel(), midiNoteNumber, static_cast<uint8>(stepEditVelocitySlider_.getValue()));
+            // The first key held down sets the step's note, replacing any chord the step had
+            chordCaptureStepPtr_ = selectedStepPtr_;
+            chordCaptureVelocity_ = jmax(velocity, 0.01f);
 
-            midiOutPtr_->sendMessageNow(message);
+            selectedStepPtr_->setNoteNumber(midiNoteNumber);
+            selectedStepPtr_->clearChordNotes();
         }
+        else
+        {
+            // Each key held down along with it adds a note to the step's chord, at the step's velocity scaled
+            // by how hard the key was played compared to the first key
+            noteVelocity = jlimit(1, 127, roundToInt(noteVelocity * (velocity / chordCaptureVelocity_)));
 
-        // Advance the step selection if auto-advance is set
-        if (autoAdvanceSelectionToggle_.getToggleState())
+            if (! selectedStepPtr_->addChordNote(midiNoteNumber, noteVelocity))
+                return;
+        }
+
+        // Update the display of the note for the step and the source buffer
+        updateStepEditNoteLabel();
+        updateSourceMeasure();
+
+        // Send a NOTE ON message to preview the note, only if the sequence is not currently being played
+        if (! isPlaying_)
         {
-            stepSelectionGoToNext();
+            auto message = MidiMessage::noteOn(tracks_[selectedStepPtr_->getOwnerTrackIndex()]->getMidiChannel(), midiNoteNumber, static_cast<uint8>(noteVelocity));
+
+            outputEncoder_.sendMessageNow(message);
         }
 
         setUnsavedChangesFlag(true);
@@ -524,7 +592,26 @@ void MainComponent::handleNoteOff(MidiKeyboardState*, int midiChannel, int midiN
         if (! isPlaying_)
         {
             auto message = MidiMessage::noteOff(tracks_[selectedStepPtr_->getOwnerTrackIndex()]->getMidiChannel(), midiNoteNumber, static_cast<uint8>(stepEditVelocitySlider_.getValue()));
-            midiOutPtr_->sendMessageNow(message);
+            outputEncoder_.sendMessageNow(message);
+        }
+    }
+
+    // The chord is complete once every key has been let go
+    for (auto noteNumber = 0; noteNumber < 128; ++noteNumber)
+    {
+        if (keyboardState_.isNoteOnForChannels(0xffff, noteNumber))
+            return;
+    }
+
+    if (chordCaptureStepPtr_ != nullptr)
+    {
+        chordCaptureStepPtr_ = nullptr;
+        projectHistory_.endCoalescing();
+
+        // Advance the step selection if auto-advance is set
+        if ((selectedStepPtr_ != nullptr) && autoAdvanceSelectionToggle_.getToggleState())
+        {
+            stepSelectionGoToNext();
         }
     }
 }
@@ -536,8 +623,9 @@ void MainComponent::handleRestButtonClick()
     {
         // Set the step to a rest and update the source buffer
         selectedStepPtr_->setNoteNumber(REST_NOTE_VALUE);    
-        stepEditNoteLabel_.setText("", dontSendNotification);
-        updateSourceMidiBuffer();
+        selectedStepPtr_->clearChordNotes();
+        updateStepEditNoteLabel();
+        updateSourceMeasure();
 
         // Advance the step selection if auto-advance is set
         if (autoAdvanceSelectionToggle_.getToggleState())
@@ -549,31 +637,176 @@ void MainComponent::handleRestButtonClick()
     }
 }
 
+void MainComponent::handleStepEditTrigButtonClick()
+{
+    if (selectedStepPtr_ == nullptr)
+        return;
+
+    // Add the probabilities, ratchets and trig conditions with ticks next to the selected step's settings
+    PopupMenu probabilityMenu;
+
+    for (auto probability : { 100, 90, 75, 66, 50, 33, 25, 10 })
+        probabilityMenu.addItem(100 + probability, String(probability) + "%", true, selectedStepPtr_->getProbability() == probability);
+
+    PopupMenu ratchetsMenu;
+
+    for (auto ratchets = 1; ratchets <= GriddleStepData::MAX_RATCHETS; ++ratchets)
+        ratchetsMenu.addItem(300 + ratchets, (ratchets == 1) ? String("None") : "x" + String(ratchets), true, selectedStepPtr_->getRatchets() == ratchets);
+
+    // The iteration conditions are grouped by the number of plays of the pattern they count
+    PopupMenu conditionMenu;
+    auto selectedCondition = selectedStepPtr_->getCondition();
+
+    conditionMenu.addItem(400 + GriddleTrigCondition::NONE, "None", true, selectedCondition == GriddleTrigCondition::NONE);
+    conditionMenu.addSeparator();
+
+    for (auto condition = GriddleTrigCondition::NONE + 1; condition < GriddleTrigCondition::FIRST_ITERATION; ++condition)
+        conditionMenu.addItem(400 + condition, GriddleTrigCondition::getName(condition), true, selectedCondition == condition);
+
+    conditionMenu.addSeparator();
+
+    for (auto length = 2; length <= GriddleTrigCondition::MAX_ITERATION_LENGTH; ++length)
+    {
+        PopupMenu iterationMenu;
+
+        for (auto iteration = 1; iteration <= length; ++iteration)
+        {
+            auto condition = GriddleTrigCondition::getIterationCondition(iteration, length);
+            iterationMenu.addItem(400 + condition, GriddleTrigCondition::getName(condition), true, selectedCondition == condition);
+        }
+
+        conditionMenu.addSubMenu("Every " + String(length) + " Plays", iterationMenu);
+    }
+
+    PopupMenu menu;
+    menu.addSubMenu("Probability (" + String(selectedStepPtr_->getProbability()) + "%)", probabilityMenu);
+    menu.addSubMenu("Ratchets (x" + String(selectedStepPtr_->getRatchets()) + ")", ratchetsMenu);
+    menu.addSubMenu("Condition (" + GriddleTrigCondition::getName(selectedCondition) + ")", conditionMenu);
+
+    const int menuResult = menu.showAt(&stepEditTrigButton_);
+
+    if ((menuResult > 100) && (menuResult <= 200))
+        selectedStepPtr_->setProbability(menuResult - 100);
+    else if ((menuResult > 300) && (menuResult <= 300 + GriddleStepData::MAX_RATCHETS))
+        selectedStepPtr_->setRatchets(menuResult - 300);
+    else if ((menuResult >= 400) && (menuResult < 400 + GriddleTrigCondition::NUM_CONDITIONS))
+        selectedStepPtr_->setCondition(menuResult - 400);
+    else
+        return;
+
+    // Update the source buffer since a step changed
+    updateStepEditTrigButtonText();
+    updateSourceMeasure();
+
+    setUnsavedChangesFlag(true);
+}
+
+void MainComponent::updateStepEditTrigButtonText()
+{
+    String trigText("TRIG");
+
+    if (selectedStepPtr_ != nullptr)
+    {
+        if (selectedStepPtr_->getProbability() < 100)
+            trigText << " " << selectedStepPtr_->getProbability() << "%";
+
+        if (selectedStepPtr_->getRatchets() > 1)
+            trigText << " x" << selectedStepPtr_->getRatchets();
+
+        if (selectedStepPtr_->getCondition() != GriddleTrigCondition::NONE)
+            trigText << " " << GriddleTrigCondition::getName(selectedStepPtr_->getCondition());
+    }
+
+    stepEditTrigButton_.setButtonText(trigText);
+}
+
+void MainComponent::updateStepEditNoteLabel()
+{
+    if (selectedStepPtr_ == nullptr)
+    {
+        stepEditNoteLabel_.setText("", dontSendNotification);
+        return;
+    }
+
+    // A chord's note names are shown in a smaller font so they all fit in the display
+    auto fontHeight = (selectedStepPtr_->getNumChordNotes() > 0) ? 32.0f : 70.0f;
+
+    stepEditNoteLabel_.setFont(Font(fontHeight, Font::italic | Font::bold));
+    stepEditNoteLabel_.setText(selectedStepPtr_->getNoteNames(), dontSendNotification);
+}
+
 void MainComponent::handleProjectButtonClick()
 {
+    // Add the MIDI output options to the Project menu with ticks showing their current settings
+    PopupMenu outputOptionsMenu;
+    outputOptionsMenu.addItem(5, "DIN MIDI Port (31.25 kbaud)", true, outputEncoder_.getWireRate() > 0.0);
+    outputOptionsMenu.addItem(6, "USB/Virtual MIDI Port (Unthrottled)", true, outputEncoder_.getWireRate() <= 0.0);
+    outputOptionsMenu.addSeparator();
+    outputOptionsMenu.addItem(7, "Bandwidth-Aware Scheduling", outputEncoder_.getWireRate() > 0.0, bandwidthAwareScheduling_);
+
+    PopupMenu menu(projectMenu_);
+    menu.addSeparator();
+    menu.addItem(9, "Undo", projectHistory_.canUndo());
+    menu.addItem(10, "Redo", projectHistory_.canRedo());
+    menu.addSeparator();
+    menu.addSubMenu("MIDI Output Options", outputOptionsMenu);
+
+    // Add the tempo automation presets with a tick next to the one in use, if any
+    PopupMenu tempoAutomationMenu;
+    tempoAutomationMenu.addItem(14, "None", true, tempoAutomation_.numPoints == 0);
+    tempoAutomationMenu.addSeparator();
+    tempoAutomationMenu.addItem(15, "Accelerando (4 Measures)", true, tempoAutomation_ == getTempoAutomationPreset(1));
+    tempoAutomationMenu.addItem(16, "Ritardando (4 Measures)", true, tempoAutomation_ == getTempoAutomationPreset(2));
+    tempoAutomationMenu.addItem(17, "Half Time from Beat 3", true, tempoAutomation_ == getTempoAutomationPreset(3));
+    tempoAutomationMenu.addItem(18, "Push and Pull (2 Measures)", true, tempoAutomation_ == getTempoAutomationPreset(4));
+    menu.addSubMenu("Tempo Automation", tempoAutomationMenu);
+
+    // Add a submenu for each groove template to edit it or replace it with one of the presets
+    PopupMenu grooveTemplatesMenu;
+
+    for (auto grooveI = 0; grooveI < GriddleProjectData::NUM_GROOVES; ++grooveI)
+    {
+        PopupMenu grooveMenu;
+        grooveMenu.addItem(20 + grooveI, "Edit...");
+        grooveMenu.addSeparator();
+
+        for (auto presetI = 0; presetI < NUM_GROOVE_PRESETS; ++presetI)
+        {
+            auto preset = getGroovePreset(presetI);
+            grooveMenu.addItem(30 + (grooveI * 10) + presetI, (presetI == 0) ? String("Clear") : "Load Preset: " + preset.name, true, grooves_[grooveI] == preset);
+        }
+
+        grooveTemplatesMenu.addSubMenu(getGrooveDisplayName(grooveI), grooveMenu);
+    }
+
+    menu.addSubMenu("Groove Templates", grooveTemplatesMenu);
+    menu.addItem(19, "Random Seed (" + String(randomSeed_) + ")...");
+
+    PopupMenu telemetryMenu;
+    telemetryMenu.addItem(11, "Show Telemetry Overlay", true, telemetryOverlay_.isVisible());
+    telemetryMenu.addItem(12, "Export Telemetry as CSV");
+   #if GRIDDLE_ENABLE_TRACING
+    telemetryMenu.addSeparator();
+    telemetryMenu.addItem(13, "Save Trace File");
+   #endif
+    menu.addSubMenu("Playback Telemetry", telemetryMenu);
+
     // Show the Project menu when the project button is clicked
-    const int menuResult = projectMenu_.showAt(&projectButton_);
+    const int menuResult = menu.showAt(&projectButton_);
 
     if (menuResult == 1)
     {
         // ** NEW **
 
         // Ensure the user has a chance to save any unsaved changes before starting a new project
-        if (promptForProjectSave() == CancellationEnum::NOT_CANCELLED)
-        {
-            startNewProject();
-        }
+        promptForProjectSave([this] { startNewProject(); });
     }
     else if (menuResult == 2)
     {
         // ** LOAD **
 
         // Ensure the user has a chance to save any unsaved changes before loading another project
-        if (promptForProjectSave() == CancellationEnum::NOT_CANCELLED)
-        {
-            loadProject();
-        }
-
+        promptForProjectSave([this] { loadProject(); });
     }
     else if (menuResult == 3)
     {
@@ -594,327 +827,594 @@ void MainComponent::handleProjectButtonClick()
             saveProject(currentProjectFile_);
         }
     }
+    else if (menuResult == 5)
+    {
+        // ** DIN MIDI PORT **
+        setMidiOutputWireRate(GriddleOutputEncoder::DIN_BYTES_PER_SECOND);
+    }
+    else if (menuResult == 6)
+    {
+        // ** USB/VIRTUAL MIDI PORT **
+        setMidiOutputWireRate(0.0);
+    }
+    else if (menuResult == 7)
+    {
+        // ** BANDWIDTH-AWARE SCHEDULING **
+        bandwidthAwareScheduling_ = ! bandwidthAwareScheduling_;
+        scheduler_.setBandwidthAwareScheduling(bandwidthAwareScheduling_);
+        updateSourceMeasure();
+        setUnsavedChangesFlag(true);
+    }
+    else if (menuResult == 8)
+    {
+        // ** OPEN PATTERN LIBRARY **
+        openPatternLibrary();
+    }
+    else if (menuResult == 9)
+    {
+        // ** UNDO **
+        undoProjectChange();
+    }
+    else if (menuResult == 10)
+    {
+        // ** REDO **
+        redoProjectChange();
+    }
+    else if (menuResult == 11)
+    {
+        // ** SHOW TELEMETRY OVERLAY **
+        telemetryOverlay_.setVisible(! telemetryOverlay_.isVisible());
+    }
+    else if (menuResult == 12)
+    {
+        // ** EXPORT TELEMETRY AS CSV **
+        exportPlaybackTelemetry();
+    }
+    else if ((menuResult >= 14) && (menuResult <= 18))
+    {
+        // ** TEMPO AUTOMATION **
+        setTempoAutomation(getTempoAutomationPreset(menuResult - 14));
+    }
+    else if (menuResult == 19)
+    {
+        // ** RANDOM SEED **
+        promptForRandomSeed();
+    }
+    else if ((menuResult >= 20) && (menuResult < 20 + GriddleProjectData::NUM_GROOVES))
+    {
+        // ** EDIT GROOVE TEMPLATE **
+        promptForGrooveTemplate(menuResult - 20);
+    }
+    else if ((menuResult >= 30) && (menuResult < 30 + (GriddleProjectData::NUM_GROOVES * 10)) && (((menuResult - 30) % 10) < NUM_GROOVE_PRESETS))
+    {
+        // ** LOAD GROOVE TEMPLATE PRESET **
+        setGrooveTemplate((menuResult - 30) / 10, getGroovePreset((menuResult - 30) % 10));
+    }
+   #if GRIDDLE_ENABLE_TRACING
+    else if (menuResult == 13)
+    {
+        // ** SAVE TRACE FILE **
+        saveTraceFile();
+    }
+   #endif
 }
 
-void MainComponent::loadProject()
+void MainComponent::openPatternLibrary()
 {
-    // Show a FileChooserDialogBox to open .griddle files
-    WildcardFileFilter wildcardFilter("*.griddle", String(), "Griddle Project files");
-       
-    // Set the initial directory for the FileBrowserComponent to the parent directory of current project file by default
-    File initialDir(currentProjectFile_.getParentDirectory());
+    // Start in the current library, or the directory of the current project file if there isn't one open
+    File initialDir(patternLibrary_.getDirectory());
 
-    // If there isn't a current project file, set the initial directory for the FileBrowser component to the Projects directory
     if (initialDir.getFullPathName().isEmpty())
-    {
-        initialDir = File::getSpecialLocation(File::currentApplicationFile).getParentDirectory().getFullPathName() + String("/Projects/");
-
-        // If for some reason the Projects directory doesn't exist, fall back to the location of the Griddle executable
-        if (!initialDir.exists())
-            initialDir = File::getSpecialLocation(File::currentApplicationFile).getParentDirectory().getFullPathName();
-    }
+        initialDir = currentProjectFile_.getParentDirectory();
 
-    FileBrowserComponent browser(FileBrowserComponent::canSelectFiles | FileBrowserComponent::openMode,
-        initialDir,
-        &wildcardFilter,
-        nullptr);
+    if (initialDir.getFullPathName().isEmpty())
+        initialDir = File::getSpecialLocation(File::currentApplicationFile).getParentDirectory();
 
-    FileChooserDialogBox dialogBox("Open Griddle Project File",
-        "Please choose a Griddle Project file that you want to open...",
-        browser,
-        false,
-        GriddleSuperDarkGray);
+    // Choose a directory of binary Griddle Project files (.griddlebin) asynchronously
+    projectFileChooser_.reset(new FileChooser("Open Pattern Library", initialDir));
 
-    if (dialogBox.show())
+    projectFileChooser_->launchAsync(FileBrowserComponent::openMode | FileBrowserComponent::canSelectDirectories, [this](const FileChooser& chooser)
     {
-        // Parse the file as JSON
-        File selectedFile = browser.getSelectedFile(0);
-        var projectData = JSON::parse(selectedFile);
-
-        // If the file was parsed successfully, set the project data from the file
-        if (projectData.isVoid() == false)
-        {
-            
-            loadedProject_ = projectData;
-
-            // Creating Identifier objects can be slow, so just initialize one to reuse for each property
-            Identifier propertyId;
-
-            // Initialize a default return var to be reused for each getProperty call
-            var defaultReturn;
-
-
-            String invalidMidiOutput("");
-
-            // Initialize an error string to populate if any properties are missing or invalid
-            String errorString("");
-            
-            // ******************************************************************************************
-            // Load each setting from the properties in the file
-            // ******************************************************************************************
-            // NOTE: When the various components are set, the notification setting is always
-            // dontSendNotification, so that the notifier callbacks don't get asynchronously called after 
-            // the processing is over resulting in a the unsaved changes flag incorrectly getting set.
-            // Since notifications aren't sent, any processing that needs to happen when the values are
-            // set is called expliclitly.
-            // *******************************************************************************************
-            propertyId = "master_settings";            
-            if (loadedProject_.hasProperty(propertyId))
-            {
-                var masterSettings = loadedProject_.getProperty(propertyId, defaultReturn);
-
-                propertyId = "tempo";                
-                if (masterSettings.hasProperty(propertyId))
-                {
-                    var tempo = masterSettings.getProperty(propertyId, defaultReturn);
-                    tempoSlider_.setValue(tempo, dontSendNotification);
-                    rotateTempoDialImage();
-                    tempoBPM_ = tempoSlider_.getValue();
-                }
-                else
-                {
-                    errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in master_settings" + String(NewLine::getDefault()));
-                }
-
-                propertyId = "midi_output";
-                if (masterSettings.hasProperty(propertyId))
-                {
-                    var midiOutput = masterSettings.getProperty(propertyId, defaultReturn);
-                    invalidMidiOutput = midiOutput.toString();
-                    for (auto moI = 0; moI < midiOutputList_.getNumItems(); ++moI)
-                    {
-                        if (midiOutputList_.getItemText(moI) == midiOutput.toString())
-                        {
-                            midiOutputList_.setSelectedId(midiOutputList_.getItemId(moI), dontSendNotification);
-                            setMidiOutput(midiOutputList_.getItemText(midiOutputList_.getSelectedItemIndex()));
-                            invalidMidiOutput = "";
-                            break;
-                        }
-                    }
-                }
-                else
-                {
-                    errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in master_settings" + String(NewLine::getDefault()));
-                }
-            }
-            else
-            {
-                errorString += ("PROPERTY MISSING - " + propertyId.toString() + " not found in the project file" + String(NewLine::getDefault()));
-            }
+        auto selectedDirectory = chooser.getResult();
 
-            propertyId = "sequence";
-            if (loadedProject_.hasProperty(propertyId))
-            {
-                var sequenceData = loadedProject_.getProperty(propertyId, defaultReturn);
+        if (selectedDirectory == File())
+            return;
 
-                propertyId = "tracks";
-                if (sequenceData.hasProperty(propertyId))
-                {
-                    var tracksList = sequenceData.getProperty(propertyId, defaultReturn);
+        auto openResult = patternLibrary_.openDirectory(selectedDirectory);
 
-                    int numTracksToRead = tracksList.size();
-                    if (numTracksToRead > tracks_.size())
-                    {
-                        numTracksToRead = static_cast<int>(tracks_.size());
+        if (openResult.failed())
+            AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Pattern Library Not Opened", openResult.getErrorMessage());
 
-                        errorString += ("INVALID TRACKS LIST - sequence has more than " + String(tracks_.size()) + " track entries" + String(NewLine::getDefault()));
-                    }
-                    else if (numTracksToRead < tracks_.size())
-                    {
-                        errorString += ("INVALID TRACKS LIST - sequence has fewer than " + String(tracks_.size()) + " track entries" + String(NewLine::getDefault()));
-                    }
+        updatePatternList();
+    });
+}
 
-                    for (auto tracksI = 0; tracksI < numTracksToRead; ++tracksI)
-                    {
-                        errorString += tracks_[tracksI]->loadProjectTrackData(tracksList[tracksI]);
-                    }
-                }
-                else
-                {
-                    errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in sequence" + String(NewLine::getDefault()));
-                }
-            }
-            else
-            {
-                errorString += ("PROPERTY MISSING - " + propertyId.toString() + " property not found in the project file" + String(NewLine::getDefault()));
-            }
-                        
-            // After loading all of the project settings, update the currentProjectFile_ and the project button to display the loaded filename
-            currentProjectFile_ = selectedFile;
-            projectButton_.setButtonText(currentProjectFile_.getFileName());
-            
-            // Reset the step selection, force-clearing the current selection
-            resetSelectedStep(true);
-
-            // Reset the source buffer
-            updateSourceMidiBuffer();
-
-            // Clear the unsaved changes flag
-            setUnsavedChangesFlag(false);
-
-            // If there is any content in the error string, warn the user that the project file may not have fully loaded and list the errors
-            if (errorString.isNotEmpty())
-            {
-                AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Project File Errors", "The project file may be only partially loaded due to the following errors:" + String(NewLine::getDefault()) + String(NewLine::getDefault()) + errorString);
-            }
+void MainComponent::updatePatternList()
+{
+    patternList_.clear(dontSendNotification);
 
-            // If the MIDI output specified in the file isn't available, let the user know the MIDI output will remain whatever it was
-            if (invalidMidiOutput.isNotEmpty())
-            {
-                AlertWindow::showMessageBox(AlertWindow::InfoIcon, "MIDI Output Not Found", invalidMidiOutput + " was specified as the MIDI output in the project file, but was not found in the currently available MIDI outputs. The selected MIDI Output will remain unchanged.");
-            }
-        }
-        else
-        {
-            AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Invalid Project File!", selectedFile.getFileName() + " does not contain valid Griddle Project data!" + String(NewLine::getDefault()) + String(NewLine::getDefault()) + "The file will not be loaded.");
-        }
+    for (auto patternI = 0; patternI < patternLibrary_.getNumPatterns(); ++patternI)
+    {
+        const auto& entry = patternLibrary_.getIndexEntry(patternI);
+        patternList_.addItem(entry.name + "  (" + String(entry.tempo, 1) + " BPM, " + String(entry.numTracks) + " tracks)", patternI + 1);
 
+        if (entry.file == currentProjectFile_)
+            patternList_.setSelectedId(patternI + 1, dontSendNotification);
     }
 }
 
-void MainComponent::saveProjectAs()
+void MainComponent::selectPattern(const int patternIndex)
 {
-    // Show a FileChooserDialogBox for saving a .griddle file
-    WildcardFileFilter wildcardFilter("*.griddle", String(), "Griddle Project files");
-
-    // Set the initial file for the FileBrowserComponent to the current project file by default
-    File initialFile(currentProjectFile_);
-
-    // If there isn't a current project file, set the initial file for the FileBrowserComponent to the Projects directory
-    if (initialFile.getFullPathName().isEmpty())
-    {
-        initialFile = File::getSpecialLocation(File::currentApplicationFile).getParentDirectory().getFullPathName() + String("/Projects/");
+    if (patternIndex < 0)
+        return;
 
-        // If for some reason the Projects directory doesn't exist, fall back to the location of the Griddle executable
-        if (!initialFile.exists())
-            initialFile = File::getSpecialLocation(File::currentApplicationFile).getParentDirectory().getFullPathName();
-    }
+    // The list goes back to showing the current pattern until the selected one has been loaded
+    auto entry = patternLibrary_.getIndexEntry(patternIndex);
+    updatePatternList();
 
-    FileBrowserComponent browser(FileBrowserComponent::canSelectFiles | FileBrowserComponent::warnAboutOverwriting | FileBrowserComponent::saveMode,
-        initialFile,
-        &wildcardFilter,
-        nullptr);
+    // Ensure the user has a chance to save any unsaved changes before switching to another pattern
+    promptForProjectSave([this, entry] { loadPatternInBackground(entry); });
+}
 
-    FileChooserDialogBox dialogBox("Save Griddle Project File",
-        "Specify a Griddle Project file for saving...",
-        browser,
-        true,
-        GriddleSuperDarkGray);
+void MainComponent::loadPatternInBackground(const GriddlePatternLibrary::IndexEntry& entry)
+{
+    // Load and compile the pattern on the background load thread, so neither the GUI nor playback waits on the file or the compiler
+    auto requestId = ++loadRequestId_;
+    auto sampleRate = bufferSampleRate_;
+    auto wireRate = outputEncoder_.getWireRate();
+    Component::SafePointer<MainComponent> safeThis(this);
 
-    if (dialogBox.show())
+    backgroundLoadPool_.addJob([this, safeThis, requestId, entry, sampleRate, wireRate]
     {
-        File selectedFile = browser.getSelectedFile(0);
+        auto pattern = std::make_shared<GriddlePatternLibrary::CompiledPattern>();
+        auto compiled = patternLibrary_.getCompiledPattern(entry, sampleRate, wireRate, *pattern);
 
-        // Do the save processing on the selected file
-        saveProject(selectedFile);
-    }
+        MessageManager::callAsync([safeThis, requestId, entry, pattern, compiled]
+        {
+            if (safeThis != nullptr)
+                safeThis->applyPattern(requestId, entry, compiled ? pattern.get() : nullptr);
+        });
+    });
 }
 
-void MainComponent::saveProject(File projectFile)
+void MainComponent::applyPattern(const int requestId, const GriddlePatternLibrary::IndexEntry& entry, const GriddlePatternLibrary::CompiledPattern* pattern)
 {
-    // Add the .griddle extension if it was omitted
-    if (projectFile.getFileName().endsWith(".griddle") == false)
+    // Ignore the pattern if another project or pattern has been requested since
+    if (requestId != loadRequestId_)
+        return;
+
+    if (pattern == nullptr)
     {
-        projectFile = File(projectFile.getFullPathName() + ".griddle");
+        AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Invalid Pattern File!", entry.file.getFileName() + " could not be loaded from the pattern library.");
+        updatePatternList();
+        return;
     }
 
-    // Creating Identifier objects can be slow, so initialize one to reuse for each property 
-    Identifier propertyId;
+    // Patterns keep the current MIDI output, so only the pattern settings and tracks are loaded
+    loadPatternData(pattern->projectData);
+    getProjectData(compileProjectData_);
 
-    // Set the properties to write to the project file as JSON
-    // ********************************************************
-    var masterSettings(new DynamicObject());
-    propertyId = "tempo";
-    masterSettings.getDynamicObject()->setProperty(propertyId, tempoSlider_.getValue());
+    // If the pattern was compiled with the current settings, its measure goes straight to the scheduler,
+    // otherwise (the wire rate was changed while it was loading) it's recompiled from the loaded tracks
+    if ((pattern->sampleRate == bufferSampleRate_) && (pattern->wireRate == outputEncoder_.getWireRate()))
+        sourceMeasure_ = pattern->measure;
+    else
+        measureCompiler_.compile(compileProjectData_, bufferSampleRate_, outputEncoder_.getWireRate(), sourceMeasure_);
 
-    propertyId = "midi_output";
-    masterSettings.getDynamicObject()->setProperty(propertyId, midiOutputList_.getItemText(midiOutputList_.getSelectedItemIndex()));
+    // The pattern's tempo map and groove are handed over with its measure, so during playback the whole pattern
+    // switches at the next measure boundary the scheduler queues, and the old pattern plays out at its own tempo
+    // and groove until then. The tracks show the switch as a pending change until that measure starts.
+    sourceGeneration_ = scheduler_.swapSourceMeasure(sourceMeasure_, GriddleTempoMap(tempoBPM_, tempoAutomation_), GriddleGroove(compileProjectData_));
 
-    var sequence(new DynamicObject());
-    Array<var> tracksArray;
-    for (auto trackI = 0; trackI < tracks_.size(); ++trackI)
+    if (isPlaying_)
     {
-        tracksArray.add(tracks_[trackI]->getProjectTrackData());
+        patternSwitchPending_ = true;
+        patternSwitchGeneration_ = sourceGeneration_;
+        patternList_.setAlpha(0.6f);
     }
 
-    propertyId = "tracks";
-    sequence.getDynamicObject()->setProperty(propertyId, tracksArray);
-
-    var project(new DynamicObject());
-    propertyId = "master_settings";
-    project.getDynamicObject()->setProperty(propertyId, masterSettings);
-    propertyId = "sequence";
-    project.getDynamicObject()->setProperty(propertyId, sequence);
+    currentProjectFile_ = entry.file;
+    projectButton_.setButtonText(currentProjectFile_.getFileName());
+    updatePatternList();
 
-    // Add the JSON to the project file
-    projectFile.appendText(JSON::toString(project));
+    // Reset the step selection, force-clearing the current selection
+    resetSelectedStep(true);
 
-    // Update the project button text to show the project filename
-    currentProjectFile_ = projectFile;
-    projectButton_.setButtonText(currentProjectFile_.getFileName());
+    // Start the undo history again from the pattern
+    resetProjectHistory();
 
     // Clear the unsaved changes flag
     setUnsavedChangesFlag(false);
 }
 
-MainComponent::CancellationEnum MainComponent::promptForProjectSave()
+void MainComponent::setMidiOutputWireRate(const double bytesPerSecond)
 {
-    CancellationEnum cancelledValue = CancellationEnum::NOT_CANCELLED;
+    // Remember the rate for the current output so it's restored whenever the output is selected again
+    midiOutputWireRates_[midiOutputList_.getText()] = bytesPerSecond;
+    outputEncoder_.setWireRate(bytesPerSecond);
 
-    // If there are unsaved changes, prompt the user to decide whether or not to save the current project
-    if (unsavedProjectChanges_)
-    {
-        auto response = AlertWindow::showYesNoCancelBox(AlertWindow::QuestionIcon, "Unsaved Project", "The current project has unsaved changes." + String(NewLine::getDefault()) + String(NewLine::getDefault()) + "Would you like to save the current project before continuing?");
-    
-        if (response == 0)
-        {
-            // CANCEL
-            cancelledValue = CancellationEnum::CANCELLED;
-        }
-        else if (response == 1)
-        {
-            // YES
-            if (projectButton_.getButtonText().startsWith("(new"))
-            {
-                saveProjectAs();
-            }
-            else
-            {
-                saveProject(currentProjectFile_);
-            }
-        }
-        else if (response == 2)
-        {
-            // NO
-        }    
-    }
+    // How far ahead the spreading of event bursts sends events depends on the wire rate, so recompile the sequence for its look-ahead
+    updateSourceMeasure();
 
-    return cancelledValue;
+    setUnsavedChangesFlag(true);
 }
 
-bool MainComponent::handleWindowCloseRequest()
+void MainComponent::calibrateTrackLatency(const int trackIndex)
 {
-    // If the user initiates closing of the application, make sure they have the opportunity to save unsaved project changes or cancel
-    return (promptForProjectSave() == CancellationEnum::NOT_CANCELLED);
-}
+    // The calibration sends its probe notes through the output encoder, so it can't run alongside the sequence
+    if (isPlaying_)
+    {
+        AlertWindow::showMessageBox(AlertWindow::InfoIcon, "Latency Calibration", "Stop the sequence before calibrating the latency of a track.");
+        return;
+    }
 
-void MainComponent::handlePlayButtonClick()
-{
-    // The button shouldn't be clickable if the sequence is already playing but check just in case
-    if (! isPlaying_)
+    if (! outputEncoder_.hasOutputPort())
     {
-        // Prep the playback buffer of MIDI events
-        playbackBuffer_ = sourceBuffer_;
-        
-        // Set the time values needed to execute the sequence
-        seqStartTime_ = Time::getMillisecondCounterHiRes() * 0.001;
-        nextStartTime_ = seqStartTime_ + (1 / (tempoBPM_ / 60.0) * 4);
+        AlertWindow::showMessageBox(AlertWindow::InfoIcon, "Latency Calibration", "Select a MIDI output before calibrating the latency of a track.");
+        return;
+    }
 
-        // Reset the play line offset
-        playLineX_Offset_ = 0.0;
+    auto midiInputs = MidiInput::getAvailableDevices();
 
-        // Set the BPM for the current pass of the sequence
-        thisPassBPM_ = tempoBPM_;
+    if (midiInputs.isEmpty())
+    {
+        AlertWindow::showMessageBox(AlertWindow::InfoIcon, "Latency Calibration", "No MIDI inputs were found to receive the loopback from the MIDI output.");
+        return;
+    }
+
+    // Ask the user which MIDI input the MIDI output is looped back to
+    StringArray midiInputNames;
+    for (const auto& midiInput : midiInputs)
+    {
+        midiInputNames.add(midiInput.name);
+    }
+
+    auto trackName = String::charToString(static_cast<juce_wchar>('A' + trackIndex));
+    auto midiChannel = tracks_[trackIndex]->getMidiChannel();
+
+    AlertWindow inputWindow("Calibrate Latency via MIDI Loopback",
+                            "Loop " + midiOutputList_.getText() + " back to a MIDI input (e.g. through the MIDI THRU of the synth for track " + trackName + ") and select the input below." +
+                            String(NewLine::getDefault()) + String(NewLine::getDefault()) + "Probe notes will be sent on MIDI channel " + String(midiChannel) + ".",
+                            AlertWindow::QuestionIcon, this);
+    inputWindow.addComboBox("input", midiInputNames, "MIDI Input");
+    inputWindow.addButton("Calibrate", 1, KeyPress(KeyPress::returnKey));
+    inputWindow.addButton("Cancel", 0, KeyPress(KeyPress::escapeKey));
+
+    if (inputWindow.runModalLoop() != 1)
+        return;
+
+    auto midiInputIndex = inputWindow.getComboBoxComponent("input")->getSelectedItemIndex();
+
+    // Run the calibration behind a progress window (runThread returns false if the user cancels it)
+    GriddleLatencyCalibrator calibrator(outputEncoder_, midiInputs[midiInputIndex].identifier, midiChannel);
+
+    if (! calibrator.runThread())
+        return;
+
+    if (! calibrator.hasResult())
+    {
+        AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Latency Calibration Failed", "Only " + String(calibrator.getNumProbesReceived()) + " of " + String(GriddleLatencyCalibrator::NUM_PROBES) +
+                                    " probe notes came back on " + midiInputNames[midiInputIndex] + ". Check the loopback connection and try again.");
+        return;
+    }
+
+    // Only the outgoing half of the round trip delays the synth, so offset the track by half of it
+    auto latencyOffsetMs = -(calibrator.getRoundTripMs() * 0.5);
+
+    if (AlertWindow::showOkCancelBox(AlertWindow::QuestionIcon, "Latency Calibration Results",
+                                     "Round-trip latency: " + String(calibrator.getRoundTripMs(), 1) + " ms (median of " + String(calibrator.getNumProbesReceived()) + " probe notes)" +
+                                     String(NewLine::getDefault()) + String(NewLine::getDefault()) + "Apply a latency offset of " + String(latencyOffsetMs, 1) + " ms to track " + trackName + "?",
+                                     "Apply", "Cancel", this))
+    {
+        tracks_[trackIndex]->setLatencyOffset(latencyOffsetMs, false);
+    }
+}
+
+void MainComponent::loadProject()
+{
+    // Start in the parent directory of the current project file by default
+    File initialDir(currentProjectFile_.getParentDirectory());
+
+    // If there isn't a current project file, set the initial directory to the Projects directory
+    if (initialDir.getFullPathName().isEmpty())
+    {
+        initialDir = File::getSpecialLocation(File::currentApplicationFile).getParentDirectory().getFullPathName() + String("/Projects/");
+
+        // If for some reason the Projects directory doesn't exist, fall back to the location of the Griddle executable
+        if (!initialDir.exists())
+            initialDir = File::getSpecialLocation(File::currentApplicationFile).getParentDirectory().getFullPathName();
+    }
+
+    // Choose the file asynchronously, so the message thread (and the play line animation) keeps running
+    projectFileChooser_.reset(new FileChooser("Open Griddle Project File", initialDir, "*.griddle;*.griddlebin"));
+
+    projectFileChooser_->launchAsync(FileBrowserComponent::openMode | FileBrowserComponent::canSelectFiles, [this](const FileChooser& chooser)
+    {
+        auto selectedFile = chooser.getResult();
+
+        if (selectedFile != File())
+            loadProjectInBackground(selectedFile);
+    });
+}
+
+void MainComponent::loadProjectInBackground(const File& projectFile)
+{
+    // Properties missing from older project files keep their current settings, so the file is read over the current project data
+    auto projectData = std::make_shared<GriddleProjectData>();
+    getProjectData(*projectData);
+
+    // Read and parse the file on the background load thread, then apply it in one go on the message thread
+    auto requestId = ++loadRequestId_;
+    Component::SafePointer<MainComponent> safeThis(this);
+
+    backgroundLoadPool_.addJob([safeThis, requestId, projectFile, projectData]
+    {
+        String errorString("");
+        auto loadResult = GriddleProjectFile::load(projectFile, *projectData, errorString);
+
+        MessageManager::callAsync([safeThis, requestId, projectFile, projectData, loadResult, errorString]
+        {
+            if (safeThis != nullptr)
+                safeThis->applyLoadedProject(requestId, projectFile, *projectData, loadResult, errorString);
+        });
+    });
+}
+
+void MainComponent::applyLoadedProject(const int requestId, const File& projectFile, const GriddleProjectData& projectData, const Result& loadResult, const String& errorString)
+{
+    // Ignore the project if another project or pattern has been requested since
+    if (requestId != loadRequestId_)
+        return;
+
+    if (loadResult.failed())
+    {
+        AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Invalid Project File!", projectFile.getFileName() + " does not contain valid Griddle Project data!" + String(NewLine::getDefault()) + String(NewLine::getDefault()) + loadResult.getErrorMessage() + String(NewLine::getDefault()) + String(NewLine::getDefault()) + "The file will not be loaded.");
+        return;
+    }
+
+    String invalidMidiOutput("");
+    loadProjectData(projectData, invalidMidiOutput);
+
+    finishProjectLoad(projectFile, errorString, invalidMidiOutput);
+}
+
+void MainComponent::loadProjectData(const GriddleProjectData& projectData, String& invalidMidiOutput)
+{
+    if (! selectMidiOutput(projectData.midiOutput))
+        invalidMidiOutput = projectData.midiOutput;
+
+    midiOutputWireRates_[midiOutputList_.getText()] = projectData.midiWireRate;
+    outputEncoder_.setWireRate(projectData.midiWireRate);
+
+    loadPatternData(projectData);
+
+    // The project's tempo, tempo automation and grooves take effect immediately, even during playback
+    updateTempoMap();
+    updateGroove();
+}
+
+void MainComponent::loadPatternData(const GriddleProjectData& projectData)
+{
+    tempoSlider_.setValue(projectData.tempo, dontSendNotification);
+    rotateTempoDialImage();
+    tempoBPM_ = tempoSlider_.getValue();
+    tempoAutomation_ = projectData.tempoAutomation;
+
+    bandwidthAwareScheduling_ = projectData.bandwidthAwareScheduling;
+    scheduler_.setBandwidthAwareScheduling(bandwidthAwareScheduling_);
+
+    grooves_ = projectData.grooves;
+    updateTrackGrooveNames();
+
+    // The random seed takes effect the next time playback starts
+    randomSeed_ = projectData.randomSeed;
+    scheduler_.setRandomSeed(randomSeed_);
+
+    for (auto tracksI = 0; tracksI < tracks_.size(); ++tracksI)
+    {
+        tracks_[tracksI]->loadTrackData(projectData.tracks[tracksI]);
+    }
+}
+
+void MainComponent::getProjectData(GriddleProjectData& projectData) const
+{
+    projectData.tempo = tempoSlider_.getValue();
+    projectData.tempoAutomation = tempoAutomation_;
+    projectData.midiOutput = midiOutputList_.getItemText(midiOutputList_.getSelectedItemIndex());
+    projectData.midiWireRate = outputEncoder_.getWireRate();
+    projectData.bandwidthAwareScheduling = bandwidthAwareScheduling_;
+    projectData.grooves = grooves_;
+    projectData.randomSeed = randomSeed_;
+
+    for (auto tracksI = 0; tracksI < tracks_.size(); ++tracksI)
+    {
+        tracks_[tracksI]->getTrackData(projectData.tracks[tracksI]);
+    }
+}
+
+bool MainComponent::selectMidiOutput(const String& midiOutputName)
+{
+    for (auto moI = 0; moI < midiOutputList_.getNumItems(); ++moI)
+    {
+        if (midiOutputList_.getItemText(moI) == midiOutputName)
+        {
+            midiOutputList_.setSelectedId(midiOutputList_.getItemId(moI), dontSendNotification);
+            setMidiOutput(midiOutputList_.getItemText(midiOutputList_.getSelectedItemIndex()));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MainComponent::finishProjectLoad(const File& projectFile, const String& errorString, const String& invalidMidiOutput)
+{
+    // After loading all of the project settings, update the currentProjectFile_ and the project button to display the loaded filename
+    currentProjectFile_ = projectFile;
+    projectButton_.setButtonText(currentProjectFile_.getFileName());
+    updatePatternList();
+
+    // Reset the step selection, force-clearing the current selection
+    resetSelectedStep(true);
+
+    // Reset the source buffer
+    updateSourceMeasure();
+
+    // Start the undo history again from the loaded project
+    resetProjectHistory();
+
+    // Clear the unsaved changes flag
+    setUnsavedChangesFlag(false);
+
+    // If there is any content in the error string, warn the user that the project file may not have fully loaded and list the errors
+    if (errorString.isNotEmpty())
+    {
+        AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Project File Errors", "The project file may be only partially loaded due to the following errors:" + String(NewLine::getDefault()) + String(NewLine::getDefault()) + errorString);
+    }
+
+    // If the MIDI output specified in the file isn't available, let the user know the MIDI output will remain whatever it was
+    if (invalidMidiOutput.isNotEmpty())
+    {
+        AlertWindow::showMessageBox(AlertWindow::InfoIcon, "MIDI Output Not Found", invalidMidiOutput + " was specified as the MIDI output in the project file, but was not found in the currently available MIDI outputs. The selected MIDI Output will remain unchanged.");
+    }
+}
+
+void MainComponent::saveProjectAs(std::function<void()> onSaved)
+{
+    // Set the initial file to the current project file by default
+    File initialFile(currentProjectFile_);
+
+    // If there isn't a current project file, set the initial file to the Projects directory
+    if (initialFile.getFullPathName().isEmpty())
+    {
+        initialFile = File::getSpecialLocation(File::currentApplicationFile).getParentDirectory().getFullPathName() + String("/Projects/");
+
+        // If for some reason the Projects directory doesn't exist, fall back to the location of the Griddle executable
+        if (!initialFile.exists())
+            initialFile = File::getSpecialLocation(File::currentApplicationFile).getParentDirectory().getFullPathName();
+    }
+
+    // Choose a .griddle file (or a .griddlebin file, if the user gives that extension) asynchronously
+    projectFileChooser_.reset(new FileChooser("Save Griddle Project File", initialFile, "*.griddle;*.griddlebin"));
+
+    projectFileChooser_->launchAsync(FileBrowserComponent::saveMode | FileBrowserComponent::canSelectFiles | FileBrowserComponent::warnAboutOverwriting, [this, onSaved](const FileChooser& chooser)
+    {
+        auto selectedFile = chooser.getResult();
+
+        if (selectedFile == File())
+            return;
+
+        // Do the save processing on the selected file
+        saveProject(selectedFile);
+
+        if ((onSaved != nullptr) && ! unsavedProjectChanges_)
+            onSaved();
+    });
+}
+
+void MainComponent::saveProject(File projectFile)
+{
+    // Both formats are written straight from the project data
+    GriddleProjectData projectData;
+    getProjectData(projectData);
+
+    if (GriddleProjectFile::isBinaryProjectFile(projectFile))
+    {
+        finishProjectSave(projectFile, projectFileIO_.saveBinary(projectFile, projectData));
+        return;
+    }
+
+    // Add the .griddle extension if it was omitted
+    if (projectFile.getFileName().endsWith(".griddle") == false)
+    {
+        projectFile = File(projectFile.getFullPathName() + ".griddle");
+    }
+
+    // Write the JSON to the project file, replacing its previous contents
+    finishProjectSave(projectFile, projectFileIO_.save(projectFile, projectData));
+}
+
+void MainComponent::finishProjectSave(const File& projectFile, const Result& saveResult)
+{
+    if (saveResult.failed())
+    {
+        AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Project Not Saved", "The project couldn't be saved to " + projectFile.getFileName() + ":" + String(NewLine::getDefault()) + String(NewLine::getDefault()) + saveResult.getErrorMessage());
+        return;
+    }
+
+    // Update the project button text to show the project filename
+    currentProjectFile_ = projectFile;
+    projectButton_.setButtonText(currentProjectFile_.getFileName());
+
+    // Clear the unsaved changes flag
+    setUnsavedChangesFlag(false);
+
+    // Re-index the pattern library if the project was saved into it
+    if (patternLibrary_.getDirectory().isDirectory() && (projectFile.getParentDirectory() == patternLibrary_.getDirectory()))
+    {
+        patternLibrary_.openDirectory(patternLibrary_.getDirectory());
+        updatePatternList();
+    }
+}
+
+void MainComponent::promptForProjectSave(std::function<void()> onContinue)
+{
+    // If there are no unsaved changes, just carry on
+    if (! unsavedProjectChanges_)
+    {
+        onContinue();
+        return;
+    }
+
+    // Prompt the user to decide whether or not to save the current project
+    auto response = AlertWindow::showYesNoCancelBox(AlertWindow::QuestionIcon, "Unsaved Project", "The current project has unsaved changes." + String(NewLine::getDefault()) + String(NewLine::getDefault()) + "Would you like to save the current project before continuing?");
+
+    if (response == 0)
+    {
+        // CANCEL
+    }
+    else if (response == 1)
+    {
+        // YES
+
+        // A new project is only continued once it has been saved, since the file is chosen asynchronously
+        if (projectButton_.getButtonText().startsWith("(new"))
+        {
+            saveProjectAs(onContinue);
+        }
+        else
+        {
+            saveProject(currentProjectFile_);
+
+            // If the save failed, the error has been shown and the unsaved changes are kept rather than discarded by continuing
+            if (! unsavedProjectChanges_)
+                onContinue();
+        }
+    }
+    else if (response == 2)
+    {
+        // NO
+        onContinue();
+    }
+}
+
+void MainComponent::handleWindowCloseRequest()
+{
+    // If the user initiates closing of the application, make sure they have the opportunity to save unsaved project changes or cancel
+    promptForProjectSave([] { JUCEApplication::getInstance()->systemRequestedQuit(); });
+}
+
+void MainComponent::handlePlayButtonClick()
+{
+    // The button shouldn't be clickable if the sequence is already playing but check just in case
+    if (! isPlaying_)
+    {
+        // Start the scheduler, which pre-rolls by its look-ahead so events moved ahead of the
+        // first measure by negative track latency offsets are still sent on time
+        scheduler_.start(Time::getMillisecondCounterHiRes() * 0.001);
+
+        // Reset the play line offset
+        playLineX_Offset_ = 0.0;
 
         // Call applyPendingChanges to alert each track that the sequence is now playing
         for (auto tI = 0; tI < tracks_.size(); ++tI)
@@ -922,6 +1422,10 @@ void MainComponent::handlePlayButtonClick()
             tracks_[tI]->applyPendingChanges(true);
         }
 
+        // The timer thread records trace events from its first callback, so reserve its trace buffer here rather
+        // than have it allocate one on the playback path
+        GRIDDLE_TRACE_RESERVE_THREAD_BUFFER();
+
         // Start the high resolution timer with an interval of 1ms to initiate play of the MIDI events
         HighResolutionTimer::startTimer(1);
         
@@ -941,29 +1445,26 @@ void MainComponent::handleStopButtonClick()
         // Stop the high resolution timer to end sending of MIDI events
         HighResolutionTimer::stopTimer();
 
-        // Iterate through the remaining messages in the playbackBuffer_ and send any NOTE OFFs to ensure
-        // all notes are off, particularly for any synths don't honor the all notes off message
-        MidiBuffer::Iterator iterator(playbackBuffer_);
-        while (iterator.getNextEvent(bufferOutputMessage_, playbackSampleNumber_))
-        {
-            if (bufferOutputMessage_.isNoteOff())
-                midiOutPtr_->sendMessageNow(bufferOutputMessage_);
-        }
+        // Stop the scheduler, which sends a NOTE OFF for each note that is still sounding
+        scheduler_.stop();
 
         // Clear necessary flags and variables
         isPlaying_ = false;
-        playbackBuffer_.clear();
-        previousSampleNumber_ = 0;
         playLineX_Offset_ = 0.0;
         
-        // Send the all notes off MIDI message on the MIDI channel for each track to ensure the end of any NOTE ONs and call applyPendingChanges to alert
-        // the tracks that the sequence is no longer playing
+        // Call applyPendingChanges to alert the tracks that the sequence is no longer playing
         for (auto tI = 0; tI < tracks_.size(); ++tI)
         {
-            MidiMessage allNotesOff = MidiMessage::allNotesOff(tracks_[tI]->getMidiChannel());
-            midiOutPtr_->sendMessageNow(allNotesOff);
             tracks_[tI]->applyPendingChanges(false);
         }
+
+        // A pattern switch that was still queued is now simply the loaded pattern
+        if (patternSwitchPending_)
+        {
+            patternSwitchPending_ = false;
+            patternList_.setAlpha(1.0f);
+            rotateTempoDialImage();
+        }
     }
 
     updateMasterComponentsEnabledState();
@@ -1025,7 +1526,7 @@ void MainComponent::stepSelectionGoToNextTrack()
 
 bool MainComponent::keyPressed(const KeyPress& key, Component* originatingComponent)
 {
-    // Allow the arrow keys on the computer keyboard to change the selected step
+    // Allow the arrow keys on the computer keyboard to change the selected step, and the usual shortcuts to undo and redo
     auto consumed = false;
     if (key.isKeyCode(KeyPress::leftKey))
     {
@@ -1047,6 +1548,18 @@ bool MainComponent::keyPressed(const KeyPress& key, Component* originatingCompon
         stepSelectionGoToNextTrack();
         consumed = true;
     }
+    else if (key == KeyPress('z', ModifierKeys::commandModifier, 0))
+    {
+        // Ctrl+Z (Cmd+Z on macOS) undoes the last change
+        undoProjectChange();
+        consumed = true;
+    }
+    else if ((key == KeyPress('z', ModifierKeys::commandModifier | ModifierKeys::shiftModifier, 0)) || (key == KeyPress('y', ModifierKeys::commandModifier, 0)))
+    {
+        // Ctrl+Shift+Z or Ctrl+Y (Cmd+Shift+Z or Cmd+Y on macOS) redoes the last undone change
+        redoProjectChange();
+        consumed = true;
+    }
 
     return consumed;
 }
@@ -1073,8 +1586,9 @@ void MainComponent::handleStepSelectNextTrackButtonClick()
 
 void MainComponent::handleTrackCharacteristicsChanged()
 {
-    // When any characteristics of a track change, udpate the source buffer...
-    updateSourceMidiBuffer();
+    // When any characteristics of a track change, udpate the source buffer and the groove (which depends on the number of steps)...
+    updateSourceMeasure();
+    updateGroove();
 
     // ...and change the step selection if the number of steps for the track changed such that the selected step is no longer valid
     if (selectedStepPtr_ != nullptr)
@@ -1088,6 +1602,13 @@ void MainComponent::handleTrackCharacteristicsChanged()
     setUnsavedChangesFlag(true);
 }
 
+void MainComponent::handleTrackGrooveChanged()
+{
+    updateGroove();
+
+    setUnsavedChangesFlag(true);
+}
+
 void MainComponent::updateAutoAdvanceSelectionState()
 {
     autoAdvanceSelectionToggle_.setToggleState(! autoAdvanceSelectionToggle_.getToggleState(), dontSendNotification);
@@ -1109,7 +1630,7 @@ void MainComponent::updateAutoAdvanceSelectionState()
 
 void MainComponent::updateMasterComponentsEnabledState()
 {
-    // All of the master components except the tempo slider should be disabled when the sequence is playing
+    // All of the master components except the tempo slider and pattern list should be disabled when the sequence is playing
     midiOutputList_.setEnabled(! isPlaying_);
     midiOutputListLabel_.setEnabled(! isPlaying_);
     playButton_.setEnabled(! isPlaying_);
@@ -1128,6 +1649,7 @@ void MainComponent::updateStepEditComponentsEnabledState()
     stepEditVelocityLabel_.setEnabled(selectedStepPtr_ != nullptr);
     stepEditNoteLabel_.setEnabled(selectedStepPtr_ != nullptr);
     stepEditNoteTitleLabel_.setEnabled(selectedStepPtr_ != nullptr);
+    stepEditTrigButton_.setEnabled(selectedStepPtr_ != nullptr);
 
     keyboardComponent_.setEnabled(selectedStepPtr_ != nullptr);
     restButton_.setEnabled(selectedStepPtr_ != nullptr);
@@ -1150,16 +1672,13 @@ void MainComponent::sliderValueChanged(Slider* slider)
 {
     if (slider == &tempoSlider_)
     {
-        // Rotate the tempo dial if the sequence isn't playing, otherwise just dim it to indicate there's a pending change,
-        // but don't rotate it yet - it will be rotated at the next start of measure when the new tempo takes effect
-        if (!isPlaying_)
-            rotateTempoDialImage();
-        else
-            tempoDialImage_.setAlpha(0.6f);
+        // The new tempo takes effect immediately, even during playback, and since the compiled measure
+        // is positioned in ticks it doesn't need to be recompiled
+        rotateTempoDialImage();
 
         tempoBPM_ = slider->getValue();
 
-        updateSourceMidiBuffer();
+        updateTempoMap();
 
         setUnsavedChangesFlag(true);
     }
@@ -1169,7 +1688,7 @@ void MainComponent::sliderValueChanged(Slider* slider)
         {
             // Update the velocity for the selected step and update the source buffer since a step changed
             selectedStepPtr_->setVelocity(static_cast<int>(stepEditVelocitySlider_.getValue()));
-            updateSourceMidiBuffer();
+            updateSourceMeasure();
 
             setUnsavedChangesFlag(true);
         }
@@ -1180,13 +1699,24 @@ void MainComponent::sliderValueChanged(Slider* slider)
         {
             // Update the gate percent for the selected step and update the source buffer since a step changed
             selectedStepPtr_->setGatePercent(static_cast<int>(stepEditGateSlider_.getValue()));
-            updateSourceMidiBuffer();
+            updateSourceMeasure();
 
             setUnsavedChangesFlag(true);
         }
     }
 }
 
+void MainComponent::sliderDragStarted(Slider* slider)
+{
+    draggedSlider_ = slider;
+}
+
+void MainComponent::sliderDragEnded(Slider* slider)
+{
+    draggedSlider_ = nullptr;
+    projectHistory_.endCoalescing();
+}
+
 void MainComponent::stepSelected(GriddleStep* selectedStep)
 {
     // Handle notification of a step being selected
@@ -1201,29 +1731,49 @@ void MainComponent::stepSelected(GriddleStep* selectedStep)
     selectedStepPtr_ = selectedStep;
 
     // Update the step edit controls to reflect the newly-selected step values
-    if (selectedStepPtr_->getNoteNumber() >= 0)
-        stepEditNoteLabel_.setText(MidiMessage::getMidiNoteName(selectedStepPtr_->getNoteNumber(), true, true, 4), dontSendNotification);
-    else
-        stepEditNoteLabel_.setText("", dontSendNotification);
+    updateStepEditNoteLabel();
 
     stepEditVelocitySlider_.setValue(selectedStepPtr_->getVelocity(), dontSendNotification);
     stepEditGateSlider_.setValue(selectedStepPtr_->getGatePercent(), dontSendNotification);
+    updateStepEditTrigButtonText();
 }
 
 void MainComponent::setMidiOutput(const juce::String& identifier)
 {
-    // Find the passed-in MIDI output in the available MIDI outputs list and set the midiOutPtr_ accordingly
+    // Open the passed-in MIDI output and hand it to the output encoder
+    auto outputPort = openMidiOutputPort(identifier);
+
+    if (outputPort != nullptr)
+    {
+        outputEncoder_.setOutputPort(std::move(outputPort));
+
+        // Outputs are assumed to be DIN ports until the user says otherwise, except for the virtual port
+        auto defaultWireRate = (identifier == VIRTUAL_MIDI_OUTPUT_NAME) ? 0.0 : GriddleOutputEncoder::DIN_BYTES_PER_SECOND;
+        auto wireRate = midiOutputWireRates_.find(identifier);
+        outputEncoder_.setWireRate(wireRate != midiOutputWireRates_.end() ? wireRate->second : defaultWireRate);
+        updateSourceMeasure();
+
+        setUnsavedChangesFlag(true);
+    }
+
+}
+
+std::unique_ptr<GriddleOutputPort> MainComponent::openMidiOutputPort(const juce::String& identifier) const
+{
+   #if JUCE_LINUX
+    if (identifier == VIRTUAL_MIDI_OUTPUT_NAME)
+        return GriddleAlsaSequencerPort::createVirtualPort("Griddle Out");
+   #endif
+
+    // Find the passed-in MIDI output in the available MIDI outputs list
     auto midiOutputs = MidiOutput::getAvailableDevices();
     for (auto i = 0; i < midiOutputs.size(); ++i)
     {
         if (midiOutputs[i].name == identifier)
-        {
-            midiOutPtr_ = MidiOutput::openDevice(midiOutputs[i].identifier);
-
-            setUnsavedChangesFlag(true);
-        }
+            return GriddleMidiOutputPort::openDevice(midiOutputs[i].identifier);
     }
 
+    return nullptr;
 }
 
 void MainComponent::resetSelectedStep(const bool forceClearCurrentSelection)
@@ -1283,68 +1833,214 @@ void MainComponent::resetSelectedStep(const bool forceClearCurrentSelection)
     updateStepEditComponentsEnabledState();
 }
 
-void MainComponent::updateSourceMidiBuffer()
+void MainComponent::updateSourceMeasure()
 {
-    sourceBuffer_.clear();
+    GRIDDLE_TRACE_SCOPE("MainComponent::updateSourceMeasure");
 
-    // Loop through the tracks and populate the MIDI buffer with MIDI events for the steps
-    for (auto i = 0; i < tracks_.size(); ++i)
+    // Compile the current settings
+    getProjectData(compileProjectData_);
+
+    measureCompiler_.compile(compileProjectData_, bufferSampleRate_, outputEncoder_.getWireRate(), sourceMeasure_);
+
+    // Hand the compiled measure over to the scheduler
+    sourceGeneration_ = scheduler_.swapSourceMeasure(sourceMeasure_);
+}
+
+void MainComponent::updateTempoMap()
+{
+    scheduler_.setTempoMap(GriddleTempoMap(tempoBPM_, tempoAutomation_));
+}
+
+void MainComponent::setTempoAutomation(const GriddleTempoAutomationData& tempoAutomation)
+{
+    tempoAutomation_ = tempoAutomation;
+    updateTempoMap();
+
+    setUnsavedChangesFlag(true);
+}
+
+GriddleTempoAutomationData MainComponent::getTempoAutomationPreset(const int presetIndex)
+{
+    GriddleTempoAutomationData tempoAutomation;
+
+    if (presetIndex == 1)
     {
-        // Inactive tracks are not included in the MIDI buffer
-        if (tracks_[i]->isActive())
-        {
-            int currentSamplePos = 0;
+        // Accelerando: ramp up to a quarter faster over 4 measures, then drop back
+        tempoAutomation.numMeasures = 4;
+        tempoAutomation.numPoints = 2;
+        tempoAutomation.points[0] = { 0.0, 1.0, false };
+        tempoAutomation.points[1] = { 16.0, 1.25, true };
+    }
+    else if (presetIndex == 2)
+    {
+        // Ritardando: ramp down to three quarters of the tempo over 4 measures, then jump back
+        tempoAutomation.numMeasures = 4;
+        tempoAutomation.numPoints = 2;
+        tempoAutomation.points[0] = { 0.0, 1.0, false };
+        tempoAutomation.points[1] = { 16.0, 0.75, true };
+    }
+    else if (presetIndex == 3)
+    {
+        // Half time from the third beat of every measure
+        tempoAutomation.numMeasures = 1;
+        tempoAutomation.numPoints = 2;
+        tempoAutomation.points[0] = { 0.0, 1.0, false };
+        tempoAutomation.points[1] = { 2.0, 0.5, false };
+    }
+    else if (presetIndex == 4)
+    {
+        // Push and pull: ramp a tenth faster over one measure and back again over the next
+        tempoAutomation.numMeasures = 2;
+        tempoAutomation.numPoints = 2;
+        tempoAutomation.points[0] = { 4.0, 1.1, true };
+        tempoAutomation.points[1] = { 8.0, 1.0, true };
+    }
 
-            // The number of notes to add for one measure depends on whether the tempo is doubled for the track
-            int numNotes = tracks_[i]->getNumSteps() * tracks_[i]->getTempoMultiplier();
+    return tempoAutomation;
+}
 
-            // Calculate the smallest possible gate length in samples equivalent to 20ms
-            int minGateLengthInSamples = static_cast<int>(20.0 / ((1 / bufferSampleRate_) * 1000));
+void MainComponent::updateGroove()
+{
+    getProjectData(compileProjectData_);
 
-            // Calcluate the number of samples beteween NOTE ON events based on the tempo and number of notes in the track
-            int sampleIncr = static_cast<int>((1 / (tempoBPM_ / 60.0) * 4.0 * bufferSampleRate_) / numNotes);
+    scheduler_.setGroove(GriddleGroove(compileProjectData_));
+}
 
-            // Loop through the steps and add the MIDI events
-            for (auto stepI = 0; stepI < numNotes; ++stepI)
-            {
-                auto stepIndex = stepI;
+void MainComponent::setGrooveTemplate(const int grooveIndex, const GriddleGrooveData& groove)
+{
+    grooves_[grooveIndex] = groove;
+    updateTrackGrooveNames();
+    updateGroove();
 
-                // When the tempo is doubled for the track, repeat the step indexes
-                if (stepIndex >= tracks_[i]->getNumSteps())
-                    stepIndex -= tracks_[i]->getNumSteps();
+    setUnsavedChangesFlag(true);
+}
 
-                // Adjust the step index if the track is set to play the steps in reverse
-                if (tracks_[i]->isFlipped())
-                    stepIndex = (tracks_[i]->getNumSteps() - stepIndex - 1);
+String MainComponent::getGrooveDisplayName(const int grooveIndex) const
+{
+    auto displayName = "Groove " + String(grooveIndex + 1);
 
-                // If the step isn't a rest, add the NOTE ON and NOTE OFF messages to the buffer
-                if (tracks_[i]->getStep(stepIndex).getNoteNumber() >= 0)
-                {
-                    auto messageNoteOn = MidiMessage::noteOn(tracks_[i]->getMidiChannel(), tracks_[i]->getStep(stepIndex).getNoteNumber(), (uint8)tracks_[i]->getStep(stepIndex).getVelocity());
+    if (grooves_[grooveIndex].name.isNotEmpty())
+        displayName << ": " << grooves_[grooveIndex].name;
 
-                    auto messageNoteOff = MidiMessage::noteOff(tracks_[i]->getMidiChannel(), tracks_[i]->getStep(stepIndex).getNoteNumber(), (uint8)0);
+    return displayName;
+}
 
-                    sourceBuffer_.addEvent(messageNoteOn, currentSamplePos);
+void MainComponent::updateTrackGrooveNames()
+{
+    StringArray grooveNames;
 
-                    // Calculate the note off sample position based on the gate percent and chopped state of the track
-                    int gatePercent = tracks_[i]->getStep(stepIndex).getGatePercent();
-                    if (tracks_[i]->isChopped())
-                        gatePercent = 10;
-                    int noteOffPos = currentSamplePos + static_cast<int>(sampleIncr * (gatePercent / 100.0) - 1);
+    for (auto grooveI = 0; grooveI < GriddleProjectData::NUM_GROOVES; ++grooveI)
+        grooveNames.add(getGrooveDisplayName(grooveI));
 
-                    // Enforce the calculated minimum gate length to ensure reliable note triggering
-                    if (noteOffPos < (currentSamplePos + minGateLengthInSamples))
-                        noteOffPos = currentSamplePos + minGateLengthInSamples;
+    for (auto& track : tracks_)
+        track->setGrooveNames(grooveNames);
+}
 
-                    sourceBuffer_.addEvent(messageNoteOff, noteOffPos);
-                }
-                                
-                currentSamplePos += sampleIncr;
-            }
-        }
+void MainComponent::promptForGrooveTemplate(const int grooveIndex)
+{
+    const auto& groove = grooves_[grooveIndex];
 
+    // The offsets are edited as lists with one value per step position
+    StringArray timingValues;
+    StringArray velocityValues;
+
+    for (auto stepI = 0; stepI < jlimit(1, GriddleTrackData::NUM_STEPS, groove.length); ++stepI)
+    {
+        timingValues.add(String(groove.timingPercents[stepI]));
+        velocityValues.add(String(groove.velocityOffsets[stepI]));
+    }
+
+    AlertWindow grooveWindow("Groove " + String(grooveIndex + 1),
+                             "Enter the timing offset of each step position as a percentage of a step (positive offsets play late, up to " +
+                             String(GriddleGrooveData::MAX_TIMING_PERCENT) + "% either way), and the velocity offset of each step position (up to " +
+                             String(GriddleGrooveData::MAX_VELOCITY_OFFSET) + " either way)." + String(NewLine::getDefault()) + String(NewLine::getDefault()) +
+                             "The groove repeats after as many step positions as there are timing offsets.",
+                             AlertWindow::NoIcon, this);
+    grooveWindow.addTextEditor("name", groove.name, "Name");
+    grooveWindow.addTextEditor("timing", timingValues.joinIntoString(", "), "Timing Offsets (%)");
+    grooveWindow.addTextEditor("velocity", velocityValues.joinIntoString(", "), "Velocity Offsets");
+    grooveWindow.addButton("OK", 1, KeyPress(KeyPress::returnKey));
+    grooveWindow.addButton("Cancel", 0, KeyPress(KeyPress::escapeKey));
+
+    if (grooveWindow.runModalLoop() != 1)
+        return;
+
+    timingValues = StringArray::fromTokens(grooveWindow.getTextEditorContents("timing"), ", ", "");
+    timingValues.removeEmptyStrings();
+    velocityValues = StringArray::fromTokens(grooveWindow.getTextEditorContents("velocity"), ", ", "");
+    velocityValues.removeEmptyStrings();
+
+    // Missing velocity offsets are left at 0, and values past the last step position are ignored
+    GriddleGrooveData newGroove;
+    newGroove.name = grooveWindow.getTextEditorContents("name").trim();
+    newGroove.length = jlimit(1, GriddleTrackData::NUM_STEPS, timingValues.size());
+
+    for (auto stepI = 0; stepI < newGroove.length; ++stepI)
+    {
+        newGroove.timingPercents[stepI] = jlimit(-GriddleGrooveData::MAX_TIMING_PERCENT, GriddleGrooveData::MAX_TIMING_PERCENT, timingValues[stepI].getIntValue());
+        newGroove.velocityOffsets[stepI] = jlimit(-GriddleGrooveData::MAX_VELOCITY_OFFSET, GriddleGrooveData::MAX_VELOCITY_OFFSET, velocityValues[stepI].getIntValue());
     }
+
+    setGrooveTemplate(grooveIndex, newGroove);
 }
+
+void MainComponent::promptForRandomSeed()
+{
+    AlertWindow seedWindow("Random Seed",
+                           "Enter the seed of the random numbers that decide whether steps with a probability play. "
+                           "The project plays the same way each time playback starts with the same seed.",
+                           AlertWindow::NoIcon, this);
+    seedWindow.addTextEditor("seed", String(randomSeed_), "Seed");
+    seedWindow.addButton("OK", 1, KeyPress(KeyPress::returnKey));
+    seedWindow.addButton("Random", 2);
+    seedWindow.addButton("Cancel", 0, KeyPress(KeyPress::escapeKey));
+
+    auto result = seedWindow.runModalLoop();
+
+    if (result == 0)
+        return;
+
+    randomSeed_ = (result == 2) ? Random::getSystemRandom().nextInt() : seedWindow.getTextEditorContents("seed").trim().getIntValue();
+    scheduler_.setRandomSeed(randomSeed_);
+
+    setUnsavedChangesFlag(true);
+}
+
+GriddleGrooveData MainComponent::getGroovePreset(const int presetIndex)
+{
+    GriddleGrooveData groove;
+
+    if (presetIndex == 1)
+    {
+        // Accented: louder on the beats, softer on the steps between the 8th notes
+        groove.name = "Accented";
+        groove.velocityOffsets = { { 16, -12, 0, -12, 16, -12, 0, -12, 16, -12, 0, -12, 16, -12, 0, -12 } };
+    }
+    else if (presetIndex == 2)
+    {
+        // Laid back: the off-beat 8th notes a little late and the steps between them later still
+        groove.name = "Laid Back";
+        groove.timingPercents = { { 0, 12, 8, 12, 0, 12, 8, 12, 0, 12, 8, 12, 0, 12, 8, 12 } };
+        groove.velocityOffsets = { { 0, -8, 0, -8, 0, -8, 0, -8, 0, -8, 0, -8, 0, -8, 0, -8 } };
+    }
+    else if (presetIndex == 3)
+    {
+        // Pushed: the steps between the 8th notes early, with accented off-beats
+        groove.name = "Pushed";
+        groove.timingPercents = { { 0, -6, 0, -6, 0, -6, 0, -6, 0, -6, 0, -6, 0, -6, 0, -6 } };
+        groove.velocityOffsets = { { 0, 0, 8, 0, 0, 0, 8, 0, 0, 0, 8, 0, 0, 0, 8, 0 } };
+    }
+    else if (presetIndex == 4)
+    {
+        // Hand played: small irregular timing and velocity changes across the measure
+        groove.name = "Hand Played";
+        groove.timingPercents = { { 0, 9, -4, 12, 2, 7, -6, 10, 0, 11, -3, 8, 3, 6, -5, 13 } };
+        groove.velocityOffsets = { { 10, -14, 0, -8, 6, -12, -2, -10, 8, -16, 2, -6, 4, -12, 0, -9 } };
+    }
+
+    return groove;
+}
+
 void MainComponent::setUnsavedChangesFlag(const bool unsavedChanges)
 {
     String currentProjectFileDisplayText = projectButton_.getButtonText();
@@ -1363,6 +2059,141 @@ void MainComponent::setUnsavedChangesFlag(const bool unsavedChanges)
     }
 
     unsavedProjectChanges_ = unsavedChanges;
+
+    getProjectData(journalProjectData_);
+
+    // Record any change to the sequence in the undo history, merging the changes made during a slider drag
+    // and the notes of a chord played on the step edit keyboard
+    if (unsavedChanges)
+        projectHistory_.recordState(journalProjectData_, (chordCaptureStepPtr_ != nullptr) ? static_cast<const void*>(chordCaptureStepPtr_) : draggedSlider_);
+
+    // Record the new state in the session journal so it can be restored after a crash
+    sessionJournal_.record(journalProjectData_, currentProjectFile_, unsavedChanges);
+}
+
+void MainComponent::resetProjectHistory()
+{
+    getProjectData(historyProjectData_);
+    projectHistory_.reset(historyProjectData_);
+}
+
+void MainComponent::undoProjectChange()
+{
+    getProjectData(historyProjectData_);
+
+    if (projectHistory_.undo(historyProjectData_))
+        applyProjectHistoryState();
+}
+
+void MainComponent::redoProjectChange()
+{
+    getProjectData(historyProjectData_);
+
+    if (projectHistory_.redo(historyProjectData_))
+        applyProjectHistoryState();
+}
+
+void MainComponent::applyProjectHistoryState()
+{
+    loadPatternData(historyProjectData_);
+
+    // Like any other edit, the restored tempo, tempo automation and grooves take effect immediately
+    updateTempoMap();
+    updateGroove();
+
+    // Keep the selected step if it's still part of its track, updating the step edit controls with its restored values
+    if ((selectedStepPtr_ != nullptr) && (selectedStepPtr_->getStepIndex() < tracks_[selectedStepPtr_->getOwnerTrackIndex()]->getNumSteps()))
+    {
+        stepSelected(selectedStepPtr_);
+        resetSelectedStep(false);
+    }
+    else
+    {
+        resetSelectedStep(true);
+    }
+
+    updateSourceMeasure();
+
+    // The history already holds this state, so flagging the change doesn't record it again
+    setUnsavedChangesFlag(true);
+}
+
+void MainComponent::exportPlaybackTelemetry()
+{
+    // Start next to the current project file, or in the user's documents if there isn't one
+    File initialFile(currentProjectFile_.getSiblingFile("Griddle Telemetry.csv"));
+
+    if (currentProjectFile_.getFullPathName().isEmpty())
+        initialFile = File::getSpecialLocation(File::userDocumentsDirectory).getChildFile("Griddle Telemetry.csv");
+
+    projectFileChooser_.reset(new FileChooser("Export Playback Telemetry", initialFile, "*.csv"));
+
+    projectFileChooser_->launchAsync(FileBrowserComponent::saveMode | FileBrowserComponent::canSelectFiles | FileBrowserComponent::warnAboutOverwriting, [this](const FileChooser& chooser)
+    {
+        auto selectedFile = chooser.getResult();
+
+        if (selectedFile == File())
+            return;
+
+        auto csvFile = selectedFile.withFileExtension("csv");
+
+        MemoryOutputStream csv;
+        scheduler_.getTelemetry().writeCsv(csv);
+
+        if (! csvFile.replaceWithData(csv.getData(), csv.getDataSize()))
+            AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Telemetry Not Exported", "The playback telemetry couldn't be written to " + csvFile.getFileName());
+    });
+}
+
+#if GRIDDLE_ENABLE_TRACING
+void MainComponent::saveTraceFile()
+{
+    File initialFile(File::getSpecialLocation(File::userDocumentsDirectory).getChildFile("Griddle Trace.json"));
+
+    projectFileChooser_.reset(new FileChooser("Save Trace File", initialFile, "*.json"));
+
+    projectFileChooser_->launchAsync(FileBrowserComponent::saveMode | FileBrowserComponent::canSelectFiles | FileBrowserComponent::warnAboutOverwriting, [](const FileChooser& chooser)
+    {
+        auto selectedFile = chooser.getResult();
+
+        if (selectedFile == File())
+            return;
+
+        // The trace is written from whatever each thread's ring buffer holds right now
+        MemoryOutputStream trace;
+        GriddleTrace::writeChromeTrace(trace);
+
+        if (! selectedFile.replaceWithData(trace.getData(), trace.getDataSize()))
+            AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Trace Not Saved", "The trace couldn't be written to " + selectedFile.getFileName());
+    });
+}
+#endif
+
+void MainComponent::restoreRecoveredSession(const GriddleProjectData& projectData, const File& projectFile)
+{
+    String sessionName = (projectFile != File()) ? projectFile.getFileName() : String("a new project");
+
+    if (! AlertWindow::showOkCancelBox(AlertWindow::QuestionIcon, "Restore Unsaved Changes?",
+        "Griddle didn't shut down properly last time, and there were unsaved changes to " + sessionName + "." + String(NewLine::getDefault()) + String(NewLine::getDefault()) + "Would you like to restore them?",
+        "Restore", "Discard", this))
+    {
+        sessionJournal_.releaseRecoveredSession();
+        return;
+    }
+
+    String invalidMidiOutput("");
+    loadProjectData(projectData, invalidMidiOutput);
+
+    finishProjectLoad(projectFile, String(), invalidMidiOutput);
+
+    // A new project that was never saved goes back to being a new project
+    if (projectFile == File())
+        projectButton_.setButtonText("(new - click here for options)");
+
+    // The restored changes still haven't been saved. Flagging them records them in this session's journal, which
+    // writes them before it deletes the recovered session.
+    setUnsavedChangesFlag(true);
+    sessionJournal_.releaseRecoveredSession();
 }
 
 void MainComponent::rotateTempoDialImage()
@@ -1377,13 +2208,29 @@ void MainComponent::rotateTempoDialImage()
     tempoDialImage_.setAlpha(1.0);
 }
 
+void MainComponent::updateMidiWireStatsLabel()
+{
+    // Show the bytes/sec and the time the last measure's messages spent on the MIDI output's wire
+    auto stats = outputEncoder_.getLastMeasureStats();
+
+    auto statsText = String(stats.bytesPerSecond, 0) + " B/s - " + String(stats.wireTimeMs, 1) + " ms wire/measure";
+
+    // Add the worst lateness of the measure's events at the far end of the wire
+    if (stats.eventsTimed > 0)
+        statsText += " - max late " + String(stats.maxLatenessMs, 1) + " ms";
+
+    midiWireStatsLabel_.setText(statsText, dontSendNotification);
+}
+
 
 void MainComponent::update()
 {
+    GRIDDLE_TRACE_SCOPE("MainComponent::update");
+
     // Update the play line offset to properly animate the play lines on the tracks
     if (isPlaying_)
     {
-        playLineX_Offset_ += static_cast<float>(((getMillisecondsSinceLastUpdate() * 0.001) / ((1 / (thisPassBPM_ / 60.0)) * 4.0)) * static_cast<float>(STEPS_DISPLAY_PIXEL_WIDTH));
+        playLineX_Offset_ += static_cast<float>(((getMillisecondsSinceLastUpdate() * 0.001) / ((1 / (scheduler_.getCurrentBPM() / 60.0)) * 4.0)) * static_cast<float>(STEPS_DISPLAY_PIXEL_WIDTH));
         if (playLineX_Offset_ >= static_cast<float>(STEPS_DISPLAY_PIXEL_WIDTH))
             playLineX_Offset_ = static_cast<float>(STEPS_DISPLAY_PIXEL_WIDTH);
     }
@@ -1398,12 +2245,22 @@ void MainComponent::update()
     {
         // Since update() is called from its own thread, use a MessageManagerLock
         const MessageManagerLock mmLock;
-        for (auto tI = 0; tI < tracks_.size(); ++tI)
+
+        // A queued pattern switch (and anything pending with it) is held back until the measure compiled from the
+        // pattern starts, which is the measure after this one if this one was already queued when it was selected
+        if (! patternSwitchPending_ || (scheduler_.getMeasureSourceGeneration() >= patternSwitchGeneration_))
         {
-            tracks_[tI]->applyPendingChanges(isPlaying_);
+            for (auto tI = 0; tI < tracks_.size(); ++tI)
+            {
+                tracks_[tI]->applyPendingChanges(isPlaying_);
+            }
+            resetSelectedStep();
+            rotateTempoDialImage();
+
+            patternSwitchPending_ = false;
+            patternList_.setAlpha(1.0f);
         }
-        resetSelectedStep();
-        rotateTempoDialImage();
+        updateMidiWireStatsLabel();
 
         startOfMeasurePassed_ = false;
     }
@@ -1412,6 +2269,8 @@ void MainComponent::update()
 //==============================================================================
 void MainComponent::paint(Graphics& g)
 {
+    GRIDDLE_TRACE_SCOPE("MainComponent::paint");
+
     g.fillAll(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
  
     // Draw some small separator bars
@@ -1425,17 +2284,20 @@ void MainComponent::paint(Graphics& g)
     Rectangle<float> separator4(0.0f, 790.0f, static_cast<float>(getWidth()), 5.0f);
     g.fillRect(separator4);
 
+    // The position of the play lines on the timeline, from the current measure and the progress through it
+    auto playLineTick = (scheduler_.getCurrentMeasureIndex() * GriddleTimeline::TICKS_PER_MEASURE)
+                        + static_cast<int64>((playLineX_Offset_ / STEPS_DISPLAY_PIXEL_WIDTH) * GriddleTimeline::TICKS_PER_MEASURE);
+
     // Draw the play lines for each track
     for (auto plI = 0; plI < playLines_.size(); ++plI)
     {
         // Only animate the play line on a track if the sequence is playing and the track is active on the current pass
         if (isPlaying_ && tracks_[plI]->isActive(true))
         {
-            // Ensure the play line moves twice as fast and runs over the measure twice if the track is burnt
-            float mult = (tracks_[plI]->isBurnt(true) ? 2.0f : 1.0f);
-            int trackPlayLineX_Offset = static_cast<int>(playLineX_Offset_ * mult);
-            if (trackPlayLineX_Offset >= STEPS_DISPLAY_PIXEL_WIDTH)
-                trackPlayLineX_Offset -= STEPS_DISPLAY_PIXEL_WIDTH;
+            // The play line runs over the track once per pattern, so it runs over the measure twice if the track is burnt
+            // and carries on across the measure boundary for a free-running clocked track
+            auto patternTicks = jmax(int64(1), tracks_[plI]->getPatternTicks(true));
+            int trackPlayLineX_Offset = static_cast<int>(((playLineTick % patternTicks) * STEPS_DISPLAY_PIXEL_WIDTH) / patternTicks);
 
             // Ensure the play line moves in reverse over the track if the track is flipped
             if (tracks_[plI]->isFlipped(true))
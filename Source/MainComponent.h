@@ -25,7 +25,21 @@ along with Griddle. If not, see < https://www.gnu.org/licenses/>.
 
 #include <JuceHeader.h>
 
+#include <map>
+#include <vector>
 #include "GriddleTrack.h"
+#include "GriddleOutputEncoder.h"
+#include "GriddleScheduler.h"
+#include "GriddleAlsaSequencerPort.h"
+#include "GriddleLatencyCalibrator.h"
+#include "GriddleProjectFile.h"
+#include "GriddleMeasureCompiler.h"
+#include "GriddlePatternLibrary.h"
+#include "GriddleSessionJournal.h"
+#include "GriddleProjectHistory.h"
+#include "GriddleTelemetryOverlay.h"
+#include "GriddleTrigCondition.h"
+#include "GriddleTrace.h"
 
 //==============================================================================
 /*
@@ -77,6 +91,18 @@ public:
     */
     void sliderValueChanged(Slider* slider) override;
 
+    /** Starts merging the changes made by dragging a slider into a single undo step
+
+        This is an override of the Slider::Listener method.
+    */
+    void sliderDragStarted(Slider* slider) override;
+
+    /** Ends the undo step for a slider drag
+
+        This is an override of the Slider::Listener method.
+    */
+    void sliderDragEnded(Slider* slider) override;
+
     /** Callback made when a GriddleStep gets selected 
 
         This is an override of the GriddleStep::Listener method.
@@ -85,7 +111,7 @@ public:
     */
     void stepSelected(GriddleStep* selectedStep) override;
 
-    /** Handles key press events from the computer keyboard for changing the selected step
+    /** Handles key press events from the computer keyboard for changing the selected step and for undo/redo
 
         This is an override of the KeyListener method.
     */
@@ -93,9 +119,10 @@ public:
 
     /** Ensures the user has the opportunity to save any unsaved changes before the application closes
     
-        This method is for the MainWindow to call when the user is attempts to close the application
+        This method is for the MainWindow to call when the user is attempts to close the application.
+        The application is asked to quit once any unsaved changes have been dealt with, unless the user cancels.
     */
-    bool handleWindowCloseRequest();
+    void handleWindowCloseRequest();
 
     /** Callback registered with a GriddleTrack to be notified that track characteristics have changed
     *
@@ -103,35 +130,74 @@ public:
     */
     void handleTrackCharacteristicsChanged();
 
+    /** Callback registered with a GriddleTrack to be notified that the track's swing or groove template has changed
+    *
+    *   Grooves are applied by the scheduler, so the MainComponent hands it the new groove without recompiling the source measure
+    */
+    void handleTrackGrooveChanged();
+
 private:
     //==============================================================================
     // MIDI Output Variables
-    std::unique_ptr<MidiOutput> midiOutPtr_;
-    MidiBuffer playbackBuffer_;
-    MidiBuffer sourceBuffer_;
-    MidiMessage bufferOutputMessage_;
+    GriddleOutputEncoder outputEncoder_;
+    GriddleCompiledMeasure sourceMeasure_;
+    int64 sourceGeneration_;
+    std::map<String, double> midiOutputWireRates_;
+    //==============================================================================
+
+    //==============================================================================
+    // Event Compilation Variables
+    GriddleMeasureCompiler measureCompiler_;
+    GriddleProjectData compileProjectData_;
+    bool bandwidthAwareScheduling_;
     //==============================================================================
 
     //==============================================================================
     // Playback Variables
-    int previousSampleNumber_;
-    double seqStartTime_;
-    double nextStartTime_;
     double bufferSampleRate_;
+    GriddleScheduler scheduler_;
     double tempoBPM_;
-    double thisPassBPM_;
+    GriddleTempoAutomationData tempoAutomation_;
+    std::array<GriddleGrooveData, GriddleProjectData::NUM_GROOVES> grooves_;
+    int randomSeed_;
     int seqStartFrameCount_;
     bool isPlaying_;
     bool startOfMeasurePassed_;
-    int playbackSampleNumber_;
     //==============================================================================
 
     //==============================================================================
     // Project File Variables
     File currentProjectFile_;
+    GriddleProjectFile projectFileIO_;
     bool unsavedProjectChanges_;
-    var trackDefaultData_;
-    var loadedProject_;
+    GriddleTrackData trackDefaultData_;
+    std::unique_ptr<FileChooser> projectFileChooser_;
+    //==============================================================================
+
+    //==============================================================================
+    // Background Loading Variables
+    ThreadPool backgroundLoadPool_;
+    int loadRequestId_;
+    //==============================================================================
+
+    //==============================================================================
+    // Pattern Library Variables
+    GriddlePatternLibrary patternLibrary_;
+    bool patternSwitchPending_;
+    int64 patternSwitchGeneration_;
+    //==============================================================================
+
+    //==============================================================================
+    // Session Journal Variables
+    GriddleSessionJournal sessionJournal_;
+    GriddleProjectData journalProjectData_;
+    //==============================================================================
+
+    //==============================================================================
+    // Undo History Variables
+    GriddleProjectHistory projectHistory_;
+    GriddleProjectData historyProjectData_;
+    Slider* draggedSlider_;
     //==============================================================================
 
     //==============================================================================
@@ -143,6 +209,11 @@ private:
     // Pointer to the currently selected GriddleStep object
     GriddleStep* selectedStepPtr_;
 
+    // The step that the keys held down on the step edit keyboard are being captured into as a chord (nullptr when
+    // no keys are held), and the velocity of the first key held, which the velocities of the other keys are scaled against
+    GriddleStep* chordCaptureStepPtr_;
+    float chordCaptureVelocity_;
+
     // Array of GriddleTracks for the sequence
     std::array<std::shared_ptr<GriddleTrack>, 4> tracks_;
 
@@ -160,9 +231,14 @@ private:
 
     ComboBox midiOutputList_;
     Label midiOutputListLabel_;
+    Label midiWireStatsLabel_;
+
+    ComboBox patternList_;
+    Label patternListLabel_;
 
     ImageButton playButton_;
     ImageButton stopButton_;
+    TextButton fillButton_;
     Slider tempoSlider_;
     ImageComponent tempoDialImage_;
     
@@ -173,6 +249,7 @@ private:
     Slider stepEditGateSlider_;
     Label stepEditNoteLabel_;
     Label stepEditNoteTitleLabel_;
+    TextButton stepEditTrigButton_;
 
     MidiKeyboardState keyboardState_;
     MidiKeyboardComponent keyboardComponent_;
@@ -185,6 +262,8 @@ private:
     ImageButton stepSelectNextTrackButton_;
     ImageButton autoAdvanceSelectionToggle_;
     Label autoAdvanceSelectionLabel_;
+
+    GriddleTelemetryOverlay telemetryOverlay_;
     //==============================================================================
 
     //==============================================================================
@@ -193,6 +272,11 @@ private:
     const int STEPS_DISPLAY_PIXEL_WIDTH;
     //==============================================================================
 
+    //==============================================================================
+    // String Constants
+    const String VIRTUAL_MIDI_OUTPUT_NAME;
+    //==============================================================================
+
     //==============================================================================
     // Colour Constants
     const Colour GriddleLightGray;
@@ -206,18 +290,11 @@ private:
     /** Reverts all of the step, track and master settings to defaults to start a new project */
     void startNewProject();
 
-    /** This enumeration provides a return value type for the promptForProjectSave() method to indicate whether the user cancelled or not */
-    enum class CancellationEnum
-    {
-        CANCELLED = 0,
-        NOT_CANCELLED = 1
-    };
-
     /** Checks for unsaved project changes and gives the opportunity for the user to save the current project, if needed
 
-        @returns    a CancellationEnum that indicates whether the user cancelled the prompted Save operation or not
+        @param onContinue    Called once any unsaved changes have been saved or discarded, but not if the user cancels
     */
-    CancellationEnum promptForProjectSave();
+    void promptForProjectSave(std::function<void()> onContinue);
 
     /** Saves the project contents to the passed-in File
 
@@ -225,18 +302,108 @@ private:
     */
     void saveProject(File projectFile);
 
-    /** Brings up a FileBrowserDialog for the user to save the current project to a file they specify */
-    void saveProjectAs();
+    /** Asynchronously brings up a file chooser for the user to save the current project to a file they specify
 
-    /** Loads a Griddle Project file specified by the user with a FileBrowserDialog */
+        @param onSaved    Called once the project has been saved, but not if the user cancels or the save fails
+    */
+    void saveProjectAs(std::function<void()> onSaved = nullptr);
+
+    /** Asynchronously brings up a file chooser for the user to pick a Griddle Project file to load */
     void loadProject();
 
+    /** Reads and parses a Griddle Project file on the background load thread, then applies it on the message thread
+
+        @param projectFile    The project file to load
+    */
+    void loadProjectInBackground(const File& projectFile);
+
+    /** Replaces the current project with one that has been read and parsed in the background
+
+        @param requestId      The ID of the load request, which is ignored if a later request has been made
+        @param projectFile    The project file that was loaded
+        @param projectData    The loaded project data
+        @param loadResult     The result of reading the project file
+        @param errorString    Any errors encountered while reading the project settings
+    */
+    void applyLoadedProject(const int requestId, const File& projectFile, const GriddleProjectData& projectData, const Result& loadResult, const String& errorString);
+
+    /** Sets the master settings and tracks from plain project data
+
+        @param projectData          The project data to load
+        @param invalidMidiOutput    Set to the name of the project's MIDI output if it isn't available
+    */
+    void loadProjectData(const GriddleProjectData& projectData, String& invalidMidiOutput);
+
+    /** Sets the tempo, scheduling option and tracks from plain project data, leaving the MIDI output unchanged
+
+        The scheduler's tempo map and groove aren't updated, so the caller can hand them over straight away
+        (see updateTempoMap() and updateGroove()) or along with the pattern's compiled measure.
+
+        @param projectData    The project data to load
+    */
+    void loadPatternData(const GriddleProjectData& projectData);
+
+    /** Gets the master settings and tracks as plain project data
+
+        @param projectData    The project data to populate
+    */
+    void getProjectData(GriddleProjectData& projectData) const;
+
+    /** Selects the MIDI output with the passed-in name in the MIDI output ComboBox and opens it
+
+        @param midiOutputName    The name of the MIDI output, as listed in the ComboBox
+        @returns                 true if the MIDI output was found, otherwise false
+    */
+    bool selectMidiOutput(const String& midiOutputName);
+
+    /** Updates the current project file and the GUI after a project has been loaded, reporting any errors
+
+        @param projectFile          The project file that was loaded
+        @param errorString          Any errors encountered while loading the project settings
+        @param invalidMidiOutput    The name of the project's MIDI output if it wasn't available, otherwise empty
+    */
+    void finishProjectLoad(const File& projectFile, const String& errorString, const String& invalidMidiOutput);
+
+    /** Updates the current project file and the GUI after a project has been saved, or reports the error if it failed
+
+        @param projectFile    The project file that was saved
+        @param saveResult     The result of the save
+    */
+    void finishProjectSave(const File& projectFile, const Result& saveResult);
+
     /** Sets a flag indicating the presence of unsaved changes to the current project based on passed-in boolean value
 
         @param unsavedChanges    Pass true to indicate the project has unsaved changes, otherwise pass false
     */
     void setUnsavedChangesFlag(const bool unsavedChanges);
 
+    /** Offers to restore the unsaved changes of a session that didn't shut down cleanly
+
+        @param projectData    The recovered project data
+        @param projectFile    The project file the session had open, or File() if it was a new project
+    */
+    void restoreRecoveredSession(const GriddleProjectData& projectData, const File& projectFile);
+
+    /** Clears the undo history, starting it again from the current project (e.g. after a project is loaded) */
+    void resetProjectHistory();
+
+    /** Reverts the sequence to the state before the last change */
+    void undoProjectChange();
+
+    /** Reapplies the last change that was undone */
+    void redoProjectChange();
+
+    /** Loads the sequence state reached by an undo or redo into the tempo and tracks */
+    void applyProjectHistoryState();
+
+    /** Asynchronously brings up a file chooser for the user to export the playback telemetry histograms as a CSV file */
+    void exportPlaybackTelemetry();
+
+   #if GRIDDLE_ENABLE_TRACING
+    /** Asynchronously brings up a file chooser for the user to save the recorded trace events as a Chrome JSON trace file */
+    void saveTraceFile();
+   #endif
+
     /** Pops up the application's About window */
     void showAboutDialog();
 
@@ -248,6 +415,13 @@ private:
         @param identifier    The string identifier for the MIDI output to be used 
     */
     void setMidiOutput(const juce::String& identifier);
+
+    /**  Opens a port for the MIDI output specified by the passed-in identifier
+
+        @param identifier    The string identifier for the MIDI output, as listed in the MIDI output ComboBox
+        @returns             The opened port, or nullptr if the output couldn't be opened
+    */
+    std::unique_ptr<GriddleOutputPort> openMidiOutputPort(const juce::String& identifier) const;
     
     /**  Handles the processing to be done when the Play button of the master section is clicked */
     void handlePlayButtonClick();
@@ -261,6 +435,16 @@ private:
     /**  Handles clicks of the Rest button of the Step Edit section*/
     void handleRestButtonClick();
 
+    /**  Handles clicks of the Trig button of the Step Edit section, which brings up a menu of the selected step's
+         probability, ratchets and trig condition */
+    void handleStepEditTrigButtonClick();
+
+    /**  Updates the Trig button of the Step Edit section to show the selected step's probability, ratchets and trig condition */
+    void updateStepEditTrigButtonText();
+
+    /**  Updates the note display of the Step Edit section to show the selected step's note and the rest of its chord */
+    void updateStepEditNoteLabel();
+
     /**  Handles clicks of the Select Previous Step button of the Step Edit section */
     void handleStepSelectPreviousButtonClick();
 
@@ -288,8 +472,100 @@ private:
     /**  Toggles the auto-advance selection state for the Step Edit section */
     void updateAutoAdvanceSelectionState();
 
-    /**  Populates the source MidiBufffer based on the current step, track, and master settings */
-    void updateSourceMidiBuffer();
+    /**  Compiles the source measure based on the current step, track, and master settings */
+    void updateSourceMeasure();
+
+    /**  Hands the scheduler a tempo map for the current tempo and tempo automation, which takes effect immediately */
+    void updateTempoMap();
+
+    /**  Sets the project's tempo automation and updates the tempo map to play it */
+    void setTempoAutomation(const GriddleTempoAutomationData& tempoAutomation);
+
+    /** Gets one of the tempo automation presets offered in the Project menu
+
+        @param presetIndex    The index of the preset, where 0 is no automation
+        @returns              The preset's tempo automation
+    */
+    static GriddleTempoAutomationData getTempoAutomationPreset(const int presetIndex);
+
+    /**  Brings up an AlertWindow for the user to set the seed of the random numbers that decide whether steps with a probability play */
+    void promptForRandomSeed();
+
+    /**  Hands the scheduler the tracks' current swing and groove templates, which take effect immediately */
+    void updateGroove();
+
+    /**  Sets one of the project's groove templates and updates the groove to play it
+
+        @param grooveIndex    The index of the groove template to set
+        @param groove         The new groove template
+    */
+    void setGrooveTemplate(const int grooveIndex, const GriddleGrooveData& groove);
+
+    /**  Gets the name of a groove template as it's shown in the menus (e.g. "Groove 2: Laid Back")
+
+        @param grooveIndex    The index of the groove template
+        @returns              The display name of the groove template
+    */
+    String getGrooveDisplayName(const int grooveIndex) const;
+
+    /**  Passes the display names of the groove templates on to the tracks for their options menus */
+    void updateTrackGrooveNames();
+
+    /**  Brings up an AlertWindow for the user to edit a groove template's name, timing offsets and velocity offsets
+
+        @param grooveIndex    The index of the groove template to edit
+    */
+    void promptForGrooveTemplate(const int grooveIndex);
+
+    /** Gets one of the groove template presets offered in the Project menu
+
+        @param presetIndex    The index of the preset, where 0 is an empty groove template
+        @returns              The preset's groove template
+    */
+    static GriddleGrooveData getGroovePreset(const int presetIndex);
+
+    /** The number of groove template presets offered in the Project menu, including the empty groove template */
+    static constexpr int NUM_GROOVE_PRESETS = 5;
+
+    /**  Brings up a FileBrowserDialog for the user to choose a directory to open as the pattern library */
+    void openPatternLibrary();
+
+    /**  Fills the Pattern ComboBox with the patterns in the library, selecting the current project file if it's one of them */
+    void updatePatternList();
+
+    /**  Loads and compiles a pattern from the library in the background, then replaces the current project with it
+
+        During playback the pattern switch is queued for the next measure boundary.
+
+        @param patternIndex    The index of the pattern in the library
+    */
+    void selectPattern(const int patternIndex);
+
+    /**  Loads and compiles a pattern on the background load thread, then applies it on the message thread
+
+        @param entry    The index entry of the pattern
+    */
+    void loadPatternInBackground(const GriddlePatternLibrary::IndexEntry& entry);
+
+    /**  Replaces the current project with a pattern that has been loaded and compiled in the background
+
+        @param requestId    The ID of the pattern request, which is ignored if a later request has been made
+        @param entry        The index entry of the pattern
+        @param pattern      The compiled pattern, or nullptr if it couldn't be loaded
+    */
+    void applyPattern(const int requestId, const GriddlePatternLibrary::IndexEntry& entry, const GriddlePatternLibrary::CompiledPattern* pattern);
+
+    /**  Measures the round-trip latency of a MIDI loopback and offers to apply it as the latency offset of a track
+
+        @param trackIndex    The index of the track to calibrate
+    */
+    void calibrateTrackLatency(const int trackIndex);
+
+    /**  Sets the wire rate of the current MIDI output, remembering it for when that output is selected again
+
+        @param bytesPerSecond    The wire rate in bytes per second, or 0 for an unthrottled output
+    */
+    void setMidiOutputWireRate(const double bytesPerSecond);
 
     /** Enables or disables components in the master section based on whether the sequence is playing or not */
     void updateMasterComponentsEnabledState();
@@ -308,6 +584,9 @@ private:
 
     /**  Performs a tranform on the tempo dial image to rotate it to the current tempo slider value */
     void rotateTempoDialImage();
+
+    /**  Updates the MIDI wire statistics label with the statistics of the last complete measure */
+    void updateMidiWireStatsLabel();
          
     //==============================================================================
 